@@ -46,6 +46,7 @@
 #include <rdescape_string.h>
 #include <rddebug.h>
 #include <rdcmd_switch.h>
+#include <rdstartuptrace.h>
 #include <rdsvc.h>
 #include <rdsystem.h>
 
@@ -246,15 +247,20 @@ MainObject::MainObject(QObject *parent,const char *name)
     exit(1);
   }
 
+  RDStartupTrace startup_trace;
+
   //
   // Provisioning
   //
   InitProvisioning();
+  startup_trace.mark("provisioning");
 
   //
   // Start Up the Drivers
   //
   RDStation *station=new RDStation(rd_config->stationName());
+  station->setSnapshotEnabled(true);
+  station->setCardsSnapshotEnabled(true);
   RDSystem *sys=new RDSystem();
   system_sample_rate=sys->sampleRate();
   delete sys;
@@ -262,11 +268,14 @@ MainObject::MainObject(QObject *parent,const char *name)
   alsaInit(station);
   jackInit(station);
   ClearDriverEntries(station);
+  station->reload();  // Pick up the card rows as now written
+  startup_trace.mark("drivers");
 
   //
   // Probe Capabilities
   //
   ProbeCaps(station);
+  startup_trace.mark("capabilities");
 
   //
   // Close Database Connection
@@ -279,6 +288,8 @@ MainObject::MainObject(QObject *parent,const char *name)
   // Initialize Mixers
   //
   InitMixers();
+  startup_trace.mark("mixers");
+  LogLine(RDConfig::LogInfo,startup_trace.report());
 
   //
   // Meter Update Timer
@@ -452,6 +463,23 @@ void MainObject::statePlayUpdate(int card,int stream,int state)
 }
 
 
+void MainObject::stateTransitionUpdate(int card,int stream,int next_stream,
+				       unsigned frame)
+{
+  int handle=GetHandle(card,stream);
+  int next_handle=GetHandle(card,next_stream);
+
+  if((next_handle<0)||(play_owner[card][next_stream]==-1)) {
+    return;
+  }
+  EchoCommand(play_owner[card][next_stream],(const char *)QString().
+	      sprintf("XE %d %d %u!",handle,next_handle,frame));
+  LogLine(RDConfig::LogDebug,QString().
+	  sprintf("TransitionExecuted - Card: %d  Stream: %d  Next Stream: %d  Frame: %u",
+		  card,stream,next_stream,frame));
+}
+
+
 void MainObject::stateRecordUpdate(int card,int stream,int state)
 {
   if(record_owner[card][stream]!=-1) {
@@ -743,8 +771,14 @@ void MainObject::DispatchCommand(int ch)
   int mode=0;
   int type=0;
   QString wavename;
+  bool chase=false;
   char temp[256];
   int handle;
+  int next_handle=-1;
+  int next_stream=-1;
+  unsigned frame=0;
+  int fade_in=0;
+  int fade_out=0;
   QString in_jport;
   QString out_jport;
 
@@ -808,6 +842,11 @@ void MainObject::DispatchCommand(int ch)
       return;
     }
     wavename = rd_config->audioFileName (QString(args[ch][2]));
+    //
+    // An optional third argument of '1' asks to chase a cut that is still
+    // being recorded
+    //
+    chase=(argnum[ch]>3)&&(!strcmp(args[ch][3],"1"));
     switch(cae_driver[card]) {
 	case RDStation::Hpi:
 	  if(!hpiLoadPlayback(card,wavename,&new_stream)) {
@@ -821,7 +860,7 @@ void MainObject::DispatchCommand(int ch)
 	  break;
 
 	case RDStation::Alsa:
-	  if(!alsaLoadPlayback(card,wavename,&new_stream)) {
+	  if(!alsaLoadPlayback(card,wavename,chase,&new_stream)) {
 	    sprintf(temp,"LP %d %s -1 -1 -!",card,args[ch][2]);
 	    EchoCommand(ch,temp);
 	    LogLine(RDConfig::LogErr,QString().
@@ -832,7 +871,7 @@ void MainObject::DispatchCommand(int ch)
 	  break;
 
 	case RDStation::Jack:
-	  if(!jackLoadPlayback(card,wavename,&new_stream)) {
+	  if(!jackLoadPlayback(card,wavename,chase,&new_stream)) {
 	    sprintf(temp,"LP %d %s -1 -1 -!",card,args[ch][2]);
 	    EchoCommand(ch,temp);
 	    LogLine(RDConfig::LogErr,QString().
@@ -1109,6 +1148,75 @@ void MainObject::DispatchCommand(int ch)
     return;
   }
 
+  if(!strcmp(args[ch][0],"XS")) {  // Schedule Transition
+    if((handle=GetHandle(ch,&card,&stream))<0) {
+      EchoArgs(ch,'-');
+      return;
+    }
+    card=play_handle[handle].card;
+    stream=play_handle[handle].stream;
+    if((sscanf(args[ch][2],"%u",&frame)!=1)||
+       (sscanf(args[ch][3],"%d",&next_handle)!=1)||
+       (next_handle<0)||(next_handle>=256)||
+       (play_handle[next_handle].card!=card)||
+       (sscanf(args[ch][4],"%d",&length)!=1)||
+       (sscanf(args[ch][5],"%d",&fade_in)!=1)||
+       (sscanf(args[ch][6],"%d",&fade_out)!=1)) {
+      EchoArgs(ch,'-');
+      return;
+    }
+    next_stream=play_handle[next_handle].stream;
+    if((play_owner[card][stream]!=ch)||(play_owner[card][next_stream]!=ch)) {
+      EchoArgs(ch,'-');
+      return;
+    }
+    switch(cae_driver[card]) {
+	case RDStation::Alsa:
+	  if(!alsaScheduleTransition(card,stream,frame,next_stream,length,
+				     fade_in,fade_out)) {
+	    EchoArgs(ch,'-');
+	    return;
+	  }
+	  break;
+
+	default:
+	  EchoArgs(ch,'-');
+	  return;
+    }
+    LogLine(RDConfig::LogInfo,QString().
+	    sprintf("ScheduleTransition - Card: %d  Stream: %d  Frame: %u  Next Stream: %d  Length: %d  Fade In: %d  Fade Out: %d",
+		    card,stream,frame,next_stream,length,fade_in,fade_out));
+    EchoArgs(ch,'+');
+    return;
+  }
+
+  if(!strcmp(args[ch][0],"XC")) {  // Cancel Transition
+    if((handle=GetHandle(ch,&card,&stream))<0) {
+      EchoArgs(ch,'-');
+      return;
+    }
+    card=play_handle[handle].card;
+    stream=play_handle[handle].stream;
+    if(play_owner[card][stream]!=ch) {
+      EchoArgs(ch,'-');
+      return;
+    }
+    switch(cae_driver[card]) {
+	case RDStation::Alsa:
+	  if(!alsaCancelTransition(card,stream)) {
+	    EchoArgs(ch,'-');
+	    return;
+	  }
+	  break;
+
+	default:
+	  EchoArgs(ch,'-');
+	  return;
+    }
+    EchoArgs(ch,'+');
+    return;
+  }
+
   if(!strcmp(args[ch][0],"TS")) {  // Timescale Support
     switch(cae_driver[card]) {
 	case RDStation::Hpi:
@@ -1214,6 +1322,7 @@ void MainObject::DispatchCommand(int ch)
     }
     if((record_owner[card][stream]==-1)||(record_owner[card][stream]==ch)) {
       unsigned len=0;
+      QString hash;
       switch(cae_driver[card]) {
 	  case RDStation::Hpi:
 	    if(!hpiUnloadRecord(card,stream,&len)) {
@@ -1223,14 +1332,14 @@ void MainObject::DispatchCommand(int ch)
 	    break;
 
 	  case RDStation::Alsa:
-	    if(!alsaUnloadRecord(card,stream,&len)) {
+	    if(!alsaUnloadRecord(card,stream,&len,&hash)) {
 	      EchoArgs(ch,'-');
 	      return;
 	    }
 	    break;
 
 	  case RDStation::Jack:
-	    if(!jackUnloadRecord(card,stream,&len)) {
+	    if(!jackUnloadRecord(card,stream,&len,&hash)) {
 	      EchoArgs(ch,'-');
 	      return;
 	    }
@@ -1244,9 +1353,21 @@ void MainObject::DispatchCommand(int ch)
       LogLine(RDConfig::LogInfo,QString().
 	      sprintf("UnloadRecord - Card: %d  Stream: %d, Length: %u",
 		      card,stream,len));
-      EchoCommand(ch,(const char *)QString().sprintf("UR %d %d %u +!",
-						     card,stream,
-	  (unsigned)((double)len*1000.0/(double)system_sample_rate)));
+      //
+      // Append the SHA-1 hash of the file if it was generated as the
+      // audio was written
+      //
+      if(hash.isEmpty()) {
+	EchoCommand(ch,(const char *)QString().sprintf("UR %d %d %u +!",
+						       card,stream,
+	    (unsigned)((double)len*1000.0/(double)system_sample_rate)));
+      }
+      else {
+	EchoCommand(ch,(const char *)QString().sprintf("UR %d %d %u + %s!",
+						       card,stream,
+	    (unsigned)((double)len*1000.0/(double)system_sample_rate),
+						       (const char *)hash));
+      }
       return;
     }
     else {
@@ -1901,17 +2022,18 @@ void MainObject::KillSocket(int ch)
     for(int j=0;j<RD_MAX_STREAMS;j++) {
       if(record_owner[i][j]==ch) {
 	unsigned len=0;
+	QString hash;
 	switch(cae_driver[i]) {
 	    case RDStation::Hpi:
 	      hpiUnloadRecord(i,j,&len);
 	      break;
 
 	    case RDStation::Jack:
-	      jackUnloadRecord(i,j,&len);
+	      jackUnloadRecord(i,j,&len,&hash);
 	      break;
 
 	    case RDStation::Alsa:
-	      alsaUnloadRecord(i,j,&len);
+	      alsaUnloadRecord(i,j,&len,&hash);
 	      break;
 
 	    default:
@@ -25,6 +25,8 @@
 #include <sys/types.h>
 #include <pthread.h>
 #include <stdint.h>
+#include <stdio.h>
+#include <time.h>
 
 #include <soundtouch/SoundTouch.h>
 
@@ -61,6 +63,11 @@ struct alsa_format {
   unsigned card_buffer_size;
   unsigned periods;
   bool exiting;
+  bool null_device;
+  double null_speed;
+  FILE *null_output;
+  struct timespec null_clock;
+  volatile unsigned null_late;
 };
 #endif  // ALSA
 
@@ -129,6 +136,8 @@ class MainObject : public QObject
   void BroadcastCommand(const char *);
   void EchoCommand(int,const char *);
   void EchoArgs(int,const char);
+  void stateTransitionUpdate(int card,int stream,int next_stream,
+			     unsigned frame);
   bool CheckDaemon(QString);
   pid_t GetPid(QString pidfile);
   int GetNextHandle();
@@ -226,7 +235,7 @@ class MainObject : public QObject
  private:
   void jackInit(RDStation *station);
   void jackFree();
-  bool jackLoadPlayback(int card,QString wavename,int *stream);
+  bool jackLoadPlayback(int card,QString wavename,bool chase,int *stream);
   bool jackUnloadPlayback(int card,int stream);
   bool jackPlaybackPosition(int card,int stream,unsigned pos);
   bool jackPlay(int card,int stream,int length,int speed,bool pitch,
@@ -235,7 +244,7 @@ class MainObject : public QObject
   bool jackTimescaleSupported(int card);
   bool jackLoadRecord(int card,int port,int coding,int chans,int samprate,
 		     int bitrate,QString wavename);
-  bool jackUnloadRecord(int card,int stream,unsigned *len);
+  bool jackUnloadRecord(int card,int stream,unsigned *len,QString *hash);
   bool jackRecord(int card,int stream,int length,int thres);
   bool jackStopRecord(int card,int stream);
   bool jackSetInputVolume(int card,int stream,int level);
@@ -291,6 +300,7 @@ class MainObject : public QObject
   int jack_offset[RD_MAX_STREAMS];
   int jack_clock_phase;
   unsigned jack_samples_recorded[RD_MAX_STREAMS];
+  unsigned jack_record_frames[RD_MAX_STREAMS];
 #endif  // JACK
 
   //
@@ -304,16 +314,20 @@ class MainObject : public QObject
  private:
   void alsaInit(RDStation *station);
   void alsaFree();
-  bool alsaLoadPlayback(int card,QString wavename,int *stream);
+  bool alsaLoadPlayback(int card,QString wavename,bool chase,int *stream);
   bool alsaUnloadPlayback(int card,int stream);
   bool alsaPlaybackPosition(int card,int stream,unsigned pos);
   bool alsaPlay(int card,int stream,int length,int speed,bool pitch,
 	       bool rates);
   bool alsaStopPlayback(int card,int stream);
+  bool alsaScheduleTransition(int card,int stream,unsigned frame,
+			      int next_stream,int length,int fade_in,
+			      int fade_out);
+  bool alsaCancelTransition(int card,int stream);
   bool alsaTimescaleSupported(int card);
   bool alsaLoadRecord(int card,int port,int coding,int chans,int samprate,
 		     int bitrate,QString wavename);
-  bool alsaUnloadRecord(int card,int stream,unsigned *len);
+  bool alsaUnloadRecord(int card,int stream,unsigned *len,QString *hash);
   bool alsaRecord(int card,int stream,int length,int thres);
   bool alsaStopRecord(int card,int stream);
   bool alsaSetInputVolume(int card,int stream,int level);
@@ -335,6 +349,7 @@ class MainObject : public QObject
 #ifdef ALSA
   bool AlsaStartCaptureDevice(QString &dev,int card,snd_pcm_t *pcm);
   bool AlsaStartPlayDevice(QString &dev,int card,snd_pcm_t *pcm);
+  bool AlsaStartNullDevice(int card,int num);
   void AlsaInitCallback();
   int GetAlsaOutputStream(int card);
   void FreeAlsaOutputStream(int card,int stream);
@@ -359,6 +374,8 @@ class MainObject : public QObject
   short alsa_fade_increment[RD_MAX_CARDS][RD_MAX_STREAMS];
   int alsa_fade_port[RD_MAX_CARDS][RD_MAX_STREAMS];
   unsigned alsa_samples_recorded[RD_MAX_CARDS][RD_MAX_STREAMS];
+  unsigned alsa_record_frames[RD_MAX_CARDS][RD_MAX_STREAMS];
+  int alsa_transition_length[RD_MAX_CARDS][RD_MAX_STREAMS];
 #endif  // ALSA
 
   bool CheckLame();
@@ -18,8 +18,12 @@
 //   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
 //
 
+#include <errno.h>
 #include <math.h>
 #include <signal.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
 
 #include <samplerate.h>
 
@@ -56,6 +60,201 @@ volatile bool alsa_recording[RD_MAX_CARDS][RD_MAX_PORTS];
 volatile bool alsa_ready[RD_MAX_CARDS][RD_MAX_PORTS];
 volatile int alsa_channels;
 
+//
+// Playing streams as a bitmask per card (RD_MAX_STREAMS must not exceed 64),
+// so the play callback touches only the active ones.
+//
+volatile uint64_t alsa_active_streams[RD_MAX_CARDS];
+
+//
+// Play callback mix timing
+//
+volatile unsigned alsa_mix_periods[RD_MAX_CARDS];
+volatile uint64_t alsa_mix_nsecs[RD_MAX_CARDS];
+volatile unsigned alsa_mix_max_nsecs[RD_MAX_CARDS];
+
+//
+// Play ring health, reported with the mix timing
+//
+volatile unsigned alsa_play_underruns[RD_MAX_CARDS];
+volatile unsigned alsa_play_min_fill[RD_MAX_CARDS];
+
+
+void AlsaSetPlaying(int card,int stream,bool state)
+{
+  alsa_playing[card][stream]=state;
+  if(state) {
+    __sync_fetch_and_or(&alsa_active_streams[card],(uint64_t)1<<stream);
+  }
+  else {
+    __sync_fetch_and_and(&alsa_active_streams[card],~((uint64_t)1<<stream));
+  }
+}
+
+
+inline int16_t AlsaSaturate(float sample)
+{
+  if(sample>32767.0) {
+    return 32767;
+  }
+  if(sample<-32768.0) {
+    return -32768;
+  }
+  return (int16_t)sample;
+}
+
+//
+// Scheduled Transitions
+//
+// Indexed by the triggering stream; 'alsa_transition_frame' is relative
+// to 'alsa_output_pos', and fade lengths are in frames.
+//
+volatile int alsa_transition_stream[RD_MAX_CARDS][RD_MAX_STREAMS];
+volatile int alsa_transition_frame[RD_MAX_CARDS][RD_MAX_STREAMS];
+volatile int alsa_transition_fade_in[RD_MAX_CARDS][RD_MAX_STREAMS];
+volatile int alsa_transition_fade_out[RD_MAX_CARDS][RD_MAX_STREAMS];
+
+//
+// Indexed by the started stream, for reporting by AlsaClock()
+//
+volatile int alsa_transition_from[RD_MAX_CARDS][RD_MAX_STREAMS];
+volatile int alsa_transition_achieved[RD_MAX_CARDS][RD_MAX_STREAMS];
+
+//
+// Per-stream Gain Envelopes
+//
+volatile int alsa_start_delay[RD_MAX_CARDS][RD_MAX_STREAMS];
+volatile double alsa_envelope_gain[RD_MAX_CARDS][RD_MAX_STREAMS];
+volatile double alsa_envelope_step[RD_MAX_CARDS][RD_MAX_STREAMS];
+volatile int alsa_envelope_delay[RD_MAX_CARDS][RD_MAX_STREAMS];
+volatile int alsa_envelope_frames[RD_MAX_CARDS][RD_MAX_STREAMS];
+volatile bool alsa_envelope_stop[RD_MAX_CARDS][RD_MAX_STREAMS];
+
+
+void AlsaResetEnvelope(int card,int stream)
+{
+  alsa_envelope_frames[card][stream]=0;
+  alsa_envelope_delay[card][stream]=0;
+  alsa_envelope_step[card][stream]=0.0;
+  alsa_envelope_gain[card][stream]=1.0;
+  alsa_envelope_stop[card][stream]=false;
+  alsa_start_delay[card][stream]=0;
+}
+
+
+void AlsaClearTransitions(int card,int stream)
+{
+  for(int i=0;i<RD_MAX_STREAMS;i++) {
+    if((i==stream)||(alsa_transition_stream[card][i]==stream)) {
+      alsa_transition_stream[card][i]=-1;
+    }
+  }
+  alsa_transition_achieved[card][stream]=-1;
+}
+
+
+void AlsaRunTransitions(int card,int frames)
+{
+  //
+  // Start any streams whose trigger falls within the coming period,
+  // offset to the exact frame.
+  //
+  int i;
+  int next;
+  int delay;
+
+  for(uint64_t active=alsa_active_streams[card];active!=0;active&=active-1) {
+    i=__builtin_ctzll(active);
+    if(((next=alsa_transition_stream[card][i])>=0)&&
+       ((alsa_output_pos[card][i]+frames)>alsa_transition_frame[card][i])) {
+      if((delay=alsa_transition_frame[card][i]-alsa_output_pos[card][i])<0) {
+	delay=0;
+      }
+      AlsaResetEnvelope(card,next);
+      alsa_start_delay[card][next]=delay;
+      if(alsa_transition_fade_in[card][i]>0) {
+	alsa_envelope_gain[card][next]=0.0;
+	alsa_envelope_step[card][next]=1.0/alsa_transition_fade_in[card][i];
+	alsa_envelope_frames[card][next]=alsa_transition_fade_in[card][i];
+      }
+      if(alsa_transition_fade_out[card][i]>0) {
+	alsa_envelope_delay[card][i]=delay;
+	alsa_envelope_step[card][i]=-alsa_envelope_gain[card][i]/
+	  alsa_transition_fade_out[card][i];
+	alsa_envelope_frames[card][i]=alsa_transition_fade_out[card][i];
+	alsa_envelope_stop[card][i]=true;
+      }
+      alsa_transition_from[card][next]=i;
+      alsa_transition_achieved[card][next]=alsa_output_pos[card][i]+delay;
+      alsa_transition_stream[card][i]=-1;
+      AlsaSetPlaying(card,next,true);
+    }
+  }
+}
+
+
+void AlsaFillEnvelope(int card,int stream,float env[],int frames)
+{
+  double gain=alsa_envelope_gain[card][stream];
+  double step=alsa_envelope_step[card][stream];
+  int delay=alsa_envelope_delay[card][stream];
+  int remaining=alsa_envelope_frames[card][stream];
+
+  for(int i=0;i<frames;i++) {
+    if(delay>0) {
+      delay--;
+    }
+    else {
+      if(remaining>0) {
+	gain+=step;
+	if(--remaining==0) {
+	  gain=step>0.0?1.0:0.0;
+	  if(alsa_envelope_stop[card][stream]) {
+	    alsa_stopping[card][stream]=true;
+	  }
+	}
+      }
+    }
+    env[i]=gain;
+  }
+  alsa_envelope_gain[card][stream]=gain;
+  alsa_envelope_delay[card][stream]=delay;
+  alsa_envelope_frames[card][stream]=remaining;
+}
+
+
+//
+// Pace a null device by the monotonic clock, scaled by its speed setting.
+// Periods that start late are counted and the clock resynchronized, rather
+// than trying to catch up in a burst.
+//
+void AlsaNullWait(struct alsa_format *alsa_format,unsigned frames)
+{
+  struct timespec now;
+  uint64_t nsecs;
+
+  if(alsa_format->null_speed<=0.0) {
+    return;
+  }
+  nsecs=(uint64_t)(1000000000.0*(double)frames/
+		   (alsa_format->null_speed*(double)alsa_format->sample_rate));
+  alsa_format->null_clock.tv_sec+=nsecs/1000000000;
+  alsa_format->null_clock.tv_nsec+=nsecs%1000000000;
+  if(alsa_format->null_clock.tv_nsec>=1000000000) {
+    alsa_format->null_clock.tv_sec++;
+    alsa_format->null_clock.tv_nsec-=1000000000;
+  }
+  clock_gettime(CLOCK_MONOTONIC,&now);
+  if((now.tv_sec>alsa_format->null_clock.tv_sec)||
+     ((now.tv_sec==alsa_format->null_clock.tv_sec)&&
+      (now.tv_nsec>alsa_format->null_clock.tv_nsec))) {
+    alsa_format->null_late++;
+    alsa_format->null_clock=now;
+    return;
+  }
+  clock_nanosleep(CLOCK_MONOTONIC,TIMER_ABSTIME,&alsa_format->null_clock,NULL);
+}
+
 
 void AlsaCapture1Callback(struct alsa_format *alsa_format)
 {
@@ -70,10 +269,19 @@ void AlsaCapture2Callback(struct alsa_format *alsa_format)
 
 
   while(!alsa_format->exiting) {
-    int s=snd_pcm_readi(alsa_format->pcm,alsa_format->card_buffer,
-			rd_config->alsaPeriodSize()/(alsa_format->periods*2));
-    if(((snd_pcm_state(alsa_format->pcm)!=SND_PCM_STATE_RUNNING)&&
-	(!alsa_format->exiting))||(s<0)) {
+    int s;
+    if(alsa_format->null_device) {
+      s=alsa_format->buffer_size/(2*alsa_format->periods);
+      memset(alsa_format->card_buffer,0,s*alsa_format->channels*2);
+      AlsaNullWait(alsa_format,s);
+    }
+    else {
+      s=snd_pcm_readi(alsa_format->pcm,alsa_format->card_buffer,
+		      rd_config->alsaPeriodSize()/(alsa_format->periods*2));
+    }
+    if((!alsa_format->null_device)&&
+       (((snd_pcm_state(alsa_format->pcm)!=SND_PCM_STATE_RUNNING)&&
+	 (!alsa_format->exiting))||(s<0))) {
       snd_pcm_drop (alsa_format->pcm);
       snd_pcm_prepare(alsa_format->pcm);
       LogLine(RDConfig::LogNotice,QString().
@@ -275,260 +483,195 @@ void AlsaPlay2Callback(struct alsa_format *alsa_format)
 {
   int n=0;
   int p;
+  int j;
   char alsa_buffer[RINGBUFFER_SIZE];
-  int modulo;
-  int16_t out_meter[RD_MAX_PORTS][2];
   int16_t stream_out_meter=0;
+  float out_meter;
+  int card=alsa_format->card;
+  unsigned chans=alsa_format->channels;
+  int period=alsa_format->buffer_size/(2*alsa_format->periods);
+  int start=0;
+  unsigned fill;
+  uint64_t active;
+  float vol;
+  float sample;
+  float env[RINGBUFFER_SIZE/4];
+  float *bus=new float[period*chans];
+  struct timespec mix_start;
+  struct timespec mix_end;
+  unsigned mix_nsecs;
 
   while(!alsa_format->exiting) {
-    memset(alsa_format->card_buffer,0,alsa_format->card_buffer_size);
-
-    switch(alsa_format->format) {
-    case SND_PCM_FORMAT_S16_LE:
-      for(unsigned j=0;j<RD_MAX_STREAMS;j++) {
-        if(alsa_playing[alsa_format->card][j]) {
-          switch(alsa_output_channels[alsa_format->card][j]) {
-          case 1:
-            n=alsa_play_ring[alsa_format->card][j]->
-              read(alsa_buffer,alsa_format->
-                   buffer_size/alsa_format->periods)/
-              (2*sizeof(int16_t));
-            stream_out_meter=0;  // Stream Output Meters
+    clock_gettime(CLOCK_MONOTONIC,&mix_start);
+    memset(bus,0,period*chans*sizeof(float));
+    AlsaRunTransitions(card,period);
+
+    //
+    // Mix the active streams onto the bus
+    //
+    for(active=alsa_active_streams[card];active!=0;active&=active-1) {
+      j=__builtin_ctzll(active);
+      start=alsa_start_delay[card][j];
+      alsa_start_delay[card][j]=0;
+      AlsaFillEnvelope(card,j,env,period-start);
+      if((fill=alsa_play_ring[card][j]->readSpace())<
+	 alsa_play_min_fill[card]) {
+	alsa_play_min_fill[card]=fill;
+      }
+      switch(alsa_output_channels[card][j]) {
+      case 1:
+        n=alsa_play_ring[card][j]->
+          read(alsa_buffer,sizeof(int16_t)*(period-start))/sizeof(int16_t);
+        stream_out_meter=0;  // Stream Output Meters
+        for(int k=0;k<n;k++) {
+          if(abs(((int16_t *)alsa_buffer)[k])>stream_out_meter) {
+            stream_out_meter=abs(((int16_t *)alsa_buffer)[k]);
+          }
+        }
+        alsa_stream_output_meter[card][j][0]->
+          addValue(((double)stream_out_meter)/32768.0);
+        alsa_stream_output_meter[card][j][1]->
+          addValue(((double)stream_out_meter)/32768.0);
+        for(unsigned i=0;i<(chans/2);i++) {
+          if((vol=alsa_output_volume[card][i][j])!=0.0) {
             for(int k=0;k<n;k++) {
-              if(abs(((int16_t *)alsa_buffer)[k])>stream_out_meter) {
-                stream_out_meter=abs(((int16_t *)alsa_buffer)[k]);
-              }
-            }
-            alsa_stream_output_meter[alsa_format->card][j][0]->
-              addValue(((double)stream_out_meter)/32768.0);
-            alsa_stream_output_meter[alsa_format->card][j][1]->
-              addValue(((double)stream_out_meter)/32768.0);
-            modulo=alsa_format->channels;
-            for(unsigned i=0;i<(alsa_format->channels/2);i++) {
-              if(alsa_output_volume[alsa_format->card][i][j]!=0.0) {
-                for(int k=0;k<(2*n);k++) {
-                  ((int16_t *)alsa_format->card_buffer)[modulo*k+2*i]+=
-                    (int16_t)(alsa_output_volume[alsa_format->card][i][j]*
-                              (double)(((int16_t *)alsa_buffer)[k]));
-                  ((int16_t *)alsa_format->card_buffer)[modulo*k+2*i+1]+=
-                    (int16_t)(alsa_output_volume[alsa_format->card][i][j]*
-                              (double)(((int16_t *)alsa_buffer)[k]));
-                }
-              }
+              sample=vol*env[k]*(float)((int16_t *)alsa_buffer)[k];
+              bus[chans*(k+start)+2*i]+=sample;
+              bus[chans*(k+start)+2*i+1]+=sample;
             }
-            n*=2;
-            break;
-
-          case 2:
-            n=alsa_play_ring[alsa_format->card][j]->
-              read(alsa_buffer,alsa_format->buffer_size*2/
-                   alsa_format->periods)/(2*sizeof(int16_t));
-            for(unsigned k=0;k<2;k++) {  // Stream Output Meters
-              stream_out_meter=0;
-              for(int l=0;l<n;l+=2) {
-                if(abs(((int16_t *)alsa_buffer)[l+k])>stream_out_meter) {
-                  stream_out_meter=abs(((int16_t *)alsa_buffer)[l+k]);
-                }
-              }
-              alsa_stream_output_meter[alsa_format->card][j][k]->
-                addValue(((double)stream_out_meter)/32768.0);
-            }
-            modulo=alsa_format->channels;
-            for(unsigned i=0;i<(alsa_format->channels/2);i++) {
-              if(alsa_output_volume[alsa_format->card][i][j]!=0.0) {
-                for(int k=0;k<n;k++) {
-                  ((int16_t *)alsa_format->card_buffer)[modulo*k+2*i]+=
-                    (int16_t)(alsa_output_volume[alsa_format->card][i][j]*
-                              (double)(((int16_t *)alsa_buffer)[2*k]));
-                  ((int16_t *)alsa_format->card_buffer)[modulo*k+2*i+1]+=
-                    (int16_t)(alsa_output_volume[alsa_format->card][i][j]*
-                              (double)(((int16_t *)alsa_buffer)[2*k+1]));
-                }
-              }
-            }
-            break;
-          }
-          alsa_output_pos[alsa_format->card][j]+=n;
-          if((n==0)&&alsa_eof[alsa_format->card][j]) {
-            alsa_stopping[alsa_format->card][j]=true;
           }
         }
-      }
-      n=alsa_format->buffer_size/(2*alsa_format->periods);
+        break;
 
-      //
-      // Process Passthroughs
-      //
-      for(unsigned i=0;i<alsa_format->capture_channels;i+=2) {
-        p=alsa_passthrough_ring[alsa_format->card][i/2]->
-          read(alsa_format->passthrough_buffer,4*n)/4;
-        bool zero_volume = true;
-        for (unsigned j=0;j<alsa_format->channels && zero_volume;j+=1) {
-          zero_volume = (alsa_passthrough_volume[alsa_format->card][i/2][j] == 0.0);
-        }
-        if (!zero_volume) {
-          for(unsigned j=0;j<alsa_format->channels;j+=2) {
-            double passthrough_volume = alsa_passthrough_volume[alsa_format->card][i/2][j/2];
-            if (passthrough_volume != 0.0) {
-              for(unsigned k=0;k<2;k++) {
-                for(int l=0;l<p;l++) {
-                  ((int16_t *)alsa_format->
-                   card_buffer)[alsa_format->channels*l+j+k]+=
-                    (int16_t)((double)((int16_t *)alsa_format->passthrough_buffer)[2*l+k]*passthrough_volume);
-                }
-              }
+      case 2:
+        n=alsa_play_ring[card][j]->
+          read(alsa_buffer,2*sizeof(int16_t)*(period-start))/
+          (2*sizeof(int16_t));
+        for(unsigned k=0;k<2;k++) {  // Stream Output Meters
+          stream_out_meter=0;
+          for(int l=0;l<n;l++) {
+            if(abs(((int16_t *)alsa_buffer)[2*l+k])>stream_out_meter) {
+              stream_out_meter=abs(((int16_t *)alsa_buffer)[2*l+k]);
             }
           }
+          alsa_stream_output_meter[card][j][k]->
+            addValue(((double)stream_out_meter)/32768.0);
         }
-      }
-
-      //
-      // Process Output Meters
-      //
-      for(unsigned i=0;i<alsa_format->channels;i+=2) {
-        unsigned port=i/2;
-        for(unsigned j=0;j<2;j++) {
-          out_meter[port][j]=0;
-          for(unsigned k=0;k<alsa_format->buffer_size;k++) {
-            int16_t sample = ((int16_t *)alsa_format->
-                              card_buffer)[alsa_format->channels*k+2*i+j];
-
-            if(sample> out_meter[i][j]) {
-              out_meter[i][j]= sample;
+        for(unsigned i=0;i<(chans/2);i++) {
+          if((vol=alsa_output_volume[card][i][j])!=0.0) {
+            for(int k=0;k<n;k++) {
+              bus[chans*(k+start)+2*i]+=
+                vol*env[k]*(float)((int16_t *)alsa_buffer)[2*k];
+              bus[chans*(k+start)+2*i+1]+=
+                vol*env[k]*(float)((int16_t *)alsa_buffer)[2*k+1];
             }
           }
-          alsa_output_meter[alsa_format->card][i][j]->
-            addValue(((double)out_meter[i][j])/32768.0);
         }
+        break;
       }
-      break;
+      alsa_output_pos[card][j]+=n;
+      if((n<(period-start))&&(!alsa_eof[card][j])) {
+        alsa_play_underruns[card]++;
+      }
+      if((n==0)&&alsa_eof[card][j]) {
+        alsa_stopping[card][j]=true;
+      }
+    }
 
-    case SND_PCM_FORMAT_S32_LE:
-      for(unsigned j=0;j<RD_MAX_STREAMS;j++) {
-        if(alsa_playing[alsa_format->card][j]) {
-          switch(alsa_output_channels[alsa_format->card][j]) {
-          case 1:
-            n=alsa_play_ring[alsa_format->card][j]->
-              read(alsa_buffer,alsa_format->buffer_size/
-                   alsa_format->periods)/(2*sizeof(int16_t));
-            stream_out_meter=0;
-            for(int k=0;k<n;k++) {  // Stream Output Meters
-              if(abs(((int16_t *)alsa_buffer)[k])>stream_out_meter) {
-                stream_out_meter=abs(((int16_t *)alsa_buffer)[k]);
-              }
-            }
-            alsa_stream_output_meter[alsa_format->card][j][0]->
-              addValue(((double)stream_out_meter)/32768.0);
-            alsa_stream_output_meter[alsa_format->card][j][1]->
-              addValue(((double)stream_out_meter)/32768.0);
-            modulo=alsa_format->channels*2;
-            for(unsigned i=0;i<(alsa_format->channels/2);i++) {
-              if(alsa_output_volume[alsa_format->card][i][j]!=0.0) {
-                for(int k=0;k<(2*n);k++) {
-                  ((int16_t *)alsa_format->card_buffer)[modulo*k+4*i+1]+=
-                    (int16_t)(alsa_output_volume[alsa_format->card][i][j]*
-                              (double)(((int16_t *)alsa_buffer)[k]));
-                  ((int16_t *)alsa_format->card_buffer)[modulo*k+4*i+3]+=
-                    (int16_t)(alsa_output_volume[alsa_format->card][i][j]*
-                              (double)(((int16_t *)alsa_buffer)[k]));
-                }
-              }
-            }
-            n*=2;
-            break;
-
-          case 2:
-            n=alsa_play_ring[alsa_format->card][j]->
-              read(alsa_buffer,alsa_format->buffer_size*2/
-                   alsa_format->periods)/(2*sizeof(int16_t));
-            for(unsigned k=0;k<2;k++) {  // Stream Output Meters
-              stream_out_meter=0;
-              for(int l=0;l<n;l+=2) {
-                if(abs(((int16_t *)alsa_buffer)[l+k])>stream_out_meter) {
-                  stream_out_meter=abs(((int16_t *)alsa_buffer)[l+k]);
-                }
+    //
+    // Process Passthroughs
+    //
+    for(unsigned i=0;i<alsa_format->capture_channels;i+=2) {
+      switch(alsa_format->format) {
+      case SND_PCM_FORMAT_S16_LE:
+        p=alsa_passthrough_ring[card][i/2]->
+          read(alsa_format->passthrough_buffer,4*period)/4;
+        break;
+
+      case SND_PCM_FORMAT_S32_LE:
+        p=alsa_passthrough_ring[card][i/2]->
+          read(alsa_format->passthrough_buffer,8*period)/8;
+        break;
+
+      default:
+        p=0;
+        break;
+      }
+      for(unsigned m=0;m<chans;m+=2) {
+        if((vol=alsa_passthrough_volume[card][i/2][m/2])!=0.0) {
+          for(unsigned k=0;k<2;k++) {
+            for(int l=0;l<p;l++) {
+              if(alsa_format->format==SND_PCM_FORMAT_S16_LE) {
+                bus[chans*l+m+k]+=vol*
+                  (float)((int16_t *)alsa_format->passthrough_buffer)[2*l+k];
               }
-              alsa_stream_output_meter[alsa_format->card][j][k]->
-                addValue(((double)stream_out_meter)/32768.0);
-            }
-            modulo=alsa_format->channels*2;
-            for(unsigned i=0;i<(alsa_format->channels/2);i++) {
-              if(alsa_output_volume[alsa_format->card][i][j]!=0.0) {
-                for(int k=0;k<n;k++) {
-                  ((int16_t *)alsa_format->card_buffer)[modulo*k+4*i+1]+=
-                    (int16_t)(alsa_output_volume[alsa_format->card][i][j]*
-                              (double)(((int16_t *)alsa_buffer)[2*k]));
-                  ((int16_t *)alsa_format->card_buffer)[modulo*k+4*i+3]+=
-                    (int16_t)(alsa_output_volume[alsa_format->card][i][j]*
-                              (double)(((int16_t *)alsa_buffer)[2*k+1]));
-                }
+              else {
+                bus[chans*l+m+k]+=vol*
+                  (float)((int32_t *)alsa_format->passthrough_buffer)[2*l+k]/
+                  65536.0;
               }
             }
-            break;
-          }
-          alsa_output_pos[alsa_format->card][j]+=n;
-          if((n==0)&&alsa_eof[alsa_format->card][j]) {
-            alsa_stopping[alsa_format->card][j]=true;
-            // Empty the ring buffer
-            while(alsa_play_ring[alsa_format->card][j]->
-                  read(alsa_buffer,alsa_format->buffer_size*2/
-                       alsa_format->periods)/(2*sizeof(int16_t))>0);
           }
         }
       }
-      n=alsa_format->buffer_size/(2*alsa_format->periods);
+    }
 
-      //
-      // Process Passthroughs
-      //
-      for(unsigned i=0;i<alsa_format->capture_channels;i+=2) {
-        p=alsa_passthrough_ring[alsa_format->card][i/2]->
-          read(alsa_format->passthrough_buffer,8*n)/8;
-        bool zero_volume = true;
-        for (unsigned j=0;j<alsa_format->channels && zero_volume;j+=1) {
-          zero_volume = (alsa_passthrough_volume[alsa_format->card][i/2][j] == 0.0);
-        }
-        if (!zero_volume) {
-          for(unsigned j=0;j<alsa_format->channels;j+=2) {
-            double passthrough_volume = alsa_passthrough_volume[alsa_format->card][i/2][j/2];
-            if (passthrough_volume != 0.0) {
-              for(unsigned k=0;k<2;k++) {
-                for(int l=0;l<p;l++) {
-                  ((int32_t *)alsa_format->
-                   card_buffer)[alsa_format->channels*l+j+k]+=
-                    (int32_t)((double)((int32_t *)alsa_format->passthrough_buffer)[2*l+k]*passthrough_volume);
-                }
-              }
-            }
+    //
+    // Process Output Meters
+    //
+    for(unsigned i=0;i<chans;i+=2) {
+      for(unsigned j=0;j<2;j++) {
+        out_meter=0.0;
+        for(int k=0;k<period;k++) {
+          if(fabsf(bus[chans*k+i+j])>out_meter) {
+            out_meter=fabsf(bus[chans*k+i+j]);
           }
         }
+        if(out_meter>32768.0) {
+          out_meter=32768.0;
+        }
+        alsa_output_meter[card][i/2][j]->addValue(out_meter/32768.0);
       }
+    }
 
-      //
-      // Process Output Meters
-      //
-      unsigned buffer_width;
-      buffer_width = (alsa_format->buffer_size*2/alsa_format->periods);
-      for(unsigned i=0;i<alsa_format->channels;i+=2) {
-        unsigned port=i/2;
-        for(unsigned j=0;j<2;j++) {
-          out_meter[port][j]=0;
-          for(unsigned k=0; k<buffer_width; k++) {
-            int16_t sample = ((int16_t *)alsa_format->
-                              card_buffer)[alsa_format->channels*2*k+2*i+1+2*j];
-            if (sample > out_meter[port][j]) {
-              out_meter[port][j] = sample;
-            }
-          }
-          alsa_output_meter[alsa_format->card][port][j]->
-            addValue(((double)out_meter[port][j])/32768.0);
-        }
+    //
+    // Convert the bus to the card format, saturating rather than wrapping
+    //
+    switch(alsa_format->format) {
+    case SND_PCM_FORMAT_S16_LE:
+      for(int k=0;k<(int)(period*chans);k++) {
+        ((int16_t *)alsa_format->card_buffer)[k]=AlsaSaturate(bus[k]);
+      }
+      break;
+
+    case SND_PCM_FORMAT_S32_LE:
+      for(int k=0;k<(int)(period*chans);k++) {
+        ((int32_t *)alsa_format->card_buffer)[k]=
+          65536*(int32_t)AlsaSaturate(bus[k]);
       }
       break;
 
     default:
+      memset(alsa_format->card_buffer,0,alsa_format->card_buffer_size);
       break;
     }
+    clock_gettime(CLOCK_MONOTONIC,&mix_end);
+    mix_nsecs=1000000000*(mix_end.tv_sec-mix_start.tv_sec)+
+      mix_end.tv_nsec-mix_start.tv_nsec;
+    alsa_mix_periods[card]++;
+    alsa_mix_nsecs[card]+=mix_nsecs;
+    if(mix_nsecs>alsa_mix_max_nsecs[card]) {
+      alsa_mix_max_nsecs[card]=mix_nsecs;
+    }
+
+    n=period;
+    if(alsa_format->null_device) {
+      if(alsa_format->null_output!=NULL) {
+        fwrite(alsa_format->card_buffer,2*chans,n,alsa_format->null_output);
+      }
+      AlsaNullWait(alsa_format,n);
+      continue;
+    }
     int s=snd_pcm_writei(alsa_format->pcm,alsa_format->card_buffer,n);
     if(s!=n) {
       if(s<0) {
@@ -549,6 +692,7 @@ void AlsaPlay2Callback(struct alsa_format *alsa_format)
                       alsa_format->card));
     }
   }
+  delete[] bus;
 }
 
 
@@ -596,9 +740,18 @@ void MainObject::AlsaInitCallback()
 	alsa_passthrough_volume[i][j][k]=0.0;
       }
     }
+    alsa_active_streams[i]=0;
+    alsa_mix_periods[i]=0;
+    alsa_mix_nsecs[i]=0;
+    alsa_mix_max_nsecs[i]=0;
+    alsa_play_underruns[i]=0;
+    alsa_play_min_fill[i]=RINGBUFFER_SIZE;
     for(int j=0;j<RD_MAX_STREAMS;j++) {
       alsa_play_ring[i][j]=NULL;
-      alsa_playing[i][j]=false;
+      AlsaSetPlaying(i,j,false);
+      alsa_transition_stream[i][j]=-1;
+      alsa_transition_achieved[i][j]=-1;
+      AlsaResetEnvelope(i,j);
       for(int k=0;k<2;k++) {
 	alsa_stream_output_meter[i][j][k]=new RDMeterAverage(avg_periods);
       }
@@ -679,6 +832,7 @@ void MainObject::alsaInit(RDStation *station)
     for(int j=0;j<RD_MAX_STREAMS;j++) {
       alsa_input_volume_db[i][j]=0;
       alsa_samples_recorded[i][j]=0;
+      alsa_record_frames[i][j]=0;
 #ifdef HAVE_MAD
       mad_mpeg[i][j]=new unsigned char[16384];
 #endif  // HAVE_MAD
@@ -788,10 +942,33 @@ void MainObject::alsaInit(RDStation *station)
       }
       card++;
       if(!pcm_opened) {
-	return;
+	break;
       }
     }
   }
+
+  //
+  // Null Devices
+  //
+  card=0;
+  for(int i=0;i<RD_MAX_CARDS;i++) {
+    if(card>=rd_config->nullAudioCards()) {
+      break;
+    }
+    if(cae_driver[i]==RDStation::None) {
+      if(AlsaStartNullDevice(i,card)) {
+	cae_driver[i]=RDStation::Alsa;
+	station->setCardDriver(i,RDStation::Alsa);
+	station->setCardName(i,QString().sprintf("Null Audio Device %d",card));
+	station->
+	  setCardInputs(i,
+			alsa_capture_format[i].channels/rd_config->channels());
+	station->
+	  setCardOutputs(i,alsa_play_format[i].channels/rd_config->channels());
+      }
+      card++;
+    }
+  }
 #endif  // ALSA
 }
 
@@ -803,6 +980,14 @@ void MainObject::alsaFree()
     if(cae_driver[i]==RDStation::Alsa) {
       alsa_play_format[i].exiting=true;
       pthread_join(alsa_play_format[i].thread,NULL);
+      if(alsa_play_format[i].null_device) {
+	alsa_capture_format[i].exiting=true;
+	pthread_join(alsa_capture_format[i].thread,NULL);
+	if(alsa_play_format[i].null_output!=NULL) {
+	  fclose(alsa_play_format[i].null_output);
+	}
+	continue;
+      }
       snd_pcm_close(alsa_play_format[i].pcm);
       if(alsa_capture_format[i].pcm!=NULL) {
 	printf("SHUTDOWN 1\n");
@@ -819,7 +1004,8 @@ void MainObject::alsaFree()
 }
 
 
-bool MainObject::alsaLoadPlayback(int card,QString wavename,int *stream)
+bool MainObject::alsaLoadPlayback(int card,QString wavename,bool chase,
+				  int *stream)
 {
 #ifdef ALSA
   if(alsa_play_format[card].exiting||((*stream=GetAlsaOutputStream(card))<0)) {
@@ -830,6 +1016,7 @@ bool MainObject::alsaLoadPlayback(int card,QString wavename,int *stream)
     return false;
   }
   alsa_play_wave[card][*stream]=new RDWaveFile(wavename);
+  alsa_play_wave[card][*stream]->setChaseMode(chase);
   if(!alsa_play_wave[card][*stream]->openWave()) {
     LogLine(RDConfig::LogErr,QString().sprintf(
             "Error: alsaLoadPlayback(%s)   openWave() failed to open file",
@@ -863,11 +1050,18 @@ bool MainObject::alsaLoadPlayback(int card,QString wavename,int *stream)
   }
   alsa_output_channels[card][*stream]=
     alsa_play_wave[card][*stream]->getChannels();
+  AlsaClearTransitions(card,*stream);
+  AlsaResetEnvelope(card,*stream);
   alsa_stopping[card][*stream]=false;
   alsa_offset[card][*stream]=0;
   alsa_output_pos[card][*stream]=0;
   alsa_eof[card][*stream]=false;
   alsa_play_ring[card][*stream]->reset();
+  if(alsa_play_wave[card][*stream]->isGrowing()) {
+    LogLine(RDConfig::LogDebug,QString().
+	    sprintf("alsaLoadPlayback(%s) chasing growing file, card: %d, stream: %d",
+		    (const char *)wavename,card,*stream));
+  }
   FillAlsaOutputStream(card,*stream);
   return true;
 #else
@@ -882,7 +1076,8 @@ bool MainObject::alsaUnloadPlayback(int card,int stream)
   if(alsa_play_ring[card][stream]==NULL) {
     return false;
   }
-  alsa_playing[card][stream]=false;
+  AlsaClearTransitions(card,stream);
+  AlsaSetPlaying(card,stream,false);
   switch(alsa_play_wave[card][stream]->getFormatTag()) {
   case WAVE_FORMAT_MPEG:
     FreeMadDecoder(card,stream);
@@ -932,6 +1127,7 @@ bool MainObject::alsaPlaybackPosition(int card,int stream,unsigned pos)
      (int)alsa_play_wave[card][stream]->getSampleLength()) {
     return false;
   }
+  AlsaClearTransitions(card,stream);
   alsa_output_pos[card][stream]=0;
   alsa_play_wave[card][stream]->seekWave(offset,SEEK_SET);
   alsa_eof[card][stream]=false;
@@ -940,8 +1136,10 @@ bool MainObject::alsaPlaybackPosition(int card,int stream,unsigned pos)
 
   if(alsa_playing[card][stream]) {
     alsa_stop_timer[card][stream]->stop();
-    alsa_stop_timer[card][stream]->
-      start(alsa_play_wave[card][stream]->getExtTimeLength()-pos,true);
+    if(!alsa_play_wave[card][stream]->isGrowing()) {
+      alsa_stop_timer[card][stream]->
+	start(alsa_play_wave[card][stream]->getExtTimeLength()-pos,true);
+    }
   }
   return true;
 #else
@@ -958,7 +1156,7 @@ bool MainObject::alsaPlay(int card,int stream,int length,int speed,bool pitch,
      alsa_playing[card][stream]||(speed!=RD_TIMESCALE_DIVISOR)) {
     return false;
   }
-  alsa_playing[card][stream]=true;
+  AlsaSetPlaying(card,stream,true);
   if(length>0) {
     alsa_stop_timer[card][stream]->start(length,true);
   }
@@ -986,7 +1184,8 @@ bool MainObject::alsaStopPlayback(int card,int stream)
   if((alsa_play_ring[card][stream]==NULL)||(!alsa_playing[card][stream])) {
     return false;
   }
-  alsa_playing[card][stream]=false;
+  AlsaClearTransitions(card,stream);
+  AlsaSetPlaying(card,stream,false);
   alsa_play_ring[card][stream]->reset();
   alsa_stop_timer[card][stream]->stop();
   statePlayUpdate(card,stream,2);
@@ -997,6 +1196,50 @@ bool MainObject::alsaStopPlayback(int card,int stream)
 }
 
 
+bool MainObject::alsaScheduleTransition(int card,int stream,unsigned frame,
+					int next_stream,int length,
+					int fade_in,int fade_out)
+{
+#ifdef ALSA
+  int rel_frame;
+
+  if((alsa_play_ring[card][stream]==NULL)||
+     (alsa_play_ring[card][next_stream]==NULL)||(stream==next_stream)||
+     alsa_playing[card][next_stream]) {
+    return false;
+  }
+  if((rel_frame=(int)frame-alsa_offset[card][stream])<0) {
+    return false;
+  }
+  AlsaClearTransitions(card,stream);
+  alsa_transition_length[card][next_stream]=length;
+  alsa_transition_fade_in[card][stream]=
+    (int)((double)fade_in*(double)alsa_play_format[card].sample_rate/1000.0);
+  alsa_transition_fade_out[card][stream]=
+    (int)((double)fade_out*(double)alsa_play_format[card].sample_rate/1000.0);
+  alsa_transition_frame[card][stream]=rel_frame;
+  alsa_transition_stream[card][stream]=next_stream;  // Arms the trigger
+  return true;
+#else
+  return false;
+#endif  // ALSA
+}
+
+
+bool MainObject::alsaCancelTransition(int card,int stream)
+{
+#ifdef ALSA
+  if(alsa_transition_stream[card][stream]<0) {
+    return false;
+  }
+  alsa_transition_stream[card][stream]=-1;
+  return true;
+#else
+  return false;
+#endif  // ALSA
+}
+
+
 bool MainObject::alsaLoadRecord(int card,int stream,int coding,int chans,
 			       int samprate,int bitrate,QString wavename)
 {
@@ -1075,6 +1318,10 @@ bool MainObject::alsaLoadRecord(int card,int stream,int coding,int chans,
   }
   alsa_record_wave[card][stream]->setBextChunk(true);
   alsa_record_wave[card][stream]->setLevlChunk(true);
+  alsa_record_wave[card][stream]->setChaseMode(true);
+  if(alsa_record_wave[card][stream]->getFormatTag()==WAVE_FORMAT_PCM) {
+    alsa_record_wave[card][stream]->setSha1Hashing(true);
+  }
   if(!alsa_record_wave[card][stream]->createWave()) {
     delete alsa_record_wave[card][stream];
     alsa_record_wave[card][stream]=NULL;
@@ -1092,7 +1339,8 @@ bool MainObject::alsaLoadRecord(int card,int stream,int coding,int chans,
 }
 
 
-bool MainObject::alsaUnloadRecord(int card,int stream,unsigned *len)
+bool MainObject::alsaUnloadRecord(int card,int stream,unsigned *len,
+				  QString *hash)
 {
 #ifdef ALSA
   alsa_recording[card][stream]=false;
@@ -1100,7 +1348,9 @@ bool MainObject::alsaUnloadRecord(int card,int stream,unsigned *len)
   EmptyAlsaInputStream(card,stream);
   *len=alsa_samples_recorded[card][stream];
   alsa_samples_recorded[card][stream]=0;
+  alsa_record_frames[card][stream]=0;
   alsa_record_wave[card][stream]->closeWave(*len);
+  *hash=alsa_record_wave[card][stream]->sha1Hash();
   delete alsa_record_wave[card][stream];
   alsa_record_wave[card][stream]=NULL;
   delete alsa_record_ring[card][stream];
@@ -1120,6 +1370,18 @@ bool MainObject::alsaRecord(int card,int stream,int length,int thres)
     return false;
   }
   alsa_recording[card][stream]=true;
+  alsa_record_frames[card][stream]=0;
+  if(length>0) {
+    //
+    // Capture exactly the requested length, so that the header written
+    // at close matches the one the SHA-1 hash was started with
+    //
+    alsa_record_frames[card][stream]=(unsigned)
+      ((double)length*(double)alsa_record_wave[card][stream]->
+       getSamplesPerSec()/1000.0);
+    alsa_record_wave[card][stream]->
+      setExpectedFrames(alsa_record_frames[card][stream]);
+  }
   if(alsa_input_vox[card][stream]==0.0) {
     if(length>0) {
       alsa_record_timer[card][stream]->start(length,true);
@@ -1711,6 +1973,93 @@ bool MainObject::AlsaStartPlayDevice(QString &dev,int card,snd_pcm_t *pcm)
 }
 
 
+bool MainObject::AlsaStartNullDevice(int card,int num)
+{
+  pthread_attr_t pthread_attr;
+  struct alsa_format *play=&alsa_play_format[card];
+  struct alsa_format *capture=&alsa_capture_format[card];
+  unsigned ports=rd_config->nullAudioPorts();
+  unsigned period=rd_config->nullAudioPeriodSize();
+  QString filename;
+
+  LogLine(RDConfig::LogInfo,QString().
+	  sprintf("Starting Null Audio Device %d:",num));
+  if(ports<1) {
+    ports=1;
+  }
+  if(ports>RD_MAX_PORTS) {
+    ports=RD_MAX_PORTS;
+  }
+  if((period<1)||(period>(RINGBUFFER_SIZE/4))) {
+    LogLine(RDConfig::LogErr,QString().
+	    sprintf("  Invalid period size %u,",period));
+    LogLine(RDConfig::LogErr,"  aborting initialization of device.");
+    return false;
+  }
+
+  //
+  // Both directions share one format; the callbacks mix one period
+  // per pass (buffer_size/(2*periods) frames).
+  //
+  memset(play,0,sizeof(struct alsa_format));
+  play->card=card;
+  play->pcm=NULL;
+  play->null_device=true;
+  play->null_speed=rd_config->nullAudioSpeed();
+  play->format=SND_PCM_FORMAT_S16_LE;
+  play->channels=rd_config->channels()*ports;
+  if((play->sample_rate=rd_config->nullAudioSampleRate())==0) {
+    play->sample_rate=system_sample_rate;
+  }
+  play->periods=1;
+  play->buffer_size=2*period;
+  play->card_buffer_size=play->buffer_size*play->channels*2;
+  play->card_buffer=new char[play->card_buffer_size];
+  play->passthrough_buffer=new char[play->card_buffer_size];
+  *capture=*play;
+  capture->card_buffer=new char[capture->card_buffer_size];
+  capture->passthrough_buffer=new char[capture->card_buffer_size];
+  play->capture_channels=capture->channels;
+  LogLine(RDConfig::LogDebug,QString().
+	  sprintf("  SampleRate = %u",play->sample_rate));
+  LogLine(RDConfig::LogDebug,QString().
+	  sprintf("  Aggregate Channels = %u",play->channels));
+  LogLine(RDConfig::LogDebug,QString().sprintf("  PeriodSize = %u frames",period));
+  LogLine(RDConfig::LogDebug,QString().
+	  sprintf("  Speed = %5.2lf",play->null_speed));
+
+  //
+  // Output File
+  //
+  if(!rd_config->nullAudioOutputDirectory().isEmpty()) {
+    filename=rd_config->nullAudioOutputDirectory()+
+      QString().sprintf("/rdnull%d.raw",num);
+    if((play->null_output=fopen((const char *)filename,"w"))==NULL) {
+      LogLine(RDConfig::LogWarning,QString().
+	      sprintf("  unable to open \"%s\" [%s], output will be discarded",
+		      (const char *)filename,strerror(errno)));
+    }
+    else {
+      LogLine(RDConfig::LogDebug,QString().
+	      sprintf("  Output File = %s",(const char *)filename));
+    }
+  }
+  LogLine(RDConfig::LogNotice,"  Device started successfully");
+
+  //
+  // Start the Callbacks
+  //
+  clock_gettime(CLOCK_MONOTONIC,&play->null_clock);
+  capture->null_clock=play->null_clock;
+  pthread_attr_init(&pthread_attr);
+  play->exiting=false;
+  pthread_create(&play->thread,&pthread_attr,AlsaPlayCallback,play);
+  capture->exiting=false;
+  pthread_create(&capture->thread,&pthread_attr,AlsaCaptureCallback,capture);
+  return true;
+}
+
+
 int MainObject::GetAlsaOutputStream(int card)
 {
   for(int i=0;i<RD_MAX_STREAMS;i++) {
@@ -1747,6 +2096,16 @@ void MainObject::WriteAlsaBuffer(int card,int stream,int16_t *buffer,unsigned le
   unsigned n;
 
   frames=len/(2*alsa_record_wave[card][stream]->getChannels());
+  if((alsa_record_frames[card][stream]>0)&&
+     ((alsa_samples_recorded[card][stream]+frames)>
+      alsa_record_frames[card][stream])) {
+    frames=alsa_record_frames[card][stream]-
+      alsa_samples_recorded[card][stream];
+    len=frames*2*alsa_record_wave[card][stream]->getChannels();
+    if(frames==0) {
+      return;
+    }
+  }
   alsa_samples_recorded[card][stream]+=frames;
   switch(alsa_record_wave[card][stream]->getFormatTag()) {
   case WAVE_FORMAT_PCM:
@@ -1812,7 +2171,7 @@ void MainObject::FillAlsaOutputStream(int card,int stream)
       free=(int)((double)free/ratio)/(2*alsa_output_channels[card][stream])*
 	      (2*alsa_output_channels[card][stream]);
       n=alsa_play_wave[card][stream]->readWave(alsa_wave_buffer,free);
-      if(n!=free) {
+      if((n!=free)&&(!alsa_play_wave[card][stream]->isGrowing())) {
 	alsa_eof[card][stream]=true;
 	alsa_stop_timer[card][stream]->stop();
       }
@@ -1822,7 +2181,7 @@ void MainObject::FillAlsaOutputStream(int card,int stream)
       free=(int)((double)free/ratio)/(2*alsa_output_channels[card][stream])*
 	      (2*alsa_output_channels[card][stream]);
       n=2*alsa_play_wave[card][stream]->readWave(alsa_wave24_buffer,3*free/2)/3;
-      if(n!=free) {
+      if((n!=free)&&(!alsa_play_wave[card][stream]->isGrowing())) {
 	alsa_eof[card][stream]=true;
 	alsa_stop_timer[card][stream]->stop();
 	break;
@@ -1862,7 +2221,13 @@ void MainObject::FillAlsaOutputStream(int card,int stream)
 			 mad_synth[card][stream].pcm.channels);
 	}
       }
-      else {  // End-of-file, read out last samples
+      else {
+	if(alsa_play_wave[card][stream]->isGrowing()) {
+	  // Wait for the writer to commit the rest of the frame
+	  alsa_play_wave[card][stream]->seekWave(-m,SEEK_CUR);
+	  break;
+	}
+	// End-of-file, read out last samples
 	if(!alsa_eof[card][stream]) {
 	  memset(mad_mpeg[card][stream]+mad_left_over[card][stream],0,
 		 MAD_BUFFER_GUARD);
@@ -1905,13 +2270,54 @@ void MainObject::FillAlsaOutputStream(int card,int stream)
 void MainObject::AlsaClock()
 {
 #ifdef ALSA
+  unsigned period;
+
   for(int i=0;i<RD_MAX_CARDS;i++) {
     if(cae_driver[i]==RDStation::Alsa) {
+      //
+      // Report mix timing about once a minute
+      //
+      if((alsa_play_format[i].periods>0)&&
+	 (alsa_play_format[i].sample_rate>0)&&
+	 ((period=alsa_play_format[i].buffer_size/
+	   (2*alsa_play_format[i].periods))>0)) {
+	if(alsa_mix_periods[i]>=60*alsa_play_format[i].sample_rate/period) {
+	  LogLine(alsa_play_format[i].null_device?RDConfig::LogInfo:
+		  RDConfig::LogDebug,QString().
+		  sprintf("ALSA mix - Card: %d  Periods: %u  Avg: %u uS  Max: %u uS  Budget: %u uS  Underruns: %u  Min Fill: %u%%  Late: %u",
+			  i,alsa_mix_periods[i],
+			  (unsigned)(alsa_mix_nsecs[i]/alsa_mix_periods[i]/1000),
+			  alsa_mix_max_nsecs[i]/1000,
+			  (unsigned)(1000000.0*period/
+				     alsa_play_format[i].sample_rate),
+			  alsa_play_underruns[i],
+			  (unsigned)(100*(uint64_t)alsa_play_min_fill[i]/
+				     RINGBUFFER_SIZE),
+			  alsa_play_format[i].null_late));
+	  alsa_mix_periods[i]=0;
+	  alsa_mix_nsecs[i]=0;
+	  alsa_mix_max_nsecs[i]=0;
+	  alsa_play_underruns[i]=0;
+	  alsa_play_min_fill[i]=RINGBUFFER_SIZE;
+	  alsa_play_format[i].null_late=0;
+	}
+      }
       for(int j=0;j<RD_MAX_STREAMS;j++) {
+	if(alsa_transition_achieved[i][j]>=0) {
+	  int from=alsa_transition_from[i][j];
+	  unsigned frame=alsa_transition_achieved[i][j]+alsa_offset[i][from];
+	  alsa_transition_achieved[i][j]=-1;
+	  play_length[i][j]=alsa_transition_length[i][j];
+	  if(play_length[i][j]>0) {
+	    alsa_stop_timer[i][j]->start(play_length[i][j],true);
+	  }
+	  statePlayUpdate(i,j,1);
+	  stateTransitionUpdate(i,from,j,frame);
+	}
 	if(alsa_stopping[i][j]) {
 	  alsa_stopping[i][j]=false;
 	  alsa_eof[i][j]=false;
-	  alsa_playing[i][j]=false;
+	  AlsaSetPlaying(i,j,false);
 	  printf("stop card: %d  stream: %d\n",i,j);
 	  statePlayUpdate(i,j,2);
 	}
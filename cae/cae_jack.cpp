@@ -600,6 +600,7 @@ void MainObject::jackInit(RDStation *station)
       jack_output_volume_db[j][i]=0; 
       jack_samples_recorded[i]=0;
     }
+    jack_record_frames[i]=0;
     jack_st_conv[i]=NULL;
   }
   for(int i=0;i<RD_MAX_PORTS;i++) {
@@ -714,7 +715,8 @@ void MainObject::jackFree()
 }
 
 
-bool MainObject::jackLoadPlayback(int card,QString wavename,int *stream)
+bool MainObject::jackLoadPlayback(int card,QString wavename,bool chase,
+				  int *stream)
 {
 #ifdef JACK
   if((*stream=GetJackOutputStream())<0) {
@@ -725,6 +727,7 @@ bool MainObject::jackLoadPlayback(int card,QString wavename,int *stream)
     return false;
   }
   jack_play_wave[*stream]=new RDWaveFile(wavename);
+  jack_play_wave[*stream]->setChaseMode(chase);
   if(!jack_play_wave[*stream]->openWave()) {
     LogLine(RDConfig::LogNotice,QString().sprintf(
             "Error: jackLoadPlayback(%s)   openWave() failed to open file",
@@ -837,8 +840,10 @@ bool MainObject::jackPlaybackPosition(int card,int stream,unsigned pos)
 
   if(jack_playing[stream]) {
     jack_stop_timer[stream]->stop();
-    jack_stop_timer[stream]->
-      start(jack_play_wave[stream]->getExtTimeLength()-pos,true);
+    if(!jack_play_wave[stream]->isGrowing()) {
+      jack_stop_timer[stream]->
+	start(jack_play_wave[stream]->getExtTimeLength()-pos,true);
+    }
   }
   return true;
 #else
@@ -978,6 +983,10 @@ bool MainObject::jackLoadRecord(int card,int stream,int coding,int chans,
   }
   jack_record_wave[stream]->setBextChunk(true);
   jack_record_wave[stream]->setLevlChunk(true);
+  jack_record_wave[stream]->setChaseMode(true);
+  if(jack_record_wave[stream]->getFormatTag()==WAVE_FORMAT_PCM) {
+    jack_record_wave[stream]->setSha1Hashing(true);
+  }
   if(!jack_record_wave[stream]->createWave()) {
     delete jack_record_wave[stream];
     jack_record_wave[stream]=NULL;
@@ -1019,7 +1028,8 @@ bool MainObject::jackLoadRecord(int card,int stream,int coding,int chans,
 }
 
 
-bool MainObject::jackUnloadRecord(int card,int stream,unsigned *len)
+bool MainObject::jackUnloadRecord(int card,int stream,unsigned *len,
+				  QString *hash)
 {
 #ifdef JACK
   if ((stream <0) || (stream >= RD_MAX_PORTS)){
@@ -1030,7 +1040,9 @@ bool MainObject::jackUnloadRecord(int card,int stream,unsigned *len)
   EmptyJackInputStream(stream,true);
   *len=jack_samples_recorded[stream];
   jack_samples_recorded[stream]=0;
+  jack_record_frames[stream]=0;
   jack_record_wave[stream]->closeWave(*len);
+  *hash=jack_record_wave[stream]->sha1Hash();
   delete jack_record_wave[stream];
   jack_record_wave[stream]=NULL;
   delete jack_record_ring[stream];
@@ -1053,6 +1065,17 @@ bool MainObject::jackRecord(int card,int stream,int length,int thres)
     return false;
   }
   jack_recording[stream]=true;
+  jack_record_frames[stream]=0;
+  if(length>0) {
+    //
+    // Capture exactly the requested length, so that the header written
+    // at close matches the one the SHA-1 hash was started with
+    //
+    jack_record_frames[stream]=(unsigned)
+      ((double)length*(double)jack_record_wave[stream]->getSamplesPerSec()/
+       1000.0);
+    jack_record_wave[stream]->setExpectedFrames(jack_record_frames[stream]);
+  }
   if(jack_input_vox[stream]==0.0) {
     if(length>0) {
       jack_record_timer[stream]->start(length,true);
@@ -1428,6 +1451,15 @@ void MainObject::WriteJackBuffer(int stream,jack_default_audio_sample_t *buffer,
 
   frames=len/(sizeof(jack_default_audio_sample_t)*
 	      jack_record_wave[stream]->getChannels());
+  if((jack_record_frames[stream]>0)&&
+     ((jack_samples_recorded[stream]+frames)>jack_record_frames[stream])) {
+    frames=jack_record_frames[stream]-jack_samples_recorded[stream];
+    len=frames*sizeof(jack_default_audio_sample_t)*
+      jack_record_wave[stream]->getChannels();
+    if((frames==0)&&(!done)) {
+      return;
+    }
+  }
   jack_samples_recorded[stream]+=frames;
   switch(jack_record_wave[stream]->getFormatTag()) {
   case WAVE_FORMAT_PCM:
@@ -1507,7 +1539,8 @@ void MainObject::FillJackOutputStream(int stream)
       free=(int)free/jack_output_channels[stream]*jack_output_channels[stream];
       n=jack_play_wave[stream]->readWave(jack_wave_buffer,sizeof(short)*free)/
 	sizeof(short);
-      if((n!=free)&&(jack_st_conv[stream]==NULL)) {
+      if((n!=free)&&(jack_st_conv[stream]==NULL)&&
+	 (!jack_play_wave[stream]->isGrowing())) {
 	jack_eof[stream]=true;
 	jack_stop_timer[stream]->stop();
       }
@@ -1517,7 +1550,8 @@ void MainObject::FillJackOutputStream(int stream)
     case 24:  // PMC24
       free=(int)free/jack_output_channels[stream]*jack_output_channels[stream];
       n=jack_play_wave[stream]->readWave(jack_wave24_buffer,3*free)/3;
-      if((n!=free)&&(jack_st_conv[stream]==NULL)) {
+      if((n!=free)&&(jack_st_conv[stream]==NULL)&&
+	 (!jack_play_wave[stream]->isGrowing())) {
 	jack_eof[stream]=true;
 	jack_stop_timer[stream]->stop();
       }
@@ -1573,7 +1607,13 @@ void MainObject::FillJackOutputStream(int stream)
 			 mad_synth[jack_card][stream].pcm.channels);
 	}
       }
-      else {  // End-of-file, read out last samples
+      else {
+	if(jack_play_wave[stream]->isGrowing()) {
+	  // Wait for the writer to commit the rest of the frame
+	  jack_play_wave[stream]->seekWave(-m,SEEK_CUR);
+	  break;
+	}
+	// End-of-file, read out last samples
 	memset(mad_mpeg[jack_card][stream]+mad_left_over[jack_card][stream],0,
 	       MAD_BUFFER_GUARD);
 	mad_stream_buffer(&mad_stream[jack_card][stream],
@@ -24,7 +24,7 @@
 /*
  * Current Database Version
  */
-#define RD_VERSION_DATABASE 287
+#define RD_VERSION_DATABASE 290
 
 
 #endif  // DBVERSION_H
@@ -57,6 +57,7 @@ SOURCES += rdconf.cpp
 SOURCES += rdconfig.cpp
 SOURCES += rdcreate_log.cpp
 SOURCES += rdcut.cpp
+SOURCES += rdcutrotation.cpp
 SOURCES += rddatedialog.cpp
 SOURCES += rddatedecode.cpp
 SOURCES += rddatepicker.cpp
@@ -91,6 +92,7 @@ SOURCES += rdlog_event.cpp
 SOURCES += rdlog_line.cpp
 SOURCES += rdlogedit_conf.cpp
 SOURCES += rdlogfilter.cpp
+SOURCES += rdloglinebuffer.cpp
 SOURCES += rdloglock.cpp
 SOURCES += rdmacro.cpp
 SOURCES += rdmacro_event.cpp
@@ -202,6 +204,7 @@ HEADERS += rdconf.h
 HEADERS += rdconfig.h
 HEADERS += rdcreate_log.h
 HEADERS += rdcut.h
+HEADERS += rdcutrotation.h
 HEADERS += rddatedecode.h
 HEADERS += rddatedialog.h
 HEADERS += rddatepicker.h
@@ -237,6 +240,7 @@ HEADERS += rdlog_event.h
 HEADERS += rdlog_line.h
 HEADERS += rdlogedit_conf.h
 HEADERS += rdlogfilter.h
+HEADERS += rdloglinebuffer.h
 HEADERS += rdloglock.h
 HEADERS += rdmacro.h
 HEADERS += rdmacro_event.h
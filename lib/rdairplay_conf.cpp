@@ -55,6 +55,39 @@ RDAirPlayConf::RDAirPlayConf(const QString &station,const QString &tablename)
   }
   air_id=q->value(0).toUInt();
   delete q;
+  air_snapshot=
+    new RDRowSnapshot(air_tablename,QString().sprintf("ID=%u",air_id));
+  air_channels_snapshot=
+    new RDRowSnapshot(air_tablename+"_CHANNELS",
+		      "STATION_NAME=\""+RDEscapeString(air_station)+"\"",
+		      "INSTANCE");
+}
+
+
+RDAirPlayConf::~RDAirPlayConf()
+{
+  delete air_snapshot;
+  delete air_channels_snapshot;
+}
+
+
+bool RDAirPlayConf::snapshotEnabled() const
+{
+  return air_snapshot->isEnabled();
+}
+
+
+void RDAirPlayConf::setSnapshotEnabled(bool state)
+{
+  air_snapshot->setEnabled(state);
+  air_channels_snapshot->setEnabled(state);
+}
+
+
+void RDAirPlayConf::reload()
+{
+  air_snapshot->reload();
+  air_channels_snapshot->reload();
 }
 
 
@@ -332,7 +365,7 @@ void RDAirPlayConf::setStopGpoLine(RDAirPlayConf::Channel chan,int line) const
 
 int RDAirPlayConf::segueLength() const
 {
-  return RDGetSqlValue(air_tablename,"ID",air_id,"SEGUE_LENGTH").toInt();
+  return air_snapshot->value("SEGUE_LENGTH").toInt();
 }
 
 
@@ -344,7 +377,7 @@ void RDAirPlayConf::setSegueLength(int len) const
 
 int RDAirPlayConf::transLength() const
 {
-  return RDGetSqlValue(air_tablename,"ID",air_id,"TRANS_LENGTH").toInt();
+  return air_snapshot->value("TRANS_LENGTH").toInt();
 }
 
 
@@ -357,7 +390,7 @@ void RDAirPlayConf::setTransLength(int len) const
 RDAirPlayConf::OpModeStyle RDAirPlayConf::opModeStyle() const
 {
   return (RDAirPlayConf::OpModeStyle)
-    RDGetSqlValue(air_tablename,"ID",air_id,"LOG_MODE_STYLE").toInt();
+    air_snapshot->value("LOG_MODE_STYLE").toInt();
 }
 
 
@@ -393,7 +426,7 @@ void RDAirPlayConf::setLogStartMode(int mach,RDAirPlayConf::OpMode mode) const
 
 int RDAirPlayConf::pieCountLength() const
 {
-  return RDGetSqlValue(air_tablename,"ID",air_id,"PIE_COUNT_LENGTH").toInt();
+  return air_snapshot->value("PIE_COUNT_LENGTH").toInt();
 }
 
 
@@ -406,7 +439,7 @@ void RDAirPlayConf::setPieCountLength(int len) const
 RDAirPlayConf::PieEndPoint RDAirPlayConf::pieEndPoint() const
 {
   return (RDAirPlayConf::PieEndPoint)
-    RDGetSqlValue(air_tablename,"ID",air_id,"PIE_COUNT_ENDPOINT").toInt();
+    air_snapshot->value("PIE_COUNT_ENDPOINT").toInt();
 }
 
 
@@ -418,8 +451,7 @@ void RDAirPlayConf::setPieEndPoint(RDAirPlayConf::PieEndPoint point) const
 
 bool RDAirPlayConf::checkTimesync() const
 {
-  return RDBool(RDGetSqlValue(air_tablename,"ID",air_id,
-			    "CHECK_TIMESYNC").toString());
+  return RDBool(air_snapshot->value("CHECK_TIMESYNC").toString());
 }
 
 
@@ -433,10 +465,10 @@ int RDAirPlayConf::panels(RDAirPlayConf::PanelType type) const
 {
   switch(type) {
       case RDAirPlayConf::StationPanel:
-	return RDGetSqlValue(air_tablename,"ID",air_id,"STATION_PANELS").toInt();
+	return air_snapshot->value("STATION_PANELS").toInt();
 
       case RDAirPlayConf::UserPanel:
-	return RDGetSqlValue(air_tablename,"ID",air_id,"USER_PANELS").toInt();
+	return air_snapshot->value("USER_PANELS").toInt();
   }
   return 0;
 }
@@ -458,8 +490,8 @@ void RDAirPlayConf::setPanels(RDAirPlayConf::PanelType type,int quan) const
 
 bool RDAirPlayConf::showAuxButton(int auxbutton) const
 {
-  return RDBool(RDGetSqlValue(air_tablename,"ID",
-	    air_id,QString().sprintf("SHOW_AUX_%d",auxbutton+1)).toString());
+  return RDBool(air_snapshot->
+		value(QString().sprintf("SHOW_AUX_%d",auxbutton+1)).toString());
 }
 
 
@@ -472,7 +504,7 @@ void RDAirPlayConf::setShowAuxButton(int auxbutton,bool state) const
 bool RDAirPlayConf::clearFilter() const
 {
   return 
-    RDBool(RDGetSqlValue(air_tablename,"ID",air_id,"CLEAR_FILTER").toString());
+    RDBool(air_snapshot->value("CLEAR_FILTER").toString());
 }
 
 
@@ -485,7 +517,7 @@ void RDAirPlayConf::setClearFilter(bool state) const
 RDLogLine::TransType RDAirPlayConf::defaultTransType() const
 {
   return (RDLogLine::TransType)
-    RDGetSqlValue(air_tablename,"ID",air_id,"DEFAULT_TRANS_TYPE").toInt();
+    air_snapshot->value("DEFAULT_TRANS_TYPE").toInt();
 }
 
 
@@ -498,7 +530,7 @@ void RDAirPlayConf::setDefaultTransType(RDLogLine::TransType type) const
 RDAirPlayConf::BarAction RDAirPlayConf::barAction() const
 {
   return (RDAirPlayConf::BarAction)
-    RDGetSqlValue(air_tablename,"ID",air_id,"BAR_ACTION").toUInt();
+    air_snapshot->value("BAR_ACTION").toUInt();
 }
 
 
@@ -511,7 +543,7 @@ void RDAirPlayConf::setBarAction(RDAirPlayConf::BarAction action) const
 bool RDAirPlayConf::flashPanel() const
 {
   return 
-    RDBool(RDGetSqlValue(air_tablename,"ID",air_id,"FLASH_PANEL").toString());
+    RDBool(air_snapshot->value("FLASH_PANEL").toString());
 }
 
 
@@ -523,7 +555,7 @@ void RDAirPlayConf::setFlashPanel(bool state) const
 
 bool RDAirPlayConf::panelPauseEnabled() const
 {
-  return RDBool(RDGetSqlValue(air_tablename,"ID",air_id,"PANEL_PAUSE_ENABLED").
+  return RDBool(air_snapshot->value("PANEL_PAUSE_ENABLED").
 	       toString());
 }
 
@@ -536,7 +568,7 @@ void RDAirPlayConf::setPanelPauseEnabled(bool state) const
 
 QString RDAirPlayConf::buttonLabelTemplate() const
 {
-  return RDGetSqlValue(air_tablename,"ID",air_id,"BUTTON_LABEL_TEMPLATE").
+  return air_snapshot->value("BUTTON_LABEL_TEMPLATE").
     toString();
 }
 
@@ -550,7 +582,7 @@ void RDAirPlayConf::setButtonLabelTemplate(const QString &str) const
 bool RDAirPlayConf::pauseEnabled() const
 {
   return 
-    RDBool(RDGetSqlValue(air_tablename,"ID",air_id,"PAUSE_ENABLED").toString());
+    RDBool(air_snapshot->value("PAUSE_ENABLED").toString());
 }
 
 
@@ -562,7 +594,7 @@ void RDAirPlayConf::setPauseEnabled(bool state) const
 
 QString RDAirPlayConf::defaultSvc() const
 {
-  return RDGetSqlValue(air_tablename,"ID",air_id,"DEFAULT_SERVICE").toString();
+  return air_snapshot->value("DEFAULT_SERVICE").toString();
 }
 
 
@@ -575,7 +607,7 @@ void RDAirPlayConf::setDefaultSvc(const QString &svcname) const
 bool RDAirPlayConf::hourSelectorEnabled() const
 {
   return 
-    RDBool(RDGetSqlValue(air_tablename,"ID",air_id,"HOUR_SELECTOR_ENABLED").
+    RDBool(air_snapshot->value("HOUR_SELECTOR_ENABLED").
 	   toString());
 }
 
@@ -588,7 +620,7 @@ void RDAirPlayConf::setHourSelectorEnabled(bool state) const
 
 QString RDAirPlayConf::titleTemplate() const
 {
-  return RDGetSqlValue(air_tablename,"ID",air_id,"TITLE_TEMPLATE").
+  return air_snapshot->value("TITLE_TEMPLATE").
     toString();
 }
 
@@ -601,7 +633,7 @@ void RDAirPlayConf::setTitleTemplate(const QString &str)
 
 QString RDAirPlayConf::artistTemplate() const
 {
-  return RDGetSqlValue(air_tablename,"ID",air_id,"ARTIST_TEMPLATE").
+  return air_snapshot->value("ARTIST_TEMPLATE").
     toString();
 }
 
@@ -614,7 +646,7 @@ void RDAirPlayConf::setArtistTemplate(const QString &str)
 
 QString RDAirPlayConf::outcueTemplate() const
 {
-  return RDGetSqlValue(air_tablename,"ID",air_id,"OUTCUE_TEMPLATE").
+  return air_snapshot->value("OUTCUE_TEMPLATE").
     toString();
 }
 
@@ -627,7 +659,7 @@ void RDAirPlayConf::setOutcueTemplate(const QString &str)
 
 QString RDAirPlayConf::descriptionTemplate() const
 {
-  return RDGetSqlValue(air_tablename,"ID",air_id,"DESCRIPTION_TEMPLATE").
+  return air_snapshot->value("DESCRIPTION_TEMPLATE").
     toString();
 }
 
@@ -749,7 +781,7 @@ void RDAirPlayConf::setLogRml(int logno,const QString &str) const
 RDAirPlayConf::ExitCode RDAirPlayConf::exitCode() const
 {
   return (RDAirPlayConf::ExitCode)
-    RDGetSqlValue(air_tablename,"ID",air_id,"EXIT_CODE").toInt();
+    air_snapshot->value("EXIT_CODE").toInt();
 }
 
 
@@ -762,7 +794,7 @@ void RDAirPlayConf::setExitCode(RDAirPlayConf::ExitCode code) const
 RDAirPlayConf::ExitCode RDAirPlayConf::virtualExitCode() const
 {
   return (RDAirPlayConf::ExitCode)
-    RDGetSqlValue(air_tablename,"ID",air_id,"VIRTUAL_EXIT_CODE").toInt();
+    air_snapshot->value("VIRTUAL_EXIT_CODE").toInt();
 }
 
 
@@ -808,7 +840,7 @@ void RDAirPlayConf::setExitPassword(const QString &passwd) const
 
 QString RDAirPlayConf::skinPath() const
 {
-  return RDGetSqlValue(air_tablename,"ID",air_id,"SKIN_PATH").toString();
+  return air_snapshot->value("SKIN_PATH").toString();
 }
 
 
@@ -820,7 +852,7 @@ void RDAirPlayConf::setSkinPath(const QString &path) const
 
 bool RDAirPlayConf::showCounters() const
 {
-  return RDBool(RDGetSqlValue(air_tablename,"ID",air_id,"SHOW_COUNTERS").
+  return RDBool(air_snapshot->value("SHOW_COUNTERS").
 		toString());
 }
 
@@ -833,7 +865,7 @@ void RDAirPlayConf::setShowCounters(bool state) const
 
 int RDAirPlayConf::auditionPreroll() const
 {
-  return RDGetSqlValue(air_tablename,"ID",air_id,"AUDITION_PREROLL").toInt();
+  return air_snapshot->value("AUDITION_PREROLL").toInt();
 }
 
 
@@ -1167,20 +1199,7 @@ QString RDAirPlayConf::logModeText(RDAirPlayConf::OpMode mode)
 
 QVariant RDAirPlayConf::GetChannelValue(const QString &param,RDAirPlayConf::Channel chan) const
 {
-  RDSqlQuery *q;
-  QString sql;
-  QVariant ret;
-
-  sql=QString("select ")+param+" from "+air_tablename+"_CHANNELS where "+
-    "(STATION_NAME=\""+RDEscapeString(air_station)+"\")&&"+
-    QString().sprintf("(INSTANCE=%u)",chan);
-  q=new RDSqlQuery(sql);
-  if(q->first()) {
-    ret=q->value(0);
-  }
-  delete q;
-
-  return ret;
+  return air_channels_snapshot->value(param,chan);
 }
 
 
@@ -1195,6 +1214,7 @@ void RDAirPlayConf::SetChannelValue(const QString &param,RDAirPlayConf::Channel
     QString().sprintf("(INSTANCE=%d)",chan);
   q=new RDSqlQuery(sql);
   delete q;
+  air_channels_snapshot->setValue(param,value,chan);
 }
 
 
@@ -1209,6 +1229,7 @@ void RDAirPlayConf::SetChannelValue(const QString &param,RDAirPlayConf::Channel
     QString().sprintf("(INSTANCE=%d)",chan);
   q=new RDSqlQuery(sql);
   delete q;
+  air_channels_snapshot->setValue(param,value,chan);
 }
 
 
@@ -1257,6 +1278,7 @@ void RDAirPlayConf::SetRow(const QString &param,int value) const
 	    (const char *)RDEscapeString(air_station));
   q=new RDSqlQuery(sql);
   delete q;
+  air_snapshot->setValue(param,value);
 }
 
 
@@ -1273,6 +1295,7 @@ void RDAirPlayConf::SetRow(const QString &param,unsigned value) const
 	    (const char *)RDEscapeString(air_station));
   q=new RDSqlQuery(sql);
   delete q;
+  air_snapshot->setValue(param,value);
 }
 
 
@@ -1289,4 +1312,5 @@ void RDAirPlayConf::SetRow(const QString &param,const QString &value) const
 	    (const char *)RDEscapeString(air_station));
   q=new RDSqlQuery(sql);
   delete q;
+  air_snapshot->setValue(param,value);
 }
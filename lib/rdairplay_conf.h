@@ -47,6 +47,10 @@ class RDAirPlayConf
 		SoundPanel4Channel=8,SoundPanel5Channel=9,LastChannel=10};
   enum GpioType {EdgeGpio=0,LevelGpio=1};
   RDAirPlayConf(const QString &station,const QString &tablename);
+  ~RDAirPlayConf();
+  bool snapshotEnabled() const;
+  void setSnapshotEnabled(bool state);
+  void reload();
   QString station() const;
   int card(Channel chan) const;
   void setCard(Channel chan,int card) const;
@@ -184,6 +188,8 @@ class RDAirPlayConf
   QString air_station;
   unsigned air_id;
   QString air_tablename;
+  RDRowSnapshot *air_snapshot;
+  RDRowSnapshot *air_channels_snapshot;
 };
 
 
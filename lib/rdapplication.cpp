@@ -42,9 +42,11 @@ RDApplication::RDApplication(const QString &module_name,const QString &cmdname,
   app_cae=NULL;
   app_cmd_switch=NULL;
   app_config=NULL;
+  app_cut_rotation=NULL;
   app_library_conf=NULL;
   app_logedit_conf=NULL;
   app_panel_conf=NULL;
+  app_peaks_cache=NULL;
   app_ripc=NULL;
   app_station=NULL;
   app_system=NULL;
@@ -57,6 +59,9 @@ RDApplication::~RDApplication()
   if(app_heartbeat!=NULL) {
     delete app_heartbeat;
   }
+  if(app_cut_rotation!=NULL) {
+    delete app_cut_rotation;
+  }
   if(app_config!=NULL) {
     delete app_config;
   }
@@ -78,6 +83,9 @@ RDApplication::~RDApplication()
   if(app_panel_conf!=NULL) {
     delete app_panel_conf;
   }
+  if(app_peaks_cache!=NULL) {
+    delete app_peaks_cache;
+  }
   if(app_user!=NULL) {
     delete app_user;
   }
@@ -148,6 +156,17 @@ bool RDApplication::open(QString *err_msg)
   app_cae=new RDCae(app_station,app_config,this);
   app_ripc=new RDRipc(app_station,app_config,this);
   connect(app_ripc,SIGNAL(userChanged()),this,SLOT(userChangedData()));
+  connect(app_ripc,SIGNAL(notificationReceived(RDNotification *)),
+	  this,SLOT(notificationReceivedData(RDNotification *)));
+
+  //
+  // Serve station configuration from row snapshots, refreshed when
+  // RDAdmin sends a STATION notification for this host
+  //
+  app_station->setSnapshotEnabled(true);
+  app_library_conf->setSnapshotEnabled(true);
+  app_airplay_conf->setSnapshotEnabled(true);
+  app_panel_conf->setSnapshotEnabled(true);
 
   return true; 
 }
@@ -177,6 +196,24 @@ RDConfig *RDApplication::config()
 }
 
 
+RDCutRotation *RDApplication::cutRotation()
+{
+  //
+  // Created on first use; modules on the play path enable it after open()
+  //
+  if(app_cut_rotation==NULL) {
+    app_cut_rotation=new RDCutRotation(this);
+    if(app_ripc!=NULL) {
+      connect(app_ripc,SIGNAL(notificationReceived(RDNotification *)),
+	      app_cut_rotation,SLOT(notificationReceivedData(RDNotification *)));
+      connect(app_ripc,SIGNAL(notificationsMissed(const QString &)),
+	      app_cut_rotation,SLOT(notificationsMissedData(const QString &)));
+    }
+  }
+  return app_cut_rotation;
+}
+
+
 RDLibraryConf *RDApplication::libraryConf()
 {
   return app_library_conf;
@@ -195,6 +232,22 @@ RDAirPlayConf *RDApplication::panelConf()
 }
 
 
+RDPeaksCache *RDApplication::peaksCache()
+{
+  //
+  // Created on first use, as most modules never draw waveforms
+  //
+  if(app_peaks_cache==NULL) {
+    app_peaks_cache=new RDPeaksCache(this);
+    if(app_ripc!=NULL) {
+      connect(app_ripc,SIGNAL(notificationReceived(RDNotification *)),
+	      app_peaks_cache,SLOT(notificationReceivedData(RDNotification *)));
+    }
+  }
+  return app_peaks_cache;
+}
+
+
 RDRipc *RDApplication::ripc()
 {
   return app_ripc;
@@ -249,3 +302,15 @@ void RDApplication::userChangedData()
   app_user->setName(app_ripc->user());
   emit userChanged();
 }
+
+
+void RDApplication::notificationReceivedData(RDNotification *notify)
+{
+  if((notify->type()==RDNotification::StationType)&&
+     notify->containsId(QVariant(app_station->name()))) {
+    app_station->reload();
+    app_library_conf->reload();
+    app_airplay_conf->reload();
+    app_panel_conf->reload();
+  }
+}
@@ -27,10 +27,12 @@
 #include <rdcae.h>
 #include <rdcmd_switch.h>
 #include <rdconfig.h>
+#include <rdcutrotation.h>
 #include <rddb.h>
 #include <rddbheartbeat.h>
 #include <rdlibrary_conf.h>
 #include <rdlogedit_conf.h>
+#include <rdpeakscache.h>
 #include <rdripc.h>
 #include <rdstation.h>
 #include <rdsystem.h>
@@ -48,9 +50,11 @@ class RDApplication : public QObject
   RDCae *cae();
   RDCmdSwitch *cmdSwitch();
   RDConfig *config();
+  RDCutRotation *cutRotation();
   RDLibraryConf *libraryConf();
   RDLogeditConf *logeditConf();
   RDAirPlayConf *panelConf();
+  RDPeaksCache *peaksCache();
   RDRipc *ripc();
   RDStation *station();
   RDSystem *system();
@@ -60,6 +64,7 @@ class RDApplication : public QObject
 
  private slots:
   void userChangedData();
+  void notificationReceivedData(RDNotification *notify);
 
  signals:
   void userChanged();
@@ -67,9 +72,11 @@ class RDApplication : public QObject
  private:
   RDAirPlayConf *app_airplay_conf;
   RDAirPlayConf *app_panel_conf;
+  RDPeaksCache *app_peaks_cache;
   RDCae *app_cae;
   RDCmdSwitch *app_cmd_switch;
   RDConfig  *app_config;
+  RDCutRotation *app_cut_rotation;
   RDLibraryConf *app_library_conf;
   RDLogeditConf *app_logedit_conf;
   RDRipc *app_ripc;
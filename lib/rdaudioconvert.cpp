@@ -61,10 +61,12 @@
 RDAudioConvert::RDAudioConvert(QObject *parent)
   : QObject(parent)
 {
+  conv_src_chase_wait=0;
   conv_start_point=-1;
   conv_end_point=-1;
   conv_speed_ratio=1.0;
   conv_peak_sample=0.0;
+  ResetLevels();
   conv_settings=NULL;
   conv_src_wavedata=new RDWaveData();
   conv_dst_wavedata=NULL;
@@ -91,6 +93,20 @@ void RDAudioConvert::setSourceFile(const QString &filename)
 }
 
 
+void RDAudioConvert::setSourceChaseWait(int msecs)
+{
+  //
+  // When non-zero, a WAV source that is still being written is followed
+  // as it grows, waiting up to 'msecs' for each block to arrive (see
+  // RDWaveFile::setChaseMode()).  Only PCM and MPEG WAV sources can be
+  // followed; if the source is still incomplete when no more arrives,
+  // convert() fails with ErrorInvalidSource without writing the
+  // destination.
+  //
+  conv_src_chase_wait=msecs;
+}
+
+
 void RDAudioConvert::setDestinationFile(const QString &filename)
 {
   conv_dst_filename=filename;
@@ -147,6 +163,8 @@ RDAudioConvert::ErrorCode RDAudioConvert::convert()
   QString tmpfile2;
   RDTempDirectory *temp_dir=NULL;
 
+  conv_sha1_hash="";
+
   //
   // Make sure we're all set to go...
   //
@@ -214,6 +232,65 @@ RDAudioConvert::ErrorCode RDAudioConvert::convert()
 }
 
 
+int RDAudioConvert::startTrim(int level) const
+{
+  //
+  // Returns the first frame of the destination audio whose block peak is
+  // at or above 'level' hundredths of a dB below full scale (the same
+  // convention as RDWaveFile::startTrim()), or -1 if there is none.
+  // Resolution is one DEFAULT_LEVL_BLOCK_SIZE block and 0.1 dB.
+  //
+  int block=-1;
+  int last_bin=level/10;
+
+  if(last_bin>=(RDAUDIOCONVERT_LEVEL_BINS-1)) {
+    last_bin=RDAUDIOCONVERT_LEVEL_BINS-2;
+  }
+  for(int i=0;i<=last_bin;i++) {
+    if((conv_level_first[i]>=0)&&
+       ((block<0)||(conv_level_first[i]<block))) {
+      block=conv_level_first[i];
+    }
+  }
+  if(block<0) {
+    return -1;
+  }
+  return block*DEFAULT_LEVL_BLOCK_SIZE;
+}
+
+
+int RDAudioConvert::endTrim(int level) const
+{
+  int block=-1;
+  int last_bin=level/10;
+
+  if(last_bin>=(RDAUDIOCONVERT_LEVEL_BINS-1)) {
+    last_bin=RDAUDIOCONVERT_LEVEL_BINS-2;
+  }
+  for(int i=0;i<=last_bin;i++) {
+    if(conv_level_last[i]>block) {
+      block=conv_level_last[i];
+    }
+  }
+  if(block<0) {
+    return -1;
+  }
+  return block*DEFAULT_LEVL_BLOCK_SIZE;
+}
+
+
+std::vector<unsigned> RDAudioConvert::levelHistogram() const
+{
+  return conv_level_counts;
+}
+
+
+QString RDAudioConvert::sha1Hash() const
+{
+  return conv_sha1_hash;
+}
+
+
 bool RDAudioConvert::settingsValid(RDSettings *settings)
 {
   return true;
@@ -289,6 +366,10 @@ RDAudioConvert::ErrorCode RDAudioConvert::Stage1Convert(const QString &srcfile,
   // Try RDWaveFile
   //
   wave=new RDWaveFile(srcfile);
+  if(conv_src_chase_wait>0) {
+    wave->setChaseMode(true);
+    wave->setChaseWait(conv_src_chase_wait);
+  }
   if(wave->openWave(conv_src_wavedata)) {
     switch(wave->type()) {
     case RDWaveFile::Wave:
@@ -297,6 +378,11 @@ RDAudioConvert::ErrorCode RDAudioConvert::Stage1Convert(const QString &srcfile,
 	delete wave;
 	return err;
       }
+      if(wave->isGrowing()) {
+	err=Stage1Pcm(dstfile,wave);
+	delete wave;
+	return err;
+      }
       break;
 
     case RDWaveFile::Mpeg:
@@ -671,6 +757,7 @@ RDAudioConvert::ErrorCode RDAudioConvert::Stage1Mpeg(const QString &dstfile,
     UpdatePeak(sf_buffer,mad_synth.pcm.length*wave->getChannels());
     sf_writef_float(sf_dst,sf_buffer,mad_synth.pcm.length);
   }
+  bool truncated=wave->isGrowing();
 
   //
   // Clean Up
@@ -682,12 +769,106 @@ RDAudioConvert::ErrorCode RDAudioConvert::Stage1Mpeg(const QString &dstfile,
 
   sf_close(sf_dst);
 
+  if(truncated) {
+    return RDAudioConvert::ErrorInvalidSource;
+  }
   return RDAudioConvert::ErrorOk;
 #else
   return RDAudioConvert::ErrorFormatNotSupported;
 #endif  // HAVE_MAD
 }
 
+RDAudioConvert::ErrorCode RDAudioConvert::Stage1Pcm(const QString &dstfile,
+						    RDWaveFile *wave)
+{
+  SNDFILE *sf_dst=NULL;
+  SF_INFO sf_dst_info;
+  unsigned char buffer[STAGE1BUFSIZE];
+  float sf_buffer[STAGE1BUFSIZE/2];
+  unsigned chans=wave->getChannels();
+  unsigned bytes=wave->getBitsPerSample()/8;
+  sf_count_t start=0;
+  sf_count_t end=-1;
+  sf_count_t frames=0;
+  sf_count_t first;
+  sf_count_t last;
+  int left_over=0;
+  int n;
+
+  //
+  // Used for PCM sources that are still being written, which libsndfile
+  // can't follow
+  //
+  if((chans==0)||((bytes!=2)&&(bytes!=3))) {
+    return RDAudioConvert::ErrorFormatNotSupported;
+  }
+
+  //
+  // Open Destination
+  //
+  memset(&sf_dst_info,0,sizeof(sf_dst_info));
+  sf_dst_info.format=SF_FORMAT_WAV|SF_FORMAT_FLOAT;
+  sf_dst_info.channels=chans;
+  sf_dst_info.samplerate=wave->getSamplesPerSec();
+  if((sf_dst=sf_open(dstfile,SFM_WRITE,&sf_dst_info))==NULL) {
+    return RDAudioConvert::ErrorNoDestination;
+  }
+
+  //
+  // Transfer Data
+  //
+  if(conv_start_point>0) {
+    start=(double)conv_start_point*(double)wave->getSamplesPerSec()/1000.0;
+  }
+  if(conv_end_point>=0) {
+    end=(double)conv_end_point*(double)wave->getSamplesPerSec()/1000.0;
+  }
+  int block=bytes*chans;
+  int size=STAGE1BUFSIZE-STAGE1BUFSIZE%block;
+  while((n=wave->readWave(buffer+left_over,size-left_over))>0) {
+    n+=left_over;
+    int count=n/block;
+    for(int i=0;i<count*(int)chans;i++) {
+      if(bytes==2) {
+	sf_buffer[i]=(float)(int16_t)(buffer[2*i]|(buffer[2*i+1]<<8))/32768.0;
+      }
+      else {
+	sf_buffer[i]=(float)((int32_t)(((uint32_t)buffer[3*i]<<8)|
+				       ((uint32_t)buffer[3*i+1]<<16)|
+				       ((uint32_t)buffer[3*i+2]<<24))>>8)/
+	  8388608.0;
+      }
+    }
+    first=start-frames;
+    if(first<0) {
+      first=0;
+    }
+    last=count;
+    if((end>=0)&&((frames+last)>end)) {
+      last=end-frames;
+    }
+    if(last>first) {
+      UpdatePeak(sf_buffer+first*chans,(last-first)*chans);
+      sf_writef_float(sf_dst,sf_buffer+first*chans,last-first);
+    }
+    frames+=count;
+    left_over=n-count*block;
+    memmove(buffer,buffer+count*block,left_over);
+    if((end>=0)&&(frames>=end)) {
+      sf_close(sf_dst);
+      return RDAudioConvert::ErrorOk;
+    }
+  }
+  bool truncated=wave->isGrowing();
+  sf_close(sf_dst);
+
+  if(truncated) {
+    return RDAudioConvert::ErrorInvalidSource;
+  }
+  return RDAudioConvert::ErrorOk;
+}
+
+
 // Based on libfaad's frontend/main.c, but using libmp4v2 for MP4 access.
 RDAudioConvert::ErrorCode RDAudioConvert::Stage1M4A(const QString &dstfile,
 						    RDWaveFile *wave) 
@@ -991,6 +1172,7 @@ RDAudioConvert::ErrorCode RDAudioConvert::Stage2Convert(const QString &srcfile,
       (float)conv_settings->normalizationLevel()-20.0*log10f(conv_peak_sample);
     ratio=exp10f(gain/20.0);
   }
+  ResetLevels();
 
   //
   // Convert
@@ -1061,6 +1243,7 @@ RDAudioConvert::ErrorCode RDAudioConvert::Stage2Convert(const QString &srcfile,
     //
     // Write Output
     //
+    UpdateLevels(pcm[2],n,dst_info.channels);
     if(sf_writef_float(dst_sf,pcm[2],n)!=n) {
       for(unsigned i=0;i<3;i++) {
 	if(free_pcm[i]) {
@@ -1084,6 +1267,7 @@ RDAudioConvert::ErrorCode RDAudioConvert::Stage2Convert(const QString &srcfile,
     while((n=st_conv->
 	   receiveSamples((soundtouch::SAMPLETYPE *)pcm[2],
 			  STAGE2_BUFFER_SIZE/dst_info.channels))>0) {
+      UpdateLevels(pcm[2],n,dst_info.channels);
       if(sf_writef_float(dst_sf,pcm[2],n)!=n) {
 	for(unsigned i=0;i<3;i++) {
 	  if(free_pcm[i]) {
@@ -1100,6 +1284,7 @@ RDAudioConvert::ErrorCode RDAudioConvert::Stage2Convert(const QString &srcfile,
     }
     delete st_conv;
   }
+  FinishLevelBlock();
 
   //
   // Clean Up
@@ -1609,6 +1794,7 @@ RDAudioConvert::ErrorCode RDAudioConvert::Stage3Layer2Wav(SNDFILE *src_sf,
   wave->setCartChunk(conv_dst_wavedata!=NULL);
   wave->setLevlChunk(true);
   wave->setRdxlContents(conv_dst_rdxl);
+  wave->setSha1Hashing(true);
   unlink(dstfile);
   if(!wave->createWave(conv_dst_wavedata,conv_start_point)) {
     return RDAudioConvert::ErrorNoDestination;
@@ -1665,6 +1851,7 @@ RDAudioConvert::ErrorCode RDAudioConvert::Stage3Layer2Wav(SNDFILE *src_sf,
   //
   twolame_close(&lameopts);
   wave->closeWave(src_sf_info->frames);
+  conv_sha1_hash=wave->sha1Hash();
   return RDAudioConvert::ErrorOk;
 #else
   return RDAudioConvert::ErrorFormatNotSupported;
@@ -1802,6 +1989,8 @@ RDAudioConvert::ErrorCode RDAudioConvert::Stage3Pcm16(SNDFILE *src_sf,
 	      exp10((double)conv_settings->normalizationLevel()/20.0));
   }
   wave->setLevlChunk(true);
+  wave->setSha1Hashing(true);
+  wave->setExpectedFrames(src_sf_info->frames);
   sf_buffer=new int16_t[2048*src_sf_info->channels];
   unlink(dstfile);
   if(!wave->createWave(conv_dst_wavedata,conv_start_point)) {
@@ -1819,6 +2008,7 @@ RDAudioConvert::ErrorCode RDAudioConvert::Stage3Pcm16(SNDFILE *src_sf,
   }
   delete sf_buffer;
   wave->closeWave();
+  conv_sha1_hash=wave->sha1Hash();
   delete wave;
   return RDAudioConvert::ErrorOk;
 }
@@ -1845,6 +2035,8 @@ RDAudioConvert::ErrorCode RDAudioConvert::Stage3Pcm24(SNDFILE *src_sf,
 	      exp10((double)conv_settings->normalizationLevel()/20.0));
   }
   wave->setLevlChunk(true);
+  wave->setSha1Hashing(true);
+  wave->setExpectedFrames(src_sf_info->frames);
   sf_buffer=new int[2048*src_sf_info->channels];
   pcm24=new uint8_t[2048*src_sf_info->channels*sizeof(int)];
   unlink(dstfile);
@@ -1869,6 +2061,7 @@ RDAudioConvert::ErrorCode RDAudioConvert::Stage3Pcm24(SNDFILE *src_sf,
   delete sf_buffer;
   delete pcm24;
   wave->closeWave();
+  conv_sha1_hash=wave->sha1Hash();
   delete wave;
   return RDAudioConvert::ErrorOk;
 }
@@ -1968,6 +2161,67 @@ void RDAudioConvert::UpdatePeak(const double data[],ssize_t len)
 }
 
 
+void RDAudioConvert::ResetLevels()
+{
+  conv_level_counts.assign(RDAUDIOCONVERT_LEVEL_BINS,0);
+  conv_level_first.assign(RDAUDIOCONVERT_LEVEL_BINS,-1);
+  conv_level_last.assign(RDAUDIOCONVERT_LEVEL_BINS,-1);
+  conv_level_block_peak=0.0;
+  conv_level_block_frames=0;
+  conv_level_block=0;
+}
+
+
+void RDAudioConvert::UpdateLevels(const float data[],ssize_t frames,
+				  unsigned chans)
+{
+  //
+  // Accumulate the peak of each DEFAULT_LEVL_BLOCK_SIZE block of output
+  // frames into the level histogram, so trim points can be found without
+  // re-reading the converted audio.
+  //
+  float peak;
+
+  for(ssize_t i=0;i<frames;i++) {
+    for(unsigned j=0;j<chans;j++) {
+      if((peak=fabsf(data[chans*i+j]))>conv_level_block_peak) {
+	conv_level_block_peak=peak;
+      }
+    }
+    if(++conv_level_block_frames==DEFAULT_LEVL_BLOCK_SIZE) {
+      FinishLevelBlock();
+    }
+  }
+}
+
+
+void RDAudioConvert::FinishLevelBlock()
+{
+  int bin=RDAUDIOCONVERT_LEVEL_BINS-1;
+
+  if(conv_level_block_frames==0) {
+    return;
+  }
+  if(conv_level_block_peak>0.0) {
+    bin=(int)(-200.0*log10f(conv_level_block_peak));
+    if(bin<0) {
+      bin=0;
+    }
+    if(bin>=RDAUDIOCONVERT_LEVEL_BINS) {
+      bin=RDAUDIOCONVERT_LEVEL_BINS-1;
+    }
+  }
+  conv_level_counts[bin]++;
+  if(conv_level_first[bin]<0) {
+    conv_level_first[bin]=conv_level_block;
+  }
+  conv_level_last[bin]=conv_level_block;
+  conv_level_block_peak=0.0;
+  conv_level_block_frames=0;
+  conv_level_block++;
+}
+
+
 bool RDAudioConvert::LoadMad()
 {
 #ifdef HAVE_MAD
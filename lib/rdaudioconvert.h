@@ -34,12 +34,20 @@
 
 #include <rdmp4.h>
 
+#include <vector>
+
 #include <qobject.h>
 
 #include "rdsettings.h"
 #include "rdwavedata.h"
 #include "rdwavefile.h"
 
+//
+// Level histogram resolution, in bins of 0.1 dB below full scale.
+// The last bin collects everything quieter, including digital silence.
+//
+#define RDAUDIOCONVERT_LEVEL_BINS 1001
+
 class RDAudioConvert : public QObject
 {
   Q_OBJECT;
@@ -51,6 +59,7 @@ class RDAudioConvert : public QObject
   RDAudioConvert(QObject *parent=0);
   ~RDAudioConvert();
   void setSourceFile(const QString &filename);
+  void setSourceChaseWait(int msecs);
   void setDestinationFile(const QString &filename);
   void setDestinationSettings(RDSettings *settings);
   RDWaveData *sourceWaveData() const;
@@ -60,6 +69,10 @@ class RDAudioConvert : public QObject
   void setRange(int start_pt,int end_pt);
   void setSpeedRatio(float ratio);
   RDAudioConvert::ErrorCode convert();
+  int startTrim(int level) const;
+  int endTrim(int level) const;
+  std::vector<unsigned> levelHistogram() const;
+  QString sha1Hash() const;
   static bool settingsValid(RDSettings *settings);
   static QString errorText(RDAudioConvert::ErrorCode err);
 
@@ -72,6 +85,8 @@ class RDAudioConvert : public QObject
 					 RDWaveFile *wave);
   RDAudioConvert::ErrorCode Stage1Mpeg(const QString &dstfile,
 				       RDWaveFile *wave);
+  RDAudioConvert::ErrorCode Stage1Pcm(const QString &dstfile,
+				      RDWaveFile *wave);
   RDAudioConvert::ErrorCode Stage1M4A(const QString &dstfile,
 				      RDWaveFile *wave);
   RDAudioConvert::ErrorCode Stage1SndFile(const QString &dstfile,
@@ -99,10 +114,14 @@ class RDAudioConvert : public QObject
   void ApplyId3Tag(const QString &filename,RDWaveData *wavedata);
   void UpdatePeak(const float data[],ssize_t len);
   void UpdatePeak(const double data[],ssize_t len);
+  void ResetLevels();
+  void UpdateLevels(const float data[],ssize_t frames,unsigned chans);
+  void FinishLevelBlock();
   bool LoadMad();
   bool LoadTwoLame();
   bool LoadLame();
   QString conv_src_filename;
+  int conv_src_chase_wait;
   QString conv_dst_filename;
   int conv_start_point;
   int conv_end_point;
@@ -112,7 +131,14 @@ class RDAudioConvert : public QObject
   RDWaveData *conv_dst_wavedata;
   QString conv_src_rdxl;
   QString conv_dst_rdxl;
+  QString conv_sha1_hash;
   float conv_peak_sample;
+  std::vector<unsigned> conv_level_counts;
+  std::vector<int> conv_level_first;
+  std::vector<int> conv_level_last;
+  float conv_level_block_peak;
+  unsigned conv_level_block_frames;
+  int conv_level_block;
   int conv_src_converter;
   void *conv_mad_handle;
   void *conv_lame_handle;
@@ -142,12 +142,19 @@ void RDCae::enableMetering(std::vector<int> *cards)
 }
 
 
-bool RDCae::loadPlay(int card,QString name,int *stream,int *handle)
+bool RDCae::loadPlay(int card,QString name,int *stream,int *handle,
+		     bool chase)
 {
   int count=0;
 
-  SendCommand(QString().sprintf("LP %d %s!",
-				card,(const char *)name));
+  if(chase) {
+    SendCommand(QString().sprintf("LP %d %s 1!",
+				  card,(const char *)name));
+  }
+  else {
+    SendCommand(QString().sprintf("LP %d %s!",
+				  card,(const char *)name));
+  }
 
   //
   // This is really warty, but needed to make the method 'synchronous'
@@ -210,6 +217,24 @@ void RDCae::stopPlay(int handle)
 }
 
 
+void RDCae::scheduleTransition(int handle,unsigned frame,int next_handle,
+				unsigned length,int fade_in,int fade_out)
+{
+  //
+  // Start 'next_handle' when 'handle' reaches sample 'frame', executed
+  // by caed in its audio callback.  Fades are in mS.
+  //
+  SendCommand(QString().sprintf("XS %d %u %d %u %d %d!",handle,frame,
+				next_handle,length,fade_in,fade_out));
+}
+
+
+void RDCae::cancelTransition(int handle)
+{
+  SendCommand(QString().sprintf("XC %d!",handle));
+}
+
+
 void RDCae::loadRecord(int card,int stream,QString name,
 		       AudioCoding coding,int chan,int samp_rate,
 		       int bit_rate)
@@ -228,6 +253,21 @@ void RDCae::unloadRecord(int card,int stream)
 }
 
 
+QString RDCae::recordSha1Hash(int card,int stream) const
+{
+  //
+  // The SHA-1 hash caed generated while writing the last recording
+  // unloaded from card/stream, or an empty string if it has none.
+  // Valid from the recordUnloaded() signal until the next recording on
+  // the same card/stream is unloaded.
+  //
+  if((card<0)||(card>=RD_MAX_CARDS)||(stream<0)||(stream>=RD_MAX_STREAMS)) {
+    return QString();
+  }
+  return cae_record_hash[card][stream];
+}
+
+
 void RDCae::record(int card,int stream,unsigned length,int threshold)
 {
   SendCommand(QString().sprintf("RD %d %d %u %d!",
@@ -497,6 +537,7 @@ void RDCae::DispatchCommand(RDCmdCache *cmd)
 {
   int pos;
   int card;
+  int stream;
 
   if(!strcmp(cmd->arg(0),"PW")) {   // Password Response
     if(cmd->arg(1)[0]=='+') {
@@ -562,6 +603,16 @@ void RDCae::DispatchCommand(RDCmdCache *cmd)
     }
   }
 
+  if(!strcmp(cmd->arg(0),"XS")) {   // Schedule Transition
+    emit transitionScheduled(GetHandle(cmd->arg(1)),GetHandle(cmd->arg(3)),
+			     cmd->arg(7)[0]=='+');
+  }
+
+  if(!strcmp(cmd->arg(0),"XE")) {   // Transition Executed
+    emit transitionExecuted(GetHandle(cmd->arg(1)),GetHandle(cmd->arg(2)),
+			    QString(cmd->arg(3)).toUInt());
+  }
+
   if(!strcmp(cmd->arg(0),"TS")) {   // Timescale Supported
     if(sscanf(cmd->arg(1),"%d",&card)==1) {
       if(cmd->arg(2)[0]=='+') {
@@ -581,8 +632,16 @@ void RDCae::DispatchCommand(RDCmdCache *cmd)
 
   if(!strcmp(cmd->arg(0),"UR")) {   // Unload Record
     if(cmd->arg(4)[0]=='+') {
-      emit recordUnloaded(CardNumber(cmd->arg(1)),StreamNumber(cmd->arg(2)),
-			  QString(cmd->arg(3)).toUInt());
+      card=CardNumber(cmd->arg(1));
+      stream=StreamNumber(cmd->arg(2));
+      if((card>=0)&&(card<RD_MAX_CARDS)&&
+	 (stream>=0)&&(stream<RD_MAX_STREAMS)) {
+	cae_record_hash[card][stream]="";
+	if(cmd->argNum()>5) {
+	  cae_record_hash[card][stream]=cmd->arg(5);
+	}
+      }
+      emit recordUnloaded(card,stream,QString(cmd->arg(3)).toUInt());
     }
   }
 
@@ -46,14 +46,19 @@ class RDCae : public QObject
   ~RDCae();
   void connectHost();
   void enableMetering(std::vector<int> *cards);
-  bool loadPlay(int card,QString name,int *stream,int *handle);
+  bool loadPlay(int card,QString name,int *stream,int *handle,
+		bool chase=false);
   void unloadPlay(int handle);
   void positionPlay(int handle,int pos);
   void play(int handle,unsigned length,int speed,bool pitch);
   void stopPlay(int handle);
+  void scheduleTransition(int handle,unsigned frame,int next_handle,
+			  unsigned length,int fade_in,int fade_out);
+  void cancelTransition(int handle);
   void loadRecord(int card,int stream,QString name,AudioCoding coding,
 		  int chan,int samp_rate,int bit_rate);
   void unloadRecord(int card,int stream);
+  QString recordSha1Hash(int card,int stream) const;
   void record(int card,int stream,unsigned length,int threshold);
   void stopRecord(int card,int stream);
   void setClockSource(int card,RDCae::ClockSource src);
@@ -94,6 +99,8 @@ class RDCae : public QObject
   void inputStatusChanged(int card,int stream,bool state);
   void playPositionChanged(int handle,unsigned sample);
   void timescalingSupported(int card,bool state);
+  void transitionScheduled(int handle,int next_handle,bool state);
+  void transitionExecuted(int handle,int next_handle,unsigned frame);
 
  private slots:
   void readyData();
@@ -116,6 +123,7 @@ class RDCae : public QObject
   bool input_status[RD_MAX_CARDS][RD_MAX_PORTS];
   int cae_handle[RD_MAX_CARDS][RD_MAX_STREAMS];
   unsigned cae_pos[RD_MAX_CARDS][RD_MAX_STREAMS];
+  QString cae_record_hash[RD_MAX_CARDS][RD_MAX_STREAMS];
   QSocketDevice *cae_meter_socket;
   short cae_input_levels[RD_MAX_CARDS][RD_MAX_PORTS][2];
   short cae_output_levels[RD_MAX_CARDS][RD_MAX_PORTS][2];
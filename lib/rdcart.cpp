@@ -29,8 +29,10 @@
 
 #include <qstringlist.h>
 #include <qobject.h>
+#include <qsqlerror.h>
 
 #include <rd.h>
+#include <rdapplication.h>
 #include <rdconf.h>
 #include <rdconfig.h>
 #include <rdcart.h>
@@ -88,6 +90,11 @@ bool RDCart::selectCut(QString *cut,const QTime &time) const
 {
   bool ret;
 
+  if((rda!=NULL)&&rda->cutRotation()->isEnabled()&&
+     rda->cutRotation()->selectCut(cart_number,time,cut)) {
+    return true;
+  }
+
   if(!exists()) {
     ret=(*cut=="");
     *cut="";
@@ -1282,6 +1289,7 @@ unsigned RDCart::create(const QString &groupname,RDCart::Type type,
 			QString *err_msg,unsigned cartnum)
 {
   bool ok=false;
+  int attempts=0;
 
   RDGroup *group=new RDGroup(groupname);
   if(!group->exists()) {
@@ -1302,10 +1310,19 @@ unsigned RDCart::create(const QString &groupname,RDCart::Type type,
 	QString().sprintf("TYPE=%d,",type)+
 	"GROUP_NAME=\""+RDEscapeString(groupname)+"\","+
 	"TITLE=\""+RDEscapeString(RDCart::uniqueCartTitle(cartnum))+"\"";
-      RDSqlQuery *q=new RDSqlQuery(sql);
+      RDSqlQuery *q=new RDSqlQuery(sql,false);  // Collisions are expected
       ok=q->isActive();
+      if((!ok)&&((q->lastError().number()!=1062)||  // ER_DUP_ENTRY
+		 (++attempts>=RDCART_CREATE_MAX_ATTEMPTS))) {
+	*err_msg=QObject::tr("Unable to create cart")+
+	  " ["+q->lastError().databaseText()+"]";
+	delete q;
+	delete group;
+	return 0;
+      }
       delete q;
     }
+    delete group;
     return cartnum;
   }
   else {
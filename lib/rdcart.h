@@ -35,6 +35,12 @@
 
 #define MAX_SERVICES 16
 
+//
+// Number of times RDCart::create() will retry an auto-allocated cart
+// number that was taken by another client between selection and insert
+//
+#define RDCART_CREATE_MAX_ATTEMPTS 10
+
 class RDCart
 {
  public:
@@ -677,9 +677,11 @@ void RDCartSlot::LogPlayout(RDPlayDeck::State state)
   if(!slot_svcname.isEmpty()) {
     QDateTime eventDateTime(datetime.date(), 
           slot_logline->startTime(RDLogLine::Actual));
-    QString svctablename=slot_svcname;
-    svctablename.replace(" ","_");
-    sql=QString("insert into `")+svctablename+"_SRT` set "+
+    if(!eventDateTime.isValid()) {
+      eventDateTime=QDateTime::currentDateTime();
+    }
+    sql=QString("insert into ELR_LINES set ")+
+      "SERVICE_NAME=\""+RDEscapeString(slot_svcname)+"\","+
       QString().sprintf("LENGTH=%d,LOG_ID=%d,CART_NUMBER=%u,EVENT_TYPE=%d,\
                        EVENT_SOURCE=%d,EXT_LENGTH=%d,PLAY_SOURCE=%d,	\
                        CUT_NUMBER=%d,USAGE_CODE=%d,START_SOURCE=%d,",
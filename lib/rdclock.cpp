@@ -17,11 +17,20 @@
 //   License along with this program; if not, write to the Free Software
 //   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
 //
+#include <algorithm>
+
 #include <rddb.h>
 #include <rdclock.h>
 #include <rdevent_line.h>
 #include <rdescape_string.h>
 
+static bool __RDClock_StartTimeLessThan(const RDEventLine *lhs,
+					const RDEventLine *rhs)
+{
+  return lhs->startTime()<rhs->startTime();
+}
+
+
 //
 // Global Classes
 //
@@ -130,8 +139,10 @@ int RDClock::size() const
 }
 
 
-bool RDClock::load()
+bool RDClock::load(std::map<QString,RDEventLine> *events)
 {
+  std::map<QString,RDEventLine>::iterator it;
+
   QString sql=QString().sprintf("select SHORT_NAME,COLOR,ARTISTSEP,REMARKS from\
                                  CLOCKS where NAME=\"%s\"",
 				(const char *)clock_name);
@@ -156,11 +167,26 @@ bool RDClock::load()
 			(const char *)clock_name_esc);
   q=new RDSqlQuery(sql);
   while(q->next()) {
-    clock_events.push_back(RDEventLine());
-    clock_events.back().setName(q->value(0).toString());
+    if(events==NULL) {
+      clock_events.push_back(RDEventLine());
+      clock_events.back().setName(q->value(0).toString());
+      clock_events.back().load();
+    }
+    else {
+      //
+      // Event definitions are shared by every clock loaded with the same
+      // cache, so each event is read from the database only once.
+      //
+      if((it=events->find(q->value(0).toString()))==events->end()) {
+	it=events->insert(std::pair<QString,RDEventLine>
+			  (q->value(0).toString(),RDEventLine())).first;
+	it->second.setName(q->value(0).toString());
+	it->second.load();
+      }
+      clock_events.push_back(it->second);
+    }
     clock_events.back().setStartTime(QTime().addMSecs(q->value(1).toInt()));
     clock_events.back().setLength(q->value(2).toInt());
-    clock_events.back().load();
   }
   delete q;
   return true;
@@ -300,28 +326,25 @@ bool RDClock::validate(const QTime &start_time,int length,int except_line)
 }
 
 
-bool RDClock::generateLog(int hour,const QString &logname,
+bool RDClock::generateLog(int hour,RDLogLineBuffer *buf,
 			  const QString &svc_name,QString *errors)
 {
-  QString sql;
-  RDSqlQuery *q;
-  RDEventLine eventline;
+  std::vector<RDEventLine *> lines;
 
-  sql=QString().sprintf("select EVENT_NAME,START_TIME,LENGTH from %s_CLK\
-                         order by START_TIME",
-			(const char *)clock_name_esc);
-  q=new RDSqlQuery(sql);
-  while(q->next()) {
-    eventline.setName(q->value(0).toString());
-    eventline.load();
-    //    eventline.setStartTime(q->value(1).toTime().addSecs(3600*hour));
-    eventline.setStartTime(QTime().addMSecs(q->value(1).toInt()).
-			   addSecs(3600*hour));
-    eventline.setLength(q->value(2).toInt());
-    eventline.generateLog(logname,svc_name,errors,artistsep,clock_name_esc);
-    eventline.clear();
+  //
+  // Generated from the events already read by load(), so a clock used
+  // for several hours is only read once.  The template lines themselves
+  // are left untouched.
+  //
+  for(unsigned i=0;i<clock_events.size();i++) {
+    lines.push_back(&clock_events[i]);
+  }
+  std::stable_sort(lines.begin(),lines.end(),__RDClock_StartTimeLessThan);
+  for(unsigned i=0;i<lines.size();i++) {
+    RDEventLine eventline=*lines[i];
+    eventline.setStartTime(lines[i]->startTime().addSecs(3600*hour));
+    eventline.generateLog(buf,svc_name,errors,artistsep,clock_name_esc);
   }
-  delete q;
   return true;
 }
 
@@ -21,6 +21,7 @@
 #ifndef RDCLOCK_H
 #define RDCLOCK_H
 
+#include <map>
 #include <vector>
 
 #include <qsqldatabase.h>
@@ -47,13 +48,13 @@ class RDClock
    RDEventLine *eventLine(int line);
    void clear();
    int size() const;
-   bool load();
+   bool load(std::map<QString,RDEventLine> *events=NULL);
    bool save();
    bool insert(const QString &event_name,int line);
    void remove(int line);
    void move(int from_line,int to_line);
    bool validate(const QTime &start_time,int length,int except_line=-1);
-   bool generateLog(int hour,const QString &logname,const QString &svc_name,
+   bool generateLog(int hour,RDLogLineBuffer *buf,const QString &svc_name,
 		    QString *errors);
    static QString tableName(const QString &name);
 
@@ -352,6 +352,42 @@ int RDConfig::alsaChannelsPerPcm() const
 }
 
 
+int RDConfig::nullAudioCards() const
+{
+  return conf_null_audio_cards;
+}
+
+
+int RDConfig::nullAudioPorts() const
+{
+  return conf_null_audio_ports;
+}
+
+
+int RDConfig::nullAudioSampleRate() const
+{
+  return conf_null_audio_sample_rate;
+}
+
+
+int RDConfig::nullAudioPeriodSize() const
+{
+  return conf_null_audio_period_size;
+}
+
+
+double RDConfig::nullAudioSpeed() const
+{
+  return conf_null_audio_speed;
+}
+
+
+QString RDConfig::nullAudioOutputDirectory() const
+{
+  return conf_null_audio_output_directory;
+}
+
+
 QString RDConfig::stationName() const
 {
   return conf_station_name;
@@ -617,6 +653,14 @@ void RDConfig::load()
   conf_alsa_period_size=
     profile->intValue("Alsa","PeriodSize",RD_ALSA_DEFAULT_PERIOD_SIZE);
   conf_alsa_channels_per_pcm=profile->intValue("Alsa","ChannelsPerPcm",-1);
+  conf_null_audio_cards=profile->intValue("NullAudio","Cards",0);
+  conf_null_audio_ports=profile->intValue("NullAudio","Ports",8);
+  conf_null_audio_sample_rate=profile->intValue("NullAudio","SampleRate",0);
+  conf_null_audio_period_size=
+    profile->intValue("NullAudio","PeriodSize",RD_ALSA_DEFAULT_PERIOD_SIZE);
+  conf_null_audio_speed=profile->doubleValue("NullAudio","Speed",1.0);
+  conf_null_audio_output_directory=
+    profile->stringValue("NullAudio","OutputDirectory","");
   conf_ripcd_logname=profile->stringValue("Ripcd","Logfile","");
   conf_airplay_logname=profile->stringValue("RDAirPlay","Logfile","");
   conf_catchd_logname=profile->stringValue("RDCatchd","Logfile","");
@@ -719,6 +763,12 @@ void RDConfig::clear()
   conf_alsa_period_quantity=RD_ALSA_DEFAULT_PERIOD_QUANTITY;
   conf_alsa_period_size=RD_ALSA_DEFAULT_PERIOD_SIZE;
   conf_alsa_channels_per_pcm=-1;
+  conf_null_audio_cards=0;
+  conf_null_audio_ports=8;
+  conf_null_audio_sample_rate=0;
+  conf_null_audio_period_size=RD_ALSA_DEFAULT_PERIOD_SIZE;
+  conf_null_audio_speed=1.0;
+  conf_null_audio_output_directory="";
   conf_station_name="";
   conf_password="";
   conf_audio_owner="";
@@ -80,6 +80,12 @@ class RDConfig
   int alsaPeriodQuantity() const;
   int alsaPeriodSize() const;
   int alsaChannelsPerPcm() const;
+  int nullAudioCards() const;
+  int nullAudioPorts() const;
+  int nullAudioSampleRate() const;
+  int nullAudioPeriodSize() const;
+  double nullAudioSpeed() const;
+  QString nullAudioOutputDirectory() const;
   QString stationName() const;
   QString password() const;
   QString audioOwner() const;
@@ -153,6 +159,12 @@ class RDConfig
   int conf_alsa_period_quantity;
   int conf_alsa_period_size;
   int conf_alsa_channels_per_pcm;
+  int conf_null_audio_cards;
+  int conf_null_audio_ports;
+  int conf_null_audio_sample_rate;
+  int conf_null_audio_period_size;
+  double conf_null_audio_speed;
+  QString conf_null_audio_output_directory;
   QString conf_station_name;
   QString conf_password;
   QString conf_audio_owner;
@@ -28,6 +28,7 @@
 #include <qobject.h>
 
 #include <rd.h>
+#include <rdapplication.h>
 #include <rdconf.h>
 #ifndef WIN32
 #include <rdwavefile.h>
@@ -256,6 +257,19 @@ void RDCut::setSha1Hash(const QString &str)
 }
 
 
+bool RDCut::isRecording() const
+{
+  return RDBool(RDGetSqlValue("CUTS","CUT_NAME",cut_name,"RECORDING",cut_db).
+		toString());
+}
+
+
+void RDCut::setRecording(bool state) const
+{
+  SetRow("RECORDING",RDYesNo(state));
+}
+
+
 unsigned RDCut::length() const
 {
   return RDGetSqlValue("CUTS","CUT_NAME",cut_name,"LENGTH",cut_db).
@@ -838,12 +852,17 @@ int RDCut::effectiveEnd() const
 
 void RDCut::logPlayout() const
 {
+  if((rda!=NULL)&&rda->cutRotation()->isEnabled()) {
+    rda->cutRotation()->logPlayout(cut_name);
+    return;
+  }
   QString sql=
     QString().sprintf("update CUTS set LAST_PLAY_DATETIME=\"%s\",\
-                       PLAY_COUNTER=%d,LOCAL_COUNTER=%d where CUT_NAME=\"%s\"",
+                       PLAY_COUNTER=PLAY_COUNTER+1,\
+                       LOCAL_COUNTER=LOCAL_COUNTER+1 where CUT_NAME=\"%s\"",
 		      (const char *)QDateTime(QDate::currentDate(),
 		        QTime::currentTime()).toString("yyyy-MM-dd hh:mm:ss"),
-		      playCounter()+1,localCounter()+1,(const char *)cut_name);
+		      (const char *)cut_name);
   RDSqlQuery *q=new RDSqlQuery(sql);
   delete q;
 }
@@ -1317,6 +1336,18 @@ void RDCut::autoTrim(RDCut::AudioEnd end,int level)
   else {
     end_point=wave->getExtTimeLength();
   }
+  setTrimPoints(start_point,end_point);
+  delete wave;
+#endif  // WIN32
+}
+
+
+void RDCut::setTrimPoints(int start_point,int end_point)
+{
+  //
+  // Apply trim points (in mS) already calculated by the caller, e.g. from
+  // the level data gathered by RDAudioConvert during an import.
+  //
   setStartPoint(start_point);
   setEndPoint(end_point);
   if(segueEndPoint()>end_point) {
@@ -1327,8 +1358,6 @@ void RDCut::autoTrim(RDCut::AudioEnd end,int level)
     setSegueEndPoint(-1);
   }
   setLength(end_point-start_point);
-  delete wave;
-#endif  // WIN32
 }
 
 
@@ -61,6 +61,8 @@ class RDCut
   void setIsci(const QString &isci) const;
   QString sha1Hash() const;
   void setSha1Hash(const QString &str);
+  bool isRecording() const;
+  void setRecording(bool state) const;
   unsigned length() const;
   void setLength(int length) const;
   QDateTime originDatetime(bool *valid) const;
@@ -138,6 +140,7 @@ class RDCut
 			QString src_hostname,RDSettings *settings,
 			unsigned msecs) const;
   void autoTrim(RDCut::AudioEnd end,int level);
+  void setTrimPoints(int start_point,int end_point);
   void autoSegue(int level,int length,RDStation *station,RDUser *user,
 		 RDConfig *config);
   void reset() const;
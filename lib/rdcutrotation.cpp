@@ -0,0 +1,467 @@
+// rdcutrotation.cpp
+//
+// In-memory cut rotation state for RDCart::selectCut()
+//
+//   (C) Copyright 2018 Fred Gleason <fredg@paravelsystems.com>
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License version 2 as
+//   published by the Free Software Foundation.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public
+//   License along with this program; if not, write to the Free Software
+//   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+//
+
+#include <stdlib.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#include <algorithm>
+
+#include "rd.h"
+#include "rdcart.h"
+#include "rdcutrotation.h"
+#include "rddb.h"
+#include "rdescape_string.h"
+
+//
+// The orderings below reproduce the 'order by' clauses of the queries
+// formerly issued by RDCart::selectCut(), including MySQL's placement
+// of NULLs (first when ascending, last when descending).
+//
+static bool WeightedOrder(const RDCutRotationCut *a,const RDCutRotationCut *b)
+{
+  if(a->local_counter!=b->local_counter) {
+    return a->local_counter<b->local_counter;
+  }
+  if(a->end_datetime.isNull()!=b->end_datetime.isNull()) {
+    return b->end_datetime.isNull();
+  }
+  if(a->end_datetime!=b->end_datetime) {
+    return a->end_datetime<b->end_datetime;
+  }
+  if(a->last_play_datetime.isNull()!=b->last_play_datetime.isNull()) {
+    return a->last_play_datetime.isNull();
+  }
+  return a->last_play_datetime<b->last_play_datetime;
+}
+
+
+static bool UnweightedOrder(const RDCutRotationCut *a,
+			    const RDCutRotationCut *b)
+{
+  if(a->last_play_datetime.isNull()!=b->last_play_datetime.isNull()) {
+    return b->last_play_datetime.isNull();
+  }
+  if(a->last_play_datetime!=b->last_play_datetime) {
+    return a->last_play_datetime>b->last_play_datetime;
+  }
+  return a->play_order>b->play_order;
+}
+
+
+static bool EvergreenWeightedOrder(const RDCutRotationCut *a,
+				   const RDCutRotationCut *b)
+{
+  return a->local_counter<b->local_counter;
+}
+
+
+static bool EvergreenUnweightedOrder(const RDCutRotationCut *a,
+				     const RDCutRotationCut *b)
+{
+  if(a->last_play_datetime.isNull()!=b->last_play_datetime.isNull()) {
+    return b->last_play_datetime.isNull();
+  }
+  return a->last_play_datetime>b->last_play_datetime;
+}
+
+
+RDCutRotationCut::RDCutRotationCut()
+{
+  play_order=0;
+  weight=1;
+  local_counter=0;
+  evergreen=false;
+  for(int i=0;i<7;i++) {
+    days[i]=false;
+  }
+}
+
+
+bool RDCutRotationCut::isValid(const QDateTime &dt) const
+{
+  if((!start_datetime.isNull())&&
+     (end_datetime.isNull()||(start_datetime>dt)||(end_datetime<dt))) {
+    return false;
+  }
+  if((!start_daypart.isNull())&&
+     (end_daypart.isNull()||(start_daypart>dt.time())||
+      (end_daypart<dt.time()))) {
+    return false;
+  }
+  return days[dt.date().dayOfWeek()-1];
+}
+
+
+RDCutRotationCart::RDCutRotationCart()
+{
+  audio=false;
+  use_weighting=false;
+}
+
+
+RDCutRotationPlay::RDCutRotationPlay()
+{
+  plays=0;
+}
+
+
+//
+// Most modules leave by way of exit() without deleting the RDApplication,
+// so pending play counts are also flushed from an atexit() handler.  A
+// forked child that calls exit() must not write its parent's counts, so
+// only the registering process flushes.
+//
+static RDCutRotation *rot_exit_rotation=NULL;
+static pid_t rot_exit_pid=-1;
+
+static void RDCutRotationExit()
+{
+  if((rot_exit_rotation!=NULL)&&(getpid()==rot_exit_pid)) {
+    rot_exit_rotation->flush();
+  }
+}
+
+
+RDCutRotation::RDCutRotation(QObject *parent)
+  : QObject(parent)
+{
+  rot_enabled=false;
+
+  rot_flush_timer=new QTimer(this);
+  connect(rot_flush_timer,SIGNAL(timeout()),this,SLOT(flushData()));
+
+  if(rot_exit_pid<0) {
+    atexit(RDCutRotationExit);
+  }
+  rot_exit_rotation=this;
+  rot_exit_pid=getpid();
+}
+
+
+RDCutRotation::~RDCutRotation()
+{
+  if(rot_exit_rotation==this) {
+    rot_exit_rotation=NULL;
+  }
+  flush();
+  for(std::map<unsigned,RDCutRotationCart *>::const_iterator it=
+	rot_carts.begin();it!=rot_carts.end();it++) {
+    delete it->second;
+  }
+}
+
+
+bool RDCutRotation::isEnabled() const
+{
+  return rot_enabled;
+}
+
+
+void RDCutRotation::setEnabled(bool state)
+{
+  if(rot_enabled!=state) {
+    flush();
+    for(std::map<unsigned,RDCutRotationCart *>::const_iterator it=
+	  rot_carts.begin();it!=rot_carts.end();it++) {
+      delete it->second;
+    }
+    rot_carts.clear();
+    rot_enabled=state;
+  }
+}
+
+
+bool RDCutRotation::selectCut(unsigned cartnum,const QTime &time,
+			      QString *cutname)
+{
+  RDCutRotationCart *cart=NULL;
+  std::vector<RDCutRotationCut *> cuts;
+
+  if(!rot_enabled) {
+    return false;
+  }
+  std::map<unsigned,RDCutRotationCart *>::iterator it=rot_carts.find(cartnum);
+  if(it!=rot_carts.end()) {
+    if(it->second->loaded_datetime.secsTo(QDateTime::currentDateTime())<
+       RDCUTROTATION_MAX_AGE) {
+      cart=it->second;
+    }
+    else {
+      delete it->second;
+      rot_carts.erase(it);
+    }
+  }
+  if(cart==NULL) {
+    if((cart=Load(cartnum))==NULL) {
+      return false;
+    }
+    rot_carts[cartnum]=cart;
+  }
+
+  //
+  // Dated and daypart-restricted cuts are compared to the second, as the
+  // database does
+  //
+  QDateTime dt(QDate::currentDate(),
+	       QTime(time.hour(),time.minute(),time.second()));
+  if(cart->audio) {
+    for(unsigned i=0;i<cart->cuts.size();i++) {
+      if((!cart->cuts[i].evergreen)&&cart->cuts[i].isValid(dt)) {
+	cuts.push_back(&cart->cuts[i]);
+      }
+    }
+    *cutname=NextCut(&cuts,cart->use_weighting,false);
+  }
+  else {
+    *cutname="";
+  }
+  if(cutname->isEmpty()) {   // No valid cuts, try the evergreen
+    cuts.clear();
+    for(unsigned i=0;i<cart->cuts.size();i++) {
+      if(cart->cuts[i].evergreen) {
+	cuts.push_back(&cart->cuts[i]);
+      }
+    }
+    *cutname=NextCut(&cuts,cart->use_weighting,true);
+  }
+
+  return true;
+}
+
+
+void RDCutRotation::logPlayout(const QString &cutname)
+{
+  QDateTime now(QDate::currentDate(),QTime::currentTime());
+
+  RDCutRotationPlay &play=rot_plays[cutname];
+  play.plays++;
+  play.last_play_datetime=now;
+
+  std::map<unsigned,RDCutRotationCart *>::const_iterator it=
+    rot_carts.find(cutname.left(6).toUInt());
+  if(it!=rot_carts.end()) {
+    for(unsigned i=0;i<it->second->cuts.size();i++) {
+      RDCutRotationCut *cut=&it->second->cuts[i];
+      if(cut->cut_name==cutname) {
+	cut->local_counter++;
+	cut->last_play_datetime=
+	  QDateTime(now.date(),QTime(now.time().hour(),now.time().minute(),
+				     now.time().second()));
+      }
+    }
+  }
+  if(!rot_flush_timer->isActive()) {
+    rot_flush_timer->start(RDCUTROTATION_FLUSH_INTERVAL,true);
+  }
+}
+
+
+void RDCutRotation::invalidate(unsigned cartnum)
+{
+  std::map<unsigned,RDCutRotationCart *>::iterator it=rot_carts.find(cartnum);
+  if(it!=rot_carts.end()) {
+    delete it->second;
+    rot_carts.erase(it);
+  }
+}
+
+
+void RDCutRotation::flush()
+{
+  QString sql;
+  RDSqlQuery *q;
+
+  rot_flush_timer->stop();
+  for(std::map<QString,RDCutRotationPlay>::const_iterator it=
+	rot_plays.begin();it!=rot_plays.end();it++) {
+    sql=QString("update CUTS set ")+
+      "LAST_PLAY_DATETIME=\""+
+      it->second.last_play_datetime.toString("yyyy-MM-dd hh:mm:ss")+"\","+
+      QString().sprintf("PLAY_COUNTER=PLAY_COUNTER+%d,",it->second.plays)+
+      QString().sprintf("LOCAL_COUNTER=LOCAL_COUNTER+%d ",it->second.plays)+
+      "where CUT_NAME=\""+RDEscapeString(it->first)+"\"";
+    q=new RDSqlQuery(sql);
+    delete q;
+  }
+  rot_plays.clear();
+}
+
+
+void RDCutRotation::notificationReceivedData(RDNotification *notify)
+{
+  if(notify->type()==RDNotification::CartType) {
+    for(unsigned i=0;i<notify->idQuantity();i++) {
+      invalidate(notify->id(i).toUInt());
+    }
+  }
+}
+
+
+void RDCutRotation::notificationsMissedData(const QString &source)
+{
+  std::map<unsigned,RDCutRotationCart *>::const_iterator it;
+
+  for(it=rot_carts.begin();it!=rot_carts.end();it++) {
+    delete it->second;
+  }
+  rot_carts.clear();
+}
+
+
+void RDCutRotation::flushData()
+{
+  flush();
+}
+
+
+RDCutRotationCart *RDCutRotation::Load(unsigned cartnum)
+{
+  QString sql;
+  RDSqlQuery *q;
+  RDCutRotationCart *cart=NULL;
+
+  sql=QString("select ")+
+    "TYPE,"+            // 00
+    "USE_WEIGHTING "+   // 01
+    "from CART where "+
+    QString().sprintf("NUMBER=%u",cartnum);
+  q=new RDSqlQuery(sql);
+  if(q->first()) {
+    cart=new RDCutRotationCart();
+    cart->audio=(q->value(0).toUInt()==RDCart::Audio);
+    cart->use_weighting=(q->value(1).toString()=="Y");
+    cart->loaded_datetime=QDateTime::currentDateTime();
+  }
+  delete q;
+  if(cart==NULL) {
+    return NULL;
+  }
+
+  sql=QString("select ")+
+    "CUT_NAME,"+            // 00
+    "PLAY_ORDER,"+          // 01
+    "WEIGHT,"+              // 02
+    "LOCAL_COUNTER,"+       // 03
+    "EVERGREEN,"+           // 04
+    "LAST_PLAY_DATETIME,"+  // 05
+    "START_DATETIME,"+      // 06
+    "END_DATETIME,"+        // 07
+    "START_DAYPART,"+       // 08
+    "END_DAYPART,"+         // 09
+    "MON,"+                 // 10
+    "TUE,"+                 // 11
+    "WED,"+                 // 12
+    "THU,"+                 // 13
+    "FRI,"+                 // 14
+    "SAT,"+                 // 15
+    "SUN "+                 // 16
+    "from CUTS where "+
+    QString().sprintf("(CART_NUMBER=%u)&&",cartnum)+
+    "(LENGTH>0)";
+  q=new RDSqlQuery(sql);
+  while(q->next()) {
+    RDCutRotationCut cut;
+    cut.cut_name=q->value(0).toString();
+    cut.play_order=q->value(1).toInt();
+    cut.weight=q->value(2).toInt();
+    cut.local_counter=q->value(3).toInt();
+    cut.evergreen=(q->value(4).toString()=="Y");
+    if(!q->value(5).isNull()) {
+      cut.last_play_datetime=q->value(5).toDateTime();
+    }
+    if(!q->value(6).isNull()) {
+      cut.start_datetime=q->value(6).toDateTime();
+    }
+    if(!q->value(7).isNull()) {
+      cut.end_datetime=q->value(7).toDateTime();
+    }
+    if(!q->value(8).isNull()) {
+      cut.start_daypart=q->value(8).toTime();
+    }
+    if(!q->value(9).isNull()) {
+      cut.end_daypart=q->value(9).toTime();
+    }
+    for(int i=0;i<7;i++) {
+      cut.days[i]=(q->value(10+i).toString()=="Y");
+    }
+
+    //
+    // Plays not yet written to the database
+    //
+    std::map<QString,RDCutRotationPlay>::const_iterator it=
+      rot_plays.find(cut.cut_name);
+    if(it!=rot_plays.end()) {
+      cut.local_counter+=it->second.plays;
+      cut.last_play_datetime=it->second.last_play_datetime;
+    }
+    cart->cuts.push_back(cut);
+  }
+  delete q;
+
+  return cart;
+}
+
+
+QString RDCutRotation::NextCut(std::vector<RDCutRotationCut *> *cuts,
+			       bool weighted,bool evergreen) const
+{
+  QString cutname;
+  double ratio;
+  double play_ratio=100000000.0;
+  int play=RD_MAX_CUT_NUMBER+1;
+  int last_play;
+
+  if(weighted) {
+    std::stable_sort(cuts->begin(),cuts->end(),
+		     evergreen?EvergreenWeightedOrder:WeightedOrder);
+    for(unsigned i=0;i<cuts->size();i++) {
+      if((ratio=(double)cuts->at(i)->local_counter/
+	  (double)cuts->at(i)->weight)<play_ratio) {
+	play_ratio=ratio;
+	cutname=cuts->at(i)->cut_name;
+      }
+    }
+  }
+  else {
+    std::stable_sort(cuts->begin(),cuts->end(),
+		     evergreen?EvergreenUnweightedOrder:UnweightedOrder);
+    if(cuts->size()>0) {
+      last_play=cuts->at(0)->play_order;
+      for(unsigned i=1;i<cuts->size();i++) {
+	if((cuts->at(i)->play_order>last_play)&&
+	   (cuts->at(i)->play_order<play)) {
+	  play=cuts->at(i)->play_order;
+	  cutname=cuts->at(i)->cut_name;
+	}
+      }
+      if(!cutname.isEmpty()) {
+	return cutname;
+      }
+    }
+    for(unsigned i=0;i<cuts->size();i++) {
+      if(cuts->at(i)->play_order<play) {
+	play=cuts->at(i)->play_order;
+	cutname=cuts->at(i)->cut_name;
+      }
+    }
+  }
+  return cutname;
+}
@@ -0,0 +1,114 @@
+// rdcutrotation.h
+//
+// In-memory cut rotation state for RDCart::selectCut()
+//
+//   (C) Copyright 2018 Fred Gleason <fredg@paravelsystems.com>
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License version 2 as
+//   published by the Free Software Foundation.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public
+//   License along with this program; if not, write to the Free Software
+//   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+//
+
+#ifndef RDCUTROTATION_H
+#define RDCUTROTATION_H
+
+#include <map>
+#include <vector>
+
+#include <qdatetime.h>
+#include <qobject.h>
+#include <qtimer.h>
+
+#include <rdnotification.h>
+
+//
+// While enabled, the rotation fields of each cart's playable cuts are
+// loaded with one select on first use and cut selection is done in
+// memory.  An entry is dropped when a CART notification for it arrives
+// or after RDCUTROTATION_MAX_AGE seconds, whichever comes first, so
+// plays made on other hosts are picked up.  Play counter updates from
+// RDCut::logPlayout() are applied to the cached state at once and
+// written to the database in batches every RDCUTROTATION_FLUSH_INTERVAL
+// mS.
+//
+#define RDCUTROTATION_MAX_AGE 60
+#define RDCUTROTATION_FLUSH_INTERVAL 1000
+
+class RDCutRotationCut
+{
+ public:
+  RDCutRotationCut();
+  bool isValid(const QDateTime &dt) const;
+  QString cut_name;
+  int play_order;
+  int weight;
+  int local_counter;
+  bool evergreen;
+  QDateTime last_play_datetime;
+  QDateTime start_datetime;
+  QDateTime end_datetime;
+  QTime start_daypart;
+  QTime end_daypart;
+  bool days[7];
+};
+
+
+class RDCutRotationCart
+{
+ public:
+  RDCutRotationCart();
+  bool audio;
+  bool use_weighting;
+  QDateTime loaded_datetime;
+  std::vector<RDCutRotationCut> cuts;
+};
+
+
+class RDCutRotationPlay
+{
+ public:
+  RDCutRotationPlay();
+  int plays;
+  QDateTime last_play_datetime;
+};
+
+
+class RDCutRotation : public QObject
+{
+  Q_OBJECT;
+ public:
+  RDCutRotation(QObject *parent=0);
+  ~RDCutRotation();
+  bool isEnabled() const;
+  void setEnabled(bool state);
+  bool selectCut(unsigned cartnum,const QTime &time,QString *cutname);
+  void logPlayout(const QString &cutname);
+  void invalidate(unsigned cartnum);
+  void flush();
+
+ private slots:
+  void notificationReceivedData(RDNotification *notify);
+  void notificationsMissedData(const QString &source);
+  void flushData();
+
+ private:
+  RDCutRotationCart *Load(unsigned cartnum);
+  QString NextCut(std::vector<RDCutRotationCut *> *cuts,bool weighted,
+		  bool evergreen) const;
+  std::map<unsigned,RDCutRotationCart *> rot_carts;
+  std::map<QString,RDCutRotationPlay> rot_plays;
+  QTimer *rot_flush_timer;
+  bool rot_enabled;
+};
+
+
+#endif  // RDCUTROTATION_H
@@ -33,6 +33,7 @@
 
 static QSqlDatabase *db = NULL;
 static RDSqlDatabaseStatus * dbStatus = NULL;
+static unsigned rdsqlquery_count = 0;
 
 QSqlDatabase *RDInitDb (unsigned *schema,QString *error)
 {
@@ -84,6 +85,7 @@ RDSqlQuery::RDSqlQuery(const QString &query,bool reconnect):
   QSqlQuery (query)
 {
   //printf("lastQuery: %s\n",(const char *)lastQuery());
+  rdsqlquery_count++;
 
   // With any luck, by the time we get here, we have already done the biz...
   unsigned schema;
@@ -167,6 +169,12 @@ int RDSqlQuery::rows(const QString &sql)
 }
 
 
+unsigned RDSqlQuery::queryCount()
+{
+  return rdsqlquery_count;
+}
+
+
 void RDSqlDatabaseStatus::sendRecon()
 {
   if (discon){
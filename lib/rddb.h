@@ -52,6 +52,7 @@ class RDSqlQuery : public QSqlQuery
   static QVariant run(const QString &sql,bool *ok=NULL);
   static bool apply(const QString &sql,QString *err_msg);
   static int rows(const QString &sql);
+  static unsigned queryCount();
 };
 
 // Setup the default database, returns true on success.
@@ -28,6 +28,7 @@
 #include <curl/curl.h>
 
 #include <qapplication.h>
+#include <qdatetime.h>
 #include <qfileinfo.h>
 
 #include <rd.h>
@@ -50,6 +51,14 @@ int DownloadProgressCallback(void *clientp,double dltotal,double dlnow,
 }
 
 
+size_t DownloadWriteCallback(void *ptr,size_t size,size_t nmemb,
+			     void *userdata)
+{
+  RDDownload *conv=(RDDownload *)userdata;
+  return conv->WriteData(ptr,size*nmemb);
+}
+
+
 int DownloadErrorCallback(CURL *curl,curl_infotype type,char *msg,size_t size,
 			void *clientp)
 {
@@ -73,6 +82,16 @@ RDDownload::RDDownload(RDConfig *config,QObject *parent)
 {
   conv_config=config;
   conv_aborting=false;
+  conv_curl=NULL;
+  conv_dst_file=NULL;
+  conv_dst_offset=0.0;
+  conv_offset_checked=false;
+  conv_restarted=false;
+  conv_range_done=false;
+  conv_range_rejected=false;
+  conv_max_resumes=RDDOWNLOAD_MAX_RESUMES;
+  conv_resumes=0;
+  conv_elapsed_msecs=0;
 }
 
 
@@ -96,6 +115,18 @@ int RDDownload::totalSteps() const
 }
 
 
+int RDDownload::maximumResumes() const
+{
+  return conv_max_resumes;
+}
+
+
+void RDDownload::setMaximumResumes(int n)
+{
+  conv_max_resumes=n;
+}
+
+
 RDDownload::ErrorCode RDDownload::runDownload(const QString &username,
 					      const QString &password,
 					      bool log_debug)
@@ -135,7 +166,8 @@ RDDownload::ErrorCode RDDownload::runDownload(const QString &username,
   strncpy(url,conv_src_url.
 	  toString(conv_src_url.protocol().lower().left(4)=="http"),1024);
   curl_easy_setopt(curl,CURLOPT_URL,url);
-  curl_easy_setopt(curl,CURLOPT_WRITEDATA,f);
+  curl_easy_setopt(curl,CURLOPT_WRITEFUNCTION,DownloadWriteCallback);
+  curl_easy_setopt(curl,CURLOPT_WRITEDATA,this);
   strncpy(userpwd,username+":"+password,256);
   curl_easy_setopt(curl,CURLOPT_USERPWD,userpwd);
   curl_easy_setopt(curl,CURLOPT_TIMEOUT,RD_CURL_TIMEOUT);
@@ -154,16 +186,61 @@ RDDownload::ErrorCode RDDownload::runDownload(const QString &username,
     setegid(user->gid());
     seteuid(user->uid());
   }
-  switch((curl_err=curl_easy_perform(curl))) {
+  conv_curl=curl;
+  conv_dst_file=f;
+  conv_dst_offset=0.0;
+  conv_resumes=0;
+  conv_restarted=false;
+  conv_range_done=false;
+  conv_range_rejected=false;
+  QTime elapsed;
+  elapsed.start();
+
+  //
+  // Interrupted transfers are picked up from where they left off by means
+  // of a range request (HTTP) or REST (FTP) rather than started over.
+  //
+  while(Resumable(curl_err=curl_easy_perform(curl))&&
+	(conv_resumes<conv_max_resumes)&&(!conv_aborting)) {
+    fflush(conv_dst_file);
+    conv_dst_offset=(double)ftell(conv_dst_file);
+    conv_offset_checked=false;
+    conv_resumes++;
+    syslog(LOG_WARNING,
+	   "download of %s interrupted [%s], resuming at byte %.0lf",
+	   (const char *)conv_src_url.toString(),
+	   curl_easy_strerror(curl_err),conv_dst_offset);
+    curl_easy_setopt(curl,CURLOPT_RESUME_FROM_LARGE,
+		     (curl_off_t)conv_dst_offset);
+  }
+  conv_elapsed_msecs=elapsed.elapsed();
+
+  switch(curl_err) {
   case CURLE_OK:
     if(conv_src_url.protocol().lower()=="http") {
       curl_easy_getinfo(curl,CURLINFO_RESPONSE_CODE,&response_code);
-      if(response_code!=200) {
+      if((response_code==416)&&(conv_resumes>0)) {
+	//
+	// The range starts at the end of the file, so we already have
+	// all of it
+	//
+	conv_range_done=true;
+      }
+      if((response_code!=200)&&(response_code!=206)&&(!conv_range_done)) {
 	ret=RDDownload::ErrorUrlInvalid;
       }
     }
     break;
 
+  case CURLE_WRITE_ERROR:
+    if(conv_range_rejected) {
+      ret=RDDownload::ErrorRemoteServer;
+    }
+    else {
+      ret=RDDownload::ErrorNoDestination;
+    }
+    break;
+
   case CURLE_UNSUPPORTED_PROTOCOL:
     ret=RDDownload::ErrorUnsupportedProtocol;
     break;
@@ -204,7 +281,11 @@ RDDownload::ErrorCode RDDownload::runDownload(const QString &username,
 	   (const char *)username);
   }
   curl_easy_cleanup(curl);
-  fclose(f);
+  if(conv_dst_file!=NULL) {
+    fclose(conv_dst_file);
+  }
+  conv_curl=NULL;
+  conv_dst_file=NULL;
 
   return ret;
 }
@@ -216,6 +297,35 @@ bool RDDownload::aborting() const
 }
 
 
+double RDDownload::bytesDownloaded() const
+{
+  return conv_dst_offset;
+}
+
+
+int RDDownload::resumeCount() const
+{
+  return conv_resumes;
+}
+
+
+bool RDDownload::restarted() const
+{
+  //
+  // True if the server ignored a range request and the download was
+  // started over in a new destination file, so that anything still
+  // reading the original one will not see the rest of the data
+  //
+  return conv_restarted;
+}
+
+
+int RDDownload::elapsedMsecs() const
+{
+  return conv_elapsed_msecs;
+}
+
+
 QString RDDownload::errorText(RDDownload::ErrorCode err)
 {
   QString ret=QString().sprintf("Unknown Error [%u]",err);
@@ -291,3 +401,71 @@ void RDDownload::UpdateProgress(int step)
 {
   emit progressChanged(step);
 }
+
+
+size_t RDDownload::WriteData(void *ptr,size_t bytes)
+{
+  long response_code=0;
+
+  //
+  // Only a 206 continues a resumed HTTP transfer.  A server that ignores
+  // the range request sends the whole file again, so start over in a new
+  // file -- the partial one may still be being read (see
+  // RDAudioConvert::setSourceChaseWait()), so is never truncated.  A 416
+  // means the range starts at the end of the file, so the body is just
+  // an error page.
+  //
+  if((conv_dst_offset>0.0)&&(!conv_offset_checked)) {
+    conv_offset_checked=true;
+    if(conv_src_url.protocol().lower().left(4)=="http") {
+      curl_easy_getinfo((CURL *)conv_curl,CURLINFO_RESPONSE_CODE,
+			&response_code);
+      switch(response_code) {
+      case 206:
+	break;
+
+      case 200:
+	fclose(conv_dst_file);
+	unlink(conv_dst_filename);
+	if((conv_dst_file=fopen(conv_dst_filename,"w"))==NULL) {
+	  return 0;
+	}
+	conv_dst_offset=0.0;
+	conv_restarted=true;
+	break;
+
+      case 416:
+	conv_range_done=true;
+	break;
+
+      default:
+	conv_range_rejected=true;
+	return 0;
+      }
+    }
+  }
+  if(conv_range_done) {
+    return bytes;
+  }
+  size_t n=fwrite(ptr,1,bytes,conv_dst_file);
+  conv_dst_offset+=(double)n;
+
+  return n;
+}
+
+
+bool RDDownload::Resumable(int curl_err) const
+{
+  switch(curl_err) {
+  case CURLE_PARTIAL_FILE:
+  case CURLE_OPERATION_TIMEDOUT:
+  case CURLE_RECV_ERROR:
+  case CURLE_SEND_ERROR:
+  case CURLE_GOT_NOTHING:
+    return true;
+
+  default:
+    break;
+  }
+  return false;
+}
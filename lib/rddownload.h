@@ -21,11 +21,18 @@
 #ifndef RDDOWNLOAD_H
 #define RDDOWNLOAD_H
 
+#include <stdio.h>
+
 #include <qobject.h>
 #include <qurl.h>
 
 #include <rdconfig.h>
 
+//
+// Number of times an interrupted transfer will be resumed before giving up
+//
+#define RDDOWNLOAD_MAX_RESUMES 5
+
 class RDDownload : public QObject
 {
   Q_OBJECT;
@@ -40,10 +47,16 @@ class RDDownload : public QObject
   void setSourceUrl(const QString &url);
   void setDestinationFile(const QString &filename);
   int totalSteps() const;
+  int maximumResumes() const;
+  void setMaximumResumes(int n);
   RDDownload::ErrorCode runDownload(const QString &username,
 				    const QString &password,
 				    bool log_debug);
   bool aborting() const;
+  double bytesDownloaded() const;
+  int resumeCount() const;
+  bool restarted() const;
+  int elapsedMsecs() const;
   static QString errorText(RDDownload::ErrorCode err);
 
  public slots:
@@ -54,13 +67,27 @@ class RDDownload : public QObject
 
  private:
   void UpdateProgress(int step);
+  size_t WriteData(void *ptr,size_t bytes);
+  bool Resumable(int curl_err) const;
   friend int DownloadProgressCallback(void *clientp,double dltotal,double dlnow,
 				      double ultotal,double ulnow);
+  friend size_t DownloadWriteCallback(void *ptr,size_t size,size_t nmemb,
+				      void *userdata);
   QUrl conv_src_url;
   QString conv_dst_filename;
   bool conv_aborting;
   uint conv_dst_size;
   RDConfig *conv_config;
+  void *conv_curl;
+  FILE *conv_dst_file;
+  double conv_dst_offset;
+  bool conv_offset_checked;
+  bool conv_restarted;
+  bool conv_range_done;
+  bool conv_range_rejected;
+  int conv_max_resumes;
+  int conv_resumes;
+  int conv_elapsed_msecs;
 };
 
 
@@ -746,11 +746,8 @@ RDEditAudio::RDEditAudio(RDCart *cart,QString cut_name,int card,
   //
   // The Wave Forms
   //
-  edit_peaks=new RDPeaksExport(this);
   RDPeaksExport::ErrorCode conv_err;
-  edit_peaks->setCartNumber(RDCut::cartNumber(cut_name));
-  edit_peaks->setCutNumber(RDCut::cutNumber(cut_name));
-  if((conv_err=edit_peaks->runExport(rda->user()->name(),rda->user()->password()))!=
+  if((conv_err=rda->peaksCache()->load(cut_name,&edit_energy))!=
      RDPeaksExport::ErrorOk) {
     QMessageBox::warning(this,tr("Rivendell Web Service"),
 			 tr("Unable to download peak data, error was:\n\"")+
@@ -902,7 +899,6 @@ RDEditAudio::RDEditAudio(RDCart *cart,QString cut_name,int card,
 
 RDEditAudio::~RDEditAudio()
 {
-  delete edit_peaks;
 }
 
 
@@ -941,7 +937,7 @@ void RDEditAudio::xFullIn()
 {
   if(edit_factor_x!=0.125) {
     edit_factor_x=0.125;
-    edit_hscroll->setRange(0,(int)((double)edit_peaks->energySize()/
+    edit_hscroll->setRange(0,(int)((double)edit_energy.size()/
 				   (double)edit_channels*
 				   (1.0-edit_factor_x/edit_max_factor_x)));
     CenterDisplay();
@@ -959,7 +955,7 @@ void RDEditAudio::xUp()
       edit_hscroll->setRange(0,0);
     }
     else {
-      edit_hscroll->setRange(0,(int)((double)edit_peaks->energySize()/
+      edit_hscroll->setRange(0,(int)((double)edit_energy.size()/
 				     (double)edit_channels*
 				     (1.0-edit_factor_x/edit_max_factor_x)));
     }
@@ -978,7 +974,7 @@ void RDEditAudio::xDown()
       edit_hscroll->setRange(0,0);
     }
     else {
-      edit_hscroll->setRange(0,(int)((double)edit_peaks->energySize()/
+      edit_hscroll->setRange(0,(int)((double)edit_energy.size()/
 				     (double)edit_channels*
 				     (1.0-edit_factor_x/edit_max_factor_x)));
     }
@@ -2784,7 +2780,7 @@ void RDEditAudio::DrawWave(int xsize,int ysize,int chan,QString label,
 		      (double)edit_channels+
 		      (double)edit_channels*
 		      (double)origin_x);
-    if(offset>=edit_peaks->energySize()) {
+    if(offset>=edit_energy.size()) {
       //    if(offset>=edit_wave->energySize()) {
       p->fillRect(i,1,xsize-i,ysize-2,
 		  QBrush(QColor(EDITAUDIO_HIGHLIGHT_COLOR)));
@@ -2802,14 +2798,14 @@ void RDEditAudio::DrawWave(int xsize,int ysize,int chan,QString label,
   p->lineTo(xsize,vert-ref_line);
 
   p->translate(1,ysize/2);
-  if(edit_peaks->energySize()>0) {
+  if(edit_energy.size()>0) {
     //  if(edit_wave->energySize()>0) {
 
     //
     // Time Tick Marks
     //
     p->setFont(QFont("Helvetica",8,QFont::Normal));
-    for(unsigned i=0;i<2*edit_peaks->energySize();
+    for(unsigned i=0;i<2*edit_energy.size();
 	i+=(int)(edit_factor_x*(double)edit_sample_rate/576.0)) {
       offset=(int)((double)(i-origin_x)/edit_factor_x);
       if((offset>0)&&(offset<(EDITAUDIO_WAVEFORM_WIDTH-2))) {
@@ -2837,9 +2833,9 @@ void RDEditAudio::DrawWave(int xsize,int ysize,int chan,QString label,
 			(double)edit_channels+
 			(double)edit_channels*
 			(double)origin_x+(double)chan);
-      if(offset<edit_peaks->energySize()) {
+      if(offset<edit_energy.size()) {
 	edit_wave_array->setPoint(i,i+(int)((double)chan/(2.0*edit_factor_x)),
-				  (int)(edit_peaks->energy(offset)*ysize*
+				  (int)(edit_energy[offset]*ysize*
 					size_y/65534));
       }
       else {
@@ -2855,9 +2851,9 @@ void RDEditAudio::DrawWave(int xsize,int ysize,int chan,QString label,
 			(double)edit_channels+
 			(double)edit_channels*
 			(double)origin_x+(double)chan);
-      if(offset<edit_peaks->energySize()) {
+      if(offset<edit_energy.size()) {
 	edit_wave_array->setPoint(i,i+(int)((double)chan/(2.0*edit_factor_x)),
-			      (int)(-edit_peaks->energy(offset)*
+			      (int)(-edit_energy[offset]*
 				    ysize*size_y/65534));
       }
       else {
@@ -21,6 +21,8 @@
 #ifndef RDEDIT_AUDIO_H
 #define RDEDIT_AUDIO_H
 
+#include <vector>
+
 #include <qdialog.h>
 #include <qscrollbar.h>
 #include <qpixmap.h>
@@ -151,7 +153,7 @@ class RDEditAudio : public QDialog
   void CenterDisplay();
   int GetTime(int samples);
   RDCut *edit_cut;
-  RDPeaksExport *edit_peaks;
+  std::vector<unsigned short> edit_energy;
   unsigned edit_sample_rate;
   unsigned edit_sample_length;
   unsigned edit_channels;
@@ -454,7 +454,7 @@ bool RDEventLine::save(RDConfig *config)
 }
 
 
-bool RDEventLine::generateLog(QString logname,const QString &svcname,
+bool RDEventLine::generateLog(RDLogLineBuffer *buf,const QString &svcname,
 			      QString *errors, unsigned artistsep,
 			      QString clockname)
 {
@@ -463,8 +463,6 @@ bool RDEventLine::generateLog(QString logname,const QString &svcname,
   RDSqlQuery *q1;
   QTime time=event_start_time;
   QTime fill_start_time;
-  int count=0;
-  logname.replace(" ","_");
   RDLogLine *logline;
   QString import_table;
   int postimport_length=0;
@@ -473,27 +471,7 @@ bool RDEventLine::generateLog(QString logname,const QString &svcname,
   RDLogLine::Type link_type=RDLogLine::MusicLink;
   bool post_point=event_post_point;
   int grace_time=event_grace_time;
-  int link_id=0;
-
-  //
-  // Get Current Count and Link ID
-  //
-  sql=QString().sprintf("select COUNT from `%s_LOG` order by COUNT desc",
-			(const char *)logname);
-  q=new RDSqlQuery(sql);
-  if(q->first()) {
-    count=q->value(0).toInt()+1;
-  }
-  delete q;
-
-  sql=QString().sprintf("select LINK_ID from `%s_LOG` where LINK_ID>=0 \
-                         order by LINK_ID desc",
-			(const char *)logname);
-  q=new RDSqlQuery(sql);
-  if(q->first()) {
-    link_id=q->value(0).toInt()+1;
-  }
-  delete q;
+  int link_id=buf->nextLinkId();
 
   //
   // Override Default Parameters if Preposition Set
@@ -514,22 +492,7 @@ bool RDEventLine::generateLog(QString logname,const QString &svcname,
   //
   for(int i=0;i<event_preimport_log->size();i++) {
     if((logline=event_preimport_log->logLine(i))!=NULL) {
-      sql=QString("insert into `")+logname+"_LOG` set "+
-	QString().sprintf("ID=%d,",count)+
-	QString().sprintf("COUNT=%d,",count)+
-	QString().sprintf("TYPE=%d,",logline->type())+
-	QString().sprintf("SOURCE=%d,",RDLogLine::Template)+
-	QString().sprintf("START_TIME=%d,",QTime().msecsTo(time))+
-	QString().sprintf("GRACE_TIME=%d,",grace_time)+
-	QString().sprintf("CART_NUMBER=%u,",logline->cartNumber())+
-	QString().sprintf("TIME_TYPE=%d,",time_type)+
-	"POST_POINT=\""+RDYesNo(post_point)+"\","+
-	QString().sprintf("TRANS_TYPE=%d,",logline->transType())+
-	"COMMENT=\""+RDEscapeString(logline->markerComment())+"\","+
-	QString().sprintf("EVENT_LENGTH=%d",event_length);
-      q=new RDSqlQuery(sql);
-      delete q;
-      count++;
+      AddImportLine(buf,logline,time,grace_time,time_type,post_point);
       time=time.addMSecs(GetLength(logline->cartNumber()));
       trans_type=event_default_transtype;
       time_type=RDLogLine::Relative;
@@ -564,28 +527,23 @@ bool RDEventLine::generateLog(QString logname,const QString &svcname,
     }
     QTime end_start_time=event_start_time.addMSecs(event_length);
 
-    sql=QString("insert into `")+logname+"_LOG` set "+
-      QString().sprintf("ID=%d,",count)+
-      QString().sprintf("COUNT=%d,",count)+
-      QString().sprintf("TYPE=%d,",link_type)+
-      QString().sprintf("SOURCE=%d,",RDLogLine::Template)+
-      QString().sprintf("START_TIME=%d,",QTime().msecsTo(time))+
-      QString().sprintf("GRACE_TIME=%d,",grace_time)+
-      QString().sprintf("TIME_TYPE=%d,",time_type)+
-      "POST_POINT=\""+RDYesNo(post_point)+"\","+
-      QString().sprintf("TRANS_TYPE=%d,",trans_type)+
-      "LINK_EVENT_NAME=\""+RDEscapeString(event_name)+"\","+
-      QString().sprintf("LINK_START_TIME=%d,",
-			QTime().msecsTo(event_start_time))+
-      QString().sprintf("LINK_LENGTH=%d,",
-			event_start_time.msecsTo(end_start_time))+
-      QString().sprintf("LINK_ID=%d,",link_id)+
-      QString().sprintf("LINK_START_SLOP=%d,",event_start_slop)+
-      QString().sprintf("LINK_END_SLOP=%d,",event_end_slop)+
-      QString().sprintf("EVENT_LENGTH=%d",event_length);
-    q=new RDSqlQuery(sql);
-    delete q;
-    count++;
+    buf->addLine();
+    buf->setValue(RDLogLineBuffer::Type,link_type);
+    buf->setValue(RDLogLineBuffer::Source,RDLogLine::Template);
+    buf->setValue(RDLogLineBuffer::StartTime,QTime().msecsTo(time));
+    buf->setValue(RDLogLineBuffer::GraceTime,grace_time);
+    buf->setValue(RDLogLineBuffer::TimeType,time_type);
+    buf->setValue(RDLogLineBuffer::PostPoint,RDYesNo(post_point));
+    buf->setValue(RDLogLineBuffer::TransType,trans_type);
+    buf->setValue(RDLogLineBuffer::LinkEventName,event_name);
+    buf->setValue(RDLogLineBuffer::LinkStartTime,
+		  QTime().msecsTo(event_start_time));
+    buf->setValue(RDLogLineBuffer::LinkLength,
+		  event_start_time.msecsTo(end_start_time));
+    buf->setValue(RDLogLineBuffer::LinkId,link_id);
+    buf->setValue(RDLogLineBuffer::LinkStartSlop,event_start_slop);
+    buf->setValue(RDLogLineBuffer::LinkEndSlop,event_end_slop);
+    buf->setValue(RDLogLineBuffer::EventLength,event_length);
     time=time.addMSecs(event_length);
     trans_type=event_default_transtype;
     time_type=RDLogLine::Relative;
@@ -818,23 +776,19 @@ bool RDEventLine::generateLog(QString logname,const QString &svcname,
 // end of deconflicting rules
       
       int schedpos=rand()%schedCL->getNumberOfItems();
-      sql=QString("insert into `")+logname+"_LOG` set "+
-	QString().sprintf("ID=%d,",count)+
-	QString().sprintf("COUNT=%d,",count)+
-	QString().sprintf("TYPE=%d,",RDLogLine::Cart)+
-	QString().sprintf("SOURCE=%d,",source)+
-	QString().sprintf("START_TIME=%d,",QTime().msecsTo(time))+
-	QString().sprintf("GRACE_TIME=%d,",grace_time)+
-	QString().sprintf("CART_NUMBER=%u,",schedCL->getItemCartnumber(schedpos))+
-	QString().sprintf("TIME_TYPE=%d,",time_type)+
-	"POST_POINT=\""+RDYesNo(post_point)+"\","+
-	QString().sprintf("TRANS_TYPE=%d,",trans_type)+
-	"EXT_START_TIME="+RDCheckDateTime(time,"hh:mm:ss")+","+
-	QString().sprintf("EVENT_LENGTH=%d",event_length);
-      q=new RDSqlQuery(sql);
-      delete q;
-
-      count++;
+      buf->addLine();
+      buf->setValue(RDLogLineBuffer::Type,RDLogLine::Cart);
+      buf->setValue(RDLogLineBuffer::Source,source);
+      buf->setValue(RDLogLineBuffer::StartTime,QTime().msecsTo(time));
+      buf->setValue(RDLogLineBuffer::GraceTime,grace_time);
+      buf->setValue(RDLogLineBuffer::CartNumber,
+		    schedCL->getItemCartnumber(schedpos));
+      buf->setValue(RDLogLineBuffer::TimeType,time_type);
+      buf->setValue(RDLogLineBuffer::PostPoint,RDYesNo(post_point));
+      buf->setValue(RDLogLineBuffer::TransType,trans_type);
+      buf->setSqlValue(RDLogLineBuffer::ExtStartTime,
+		       RDCheckDateTime(time,"hh:mm:ss"));
+      buf->setValue(RDLogLineBuffer::EventLength,event_length);
 
       sql=QString("insert into `")+svcname_rp+"_STACK` set "+
 	"SCHEDULED_AT=now(),"+
@@ -858,22 +812,7 @@ bool RDEventLine::generateLog(QString logname,const QString &svcname,
   //
   for(int i=0;i<event_postimport_log->size();i++) {
     if((logline=event_postimport_log->logLine(i))!=NULL) {
-      sql=QString("insert into `")+logname+"_LOG` set "+
-	QString().sprintf("ID=%d,",count)+
-	QString().sprintf("COUNT=%d,",count)+
-	QString().sprintf("TYPE=%d,",logline->type())+
-	QString().sprintf("SOURCE=%d,",RDLogLine::Template)+
-	QString().sprintf("START_TIME=%d,",QTime().msecsTo(time))+
-	QString().sprintf("GRACE_TIME=%d,",grace_time)+
-	QString().sprintf("CART_NUMBER=%u,",logline->cartNumber())+
-	QString().sprintf("TIME_TYPE=%d,",time_type)+
-	"POST_POINT=\""+RDYesNo(post_point)+"\","+
-	QString().sprintf("TRANS_TYPE=%d,",logline->transType())+
-	"COMMENT=\""+RDEscapeString(logline->markerComment())+"\","+
-	QString().sprintf("EVENT_LENGTH=%d",event_length);
-      q=new RDSqlQuery(sql);
-      delete q;
-      count++;
+      AddImportLine(buf,logline,time,grace_time,time_type,post_point);
       time=time.addMSecs(GetLength(logline->cartNumber()));
       time_type=RDLogLine::Relative;
       trans_type=event_default_transtype;
@@ -973,7 +912,8 @@ bool RDEventLine::linkLog(RDLogEvent *e,const QString &svcname,
     "TITLE,"+           // 10
     "TRACK_STRING,"+    // 11
     "LINK_START_TIME,"+ // 12
-    "LINK_LENGTH "+     // 13
+    "LINK_LENGTH,"+     // 13
+    "CART_FORCED_LENGTH "+  // 14
     "from `"+import_table+"` where "+
     QString().sprintf("(START_HOUR=%d)&&",start_start_hour)+
     QString().sprintf("(START_SECS>=%d)&&",start_start_secs/1000)+
@@ -981,7 +921,10 @@ bool RDEventLine::linkLog(RDLogEvent *e,const QString &svcname,
     "(EVENT_USED=\"N\") order by ID";
   q=new RDSqlQuery(sql);
   while(q->next()) {
-    int length=GetLength(q->value(0).toUInt(),q->value(2).toInt());
+    int length=q->value(2).toInt();
+    if(!q->value(14).isNull()) {  // Set by RDSvc::import() if the cart exists
+      length=q->value(14).toInt();
+    }
     if(q->value(9).toUInt()==RDEventLine::InsertBreak) {
       if(q->value(7).toString()=="Y") {  // Insert Break
 	if((!event_nested_event.isEmpty()&&(event_nested_event!=event_name))) {
@@ -1217,6 +1160,24 @@ bool RDEventLine::linkLog(RDLogEvent *e,const QString &svcname,
 }
 
 
+void RDEventLine::AddImportLine(RDLogLineBuffer *buf,RDLogLine *logline,
+				const QTime &time,int grace_time,
+				RDLogLine::TimeType time_type,bool post_point)
+{
+  buf->addLine();
+  buf->setValue(RDLogLineBuffer::Type,logline->type());
+  buf->setValue(RDLogLineBuffer::Source,RDLogLine::Template);
+  buf->setValue(RDLogLineBuffer::StartTime,QTime().msecsTo(time));
+  buf->setValue(RDLogLineBuffer::GraceTime,grace_time);
+  buf->setValue(RDLogLineBuffer::CartNumber,logline->cartNumber());
+  buf->setValue(RDLogLineBuffer::TimeType,time_type);
+  buf->setValue(RDLogLineBuffer::PostPoint,RDYesNo(post_point));
+  buf->setValue(RDLogLineBuffer::TransType,logline->transType());
+  buf->setValue(RDLogLineBuffer::Comment,logline->markerComment());
+  buf->setValue(RDLogLineBuffer::EventLength,event_length);
+}
+
+
 int RDEventLine::GetLength(unsigned cartnum,int def_length)
 {
   RDCart *cart=new RDCart(cartnum);
@@ -26,6 +26,7 @@
 
 #include <rdlog_event.h>
 #include <rdlog_line.h>
+#include <rdloglinebuffer.h>
 
 class RDEventLine
 {
@@ -80,7 +81,7 @@ class RDEventLine
   void clear();
   bool load();
   bool save(RDConfig *config);
-  bool generateLog(QString logname,const QString &svcname,
+  bool generateLog(RDLogLineBuffer *buf,const QString &svcname,
 		   QString *errors, unsigned artistsep,QString clockname);
   bool linkLog(RDLogEvent *e,const QString &svcname,
 	       RDLogLine *link_logline,const QString &track_str,
@@ -88,6 +89,9 @@ class RDEventLine
 	       const QString &import_table,QString *errors);
   
  private:
+  void AddImportLine(RDLogLineBuffer *buf,RDLogLine *logline,
+		     const QTime &time,int grace_time,
+		     RDLogLine::TimeType time_type,bool post_point);
   int GetLength(unsigned cartnum,int def_length=0);
   QString event_name;
   QString event_properties;
@@ -18,8 +18,11 @@
 //   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
 //
 
+#include <errno.h>
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
+#include <sys/time.h>
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <fcntl.h>
@@ -175,6 +178,12 @@ QVariant RDFormPost::value(const QString &name,bool *ok)
 }
 
 
+void RDFormPost::setValue(const QString &name,const QVariant &value)
+{
+  post_values[name]=value;
+}
+
+
 bool RDFormPost::getValue(const QString &name,QHostAddress *addr,bool *ok)
 {
   QString str;
@@ -355,7 +364,9 @@ void RDFormPost::dump()
 void RDFormPost::dumpRawPost()
 {
   printf("Content-type: text/html\n\n");
-  printf("%s",post_data);
+  if(post_data!=NULL) {
+    printf("%s",post_data);
+  }
   fflush(stdout);
 }
 
@@ -516,108 +527,197 @@ void RDFormPost::LoadUrlEncoding(char first)
 
 void RDFormPost::LoadMultipartEncoding(char first)
 {
-  std::map<QString,QString> headers;
-  bool header=true;
-  post_data=NULL;
-  FILE *f=NULL;
-  ssize_t n=0;
-  QString sep;
+  //
+  // The body is read in RDFORMPOST_BUFFER_SIZE blocks and scanned for
+  // the part delimiter ("\r\n--<boundary>") with memmem(), so file parts
+  // go straight to disk in large writes and are never copied into a
+  // QString.  The last (delimiter length - 1) bytes of each block are
+  // held back in case the delimiter straddles two reads.
+  //
+  char *buf=NULL;
+  unsigned pos=0;
+  unsigned len=0;
+  char *ptr=NULL;
+  std::string delim;
+  std::string text;
+  QStringList lines;
   QString name;
   QString filename;
-  QString tempdir;
+  unsigned long long total=0;
+  struct timeval start;
+  struct timeval end;
   int fd=-1;
 
-  if((f=fdopen(0,"r"))==NULL) {
+  gettimeofday(&start,NULL);
+  if((buf=(char *)malloc(RDFORMPOST_BUFFER_SIZE))==NULL) {
     post_error=RDFormPost::ErrorInternal;
     return;
   }
+  buf[0]=first;
+  len=1;
+  total=1;
 
-  /*
-   * Uncomment this to dump the raw post data to "/tmp/output.dat".
-   */
-  /*
-  int out=open("/tmp/output.dat",O_WRONLY|O_CREAT);
-  while((n=getline(&post_data,(size_t *)&n,f))>0) {
-    write(out,post_data,n);
+  //
+  // Get the boundary
+  //
+  while((ptr=(char *)memchr(buf+pos,'\n',len-pos))==NULL) {
+    if(!FillBuffer(buf,&pos,&len,&total)) {
+      free(buf);
+      post_error=RDFormPost::ErrorMalformedData;
+      return;
+    }
   }
-  ::close(out);
-  printf("Content-type: text/html\n\n");
-  printf("POST DUMPED TO \"/tmp/output.dat\"!\n");
-  exit(0);
-  */
-
-  if((n=getline(&post_data,(size_t *)&n,f))<=0) {
-    post_error=RDFormPost::ErrorMalformedData;
-    return;
+  delim=std::string("\r\n")+std::string(buf+pos,ptr-buf-pos);
+  if(delim[delim.size()-1]=='\r') {
+    delim.erase(delim.size()-1);
   }
-  sep=QString(post_data).simplifyWhiteSpace();
+  pos=ptr-buf+1;
 
   //
   // Get message parts
   //
-  while((n=getline(&post_data,(size_t *)&n,f))>0) {
-    if(QString(post_data).simplifyWhiteSpace().contains(sep)>0) {  // End of part
-      if(fd>=0) {
-	ftruncate(fd,lseek(fd,0,SEEK_CUR)-2);  // Remove extraneous final CR/LF
-	::close(fd);
-	fd=-1;
+  while(true) {
+    //
+    // Read headers
+    //
+    while((ptr=(char *)memmem(buf+pos,len-pos,"\r\n\r\n",4))==NULL) {
+      if(!FillBuffer(buf,&pos,&len,&total)) {
+	free(buf);
+	post_error=RDFormPost::ErrorMalformedData;
+	return;
       }
-      name="";
-      filename="";
-      headers.clear();
-      header=true;
-      continue;
     }
-    if(header) {  // Read header
-      if(QString(post_data).simplifyWhiteSpace().isEmpty()) {
-	if(!headers["content-disposition"].isNull()) {
-	  QStringList fields;
-	  fields=fields.split(";",headers["content-disposition"]);
-	  if(fields.size()>0) {
-	    if(fields[0].lower().simplifyWhiteSpace()=="form-data") {
-	      for(unsigned i=1;i<fields.size();i++) {
-		QStringList pairs;
-		pairs=pairs.split("=",fields[i]);
-		if(pairs[0].lower().simplifyWhiteSpace()=="name") {
-		  name=pairs[1].simplifyWhiteSpace();
-		  name.replace("\"","");
-		}
-		if(pairs[0].lower().simplifyWhiteSpace()=="filename") {
-		  filename=post_tempdir->path()+"/"+
-		    pairs[1].simplifyWhiteSpace();
-		  filename.replace("\"","");
-		  fd=open(filename,O_WRONLY|O_CREAT,S_IRUSR|S_IWUSR);
-		}
-	      }
-	    }
+    name="";
+    filename="";
+    text=std::string(buf+pos,ptr-buf-pos);
+    lines=lines.split("\r\n",QString(text.c_str()));
+    pos=ptr-buf+4;
+    for(unsigned i=0;i<lines.size();i++) {
+      QStringList hdr;
+      hdr=hdr.split(":",lines[i].simplifyWhiteSpace());
+      // Reconcaternate trailing sections so we don't split on the 
+      // useless M$ drive letter supplied by IE
+      for(unsigned j=2;j<hdr.size();j++) {
+	hdr[1]+=hdr[j];
+      }
+      if((hdr.size()<2)||(hdr[0].lower()!="content-disposition")) {
+	continue;
+      }
+      QStringList fields;
+      fields=fields.split(";",hdr[1]);
+      if((fields.size()>0)&&
+	 (fields[0].lower().simplifyWhiteSpace()=="form-data")) {
+	for(unsigned j=1;j<fields.size();j++) {
+	  QStringList pairs;
+	  pairs=pairs.split("=",fields[j]);
+	  if(pairs.size()<2) {
+	    continue;
+	  }
+	  if(pairs[0].lower().simplifyWhiteSpace()=="name") {
+	    name=pairs[1].simplifyWhiteSpace();
+	    name.replace("\"","");
+	  }
+	  if(pairs[0].lower().simplifyWhiteSpace()=="filename") {
+	    filename=post_tempdir->path()+"/"+pairs[1].simplifyWhiteSpace();
+	    filename.replace("\"","");
+	    fd=open(filename,O_WRONLY|O_CREAT|O_TRUNC,S_IRUSR|S_IWUSR);
 	  }
 	}
-	header=false;
       }
-      else {
-	QStringList hdr;
-	hdr=hdr.split(":",QString(post_data).simplifyWhiteSpace());
-	// Reconcaternate trailing sections so we don't split on the 
-	// useless M$ drive letter supplied by IE
-	for(unsigned i=2;i<hdr.size();i++) {
-	  hdr[1]+=hdr[i];
+    }
+
+    //
+    // Read data
+    //
+    text="";
+    while((ptr=(char *)memmem(buf+pos,len-pos,delim.c_str(),delim.size()))==
+	  NULL) {
+      if((len-pos)>=delim.size()) {
+	unsigned n=len-pos-delim.size()+1;
+	if(filename.isEmpty()) {
+	  text+=std::string(buf+pos,n);
+	}
+	else {
+	  write(fd,buf+pos,n);
 	}
-	headers[hdr[0].lower()]=hdr[1];
+	pos+=n;
+      }
+      if(!FillBuffer(buf,&pos,&len,&total)) {
+	if(fd>=0) {
+	  ::close(fd);
+	}
+	free(buf);
+	post_error=RDFormPost::ErrorMalformedData;
+	return;
       }
     }
-    else {  // Read data
-      if(filename.isEmpty()) {
-	QString str=post_values[name].toString();
-	str+=QString(post_data);
-	post_filenames[name]=false;
-	post_values[name]=str.simplifyWhiteSpace();
+    if(filename.isEmpty()) {
+      text+=std::string(buf+pos,ptr-buf-pos);
+      post_filenames[name]=false;
+      post_values[name]=QString(text.c_str()).simplifyWhiteSpace();
+    }
+    else {
+      write(fd,buf+pos,ptr-buf-pos);
+      ::close(fd);
+      fd=-1;
+      post_filenames[name]=true;
+      post_values[name]=filename;
+    }
+    pos=ptr-buf+delim.size();
+
+    //
+    // Final delimiter is followed by "--"
+    //
+    while((len-pos)<2) {
+      if(!FillBuffer(buf,&pos,&len,&total)) {
+	break;
       }
-      else {
-	post_filenames[name]=true;
-	post_values[name]=filename;
-	write(fd,post_data,n);
+    }
+    if(((len-pos)<2)||((buf[pos]=='-')&&(buf[pos+1]=='-'))) {
+      break;
+    }
+    while((ptr=(char *)memchr(buf+pos,'\n',len-pos))==NULL) {
+      if(!FillBuffer(buf,&pos,&len,&total)) {
+	free(buf);
+	post_error=RDFormPost::ErrorMalformedData;
+	return;
       }
     }
+    pos=ptr-buf+1;
+  }
+  free(buf);
+
+  gettimeofday(&end,NULL);
+  double secs=(double)(end.tv_sec-start.tv_sec)+
+    (double)(end.tv_usec-start.tv_usec)/1000000.0;
+  if(secs>0.0) {
+    syslog(LOG_DEBUG,
+	   "received %llu bytes of POST data in %.2lf sec [%.1lf MB/sec]",
+	   total,secs,(double)total/(1048576.0*secs));
   }
   post_error=RDFormPost::ErrorOk;
 }
+
+
+bool RDFormPost::FillBuffer(char *buf,unsigned *pos,unsigned *len,
+			    unsigned long long *total)
+{
+  ssize_t n;
+
+  if(*pos>0) {
+    memmove(buf,buf+*pos,*len-*pos);
+    *len-=*pos;
+    *pos=0;
+  }
+  if(*len>=RDFORMPOST_BUFFER_SIZE) {
+    return false;  // Headers too large
+  }
+  while((n=read(0,buf+*len,RDFORMPOST_BUFFER_SIZE-*len))<0) {
+    if(errno!=EINTR) {
+      return false;
+    }
+  }
+  *len+=n;
+  *total+=n;
+  return n>0;
+}
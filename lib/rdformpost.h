@@ -22,6 +22,7 @@
 #define RDFORMPOST_H
 
 #include <map>
+#include <string>
 
 #include <qstring.h>
 #include <qstringlist.h>
@@ -30,6 +31,11 @@
 
 #include <rdtempdirectory.h>
 
+//
+// Read size for multipart POST data
+//
+#define RDFORMPOST_BUFFER_SIZE 1048576
+
 class RDFormPost
 {
  public:
@@ -43,6 +49,7 @@ class RDFormPost
   QHostAddress clientAddress() const;
   QStringList names() const;
   QVariant value(const QString &name,bool *ok=NULL);
+  void setValue(const QString &name,const QVariant &value);
   bool getValue(const QString &name,QHostAddress *addr,bool *ok=NULL);
   bool getValue(const QString &name,QString *str,bool *ok=NULL);
   bool getValue(const QString &name,int *n,bool *ok=NULL);
@@ -64,6 +71,8 @@ class RDFormPost
  private:
   void LoadUrlEncoding(char first);
   void LoadMultipartEncoding(char first);
+  bool FillBuffer(char *buf,unsigned *pos,unsigned *len,
+		  unsigned long long *total);
   QHostAddress post_client_address;
   RDFormPost::Encoding post_encoding;
   RDFormPost::Error post_error;
@@ -257,12 +257,15 @@ int RDGroup::freeCartQuantity() const
   }
   int low=q->value(0).toInt();
   int high=q->value(1).toInt();
-  sql=QString().sprintf("select NUMBER from CART\
+  sql=QString().sprintf("select count(NUMBER) from CART\
                          where (NUMBER>=%d)&&(NUMBER<=%d)",
 			q->value(0).toInt(),q->value(1).toInt());
   delete q;
   q=new RDSqlQuery(sql);
-  int free=high-low-q->size();
+  int free=high-low;
+  if(q->first()) {
+    free-=q->value(0).toInt();
+  }
   delete q;
 
   return free;
@@ -273,32 +276,25 @@ bool RDGroup::reserveCarts(std::vector<unsigned> *cart_nums,
 			   const QString &station_name,RDCart::Type type,
 			   unsigned quan) const
 {
-  unsigned next;
-  QString sql;
-  RDSqlQuery *q;
+  unsigned low;
+  unsigned high;
+  unsigned first;
 
   cart_nums->clear();
-  if((next=GetNextFreeCart(0))==0) {
+  if(quan==0) {
     return false;
   }
-  while(next!=0) {
-    if(ReserveCart(station_name,type,next)) {
-      cart_nums->push_back(next);
-      next++;
-    }
-    else {
-      for(unsigned i=0;i<cart_nums->size();i++) {
-	sql=QString().sprintf("delete from CART where NUMBER=%u",
-			      cart_nums->at(i));
-	q=new RDSqlQuery(sql);
-	delete q;
+  if(!GetCartRange(0,&low,&high)) {
+    return false;
+  }
+  while(FindFreeCarts(low,high,quan,&first)) {
+    if(ReserveCarts(station_name,type,first,quan)) {
+      for(unsigned i=0;i<quan;i++) {
+	cart_nums->push_back(first+i);
       }
-      cart_nums->clear();
-      next=GetNextFreeCart(next+1);
-    }
-    if(cart_nums->size()==quan) {
       return true;
     }
+    low=first+1;  // Lost a race for this range, so look further along
   }
 
   return false;
@@ -376,11 +372,27 @@ QString RDGroup::xml() const
 
 
 unsigned RDGroup::GetNextFreeCart(unsigned startcart) const
+{
+  unsigned low;
+  unsigned high;
+  unsigned first;
+
+  if(!GetCartRange(startcart,&low,&high)) {
+    return 0;
+  }
+  if(FindFreeCarts(low,high,1,&first)) {
+    return first;
+  }
+  return 0;
+}
+
+
+bool RDGroup::GetCartRange(unsigned startcart,unsigned *low,
+			   unsigned *high) const
 {
   QString sql;
   RDSqlQuery *q;
-  unsigned cart_low_limit;
-  unsigned cart_high_limit;
+  bool ret=false;
 
   sql=QString().sprintf("select DEFAULT_LOW_CART,DEFAULT_HIGH_CART\
                          from GROUPS where NAME=\"%s\"",
@@ -388,65 +400,128 @@ unsigned RDGroup::GetNextFreeCart(unsigned startcart) const
   q=new RDSqlQuery(sql);
   if(q->first()) {
     if(startcart>q->value(0).toUInt()) {
-      cart_low_limit=startcart;
+      *low=startcart;
     }
     else {
-      cart_low_limit=q->value(0).toUInt();
+      *low=q->value(0).toUInt();
+    }
+    *high=q->value(1).toUInt();
+    ret=(*low>=1)&&(startcart<=*high)&&(*low<=*high);
+  }
+  delete q;
+
+  return ret;
+}
+
+
+bool RDGroup::FindFreeCarts(unsigned low,unsigned high,unsigned quan,
+			    unsigned *first) const
+{
+  //
+  // Only the gaps are transferred, never the carts themselves: the
+  // first query finds the start of the occupied range and the second
+  // walks the primary key for carts with no successor, returning each
+  // along with the next occupied number.
+  //
+  QString sql;
+  RDSqlQuery *q;
+  unsigned start;
+  unsigned end;
+
+  if(low>high) {
+    return false;
+  }
+  sql=QString("select NUMBER from CART where ")+
+    QString().sprintf("(NUMBER>=%u)&&(NUMBER<=%u) ",low,high)+
+    "order by NUMBER limit 1";
+  q=new RDSqlQuery(sql);
+  if(!q->first()) {
+    delete q;
+    if((high-low+1)>=quan) {
+      *first=low;
+      return true;
     }
-    cart_high_limit=q->value(1).toUInt();
+    return false;
+  }
+  if((q->value(0).toUInt()-low)>=quan) {
     delete q;
-    if((cart_low_limit<1)||(startcart>cart_high_limit)) {
-      return 0;
+    *first=low;
+    return true;
+  }
+  delete q;
+
+  sql=QString("select C1.NUMBER,")+
+    "(select min(C3.NUMBER) from CART as C3 where C3.NUMBER>C1.NUMBER) "+
+    "from CART as C1 left join CART as C2 on C2.NUMBER=C1.NUMBER+1 where "+
+    QString().sprintf("(C1.NUMBER>=%u)&&(C1.NUMBER<%u)&&",low,high)+
+    "(C2.NUMBER is null) order by C1.NUMBER";
+  if(quan==1) {
+    sql+=" limit 1";
+  }
+  q=new RDSqlQuery(sql);
+  while(q->next()) {
+    start=q->value(0).toUInt()+1;
+    if(q->value(1).isNull()||(q->value(1).toUInt()>high)) {
+      end=high;
     }
-    sql=QString().sprintf("select NUMBER from CART where \
-                         (NUMBER>=%u)&&(NUMBER<=%u) order by NUMBER",
-			  cart_low_limit,cart_high_limit);
-    q=new RDSqlQuery(sql);
-    if(q->size()<1) {
-      delete q;
-      return cart_low_limit;
+    else {
+      end=q->value(1).toUInt()-1;
     }
-    for(unsigned i=cart_low_limit;i<=cart_high_limit;i++) {
-      if(!q->next()) {
-	delete q;
-	return i;
-      }
-      if(i!=q->value(0).toUInt()) {
-	delete q;
-	return i;
-      }
+    if((end-start+1)>=quan) {
+      delete q;
+      *first=start;
+      return true;
     }
-    delete q;
   }
-  else {
-    delete q;
-  }
-  return 0;
+  delete q;
+
+  return false;
 }
 
 
 #ifndef WIN32
-bool RDGroup::ReserveCart(const QString &station_name,RDCart::Type type,
-			  unsigned cart_num) const
+bool RDGroup::ReserveCarts(const QString &station_name,RDCart::Type type,
+			   unsigned first,unsigned quan) const
 {
   //
   // We use QSqlQuery here, not RDSqlQuery because the insert could
   // fail and we don't want to reset the DB connection when that happens.
   //
+  // All carts in the block go in with a single statement.  Numbers taken
+  // by someone else in the meantime are skipped by 'insert ignore', in
+  // which case whatever we did get is released again.
+  //
   QString sql;
   QSqlQuery *q;
+  QString values;
   bool ret=false;
 
-  if((cart_num>=defaultLowCart())&&(cart_num<=defaultHighCart())) {
-    sql=QString().sprintf("insert into CART set NUMBER=%u,",cart_num)+
-      "GROUP_NAME=\""+RDEscapeString(group_name)+"\","+
-      QString().sprintf("TYPE=%d,",type)+
-      "TITLE=\"["+RDEscapeString(QObject::tr("reserved"))+"]\","+
-      "PENDING_STATION=\""+RDEscapeString(station_name)+"\","+
-      QString().sprintf("PENDING_PID=%d,",getpid())+
-      "PENDING_DATETIME=now()";
+  if((first<defaultLowCart())||((first+quan-1)>defaultHighCart())) {
+    return false;
+  }
+  values=QString("\"")+RDEscapeString(group_name)+"\","+
+    QString().sprintf("%d,",type)+
+    "\"["+RDEscapeString(QObject::tr("reserved"))+"]\","+
+    "\""+RDEscapeString(station_name)+"\","+
+    QString().sprintf("%d,",getpid())+
+    "now())";
+  sql=QString("insert ignore into CART (NUMBER,GROUP_NAME,TYPE,TITLE,")+
+    "PENDING_STATION,PENDING_PID,PENDING_DATETIME) values ";
+  for(unsigned i=0;i<quan;i++) {
+    sql+=QString().sprintf("(%u,",first+i)+values;
+    if(i<(quan-1)) {
+      sql+=",";
+    }
+  }
+  q=new QSqlQuery(sql);
+  ret=q->isActive()&&(q->numRowsAffected()==(int)quan);
+  delete q;
+  if(!ret) {
+    sql=QString("delete from CART where ")+
+      QString().sprintf("(NUMBER>=%u)&&(NUMBER<=%u)&&",first,first+quan-1)+
+      "(PENDING_STATION=\""+RDEscapeString(station_name)+"\")&&"+
+      QString().sprintf("(PENDING_PID=%d)",getpid());
     q=new QSqlQuery(sql);
-    ret=q->isActive();
     delete q;
   }
   return ret;
@@ -70,9 +70,12 @@ class RDGroup
   
  private:
   unsigned GetNextFreeCart(unsigned startcart) const;
+  bool GetCartRange(unsigned startcart,unsigned *low,unsigned *high) const;
+  bool FindFreeCarts(unsigned low,unsigned high,unsigned quan,
+		     unsigned *first) const;
 #ifndef WIN32
-  bool ReserveCart(const QString &station_name,RDCart::Type type,
-		   unsigned cart_num) const;
+  bool ReserveCarts(const QString &station_name,RDCart::Type type,
+		    unsigned first,unsigned quan) const;
 #endif  // WIN32
   void SetRow(const QString &param,int value) const;
   void SetRow(const QString &param,unsigned value) const;
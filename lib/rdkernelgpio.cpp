@@ -18,6 +18,9 @@
 //   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
 //
 
+#include <fcntl.h>
+#include <unistd.h>
+
 #include "rdkernelgpio.h"
 
 RDKernelGpio::RDKernelGpio(QObject *parent)
@@ -30,8 +33,8 @@ RDKernelGpio::RDKernelGpio(QObject *parent)
 
 RDKernelGpio::~RDKernelGpio()
 {
-  for(unsigned i=0;i<gpio_gpios.size();i++) {
-    removeGpio(gpio_gpios[i]);
+  while(gpio_gpios.size()>0) {
+    removeGpio(gpio_gpios.back());
   }
   delete gpio_poll_timer;
 }
@@ -41,10 +44,8 @@ bool RDKernelGpio::addGpio(int gpio)
 {
   FILE *f=NULL;
 
-  for(unsigned i=0;i<gpio_gpios.size();i++) {
-    if(gpio==gpio_gpios[i]) {
-      return true;
-    }
+  if(GpioIndex(gpio)>=0) {
+    return true;
   }
 
   if((f=OpenNode("export","w"))==NULL) {
@@ -54,10 +55,18 @@ bool RDKernelGpio::addGpio(int gpio)
   fclose(f);
   gpio_gpios.push_back(gpio);
   gpio_states.push_back(value(gpio));
-
-  if(gpio_gpios.size()==1) {
-    gpio_poll_timer->start(KERNELGPIO_POLL_INTERVAL);
+  gpio_value_fds.push_back(-1);
+  gpio_notifiers.push_back(NULL);
+  gpio_change_datetimes.push_back(QDateTime::currentDateTime());
+
+  //
+  // Prefer edge notification from the kernel, falling back to polling
+  // for lines that can't generate interrupts (e.g. outputs).
+  //
+  if(direction(gpio)==RDKernelGpio::In) {
+    StartEdge(gpio_gpios.size()-1);
   }
+  UpdatePollTimer();
 
   return true;
 }
@@ -66,6 +75,17 @@ bool RDKernelGpio::addGpio(int gpio)
 bool RDKernelGpio::removeGpio(int gpio)
 {
   FILE *f=NULL;
+  int n;
+
+  if((n=GpioIndex(gpio))>=0) {
+    StopEdge(n);
+    gpio_gpios.erase(gpio_gpios.begin()+n);
+    gpio_states.erase(gpio_states.begin()+n);
+    gpio_value_fds.erase(gpio_value_fds.begin()+n);
+    gpio_notifiers.erase(gpio_notifiers.begin()+n);
+    gpio_change_datetimes.erase(gpio_change_datetimes.begin()+n);
+    UpdatePollTimer();
+  }
 
   if((f=OpenNode("unexport","w"))==NULL) {
     return false;
@@ -103,10 +123,14 @@ RDKernelGpio::Direction RDKernelGpio::direction(int gpio,bool *ok) const
 }
 
 
-bool RDKernelGpio::setDirection(int gpio,RDKernelGpio::Direction dir) const
+bool RDKernelGpio::setDirection(int gpio,RDKernelGpio::Direction dir)
 {
   FILE *f=NULL;
+  int n;
 
+  if((n=GpioIndex(gpio))>=0) {
+    StopEdge(n);
+  }
   if((f=OpenNode("direction","w",gpio))!=NULL) {
     switch(dir) {
     case RDKernelGpio::In:
@@ -118,12 +142,82 @@ bool RDKernelGpio::setDirection(int gpio,RDKernelGpio::Direction dir) const
       break;
     }
     fclose(f);
+    if(n>=0) {
+      if(dir==RDKernelGpio::In) {
+	StartEdge(n);
+      }
+      UpdatePollTimer();
+    }
     return true;
   }
+  if(n>=0) {
+    UpdatePollTimer();
+  }
   return false;
 }
 
 
+RDKernelGpio::Edge RDKernelGpio::edge(int gpio,bool *ok) const
+{
+  RDKernelGpio::Edge ret=RDKernelGpio::None;
+  FILE *f=NULL;
+  char str[255];
+
+  if((f=OpenNode("edge","r",gpio))!=NULL) {
+    fscanf(f,"%s",str);
+    if(QString(str)=="rising") {
+      ret=RDKernelGpio::Rising;
+    }
+    if(QString(str)=="falling") {
+      ret=RDKernelGpio::Falling;
+    }
+    if(QString(str)=="both") {
+      ret=RDKernelGpio::Both;
+    }
+    fclose(f);
+    if(ok!=NULL) {
+      *ok=true;
+    }
+  }
+  else {
+    if(ok!=NULL) {
+      *ok=false;
+    }
+  }    
+
+  return ret;
+}
+
+
+bool RDKernelGpio::setEdge(int gpio,RDKernelGpio::Edge edge) const
+{
+  FILE *f=NULL;
+  bool ret=false;
+
+  if((f=OpenNode("edge","w",gpio))!=NULL) {
+    switch(edge) {
+    case RDKernelGpio::None:
+      fprintf(f,"none");
+      break;
+
+    case RDKernelGpio::Rising:
+      fprintf(f,"rising");
+      break;
+
+    case RDKernelGpio::Falling:
+      fprintf(f,"falling");
+      break;
+
+    case RDKernelGpio::Both:
+      fprintf(f,"both");
+      break;
+    }
+    ret=fclose(f)==0;
+  }
+  return ret;
+}
+
+
 bool RDKernelGpio::activeLow(int gpio,bool *ok) const
 {
   unsigned ret=false;
@@ -181,6 +275,28 @@ bool RDKernelGpio::value(int gpio,bool *ok) const
 }
 
 
+bool RDKernelGpio::edgeTriggered(int gpio) const
+{
+  int n;
+
+  if((n=GpioIndex(gpio))<0) {
+    return false;
+  }
+  return gpio_notifiers[n]!=NULL;
+}
+
+
+QDateTime RDKernelGpio::changedDateTime(int gpio) const
+{
+  int n;
+
+  if((n=GpioIndex(gpio))<0) {
+    return QDateTime();
+  }
+  return gpio_change_datetimes[n];
+}
+
+
 bool RDKernelGpio::setValue(int gpio,bool state) const
 {
   FILE *f=NULL;
@@ -199,14 +315,36 @@ void RDKernelGpio::pollData()
   bool state=false;
 
   for(unsigned i=0;i<gpio_gpios.size();i++) {
+    if(gpio_notifiers[i]!=NULL) {
+      continue;
+    }
     if((state=value(gpio_gpios[i]))!=gpio_states[i]) {
       gpio_states[i]=state;
+      gpio_change_datetimes[i]=QDateTime::currentDateTime();
       emit valueChanged(gpio_gpios[i],state);
     }
   }
 }
 
 
+void RDKernelGpio::edgeData(int fd)
+{
+  QDateTime now=QDateTime::currentDateTime();
+  bool state=false;
+
+  for(unsigned i=0;i<gpio_value_fds.size();i++) {
+    if(gpio_value_fds[i]==fd) {
+      if(ReadValue(fd,&state)&&(state!=gpio_states[i])) {
+	gpio_states[i]=state;
+	gpio_change_datetimes[i]=now;
+	emit valueChanged(gpio_gpios[i],state);
+      }
+      return;
+    }
+  }
+}
+
+
 FILE *RDKernelGpio::OpenNode(const QString &name,const char *mode,int gpio) const
 {
   if(gpio<0) {
@@ -215,3 +353,96 @@ FILE *RDKernelGpio::OpenNode(const QString &name,const char *mode,int gpio) cons
   return fopen((KERNELGPIO_SYS_FILE+QString().sprintf("/gpio%d/",gpio)+name),
 	       mode);
 }
+
+
+int RDKernelGpio::GpioIndex(int gpio) const
+{
+  for(unsigned i=0;i<gpio_gpios.size();i++) {
+    if(gpio_gpios[i]==gpio) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+
+bool RDKernelGpio::StartEdge(unsigned n)
+{
+  int fd=-1;
+  bool state=false;
+
+  StopEdge(n);
+  if(!setEdge(gpio_gpios[n],RDKernelGpio::Both)) {
+    return false;
+  }
+  if((fd=open((KERNELGPIO_SYS_FILE+
+	       QString().sprintf("/gpio%d/value",gpio_gpios[n])),
+	      O_RDONLY|O_NONBLOCK))<0) {
+    setEdge(gpio_gpios[n],RDKernelGpio::None);
+    return false;
+  }
+
+  //
+  // The value node signals an edge as an exceptional condition, and must
+  // be read once to arm it.
+  //
+  if(!ReadValue(fd,&state)) {
+    close(fd);
+    setEdge(gpio_gpios[n],RDKernelGpio::None);
+    return false;
+  }
+  if(state!=gpio_states[n]) {
+    gpio_states[n]=state;
+    gpio_change_datetimes[n]=QDateTime::currentDateTime();
+    emit valueChanged(gpio_gpios[n],state);
+  }
+  gpio_value_fds[n]=fd;
+  gpio_notifiers[n]=new QSocketNotifier(fd,QSocketNotifier::Exception,this);
+  connect(gpio_notifiers[n],SIGNAL(activated(int)),this,SLOT(edgeData(int)));
+
+  return true;
+}
+
+
+void RDKernelGpio::StopEdge(unsigned n)
+{
+  if(gpio_notifiers[n]!=NULL) {
+    delete gpio_notifiers[n];
+    gpio_notifiers[n]=NULL;
+    setEdge(gpio_gpios[n],RDKernelGpio::None);
+  }
+  if(gpio_value_fds[n]>=0) {
+    close(gpio_value_fds[n]);
+    gpio_value_fds[n]=-1;
+  }
+}
+
+
+bool RDKernelGpio::ReadValue(int fd,bool *state) const
+{
+  char c;
+
+  if(lseek(fd,0,SEEK_SET)<0) {
+    return false;
+  }
+  if(read(fd,&c,1)!=1) {
+    return false;
+  }
+  *state=c=='1';
+
+  return true;
+}
+
+
+void RDKernelGpio::UpdatePollTimer()
+{
+  for(unsigned i=0;i<gpio_notifiers.size();i++) {
+    if(gpio_notifiers[i]==NULL) {
+      if(!gpio_poll_timer->isActive()) {
+	gpio_poll_timer->start(KERNELGPIO_POLL_INTERVAL);
+      }
+      return;
+    }
+  }
+  gpio_poll_timer->stop();
+}
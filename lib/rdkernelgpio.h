@@ -25,7 +25,9 @@
 
 #include <vector>
 
+#include <qdatetime.h>
 #include <qobject.h>
+#include <qsocketnotifier.h>
 #include <qtimer.h>
 
 //
@@ -46,24 +48,37 @@ class RDKernelGpio : public QObject
   bool addGpio(int gpio);
   bool removeGpio(int gpio);
   Direction direction(int gpio, bool *ok=NULL) const;
-  bool setDirection(int gpio,Direction dir) const;
+  bool setDirection(int gpio,Direction dir);
+  Edge edge(int gpio,bool *ok=NULL) const;
+  bool setEdge(int gpio,Edge edge) const;
   bool activeLow(int gpio, bool *ok=NULL) const;
   bool setActiveLow(int gpio,bool state) const;
   bool value(int gpio,bool *ok=NULL) const;
+  bool edgeTriggered(int gpio) const;
+  QDateTime changedDateTime(int gpio) const;
 
  public slots:
   bool setValue(int gpio,bool state) const;
 
  private slots:
   void pollData();
+  void edgeData(int fd);
 
  signals:
   void valueChanged(int gpio,bool state);
 
  private:
   FILE *OpenNode(const QString &name,const char *mode,int gpio=-1) const;
+  int GpioIndex(int gpio) const;
+  bool StartEdge(unsigned n);
+  void StopEdge(unsigned n);
+  bool ReadValue(int fd,bool *state) const;
+  void UpdatePollTimer();
   std::vector<int> gpio_gpios;
   std::vector<bool> gpio_states;
+  std::vector<int> gpio_value_fds;
+  std::vector<QSocketNotifier *> gpio_notifiers;
+  std::vector<QDateTime> gpio_change_datetimes;
   QTimer *gpio_poll_timer;
 };
 
@@ -48,6 +48,31 @@ RDLibraryConf::RDLibraryConf(const QString &station)
   }
   lib_id=q->value(0).toUInt();
   delete q;
+  lib_snapshot=new RDRowSnapshot("RDLIBRARY",QString().sprintf("ID=%u",lib_id));
+}
+
+
+RDLibraryConf::~RDLibraryConf()
+{
+  delete lib_snapshot;
+}
+
+
+bool RDLibraryConf::snapshotEnabled() const
+{
+  return lib_snapshot->isEnabled();
+}
+
+
+void RDLibraryConf::setSnapshotEnabled(bool state)
+{
+  lib_snapshot->setEnabled(state);
+}
+
+
+void RDLibraryConf::reload()
+{
+  lib_snapshot->reload();
 }
 
 
@@ -59,13 +84,13 @@ QString RDLibraryConf::station() const
 
 int RDLibraryConf::inputCard() const
 {
-  return RDGetSqlValue("RDLIBRARY","ID",lib_id,"INPUT_CARD").toInt();
+  return lib_snapshot->value("INPUT_CARD").toInt();
 }
 
 
 int RDLibraryConf::inputPort() const
 {
-  return RDGetSqlValue("RDLIBRARY","ID",lib_id,"INPUT_PORT").toInt();
+  return lib_snapshot->value("INPUT_PORT").toInt();
 }
 
 
@@ -83,13 +108,13 @@ void RDLibraryConf::setInputPort(int input) const
 
 int RDLibraryConf::outputCard() const
 {
-  return RDGetSqlValue("RDLIBRARY","ID",lib_id,"OUTPUT_CARD").toInt();
+  return lib_snapshot->value("OUTPUT_CARD").toInt();
 }
 
 
 int RDLibraryConf::outputPort() const
 {
-  return RDGetSqlValue("RDLIBRARY","ID",lib_id,"OUTPUT_PORT").toInt();
+  return lib_snapshot->value("OUTPUT_PORT").toInt();
 }
 
 
@@ -107,7 +132,7 @@ void RDLibraryConf::setOutputPort(int output) const
 
 int RDLibraryConf::voxThreshold() const
 {
-  return RDGetSqlValue("RDLIBRARY","ID",lib_id,"VOX_THRESHOLD").toInt();
+  return lib_snapshot->value("VOX_THRESHOLD").toInt();
 }
 
 
@@ -119,7 +144,7 @@ void RDLibraryConf::setVoxThreshold(int level) const
 
 int RDLibraryConf::trimThreshold() const
 {
-  return RDGetSqlValue("RDLIBRARY","ID",lib_id,"TRIM_THRESHOLD").toInt();
+  return lib_snapshot->value("TRIM_THRESHOLD").toInt();
 }
 
 
@@ -131,7 +156,7 @@ void RDLibraryConf::setTrimThreshold(int level) const
 
 unsigned RDLibraryConf::defaultFormat() const
 {
-  return RDGetSqlValue("RDLIBRARY","ID",lib_id,"DEFAULT_FORMAT").toUInt();
+  return lib_snapshot->value("DEFAULT_FORMAT").toUInt();
 }
 
 
@@ -143,7 +168,7 @@ void RDLibraryConf::setDefaultFormat(unsigned format) const
 
 unsigned RDLibraryConf::defaultChannels() const
 {
-  return RDGetSqlValue("RDLIBRARY","ID",lib_id,"DEFAULT_CHANNELS").toUInt();
+  return lib_snapshot->value("DEFAULT_CHANNELS").toUInt();
 }
 
 
@@ -155,7 +180,7 @@ void RDLibraryConf::setDefaultChannels(unsigned chans) const
 
 unsigned RDLibraryConf::defaultLayer() const
 {
-  return RDGetSqlValue("RDLIBRARY","ID",lib_id,"DEFAULT_LAYER").toUInt();
+  return lib_snapshot->value("DEFAULT_LAYER").toUInt();
 }
 
 
@@ -167,7 +192,7 @@ void RDLibraryConf::setDefaultLayer(unsigned layer) const
 
 unsigned RDLibraryConf::defaultBitrate() const
 {
-  return RDGetSqlValue("RDLIBRARY","ID",lib_id,"DEFAULT_BITRATE").toUInt();
+  return lib_snapshot->value("DEFAULT_BITRATE").toUInt();
 }
 
 
@@ -180,7 +205,7 @@ void RDLibraryConf::setDefaultBitrate(unsigned rate) const
 RDLibraryConf::RecordMode RDLibraryConf::defaultRecordMode() const
 {
   return (RDLibraryConf::RecordMode)
-    RDGetSqlValue("RDLIBRARY","ID",lib_id,"DEFAULT_RECORD_MODE").toUInt();
+    lib_snapshot->value("DEFAULT_RECORD_MODE").toUInt();
 }
 
 
@@ -192,7 +217,7 @@ void RDLibraryConf::setDefaultRecordMode(RecordMode mode) const
 
 bool RDLibraryConf::defaultTrimState() const
 {
-  return RDBool(RDGetSqlValue("RDLIBRARY","ID",lib_id,"DEFAULT_TRIM_STATE").
+  return RDBool(lib_snapshot->value("DEFAULT_TRIM_STATE").
 	       toString());
 }
 
@@ -205,7 +230,7 @@ void RDLibraryConf::setDefaultTrimState(bool state) const
 
 unsigned RDLibraryConf::maxLength() const
 {
-  return RDGetSqlValue("RDLIBRARY","ID",lib_id,"MAXLENGTH").toUInt();
+  return lib_snapshot->value("MAXLENGTH").toUInt();
 }
 
 
@@ -217,7 +242,7 @@ void RDLibraryConf::setMaxLength(unsigned length) const
 
 unsigned RDLibraryConf::tailPreroll() const
 {
-  return RDGetSqlValue("RDLIBRARY","ID",lib_id,"TAIL_PREROLL").toUInt();
+  return lib_snapshot->value("TAIL_PREROLL").toUInt();
 }
 
 
@@ -229,7 +254,7 @@ void RDLibraryConf::setTailPreroll(unsigned length) const
 
 QString RDLibraryConf::ripperDevice() const
 {
-  return RDGetSqlValue("RDLIBRARY","ID",lib_id,"RIPPER_DEVICE").toString();
+  return lib_snapshot->value("RIPPER_DEVICE").toString();
 }
 
 
@@ -241,7 +266,7 @@ void RDLibraryConf::setRipperDevice(QString dev) const
 
 int RDLibraryConf::paranoiaLevel() const
 {
-  return RDGetSqlValue("RDLIBRARY","ID",lib_id,"PARANOIA_LEVEL").toInt();
+  return lib_snapshot->value("PARANOIA_LEVEL").toInt();
 }
 
 
@@ -253,7 +278,7 @@ void RDLibraryConf::setParanoiaLevel(int level) const
 
 int RDLibraryConf::ripperLevel() const
 {
-  return RDGetSqlValue("RDLIBRARY","ID",lib_id,"RIPPER_LEVEL").toInt();
+  return lib_snapshot->value("RIPPER_LEVEL").toInt();
 }
  
 
@@ -265,7 +290,7 @@ void RDLibraryConf::setRipperLevel(int level) const
 
 QString RDLibraryConf::cddbServer() const
 {
-  return RDGetSqlValue("RDLIBRARY","ID",lib_id,"CDDB_SERVER").toString();
+  return lib_snapshot->value("CDDB_SERVER").toString();
 }
 
 
@@ -277,7 +302,7 @@ void RDLibraryConf::setCddbServer(QString server) const
 
 bool RDLibraryConf::readIsrc() const
 {
-  return RDBool(RDGetSqlValue("RDLIBRARY","ID",lib_id,"READ_ISRC").
+  return RDBool(lib_snapshot->value("READ_ISRC").
 		toString());
 }
 
@@ -290,7 +315,7 @@ void RDLibraryConf::setReadIsrc(bool state) const
 
 bool RDLibraryConf::enableEditor() const
 {
-  return RDBool(RDGetSqlValue("RDLIBRARY","ID",lib_id,"ENABLE_EDITOR").
+  return RDBool(lib_snapshot->value("ENABLE_EDITOR").
 		toString());
 }
 
@@ -303,7 +328,7 @@ void RDLibraryConf::setEnableEditor(bool state) const
 
 int RDLibraryConf::srcConverter() const
 {
-  return RDGetSqlValue("RDLIBRARY","ID",lib_id,"SRC_CONVERTER").toInt();
+  return lib_snapshot->value("SRC_CONVERTER").toInt();
 }
 
 
@@ -316,7 +341,7 @@ void RDLibraryConf::setSrcConverter(int conv) const
 RDLibraryConf::SearchLimit RDLibraryConf::limitSearch() const
 {
   return (RDLibraryConf::SearchLimit)
-    RDGetSqlValue("RDLIBRARY","ID",lib_id,"LIMIT_SEARCH").toInt();
+    lib_snapshot->value("LIMIT_SEARCH").toInt();
 }
 
 
@@ -328,7 +353,7 @@ void RDLibraryConf::setLimitSearch(RDLibraryConf::SearchLimit lmt) const
 
 bool RDLibraryConf::searchLimited() const
 {
-  return RDBool(RDGetSqlValue("RDLIBRARY","ID",lib_id,"SEARCH_LIMITED").
+  return RDBool(lib_snapshot->value("SEARCH_LIMITED").
 		toString());
 }
 
@@ -389,6 +414,7 @@ void RDLibraryConf::SetRow(const QString &param,int value) const
     "STATION=\""+RDEscapeString(lib_station)+"\"";
   q=new RDSqlQuery(sql);
   delete q;
+  lib_snapshot->setValue(param,value);
 }
 
 
@@ -402,6 +428,7 @@ void RDLibraryConf::SetRow(const QString &param,unsigned value) const
     "STATION=\""+RDEscapeString(lib_station)+"\"";
   q=new RDSqlQuery(sql);
   delete q;
+  lib_snapshot->setValue(param,value);
 }
 
 
@@ -415,6 +442,7 @@ void RDLibraryConf::SetRow(const QString &param,const QString &value) const
     "STATION=\""+RDEscapeString(lib_station)+"\"";
   q=new RDSqlQuery(sql);
   delete q;
+  lib_snapshot->setValue(param,value);
 }
 
 
@@ -23,6 +23,7 @@
 
 #include <qsqldatabase.h>
 
+#include <rdrowsnapshot.h>
 #include <rdsettings.h>
 
 class RDLibraryConf
@@ -31,6 +32,10 @@ class RDLibraryConf
   enum RecordMode {Manual=0,Vox=1};
   enum SearchLimit {LimitNo=0,LimitYes=1,LimitPrevious=2};
   RDLibraryConf(const QString &station);
+  ~RDLibraryConf();
+  bool snapshotEnabled() const;
+  void setSnapshotEnabled(bool state);
+  void reload();
   QString station() const;
   int inputCard() const;
   void setInputCard(int input) const;
@@ -87,6 +92,7 @@ class RDLibraryConf
   void SetRow(const QString &param,bool value) const;
   QString lib_station;
   unsigned lib_id;
+  RDRowSnapshot *lib_snapshot;
 };
 
 
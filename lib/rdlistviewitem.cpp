@@ -72,6 +72,9 @@ QColor RDListViewItem::backgroundColor() const
 
 void RDListViewItem::setBackgroundColor(QColor color)
 {
+  if(color==item_background_color) {
+    return;
+  }
   item_background_color=color;
   listView()->repaintItem(this);
 }
@@ -94,6 +97,9 @@ QColor RDListViewItem::textColor(int column) const
 
 void RDListViewItem::setTextColor(int column,QColor color,int weight)
 {
+  if((color==item_text_color[column])&&(weight==item_text_weight[column])) {
+    return;
+  }
   item_text_color[column]=color;
   item_text_weight[column]=weight;
   listView()->repaintItem(this);
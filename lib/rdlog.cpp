@@ -23,7 +23,6 @@
 #include "rdapplication.h"
 #include "rddb.h"
 #include "rdconf.h"
-#include "rdcreate_log.h"
 #include "rdescape_string.h"
 #include "rdlog.h"
 #include "rdlog_line.h"
@@ -257,8 +256,9 @@ void RDLog::updateLinkQuantity(RDLog::Source src) const
   RDSqlQuery *q;
   switch(src) {
       case RDLog::SourceMusic:
-	sql=QString("select ID from `")+RDLog::tableName(log_name)+
-	  "` where "+QString().sprintf("TYPE=%d",RDLogLine::MusicLink);
+	sql=QString("select ID from LOG_LINES where ")+
+	  "(LOG_NAME=\""+RDEscapeString(log_name)+"\")&&"+
+	  QString().sprintf("(TYPE=%d)",RDLogLine::MusicLink);
 	q=new RDSqlQuery(sql);
 	sql=QString("update LOGS set ")+
 	  QString().sprintf("MUSIC_LINKS=%d ",q->size())+
@@ -266,8 +266,9 @@ void RDLog::updateLinkQuantity(RDLog::Source src) const
 	break;
 
       case RDLog::SourceTraffic:
-	sql=QString("select ID from `")+RDLog::tableName(log_name)+
-	  "` where "+QString().sprintf("TYPE=%d",RDLogLine::TrafficLink);
+	sql=QString("select ID from LOG_LINES where ")+
+	  "(LOG_NAME=\""+RDEscapeString(log_name)+"\")&&"+
+	  QString().sprintf("(TYPE=%d)",RDLogLine::TrafficLink);
 	q=new RDSqlQuery(sql);
 
 	sql=QString("update LOGS set ")+
@@ -356,7 +357,10 @@ bool RDLog::remove(RDStation *station,RDUser *user,RDConfig *config) const
     return false;
   }
 
-  rda->dropTable(RDLog::tableName(log_name));
+  sql=QString("delete from LOG_LINES where ")+
+    "LOG_NAME=\""+RDEscapeString(log_name)+"\"";
+  q=new RDSqlQuery(sql);
+  delete q;
 
   sql=QString().sprintf("delete from LOGS where (NAME=\"%s\" && TYPE=0)",
 			(const char *)RDEscapeString(log_name));
@@ -373,16 +377,17 @@ void RDLog::updateTracks()
   unsigned scheduled=0;
   unsigned completed=0;
 
-  sql=QString("select `")+RDLog::tableName(log_name)+"`.ID from "+
-    "`"+RDLog::tableName(log_name)+"` left join CART "+
-    "on `"+RDLog::tableName(log_name)+"`.CART_NUMBER=CART.NUMBER where "+
-    "CART.OWNER is not null";
+  sql=QString("select LOG_LINES.ID from LOG_LINES left join CART ")+
+    "on LOG_LINES.CART_NUMBER=CART.NUMBER where "+
+    "(LOG_LINES.LOG_NAME=\""+RDEscapeString(log_name)+"\")&&"+
+    "(CART.OWNER is not null)";
   q=new RDSqlQuery(sql);
   completed=q->size();
   delete q;
 
-  sql=QString("select ID from `")+RDLog::tableName(log_name)+
-    "` where "+QString().sprintf("TYPE=%d",RDLogLine::Track);
+  sql=QString("select ID from LOG_LINES where ")+
+    "(LOG_NAME=\""+RDEscapeString(log_name)+"\")&&"+
+    QString().sprintf("(TYPE=%d)",RDLogLine::Track);
   q=new RDSqlQuery(sql);
   scheduled=q->size()+completed;
   delete q;
@@ -425,9 +430,7 @@ int RDLog::removeTracks(RDStation *station,RDUser *user,RDConfig *config) const
 
 RDLogEvent *RDLog::createLogEvent() const
 {
-  QString logname=name()+"_LOG";
-  logname.replace(" ","_");
-  return new RDLogEvent(logname);
+  return new RDLogEvent(RDLog::tableName(name()));
 }
 
 
@@ -546,7 +549,6 @@ bool RDLog::create(const QString &name,const QString &svc_name,
     return false;
   }
   delete q;
-  RDCreateLogTable(RDLog::tableName(name),config);
   *err_msg=QObject::tr("OK");
   return true;
 }
@@ -580,11 +582,13 @@ bool RDLog::remove(const QString &name,RDStation *station,RDUser *user,
 }
 
 
+//
+// Log lines live in LOG_LINES, keyed by LOG_NAME.  This returns the handle
+// by which RDLogEvent refers to a log, not an actual table.
+//
 QString RDLog::tableName(const QString &log_name)
 {
-  QString ret=log_name;
-  ret.replace(" ","_");
-  return ret+"_LOG";
+  return log_name+"_LOG";
 }
 
 
@@ -52,6 +52,9 @@ bool RDLogEvent::exists()
   if(log_name.isEmpty()) {
     return false;
   }
+  if(IsLog(log_name)) {
+    return RDLog::exists(log_name.left(log_name.length()-4));
+  }
   QString sql="show tables";
   RDSqlQuery *q=new RDSqlQuery(sql);
   while(q->next()) {
@@ -150,10 +153,17 @@ void RDLogEvent::save(RDConfig *config,bool update_tracks,int line)
     return;
   }
   if(line<0) {
-    if(exists()) {
-      rda->dropTable(log_name);
+    if(IsLog(log_name)) {
+      sql=QString("delete from LOG_LINES where ")+LineFilter(log_name);
+      q=new RDSqlQuery(sql);
+      delete q;
+    }
+    else {
+      if(exists()) {
+	rda->dropTable(log_name);
+      }
+      RDCreateLogTable(log_name,config);
     }
-    RDCreateLogTable(log_name,config);
     if (log_line.size() > 0) {
        QString values = "";
        for(unsigned i=0;i<log_line.size();i++) {
@@ -166,8 +176,11 @@ void RDLogEvent::save(RDConfig *config,bool update_tracks,int line)
     }
   }
   else {
-    sql=QString().sprintf("delete from `%s` where COUNT=%d",
-			  (const char *)log_name,line);
+    sql=QString("delete from `")+LineTable(log_name)+"` where "+
+      QString().sprintf("(COUNT=%d)",line);
+    if(IsLog(log_name)) {
+      sql+="&&"+LineFilter(log_name);
+    }
     q=new RDSqlQuery(sql);
     delete q;
     SaveLine(line);
@@ -808,6 +821,12 @@ int RDLogEvent::LoadLines(const QString &log_table,int id_offset,
   bool prev_custom=false;
   unsigned lines=0;
   unsigned start_line=log_line.size();
+  QString table=LineTable(log_table);
+  QString where;
+
+  if(IsLog(log_table)) {
+    where=" where "+LineFilter(log_table);
+  }
 
   //
   // Load the group color table
@@ -875,47 +894,48 @@ CART.PUBLISHER,CART.COMPOSER,CART.USAGE_CODE,CART.AVERAGE_SEGUE_LENGTH,\
 `%s`.LINK_START_SLOP,`%s`.LINK_END_SLOP, \
 `%s`.DUCK_UP_GAIN,`%s`.DUCK_DOWN_GAIN,CART.START_DATETIME,CART.END_DATETIME,\
 `%s`.EVENT_LENGTH,CART.USE_EVENT_LENGTH,CART.NOTES \
-from `%s` left join CART on `%s`.CART_NUMBER=CART.NUMBER order by COUNT",
-				(const char *)log_table,
-				(const char *)log_table,
-				(const char *)log_table,
-				(const char *)log_table,
-				(const char *)log_table,
-				(const char *)log_table,
-				(const char *)log_table,
-				(const char *)log_table,
-				(const char *)log_table,
-				(const char *)log_table,
-				(const char *)log_table,
-				(const char *)log_table,
-				(const char *)log_table,
-				(const char *)log_table,
-				(const char *)log_table,
-				(const char *)log_table,
-				(const char *)log_table,
-				(const char *)log_table,
-				(const char *)log_table,
-				(const char *)log_table,
-				(const char *)log_table,
-				(const char *)log_table,
-				(const char *)log_table,
-				(const char *)log_table,
-				(const char *)log_table,
-				(const char *)log_table,
-				(const char *)log_table,
-				(const char *)log_table,
-				(const char *)log_table,
-				(const char *)log_table,
-				(const char *)log_table,
-				(const char *)log_table,
-				(const char *)log_table,
-				(const char *)log_table,
-				(const char *)log_table,
-				(const char *)log_table,
-				(const char *)log_table,
-				(const char *)log_table,
-				(const char *)log_table,
-				(const char *)log_table);
+from `%s` left join CART on `%s`.CART_NUMBER=CART.NUMBER%s order by COUNT",
+				(const char *)table,
+				(const char *)table,
+				(const char *)table,
+				(const char *)table,
+				(const char *)table,
+				(const char *)table,
+				(const char *)table,
+				(const char *)table,
+				(const char *)table,
+				(const char *)table,
+				(const char *)table,
+				(const char *)table,
+				(const char *)table,
+				(const char *)table,
+				(const char *)table,
+				(const char *)table,
+				(const char *)table,
+				(const char *)table,
+				(const char *)table,
+				(const char *)table,
+				(const char *)table,
+				(const char *)table,
+				(const char *)table,
+				(const char *)table,
+				(const char *)table,
+				(const char *)table,
+				(const char *)table,
+				(const char *)table,
+				(const char *)table,
+				(const char *)table,
+				(const char *)table,
+				(const char *)table,
+				(const char *)table,
+				(const char *)table,
+				(const char *)table,
+				(const char *)table,
+				(const char *)table,
+				(const char *)table,
+				(const char *)table,
+				(const char *)table,
+				(const char *)where);
    q=new RDSqlQuery(sql);
   if(q->size()<=0) {
     delete q;
@@ -1179,7 +1199,7 @@ void RDLogEvent::InsertLines(QString values) {
   QString sql;
   RDSqlQuery *q;
 
-  sql = QString().sprintf("insert into `%s` (ID,COUNT,CART_NUMBER,START_TIME,TIME_TYPE,\
+  sql = QString().sprintf("insert into `%s` (%sID,COUNT,CART_NUMBER,START_TIME,TIME_TYPE,\
   TRANS_TYPE,START_POINT,END_POINT,SEGUE_START_POINT,SEGUE_END_POINT,TYPE, \
   COMMENT,LABEL,GRACE_TIME,SOURCE,EXT_START_TIME,                       \
   EXT_LENGTH,EXT_DATA,EXT_EVENT_ID,EXT_ANNC_TYPE,EXT_CART_NAME,         \
@@ -1187,7 +1207,8 @@ void RDLogEvent::InsertLines(QString values) {
   LINK_EVENT_NAME,LINK_START_TIME,LINK_LENGTH,LINK_ID,LINK_EMBEDDED,    \
   ORIGIN_USER,ORIGIN_DATETIME,LINK_START_SLOP,LINK_END_SLOP,            \
   DUCK_UP_GAIN,DUCK_DOWN_GAIN,EVENT_LENGTH) values %s",
-                          (const char *)log_name,
+                          (const char *)LineTable(log_name),
+                          IsLog(log_name)?"LOG_NAME,":"",
                           (const char *)values);
   q=new RDSqlQuery(sql);
   delete q;
@@ -1197,7 +1218,7 @@ void RDLogEvent::InsertLines(QString values) {
 void RDLogEvent::InsertLineValues(QString *query, int line)
 {
   // one line to save query space
-  QString sql=QString().sprintf("(%d,%d,%u,%d,%d,%d,%d,%d,%d,%d,%d,\"%s\",\"%s\",%d,%d,%s,%d,\"%s\",\"%s\",\"%s\",\"%s\",%d,%d,%d,%d,%d,\"%s\",%d,%d,%d,\"%s\",\"%s\",%s,%d,%d,%d,%d,%d)",
+  QString sql=QString().sprintf("%d,%d,%u,%d,%d,%d,%d,%d,%d,%d,%d,\"%s\",\"%s\",%d,%d,%s,%d,\"%s\",\"%s\",\"%s\",\"%s\",%d,%d,%d,%d,%d,\"%s\",%d,%d,%d,\"%s\",\"%s\",%s,%d,%d,%d,%d,%d)",
                         log_line[line]->id(),
                         line,
                         log_line[line]->cartNumber(),
@@ -1246,7 +1267,11 @@ void RDLogEvent::InsertLineValues(QString *query, int line)
                         log_line[line]->duckUpGain(),
                         log_line[line]->duckDownGain(),
                         log_line[line]->eventLength());
-  *query += sql;
+  *query+="(";
+  if(IsLog(log_name)) {
+    *query+="\""+RDEscapeString(log_name.left(log_name.length()-4))+"\",";
+  }
+  *query+=sql;
 }
 
 void RDLogEvent::SaveLine(int line)
@@ -1281,3 +1306,28 @@ void RDLogEvent::LoadNowNext(unsigned from_line)
   }
 }
 
+
+bool RDLogEvent::IsLog(const QString &table) const
+{
+  //
+  // Logs are stored in LOG_LINES; event pre- and post-import lists still
+  // have tables of their own with the same layout.
+  //
+  return table.right(4)=="_LOG";
+}
+
+
+QString RDLogEvent::LineTable(const QString &table) const
+{
+  if(IsLog(table)) {
+    return QString("LOG_LINES");
+  }
+  return table;
+}
+
+
+QString RDLogEvent::LineFilter(const QString &table) const
+{
+  return QString("(LOG_LINES.LOG_NAME=\"")+
+    RDEscapeString(table.left(table.length()-4))+"\")";
+}
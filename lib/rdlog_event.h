@@ -77,6 +77,9 @@ class RDLogEvent
    void InsertLines(QString values);
    void InsertLineValues(QString *query, int line);
    void LoadNowNext(unsigned from_line);
+   bool IsLog(const QString &table) const;
+   QString LineTable(const QString &table) const;
+   QString LineFilter(const QString &table) const;
    QString log_name;
    QString log_service_name;
    int log_max_id;
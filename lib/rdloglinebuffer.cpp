@@ -0,0 +1,165 @@
+// rdloglinebuffer.cpp
+//
+// Buffered LOG_LINES writer for log generation
+//
+//   (C) Copyright 2018 Fred Gleason <fredg@paravelsystems.com>
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License version 2 as
+//   published by the Free Software Foundation.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public
+//   License along with this program; if not, write to the Free Software
+//   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+//
+
+#include "rddb.h"
+#include "rdescape_string.h"
+#include "rdloglinebuffer.h"
+
+//
+// Must match the order of RDLogLineBuffer::Column
+//
+static const char *rdloglinebuffer_columns[]=
+  {"TYPE","SOURCE","START_TIME","GRACE_TIME","CART_NUMBER","TIME_TYPE",
+   "POST_POINT","TRANS_TYPE","COMMENT","LABEL","EVENT_LENGTH",
+   "LINK_EVENT_NAME","LINK_START_TIME","LINK_LENGTH","LINK_ID",
+   "LINK_START_SLOP","LINK_END_SLOP","EXT_START_TIME"};
+
+RDLogLineBuffer::RDLogLineBuffer(const QString &logname)
+{
+  QString sql;
+  RDSqlQuery *q;
+
+  buf_log_name=logname;
+  buf_next_count=0;
+  buf_next_link_id=0;
+
+  sql=QString("select ")+
+    "max(COUNT),"+  // 00
+    "max(LINK_ID) "+  // 01
+    "from LOG_LINES where "+
+    "LOG_NAME=\""+RDEscapeString(logname)+"\"";
+  q=new RDSqlQuery(sql);
+  if(q->first()) {
+    if(!q->value(0).isNull()) {
+      buf_next_count=q->value(0).toInt()+1;
+    }
+    if((!q->value(1).isNull())&&(q->value(1).toInt()>=0)) {
+      buf_next_link_id=q->value(1).toInt()+1;
+    }
+  }
+  delete q;
+}
+
+
+QString RDLogLineBuffer::logName() const
+{
+  return buf_log_name;
+}
+
+
+int RDLogLineBuffer::nextCount() const
+{
+  return buf_next_count;
+}
+
+
+int RDLogLineBuffer::nextLinkId() const
+{
+  return buf_next_link_id;
+}
+
+
+unsigned RDLogLineBuffer::size() const
+{
+  return buf_lines.size();
+}
+
+
+int RDLogLineBuffer::addLine()
+{
+  QStringList values;
+
+  for(int i=0;i<RDLogLineBuffer::LastColumn;i++) {
+    values.push_back("default");
+  }
+  buf_lines.push_back(values);
+
+  return buf_next_count++;
+}
+
+
+void RDLogLineBuffer::setValue(Column col,int value)
+{
+  setSqlValue(col,QString().sprintf("%d",value));
+  if((col==RDLogLineBuffer::LinkId)&&(value>=buf_next_link_id)) {
+    buf_next_link_id=value+1;
+  }
+}
+
+
+void RDLogLineBuffer::setValue(Column col,const QString &value)
+{
+  setSqlValue(col,"\""+RDEscapeString(value)+"\"");
+}
+
+
+void RDLogLineBuffer::setSqlValue(Column col,const QString &sql)
+{
+  if(buf_lines.size()>0) {
+    buf_lines.back()[col]=sql;
+  }
+}
+
+
+bool RDLogLineBuffer::flush()
+{
+  QString sql;
+  QString fields;
+  RDSqlQuery *q;
+  bool ret=true;
+  int count=buf_next_count-buf_lines.size();
+
+  if(buf_lines.size()==0) {
+    return true;
+  }
+  for(int i=0;i<RDLogLineBuffer::LastColumn;i++) {
+    fields+=QString(",")+rdloglinebuffer_columns[i];
+  }
+
+  //
+  // Tables using a non-transactional engine (such as MyISAM) just ignore
+  // the transaction, but still get the benefit of the multi-row inserts.
+  //
+  q=new RDSqlQuery("start transaction");
+  delete q;
+  for(unsigned i=0;i<buf_lines.size();i+=RDLOGLINEBUFFER_MAX_ROWS) {
+    sql=QString("insert into LOG_LINES (LOG_NAME,ID,COUNT")+fields+") values ";
+    for(unsigned j=i;(j<buf_lines.size())&&(j<(i+RDLOGLINEBUFFER_MAX_ROWS));
+	j++) {
+      sql+="(\""+RDEscapeString(buf_log_name)+"\","+
+	QString().sprintf("%d,%d,",count,count)+buf_lines[j].join(",")+"),";
+      count++;
+    }
+    sql=sql.left(sql.length()-1);
+    q=new RDSqlQuery(sql);
+    ret=ret&&q->isActive();
+    delete q;
+  }
+  if(ret) {
+    q=new RDSqlQuery("commit");
+  }
+  else {
+    q=new RDSqlQuery("rollback");
+  }
+  delete q;
+  buf_lines.clear();
+
+  return ret;
+}
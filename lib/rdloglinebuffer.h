@@ -0,0 +1,67 @@
+// rdloglinebuffer.h
+//
+// Buffered LOG_LINES writer for log generation
+//
+//   (C) Copyright 2018 Fred Gleason <fredg@paravelsystems.com>
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License version 2 as
+//   published by the Free Software Foundation.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public
+//   License along with this program; if not, write to the Free Software
+//   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+//
+
+#ifndef RDLOGLINEBUFFER_H
+#define RDLOGLINEBUFFER_H
+
+#include <vector>
+
+#include <qstringlist.h>
+
+//
+// Maximum number of rows sent in a single INSERT statement
+//
+#define RDLOGLINEBUFFER_MAX_ROWS 250
+
+//
+// Collects the lines of a log as it is generated and writes them with
+// multi-row INSERTs inside a single transaction when flush() is called.
+// ID/COUNT and LINK_ID values are handed out from the buffer, so no
+// queries are needed to find them while the log is being built.  Columns
+// that are not set for a line get their table default.
+//
+class RDLogLineBuffer
+{
+ public:
+  enum Column {Type=0,Source=1,StartTime=2,GraceTime=3,CartNumber=4,
+	       TimeType=5,PostPoint=6,TransType=7,Comment=8,Label=9,
+	       EventLength=10,LinkEventName=11,LinkStartTime=12,
+	       LinkLength=13,LinkId=14,LinkStartSlop=15,LinkEndSlop=16,
+	       ExtStartTime=17,LastColumn=18};
+  RDLogLineBuffer(const QString &logname);
+  QString logName() const;
+  int nextCount() const;
+  int nextLinkId() const;
+  unsigned size() const;
+  int addLine();
+  void setValue(Column col,int value);
+  void setValue(Column col,const QString &value);
+  void setSqlValue(Column col,const QString &sql);
+  bool flush();
+
+ private:
+  QString buf_log_name;
+  int buf_next_count;
+  int buf_next_link_id;
+  std::vector<QStringList> buf_lines;
+};
+
+
+#endif  // RDLOGLINEBUFFER_H
@@ -105,6 +105,8 @@ RDLogPlay::RDLogPlay(int id,RDEventPlayer *player,QSocketDevice *nn_sock,
   play_prevnow_cartnum=0;
   play_prevnext_cartnum=0;
   play_op_mode=RDAirPlayConf::Auto;
+  play_start_times_running=false;
+  play_start_times_mode=RDAirPlayConf::Auto;
 
   //
   // Macro Cart Decks
@@ -158,6 +160,18 @@ RDLogPlay::RDLogPlay(int id,RDEventPlayer *player,QSocketDevice *nn_sock,
   play_grace_timer=new QTimer(this);
   connect(play_grace_timer,SIGNAL(timeout()),
 	  this,SLOT(graceTimerData()));
+
+  //
+  // As-Played Write Queue
+  //
+  play_elr_timer=new QTimer(this);
+  connect(play_elr_timer,SIGNAL(timeout()),this,SLOT(elrFlushData()));
+}
+
+
+RDLogPlay::~RDLogPlay()
+{
+  elrFlushData();
 }
 
 
@@ -854,7 +868,7 @@ void RDLogPlay::insert(int line,int cartnum,RDLogLine::TransType next_type,
 		    rda->airplayConf()->defaultTransType());
   logline->
     setTimescalingActive(play_timescaling_available&&logline->enforceLength());
-  UpdateStartTimes(line);
+  UpdateStartTimes(line,true);
   emit inserted(line);
   UpdatePostPoint();
   if(mod_line>=0) {
@@ -908,7 +922,7 @@ void RDLogPlay::insert(int line,RDLogLine *l,bool update,bool preserv_custom_tra
   logline->
     setTimescalingActive(play_timescaling_available&&logline->enforceLength());
   if(update) {
-    UpdateStartTimes(line);
+    UpdateStartTimes(line,true);
     emit inserted(line);
     UpdatePostPoint();
     if(mod_line>=0) {
@@ -970,7 +984,7 @@ void RDLogPlay::remove(int line,int num_lines,bool update,bool preserv_custom_tr
     if(nextLine()>line) {
       makeNext(nextLine()-num_lines);
     }
-    UpdateStartTimes(line);
+    UpdateStartTimes(line,true);
     if(size()==0) {
       emit reloaded();
     }
@@ -1298,7 +1312,7 @@ void RDLogPlay::lineModified(int line)
   RDLogLine *next_logline;
 
   SetTransTimer();
-  UpdateStartTimes(line);
+  UpdateStartTimes(line,true);
 
   if((logline=logLine(line))!=NULL) {
     if((next_logline=logLine(line+1))==NULL) {
@@ -1561,7 +1575,7 @@ void RDLogPlay::segueEndData(int id)
      (logline->status()==RDLogLine::Finishing)) {
     ((RDPlayDeck *)logline->playDeck())->stop();
     CleanupEvent(id);
-    UpdateStartTimes(line);
+    UpdateStartTimes(line,true);
     LogTraffic(serviceName(),logName().left(logName().length()-4),logline,
 	       (RDLogLine::PlaySource)(play_id+1),
 	       RDAirPlayConf::TrafficFinish,play_onair_flag);
@@ -1619,7 +1633,7 @@ void RDLogPlay::macroStartedData()
   logline->
     setStartTime(RDLogLine::Initial,
 		 QTime::currentTime().addMSecs(rda->station()->timeOffset()));
-  UpdateStartTimes(line);
+  UpdateStartTimes(line,true);
   emit played(line);
   UpdatePostPoint();
   emit transportChanged();
@@ -1713,10 +1727,9 @@ void RDLogPlay::notificationReceivedData(RDNotification *notify)
   RDLogLine *next_ll=NULL;
 
   if(notify->type()==RDNotification::CartType) {
-    unsigned cartnum=notify->id().toUInt();
     for(int i=0;i<size();i++) {
       if((ll=logLine(i))!=NULL) {
-	if((ll->cartNumber()==cartnum)&&(ll->status()==RDLogLine::Scheduled)&&
+	if(notify->containsId(QVariant(ll->cartNumber()))&&(ll->status()==RDLogLine::Scheduled)&&
 	   ((ll->type()==RDLogLine::Cart)||(ll->type()==RDLogLine::Macro))) {
 	  switch(ll->state()) {
 	  case RDLogLine::Ok:
@@ -1745,7 +1758,7 @@ void RDLogPlay::notificationReceivedData(RDNotification *notify)
     //
     // Check Refreshability
     //
-    if((play_log!=NULL)&&(notify->id().toString()==play_log->name())) {
+    if((play_log!=NULL)&&notify->containsId(QVariant(play_log->name()))) {
       if((!play_log->exists())||(play_log->linkDatetime()!=play_link_datetime)||
 	 (play_log->modifiedDatetime()<=play_modified_datetime)) {
 	if(play_refreshable) {
@@ -1769,6 +1782,56 @@ void RDLogPlay::notificationReceivedData(RDNotification *notify)
 }
 
 
+void RDLogPlay::elrFlushData()
+{
+  QString sql;
+  RDSqlQuery *q;
+
+  play_elr_timer->stop();
+  if(play_elr_queue.size()==0) {
+    return;
+  }
+  sql=QString("insert into ELR_LINES (")+
+    "SERVICE_NAME,"+
+    "LENGTH,"+
+    "LOG_NAME,"+
+    "LOG_ID,"+
+    "CART_NUMBER,"+
+    "STATION_NAME,"+
+    "EVENT_DATETIME,"+
+    "EVENT_TYPE,"+
+    "EVENT_SOURCE,"+
+    "EXT_START_TIME,"+
+    "EXT_LENGTH,"+
+    "EXT_DATA,"+
+    "EXT_EVENT_ID,"+
+    "EXT_ANNC_TYPE,"+
+    "PLAY_SOURCE,"+
+    "CUT_NUMBER,"+
+    "EXT_CART_NAME,"+
+    "TITLE,"+
+    "ARTIST,"+
+    "SCHEDULED_TIME,"+
+    "ISRC,"+
+    "PUBLISHER,"+
+    "COMPOSER,"+
+    "USAGE_CODE,"+
+    "START_SOURCE,"+
+    "ONAIR_FLAG,"+
+    "ALBUM,"+
+    "LABEL,"+
+    "USER_DEFINED,"+
+    "CONDUCTOR,"+
+    "SONG_ID,"+
+    "DESCRIPTION,"+
+    "OUTCUE,"+
+    "ISCI) values "+play_elr_queue.join(",");
+  q=new RDSqlQuery(sql);
+  delete q;
+  play_elr_queue.clear();
+}
+
+
 bool RDLogPlay::StartEvent(int line,RDLogLine::TransType trans_type,
 			   int trans_length,RDLogLine::StartSource src,
 			   int mport,int duck_length)
@@ -2033,7 +2096,7 @@ bool RDLogPlay::StartEvent(int line,RDLogLine::TransType trans_type,
 	// Skip Past
 	//
 	logline->setStatus(RDLogLine::Finished);
-	UpdateStartTimes(line);
+	UpdateStartTimes(line,true);
 	emit played(line);
 	FinishEvent(line);
 	emit nextEventChanged(play_next_line);
@@ -2178,7 +2241,7 @@ void RDLogPlay::CleanupEvent(int id)
 }
 
 
-void RDLogPlay::UpdateStartTimes(int line)
+void RDLogPlay::UpdateStartTimes(int line,bool incremental)
 {
   QTime time;
   QTime new_time;
@@ -2194,6 +2257,9 @@ void RDLogPlay::UpdateStartTimes(int line)
   RDLogLine *next_logline;
   RDLogLine::TransType next_trans;
   int lines[TRANSPORT_QUANTITY];
+  int changed_line=line;
+  bool converge=false;
+  bool converged=false;
 
   if((running=runningEvents(lines,false))>0) {
     line=lines[0];
@@ -2201,6 +2267,15 @@ void RDLogPlay::UpdateStartTimes(int line)
   else {
     line=play_next_line;
   }
+
+  //
+  // When nothing upstream of 'changed_line' has been touched, the times
+  // past it only need recalculating until a scheduled line comes out with
+  // the same predicted time as before; everything after that line is
+  // derived from identical inputs and so is already correct.
+  //
+  converge=incremental&&((running>0)==play_start_times_running)&&
+    (play_op_mode==play_start_times_mode);
   for(int i=line;i<size();i++) {
     if((logline=logLine(i))!=NULL) {
       if((next_logline=logLine(nextLine(i)))!=NULL) {
@@ -2222,9 +2297,17 @@ void RDLogPlay::UpdateStartTimes(int line)
 				  logline->timeType(),
 				  time,prev_total_length,prev_segue_length,
 				  &stop,running);
+	    if(converge&&(i>changed_line)&&
+	       (logline->status()==RDLogLine::Scheduled)&&
+	       (time==logline->startTime(RDLogLine::Predicted))) {
+	      converged=true;
+	    }
 	    logline->setStartTime(RDLogLine::Predicted,time);
 	    break;
       }
+      if(converged) {
+	break;
+      }
       if(stop&&(!stop_set)) {
 	next_stop=time.addMSecs(prev_total_length);
 	stop_set=true;
@@ -2258,6 +2341,8 @@ void RDLogPlay::UpdateStartTimes(int line)
       }
     }
   }
+  play_start_times_running=running>0;
+  play_start_times_mode=play_op_mode;
   next_stop=GetNextStop(line);
 
   if(next_stop!=play_next_stop) {
@@ -2292,7 +2377,7 @@ void RDLogPlay::FinishEvent(int line)
       }
     }
   }
-  UpdateStartTimes(line);
+  UpdateStartTimes(line,true);
   emit stopped(line);
 }
 
@@ -2721,7 +2806,7 @@ void RDLogPlay::Playing(int id)
   if((logline=logLine(line))==NULL) {
     return;
   }
-  UpdateStartTimes(line);
+  UpdateStartTimes(line,true);
   emit played(line);
   AdvanceActiveEvent();
   UpdatePostPoint();
@@ -2739,7 +2824,7 @@ void RDLogPlay::Paused(int id)
     logline->setPortName("");
     logline->setStatus(RDLogLine::Paused);
   }
-  UpdateStartTimes(line);
+  UpdateStartTimes(line,true);
   emit paused(line);
   UpdatePostPoint();
   LogTraffic(serviceName(),logName().left(logName().length()-4),logLine(line),
@@ -2759,7 +2844,7 @@ void RDLogPlay::Stopped(int id)
   int line=GetLineById(id);
   int lines[TRANSPORT_QUANTITY];
   CleanupEvent(id);
-  UpdateStartTimes(line);
+  UpdateStartTimes(line,true);
   emit stopped(line);
   AdvanceActiveEvent();
   UpdatePostPoint();
@@ -2834,8 +2919,9 @@ void RDLogPlay::ClearChannel(int deckid)
 RDLogLine::TransType RDLogPlay::GetTransType(const QString &logname,int line)
 {
   RDLogLine::TransType trans=RDLogLine::Stop;
-  QString sql=QString("select TRANS_TYPE from `")+
-    RDLog::tableName(logname)+"` where "+QString().sprintf("COUNT=%d",line);
+  QString sql=QString("select TRANS_TYPE from LOG_LINES where ")+
+    "(LOG_NAME=\""+RDEscapeString(logname)+"\")&&"+
+    QString().sprintf("(COUNT=%d)",line);
   RDSqlQuery *q=new RDSqlQuery(sql);
   if(q->first()) {
     trans=(RDLogLine::TransType)q->value(0).toUInt();
@@ -2979,10 +3065,8 @@ void RDLogPlay::SendNowNext()
 void RDLogPlay::LogTraffic(const QString &svcname,const QString &logname,
 			   RDLogLine *logline,RDLogLine::PlaySource src,
 			   RDAirPlayConf::TrafficAction action,bool onair_flag)
-  const
 {
   QString sql;
-  RDSqlQuery *q;
   QDateTime datetime=QDateTime(QDate::currentDate(),QTime::currentTime());
   int length=logline->startTime(RDLogLine::Actual).msecsTo(datetime.time());
   if(length<0) {  // Event crossed midnight!
@@ -2994,48 +3078,64 @@ void RDLogPlay::LogTraffic(const QString &svcname,const QString &logname,
     return;
   }
 
-  QString eventDateTimeSQL = "NULL";
+  //
+  // ELR_LINES.EVENT_DATETIME cannot be NULL, so fall back to the time of
+  // logging if the actual start time is unknown.
+  //
+  QString eventDateTimeSQL=
+    RDCheckDateTime(QDateTime::currentDateTime(),"yyyy-MM-dd hh:mm:ss");
 
   if(datetime.isValid() && logline->startTime(RDLogLine::Actual).isValid())
     eventDateTimeSQL = RDCheckDateTime(QDateTime(datetime.date(),
           logline->startTime(RDLogLine::Actual)), "yyyy-MM-dd hh:mm:ss");
 
-  sql=QString("insert into `")+RDSvc::svcTableName(svcname)+"` set "+
-    QString().sprintf("LENGTH=%d,",length)+
-    "LOG_NAME=\""+RDEscapeString(logname.utf8())+"\","+
-    QString().sprintf("LOG_ID=%d,",logline->id())+
-    QString().sprintf("CART_NUMBER=%u,",logline->cartNumber())+
-    "STATION_NAME=\""+RDEscapeString(rda->station()->name().utf8())+"\","+
-    "EVENT_DATETIME="+eventDateTimeSQL+","+
-    QString().sprintf("EVENT_TYPE=%d,",action)+
-    QString().sprintf("EVENT_SOURCE=%d,",logline->source())+
-    "EXT_START_TIME="+RDCheckDateTime(logline->extStartTime(),"hh:mm:ss")+","+
-    QString().sprintf("EXT_LENGTH=%d,",logline->extLength())+
-    "EXT_DATA=\""+RDEscapeString(logline->extData())+"\","+
-    "EXT_EVENT_ID=\""+RDEscapeString(logline->extEventId())+"\","+
-    "EXT_ANNC_TYPE=\""+RDEscapeString(logline->extAnncType())+"\","+
-    QString().sprintf("PLAY_SOURCE=%d,",src)+
-    QString().sprintf("CUT_NUMBER=%d,",logline->cutNumber())+
-    "EXT_CART_NAME=\""+RDEscapeString(logline->extCartName().utf8())+"\","+
-    "TITLE=\""+RDEscapeString(logline->title().utf8())+"\","+
-    "ARTIST=\""+RDEscapeString(logline->artist().utf8())+"\","+
-    "SCHEDULED_TIME="+RDCheckDateTime(logline->startTime(RDLogLine::Logged),
-				       "hh:mm:ss")+","+
-    "ISRC=\""+RDEscapeString(logline->isrc().utf8())+"\","+
-    "PUBLISHER=\""+RDEscapeString(logline->publisher().utf8())+"\","+
-    "COMPOSER=\""+RDEscapeString(logline->composer().utf8())+"\","+
-    QString().sprintf("USAGE_CODE=%d,",logline->usageCode())+
-    QString().sprintf("START_SOURCE=%d,",logline->startSource())+
-    "ONAIR_FLAG=\""+RDYesNo(onair_flag)+"\","+
-    "ALBUM=\""+RDEscapeString(logline->album().utf8())+"\","+
-    "LABEL=\""+RDEscapeString(logline->label().utf8())+"\","+
-    "USER_DEFINED=\""+RDEscapeString(logline->userDefined().utf8())+"\","+
-    "CONDUCTOR=\""+RDEscapeString(logline->conductor().utf8())+"\","+
-    "SONG_ID=\""+RDEscapeString(logline->songId().utf8())+"\","+
-    "DESCRIPTION=\""+RDEscapeString(logline->description().utf8())+"\","+
-    "OUTCUE=\""+RDEscapeString(logline->outcue().utf8())+"\","+
-    "ISCI=\""+RDEscapeString(logline->isci().utf8())+"\"";
-
-  q=new RDSqlQuery(sql);
-  delete q;
+  //
+  // Rows are queued and written as a single multi-row insert, either once
+  // LOGPLAY_ELR_BATCH_SIZE events have accumulated or after
+  // LOGPLAY_ELR_FLUSH_INTERVAL mS, whichever comes first.
+  //
+  sql=QString("(")+
+    "\""+RDEscapeString(svcname)+"\","+
+    QString().sprintf("%d,",length)+
+    "\""+RDEscapeString(logname.utf8())+"\","+
+    QString().sprintf("%d,",logline->id())+
+    QString().sprintf("%u,",logline->cartNumber())+
+    "\""+RDEscapeString(rda->station()->name().utf8())+"\","+
+    eventDateTimeSQL+","+
+    QString().sprintf("%d,",action)+
+    QString().sprintf("%d,",logline->source())+
+    RDCheckDateTime(logline->extStartTime(),"hh:mm:ss")+","+
+    QString().sprintf("%d,",logline->extLength())+
+    "\""+RDEscapeString(logline->extData())+"\","+
+    "\""+RDEscapeString(logline->extEventId())+"\","+
+    "\""+RDEscapeString(logline->extAnncType())+"\","+
+    QString().sprintf("%d,",src)+
+    QString().sprintf("%d,",logline->cutNumber())+
+    "\""+RDEscapeString(logline->extCartName().utf8())+"\","+
+    "\""+RDEscapeString(logline->title().utf8())+"\","+
+    "\""+RDEscapeString(logline->artist().utf8())+"\","+
+    RDCheckDateTime(logline->startTime(RDLogLine::Logged),"hh:mm:ss")+","+
+    "\""+RDEscapeString(logline->isrc().utf8())+"\","+
+    "\""+RDEscapeString(logline->publisher().utf8())+"\","+
+    "\""+RDEscapeString(logline->composer().utf8())+"\","+
+    QString().sprintf("%d,",logline->usageCode())+
+    QString().sprintf("%d,",logline->startSource())+
+    "\""+RDYesNo(onair_flag)+"\","+
+    "\""+RDEscapeString(logline->album().utf8())+"\","+
+    "\""+RDEscapeString(logline->label().utf8())+"\","+
+    "\""+RDEscapeString(logline->userDefined().utf8())+"\","+
+    "\""+RDEscapeString(logline->conductor().utf8())+"\","+
+    "\""+RDEscapeString(logline->songId().utf8())+"\","+
+    "\""+RDEscapeString(logline->description().utf8())+"\","+
+    "\""+RDEscapeString(logline->outcue().utf8())+"\","+
+    "\""+RDEscapeString(logline->isci().utf8())+"\")";
+  play_elr_queue.push_back(sql);
+  if(play_elr_queue.size()>=LOGPLAY_ELR_BATCH_SIZE) {
+    elrFlushData();
+  }
+  else {
+    if(!play_elr_timer->isActive()) {
+      play_elr_timer->start(LOGPLAY_ELR_FLUSH_INTERVAL,true);
+    }
+  }
 }
@@ -28,6 +28,7 @@
 #include <qtimer.h>
 #include <qsocketdevice.h>
 #include <qdatetime.h>
+#include <qstringlist.h>
 
 #include <rd.h>
 #include <rdairplay_conf.h>
@@ -48,6 +49,8 @@
 #define LOGPLAY_LOOKAHEAD_EVENTS 20
 #define LOGPLAY_RESCAN_INTERVAL 5000
 #define LOGPLAY_RESCAN_SIZE 30
+#define LOGPLAY_ELR_BATCH_SIZE 20
+#define LOGPLAY_ELR_FLUSH_INTERVAL 5000
 
 class RDLogPlay : public QObject,public RDLogEvent
 {
@@ -55,6 +58,7 @@ class RDLogPlay : public QObject,public RDLogEvent
  public:
   RDLogPlay(int id,RDEventPlayer *player,QSocketDevice *nn_sock,QString logname,
 	  std::vector<RDRLMHost *> *rlm_hosts,QObject *parent=0);
+  ~RDLogPlay();
   QString serviceName() const;
   void setServiceName(const QString &svcname);
   QString defaultServiceName() const;
@@ -129,6 +133,7 @@ class RDLogPlay : public QObject,public RDLogEvent
   void auditionStartedData();
   void auditionStoppedData();
   void notificationReceivedData(RDNotification *notify);
+  void elrFlushData();
 
  signals:
   void renamed();
@@ -160,7 +165,7 @@ class RDLogPlay : public QObject,public RDLogEvent
 		  RDLogLine::StartSource src,int mport=-1,int duck_length=0);
   bool StartAudioEvent(int line);
   void CleanupEvent(int id);
-  void UpdateStartTimes(int line);
+  void UpdateStartTimes(int line,bool incremental=false);
   void FinishEvent(int line);
   QTime GetStartTime(QTime sched_time,RDLogLine::TransType trans_type,
 		     RDLogLine::TimeType time_type,QTime prev_time,
@@ -190,7 +195,7 @@ class RDLogPlay : public QObject,public RDLogEvent
   void SendNowNext();
   void LogTraffic(const QString &svcname,const QString &logname,
 		  RDLogLine *logline,RDLogLine::PlaySource src,
-		  RDAirPlayConf::TrafficAction action,bool onair_flag) const;
+		  RDAirPlayConf::TrafficAction action,bool onair_flag);
   RDCae *play_cae;
   RDAirPlayConf::OpMode play_op_mode;
   int play_slot_id[LOGPLAY_MAX_PLAYS];
@@ -201,6 +206,8 @@ class RDLogPlay : public QObject,public RDLogEvent
   bool play_start_next;
   int play_id;
   QTime play_next_stop;
+  bool play_start_times_running;
+  RDAirPlayConf::OpMode play_start_times_mode;
   bool play_running;
   QTime play_post_time;
   int play_post_offset;
@@ -247,6 +254,8 @@ class RDLogPlay : public QObject,public RDLogEvent
   bool play_audition_head_played;
   int play_audition_preroll;
   RDEventPlayer *play_event_player;
+  QStringList play_elr_queue;
+  QTimer *play_elr_timer;
 };
 
 
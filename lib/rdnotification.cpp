@@ -18,13 +18,17 @@
 //   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
 //
 
+#include <qstringlist.h>
+
 #include "rdnotification.h"
 
 RDNotification::RDNotification(Type type,Action action,const QVariant &id)
 {
   notify_type=type;
   notify_action=action;
-  notify_id=id;
+  notify_length=0;
+  notify_sequence=0;
+  setId(id);
 }
 
 
@@ -32,6 +36,8 @@ RDNotification::RDNotification()
 {
   notify_type=RDNotification::NullType;
   notify_action=RDNotification::NoAction;
+  notify_length=0;
+  notify_sequence=0;
 }
 
 
@@ -59,15 +65,81 @@ void RDNotification::setAction(RDNotification::Action action)
 }
 
 
-QVariant RDNotification::id() const
+QVariant RDNotification::id(unsigned n) const
 {
-  return notify_id;
+  if(n>=notify_ids.size()) {
+    return QVariant();
+  }
+  return notify_ids[n];
 }
 
 
 void RDNotification::setId(const QVariant id)
 {
-  notify_id=id;
+  notify_ids.clear();
+  notify_length=0;
+  if(id.isValid()) {
+    notify_ids.push_back(id);
+    notify_length=IdString(id).length()+1;
+  }
+}
+
+
+unsigned RDNotification::idQuantity() const
+{
+  return notify_ids.size();
+}
+
+
+bool RDNotification::addId(const QVariant &id)
+{
+  unsigned len=IdString(id).length()+1;
+
+  //
+  // Leave room for the command words and the sequence tag
+  //
+  if((notify_ids.size()>=RDNOTIFICATION_MAX_IDS)||
+     ((notify_length+len)>(RDNOTIFICATION_MAX_LENGTH-128))) {
+    return false;
+  }
+  notify_ids.push_back(id);
+  notify_length+=len;
+  return true;
+}
+
+
+bool RDNotification::containsId(const QVariant &id) const
+{
+  for(unsigned i=0;i<notify_ids.size();i++) {
+    if(notify_ids[i]==id) {
+      return true;
+    }
+  }
+  return false;
+}
+
+
+QString RDNotification::source() const
+{
+  return notify_source;
+}
+
+
+void RDNotification::setSource(const QString &str)
+{
+  notify_source=str;
+}
+
+
+unsigned RDNotification::sequence() const
+{
+  return notify_sequence;
+}
+
+
+void RDNotification::setSequence(unsigned seq)
+{
+  notify_sequence=seq;
 }
 
 
@@ -79,48 +151,66 @@ bool RDNotification::isValid() const
 
 bool RDNotification::read(const QString &str)
 {
+  unsigned last;
+  int slash;
+
   notify_type=RDNotification::NullType;
   notify_action=RDNotification::NoAction;
-  notify_id=QVariant();
+  notify_ids.clear();
+  notify_length=0;
+  notify_source="";
+  notify_sequence=0;
 
   QStringList args=args.split(" ",str);
-  if(args.size()==4) {
-    if(args[0]!="NOTIFY") {
-      return false;
+  if((args.size()<4)||(args[0]!="NOTIFY")) {
+    return false;
+  }
+  for(int i=0;i<RDNotification::LastType;i++) {
+    RDNotification::Type type=(RDNotification::Type)i;
+    if(args[1]==RDNotification::typeString(type)) {
+      notify_type=type;
     }
-    for(int i=0;i<RDNotification::LastType;i++) {
-      RDNotification::Type type=(RDNotification::Type)i;
-      if(args[1]==RDNotification::typeString(type)) {
-	notify_type=type;
-	switch(type) {
-	case RDNotification::CartType:
-	  notify_id=QVariant(args[3].toUInt());
-	  break;
-
-	case RDNotification::LogType:
-	  notify_id=QVariant(args[3]);
-	  break;
-
-	case RDNotification::NullType:
-	case RDNotification::LastType:
-	  break;
-	}
-      }
+  }
+  if(notify_type==RDNotification::NullType) {
+    return false;
+  }
+  for(int i=0;i<RDNotification::LastAction;i++) {
+    RDNotification::Action action=(RDNotification::Action)i;
+    if(args[2]==RDNotification::actionString(action)) {
+      notify_action=action;
     }
-    if(notify_type==RDNotification::NullType) {
-      return false;
+  }
+  if(notify_action==RDNotification::NoAction) {
+    return false;
+  }
+
+  //
+  // Sequence Tag
+  //
+  last=args.size();
+  if(args[last-1].left(1)=="@") {
+    if((slash=args[last-1].findRev("/"))>1) {
+      notify_source=Decode(args[last-1].mid(1,slash-1));
+      notify_sequence=args[last-1].right(args[last-1].length()-slash-1).
+	toUInt();
     }
-    for(int i=0;i<RDNotification::LastAction;i++) {
-      RDNotification::Action action=(RDNotification::Action)i;
-      if(args[2]==RDNotification::actionString(action)) {
-	notify_action=action;
-      }
+    last--;
+  }
+
+  //
+  // IDs
+  //
+  for(unsigned i=3;i<last;i++) {
+    if(notify_type==RDNotification::CartType) {
+      notify_ids.push_back(QVariant(args[i].toUInt()));
     }
-    if(notify_action==RDNotification::NoAction) {
-      return false;
+    else {
+      notify_ids.push_back(QVariant(Decode(args[i])));
     }
+    notify_length+=args[i].length()+1;
   }
-  return true;
+
+  return notify_ids.size()>0;
 }
 
 
@@ -130,19 +220,12 @@ QString RDNotification::write() const
 
   ret+="NOTIFY ";
   ret+=RDNotification::typeString(notify_type)+" ";
-  ret+=RDNotification::actionString(notify_action)+" ";
-  switch(notify_type) {
-  case RDNotification::CartType: 
-    ret+=QString().sprintf("%u",notify_id.toUInt());
-    break;
-
-  case RDNotification::LogType: 
-    ret+=notify_id.toString();
-    break;
-
-  case RDNotification::NullType:
-  case RDNotification::LastType:
-    break;
+  ret+=RDNotification::actionString(notify_action);
+  for(unsigned i=0;i<notify_ids.size();i++) {
+    ret+=" "+IdString(notify_ids[i]);
+  }
+  if(notify_sequence>0) {
+    ret+=" @"+Encode(notify_source)+QString().sprintf("/%u",notify_sequence);
   }
   return ret;
 }
@@ -161,6 +244,34 @@ QString RDNotification::typeString(RDNotification::Type type)
     ret="LOG";
     break;
 
+  case RDNotification::StationType:
+    ret="STATION";
+    break;
+
+  case RDNotification::CutType:
+    ret="CUT";
+    break;
+
+  case RDNotification::GroupType:
+    ret="GROUP";
+    break;
+
+  case RDNotification::ServiceType:
+    ret="SERVICE";
+    break;
+
+  case RDNotification::ClockType:
+    ret="CLOCK";
+    break;
+
+  case RDNotification::EventType:
+    ret="EVENT";
+    break;
+
+  case RDNotification::PanelType:
+    ret="PANEL";
+    break;
+
   case RDNotification::NullType:
   case RDNotification::LastType:
     break;
@@ -192,3 +303,54 @@ QString RDNotification::actionString(Action action)
   }
   return ret;
 }
+
+
+QString RDNotification::IdString(const QVariant &id) const
+{
+  if(notify_type==RDNotification::CartType) {
+    return QString().sprintf("%u",id.toUInt());
+  }
+  return Encode(id.toString());
+}
+
+
+QString RDNotification::Encode(const QString &str)
+{
+  //
+  // Anything that ripcd(8) would treat as a delimiter is escaped
+  //
+  QString ret;
+  QCString utf8=str.utf8();
+
+  for(unsigned i=0;i<utf8.length();i++) {
+    unsigned char c=utf8.at(i);
+    if((c>0x20)&&(c<0x7F)&&(c!='%')&&(c!='!')&&(c!='@')&&(c!='/')) {
+      ret+=QChar(c);
+    }
+    else {
+      ret+=QString().sprintf("%%%02X",c);
+    }
+  }
+  return ret;
+}
+
+
+QString RDNotification::Decode(const QString &str)
+{
+  QCString ret;
+  bool ok=false;
+  unsigned c;
+
+  for(unsigned i=0;i<str.length();i++) {
+    if((str.at(i)=='%')&&((i+2)<str.length())) {
+      c=str.mid(i+1,2).toUInt(&ok,16);
+      if(ok) {
+	ret+=(char)c;
+	i+=2;
+	continue;
+      }
+    }
+    ret+=str.at(i).latin1();
+  }
+  return QString::fromUtf8(ret);
+}
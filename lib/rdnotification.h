@@ -21,13 +21,34 @@
 #ifndef RDNOTIFICATION_H
 #define RDNOTIFICATION_H
 
+#include <vector>
+
 #include <qstring.h>
 #include <qvariant.h>
 
+//
+// Wire format:
+//
+//   NOTIFY <type> <action> <id> [<id> ...] [@<source>/<sequence>]
+//
+// A message can carry a batch of ids sharing the same type and action.
+// String ids are percent-encoded.  The optional trailing tag names the
+// sending process and carries a sequence number that increments by one
+// for each message it sends, so receivers can detect lost messages.
+//
+// Batches are limited to RDNOTIFICATION_MAX_IDS ids and
+// RDNOTIFICATION_MAX_LENGTH characters so that a message fits in a single
+// ripcd(8) command and notification datagram.
+//
+#define RDNOTIFICATION_MAX_IDS 90
+#define RDNOTIFICATION_MAX_LENGTH 1400
+
 class RDNotification
 {
  public:
-  enum Type {NullType=0,CartType=1,LogType=2,LastType=3};
+  enum Type {NullType=0,CartType=1,LogType=2,StationType=3,CutType=4,
+	     GroupType=5,ServiceType=6,ClockType=7,EventType=8,PanelType=9,
+	     LastType=10};
   enum Action {NoAction=0,AddAction=1,DeleteAction=2,ModifyAction=3,
 	       LastAction=4};
   RDNotification(Type type,Action action,const QVariant &id);
@@ -36,8 +57,15 @@ class RDNotification
   void setType(Type type);
   Action action() const;
   void setAction(Action action);
-  QVariant id() const;
+  QVariant id(unsigned n=0) const;
   void setId(const QVariant id);
+  unsigned idQuantity() const;
+  bool addId(const QVariant &id);
+  bool containsId(const QVariant &id) const;
+  QString source() const;
+  void setSource(const QString &str);
+  unsigned sequence() const;
+  void setSequence(unsigned seq);
   bool isValid() const;
   bool read(const QString &str);
   QString write() const;
@@ -45,9 +73,15 @@ class RDNotification
   static QString actionString(Action action);
 
  private:
+  QString IdString(const QVariant &id) const;
+  static QString Encode(const QString &str);
+  static QString Decode(const QString &str);
   Type notify_type;
   Action notify_action;
-  QVariant notify_id;
+  std::vector<QVariant> notify_ids;
+  unsigned notify_length;
+  QString notify_source;
+  unsigned notify_sequence;
 };
 
 
@@ -0,0 +1,489 @@
+// rdpeakscache.cpp
+//
+// Local cache for peak data exported by the RdXport Web Service
+//
+//   (C) Copyright 2018 Fred Gleason <fredg@paravelsystems.com>
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License version 2 as
+//   published by the Free Software Foundation.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public
+//   License along with this program; if not, write to the Free Software
+//   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+//
+
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include <qdir.h>
+
+#include "rd.h"
+#include "rdapplication.h"
+#include "rdconf.h"
+#include "rdcut.h"
+#include "rddb.h"
+#include "rdescape_string.h"
+#include "rdformpost.h"
+#include "rdpeakscache.h"
+#include "rdxport_interface.h"
+
+//
+// LibCURL Write Callback
+//
+size_t RDPeaksCacheWrite(void *ptr,size_t size,size_t nmemb,void *userdata)
+{
+  RDPeaksCacheFetch *fetch=(RDPeaksCacheFetch *)userdata;
+  size_t bytes=size*nmemb;
+
+  fetch->data.insert(fetch->data.end(),(uint8_t *)ptr,(uint8_t *)ptr+bytes);
+
+  return bytes;
+}
+
+
+RDPeaksCacheEntry::RDPeaksCacheEntry()
+{
+  last_used=0;
+}
+
+
+RDPeaksCacheFetch::RDPeaksCacheFetch()
+{
+  curl=NULL;
+  memset(url,0,1024);
+}
+
+
+RDPeaksCacheFetch::~RDPeaksCacheFetch()
+{
+  if(curl!=NULL) {
+    curl_easy_cleanup(curl);
+  }
+}
+
+
+RDPeaksCache::RDPeaksCache(QObject *parent)
+  : QObject(parent)
+{
+  cache_max_entries=RDPEAKSCACHE_MAX_ENTRIES;
+  cache_use_counter=0;
+  cache_multi=curl_multi_init();
+
+  cache_poll_timer=new QTimer(this);
+  connect(cache_poll_timer,SIGNAL(timeout()),this,SLOT(pollData()));
+}
+
+
+RDPeaksCache::~RDPeaksCache()
+{
+  for(std::map<QString,RDPeaksCacheFetch *>::const_iterator it=
+	cache_fetches.begin();it!=cache_fetches.end();it++) {
+    curl_multi_remove_handle(cache_multi,it->second->curl);
+    delete it->second;
+  }
+  for(std::map<QString,RDPeaksCacheEntry *>::const_iterator it=
+	cache_entries.begin();it!=cache_entries.end();it++) {
+    delete it->second;
+  }
+  if(cache_multi!=NULL) {
+    curl_multi_cleanup(cache_multi);
+  }
+  delete cache_poll_timer;
+}
+
+
+bool RDPeaksCache::peaks(const QString &cutname,
+			 std::vector<unsigned short> *energy)
+{
+  //
+  // Non-blocking lookup.  Returns true and fills 'energy' if current
+  // data is held in memory or on disk, otherwise queues a background
+  // fetch and returns false.  peaksLoaded() is emitted once the fetch
+  // completes.
+  //
+  QString stamp=Stamp(cutname);
+
+  cache_stamps[cutname]=stamp;
+  if(Cached(cutname,stamp,energy)) {
+    return true;
+  }
+  Fetch(cutname,stamp);
+  energy->clear();
+
+  return false;
+}
+
+
+bool RDPeaksCache::lookup(const QString &cutname,
+			  std::vector<unsigned short> *energy)
+{
+  std::map<QString,RDPeaksCacheEntry *>::iterator it=
+    cache_entries.find(cutname);
+  std::map<QString,QString>::const_iterator st=cache_stamps.find(cutname);
+
+  //
+  // Memory only, no database access.  The entry must match the stamp
+  // last read by peaks() or load(); anything else is stale.
+  //
+  if((it==cache_entries.end())||(st==cache_stamps.end())||
+     (it->second->stamp!=st->second)) {
+    return false;
+  }
+  it->second->last_used=++cache_use_counter;
+  *energy=it->second->energy;
+
+  return true;
+}
+
+
+RDPeaksExport::ErrorCode RDPeaksCache::load(const QString &cutname,
+				       std::vector<unsigned short> *energy)
+{
+  RDPeaksExport::ErrorCode err=RDPeaksExport::ErrorOk;
+  QString stamp=Stamp(cutname);
+
+  cache_stamps[cutname]=stamp;
+  if(Cached(cutname,stamp,energy)) {
+    return RDPeaksExport::ErrorOk;
+  }
+
+  RDPeaksExport *conv=new RDPeaksExport();
+  conv->setCartNumber(RDCut::cartNumber(cutname));
+  conv->setCutNumber(RDCut::cutNumber(cutname));
+  if((err=conv->runExport(rda->user()->name(),rda->user()->password()))==
+     RDPeaksExport::ErrorOk) {
+    energy->resize(conv->energySize());
+    if(energy->size()>0) {
+      conv->readEnergy(&(*energy)[0],energy->size());
+    }
+    Store(cutname,stamp,*energy);
+    WriteFile(cutname,stamp,*energy);
+  }
+  else {
+    energy->clear();
+  }
+  delete conv;
+
+  return err;
+}
+
+
+void RDPeaksCache::invalidate(const QString &cutname)
+{
+  std::map<QString,RDPeaksCacheEntry *>::iterator it=
+    cache_entries.find(cutname);
+
+  if(it!=cache_entries.end()) {
+    delete it->second;
+    cache_entries.erase(it);
+  }
+  cache_stamps.erase(cutname);
+  unlink((const char *)FileName(cutname));
+}
+
+
+unsigned RDPeaksCache::maximumEntries() const
+{
+  return cache_max_entries;
+}
+
+
+void RDPeaksCache::setMaximumEntries(unsigned n)
+{
+  cache_max_entries=n;
+}
+
+
+void RDPeaksCache::notificationReceivedData(RDNotification *notify)
+{
+  std::vector<QString> cutnames;
+
+  if(notify->action()==RDNotification::AddAction) {
+    return;
+  }
+  switch(notify->type()) {
+  case RDNotification::CutType:
+    for(unsigned i=0;i<notify->idQuantity();i++) {
+      invalidate(notify->id(i).toString());
+    }
+    break;
+
+  case RDNotification::CartType:
+    for(unsigned i=0;i<notify->idQuantity();i++) {
+      unsigned cartnum=notify->id(i).toUInt();
+      for(std::map<QString,QString>::const_iterator it=cache_stamps.begin();
+	  it!=cache_stamps.end();it++) {
+	if(RDCut::cartNumber(it->first)==cartnum) {
+	  cutnames.push_back(it->first);
+	}
+      }
+      for(std::map<QString,RDPeaksCacheEntry *>::const_iterator it=
+	    cache_entries.begin();it!=cache_entries.end();it++) {
+	if(RDCut::cartNumber(it->first)==cartnum) {
+	  cutnames.push_back(it->first);
+	}
+      }
+    }
+    for(unsigned i=0;i<cutnames.size();i++) {
+      invalidate(cutnames[i]);
+    }
+    break;
+
+  default:
+    break;
+  }
+}
+
+
+void RDPeaksCache::pollData()
+{
+  int running=0;
+  int msgs=0;
+  CURLMsg *msg=NULL;
+  long response_code=0;
+  RDPeaksCacheFetch *fetch=NULL;
+
+  curl_multi_perform(cache_multi,&running);
+  while((msg=curl_multi_info_read(cache_multi,&msgs))!=NULL) {
+    if(msg->msg!=CURLMSG_DONE) {
+      continue;
+    }
+    fetch=NULL;
+    for(std::map<QString,RDPeaksCacheFetch *>::iterator it=
+	  cache_fetches.begin();it!=cache_fetches.end();it++) {
+      if(it->second->curl==msg->easy_handle) {
+	fetch=it->second;
+	cache_fetches.erase(it);
+	break;
+      }
+    }
+    if(fetch==NULL) {
+      continue;
+    }
+    curl_easy_getinfo(fetch->curl,CURLINFO_RESPONSE_CODE,&response_code);
+    curl_multi_remove_handle(cache_multi,fetch->curl);
+    //
+    // Data for audio that has changed while the fetch was in flight is
+    // dropped
+    //
+    std::map<QString,QString>::const_iterator st=
+      cache_stamps.find(fetch->cutname);
+    bool current=(st!=cache_stamps.end())&&(st->second==fetch->stamp);
+    if(current&&(msg->data.result==CURLE_OK)&&(response_code==200)) {
+      fetch->energy.resize(fetch->data.size()/sizeof(unsigned short));
+      if(fetch->energy.size()>0) {
+	memcpy(&fetch->energy[0],&fetch->data[0],
+	       fetch->energy.size()*sizeof(unsigned short));
+      }
+      Store(fetch->cutname,fetch->stamp,fetch->energy);
+      WriteFile(fetch->cutname,fetch->stamp,fetch->energy);
+      emit peaksLoaded(fetch->cutname);
+    }
+    else if(current) {
+      rda->log(RDConfig::LogWarning,
+	       QString().sprintf("peak data fetch for cut %s failed [%ld]",
+				 (const char *)fetch->cutname,response_code));
+    }
+    delete fetch;
+  }
+  if(cache_fetches.size()==0) {
+    cache_poll_timer->stop();
+  }
+}
+
+
+bool RDPeaksCache::Cached(const QString &cutname,const QString &stamp,
+			  std::vector<unsigned short> *energy)
+{
+  std::map<QString,RDPeaksCacheEntry *>::iterator it=
+    cache_entries.find(cutname);
+
+  if((it!=cache_entries.end())&&(it->second->stamp==stamp)) {
+    it->second->last_used=++cache_use_counter;
+    *energy=it->second->energy;
+    return true;
+  }
+  if(ReadFile(cutname,stamp,energy)) {
+    Store(cutname,stamp,*energy);
+    return true;
+  }
+  return false;
+}
+
+
+void RDPeaksCache::Fetch(const QString &cutname,const QString &stamp)
+{
+  QString key=cutname+"-"+stamp;
+
+  if((cache_multi==NULL)||(cache_fetches.find(key)!=cache_fetches.end())) {
+    return;
+  }
+
+  RDPeaksCacheFetch *fetch=new RDPeaksCacheFetch();
+  fetch->cutname=cutname;
+  fetch->stamp=stamp;
+  fetch->post=QString().
+    sprintf("COMMAND=%d&LOGIN_NAME=%s&PASSWORD=%s&CART_NUMBER=%u&CUT_NUMBER=%u",
+	    RDXPORT_COMMAND_EXPORT_PEAKS,
+	    (const char *)RDFormPost::urlEncode(rda->user()->name()),
+	    (const char *)RDFormPost::urlEncode(rda->user()->password()),
+	    RDCut::cartNumber(cutname),
+	    RDCut::cutNumber(cutname)).utf8();
+  if((fetch->curl=curl_easy_init())==NULL) {
+    delete fetch;
+    return;
+  }
+  curl_easy_setopt(fetch->curl,CURLOPT_WRITEDATA,fetch);
+  curl_easy_setopt(fetch->curl,CURLOPT_WRITEFUNCTION,RDPeaksCacheWrite);
+
+  //
+  // Write out URL as a C string before passing to curl_easy_setopt(), 
+  // otherwise some versions of LibCurl will throw a 'bad/illegal format' 
+  // error.
+  //
+  strncpy(fetch->url,rda->station()->webServiceUrl(rda->config()),1023);
+  curl_easy_setopt(fetch->curl,CURLOPT_URL,fetch->url);
+  curl_easy_setopt(fetch->curl,CURLOPT_POST,1);
+  curl_easy_setopt(fetch->curl,CURLOPT_POSTFIELDS,(const char *)fetch->post);
+  curl_easy_setopt(fetch->curl,CURLOPT_TIMEOUT,RD_CURL_TIMEOUT);
+  curl_easy_setopt(fetch->curl,CURLOPT_NOPROGRESS,1);
+  curl_easy_setopt(fetch->curl,CURLOPT_USERAGENT,
+		   (const char *)rda->config()->userAgent());
+  curl_multi_add_handle(cache_multi,fetch->curl);
+  cache_fetches[key]=fetch;
+
+  if(!cache_poll_timer->isActive()) {
+    cache_poll_timer->start(RDPEAKSCACHE_POLL_INTERVAL);
+  }
+}
+
+
+void RDPeaksCache::Store(const QString &cutname,const QString &stamp,
+			 const std::vector<unsigned short> &energy)
+{
+  RDPeaksCacheEntry *entry=NULL;
+  std::map<QString,RDPeaksCacheEntry *>::iterator it=
+    cache_entries.find(cutname);
+
+  if(it==cache_entries.end()) {
+    //
+    // Evict the least recently used entry
+    //
+    if((cache_max_entries>0)&&(cache_entries.size()>=cache_max_entries)) {
+      std::map<QString,RDPeaksCacheEntry *>::iterator oldest=
+	cache_entries.begin();
+      for(it=cache_entries.begin();it!=cache_entries.end();it++) {
+	if(it->second->last_used<oldest->second->last_used) {
+	  oldest=it;
+	}
+      }
+      delete oldest->second;
+      cache_entries.erase(oldest);
+    }
+    entry=new RDPeaksCacheEntry();
+    cache_entries[cutname]=entry;
+  }
+  else {
+    entry=it->second;
+  }
+  entry->stamp=stamp;
+  entry->energy=energy;
+  entry->last_used=++cache_use_counter;
+}
+
+
+bool RDPeaksCache::ReadFile(const QString &cutname,const QString &stamp,
+			    std::vector<unsigned short> *energy) const
+{
+  FILE *f=NULL;
+  char line[256];
+  struct stat st;
+  long offset=0;
+
+  if((f=fopen((const char *)FileName(cutname),"r"))==NULL) {
+    return false;
+  }
+  if((fgets(line,256,f)==NULL)||(QString(line).stripWhiteSpace()!=stamp)) {
+    fclose(f);
+    return false;
+  }
+  offset=ftell(f);
+  if(fstat(fileno(f),&st)!=0) {
+    fclose(f);
+    return false;
+  }
+  energy->resize((st.st_size-offset)/sizeof(unsigned short));
+  if(energy->size()>0) {
+    if(fread(&(*energy)[0],sizeof(unsigned short),energy->size(),f)!=
+       energy->size()) {
+      energy->clear();
+      fclose(f);
+      return false;
+    }
+  }
+  fclose(f);
+
+  return true;
+}
+
+
+void RDPeaksCache::WriteFile(const QString &cutname,const QString &stamp,
+			     const std::vector<unsigned short> &energy) const
+{
+  FILE *f=NULL;
+  QString tempname=FileName(cutname)+".tmp";
+  QDir dir(RDHomeDir()+"/"+RDPEAKSCACHE_DIRECTORY);
+
+  if(!dir.exists()) {
+    if(mkdir((const char *)dir.path(),0700)!=0) {
+      return;
+    }
+  }
+  if((f=fopen((const char *)tempname,"w"))==NULL) {
+    return;
+  }
+  fprintf(f,"%s\n",(const char *)stamp);
+  if(energy.size()>0) {
+    fwrite(&energy[0],sizeof(unsigned short),energy.size(),f);
+  }
+  fclose(f);
+  rename((const char *)tempname,
+	 (const char *)FileName(cutname));
+}
+
+
+QString RDPeaksCache::Stamp(const QString &cutname) const
+{
+  QString ret;
+  QString sql=QString("select ")+
+    "ORIGIN_DATETIME,"+  // 00
+    "LENGTH,"+           // 01
+    "SHA1_HASH "+        // 02
+    "from CUTS where "+
+    "CUT_NAME=\""+RDEscapeString(cutname)+"\"";
+  RDSqlQuery *q=new RDSqlQuery(sql);
+  if(q->first()) {
+    ret=q->value(0).toDateTime().toString("yyyyMMddhhmmss")+
+      QString().sprintf("-%d-",q->value(1).toInt())+
+      q->value(2).toString();
+  }
+  delete q;
+
+  return ret;
+}
+
+
+QString RDPeaksCache::FileName(const QString &cutname) const
+{
+  return RDHomeDir()+"/"+RDPEAKSCACHE_DIRECTORY+"/"+cutname+".dat";
+}
@@ -0,0 +1,118 @@
+// rdpeakscache.h
+//
+// Local cache for peak data exported by the RdXport Web Service
+//
+//   (C) Copyright 2018 Fred Gleason <fredg@paravelsystems.com>
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License version 2 as
+//   published by the Free Software Foundation.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public
+//   License along with this program; if not, write to the Free Software
+//   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+//
+
+#ifndef RDPEAKSCACHE_H
+#define RDPEAKSCACHE_H
+
+#include <map>
+#include <vector>
+
+#include <curl/curl.h>
+
+#include <qobject.h>
+#include <qtimer.h>
+
+#include <rdnotification.h>
+#include <rdpeaksexport.h>
+
+//
+// Peak data is cached in memory and in a per-user directory, keyed by
+// cut name and a stamp derived from the cut's origin date/time, length
+// and SHA1 hash.  Entries are refetched automatically whenever the
+// audio for a cut changes, and dropped when a CUT or CART notification
+// says it has.
+//
+#define RDPEAKSCACHE_DIRECTORY ".rdpeaks"
+#define RDPEAKSCACHE_MAX_ENTRIES 64
+#define RDPEAKSCACHE_POLL_INTERVAL 20
+
+class RDPeaksCacheEntry
+{
+ public:
+  RDPeaksCacheEntry();
+  QString stamp;
+  std::vector<unsigned short> energy;
+  unsigned last_used;
+};
+
+
+class RDPeaksCacheFetch
+{
+ public:
+  RDPeaksCacheFetch();
+  ~RDPeaksCacheFetch();
+  QString cutname;
+  QString stamp;
+  QCString post;
+  char url[1024];
+  CURL *curl;
+  std::vector<unsigned short> energy;
+  std::vector<unsigned char> data;
+};
+
+
+class RDPeaksCache : public QObject
+{
+  Q_OBJECT;
+ public:
+  RDPeaksCache(QObject *parent=0);
+  ~RDPeaksCache();
+  bool peaks(const QString &cutname,std::vector<unsigned short> *energy);
+  bool lookup(const QString &cutname,std::vector<unsigned short> *energy);
+  RDPeaksExport::ErrorCode load(const QString &cutname,
+				std::vector<unsigned short> *energy);
+  void invalidate(const QString &cutname);
+  unsigned maximumEntries() const;
+  void setMaximumEntries(unsigned n);
+
+ signals:
+  void peaksLoaded(const QString &cutname);
+
+ public slots:
+  void notificationReceivedData(RDNotification *notify);
+
+ private slots:
+  void pollData();
+
+ private:
+  bool Cached(const QString &cutname,const QString &stamp,
+	      std::vector<unsigned short> *energy);
+  void Fetch(const QString &cutname,const QString &stamp);
+  void Store(const QString &cutname,const QString &stamp,
+	     const std::vector<unsigned short> &energy);
+  bool ReadFile(const QString &cutname,const QString &stamp,
+		std::vector<unsigned short> *energy) const;
+  void WriteFile(const QString &cutname,const QString &stamp,
+		 const std::vector<unsigned short> &energy) const;
+  QString Stamp(const QString &cutname) const;
+  QString FileName(const QString &cutname) const;
+  std::map<QString,RDPeaksCacheEntry *> cache_entries;
+  std::map<QString,QString> cache_stamps;
+  std::map<QString,RDPeaksCacheFetch *> cache_fetches;
+  CURLM *cache_multi;
+  QTimer *cache_poll_timer;
+  unsigned cache_max_entries;
+  unsigned cache_use_counter;
+  friend size_t RDPeaksCacheWrite(void *ptr,size_t size,size_t nmemb,
+				  void *userdata);
+};
+
+
+#endif  // RDPEAKSCACHE_H
@@ -248,7 +248,8 @@ bool RDPlayDeck::setCart(RDLogLine *logline,bool rotate)
 
   if(play_state!=RDPlayDeck::Paused) {
     if(!play_cae->loadPlay(play_card,play_cut->cutName(),
-			   &play_stream,&play_handle)) {
+			   &play_stream,&play_handle,
+			   play_cut->isRecording())) {
       return false;
     }
   }
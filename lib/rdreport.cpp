@@ -328,10 +328,6 @@ bool RDReport::generateReport(const QDate &startdate,const QDate &enddate,
 {
   QString sql;
   RDSqlQuery *q;
-  RDSqlQuery *q1;
-  RDSqlQuery *q2;
-  RDSvc *svc;
-  QString rec_name;
   QString daypart_sql;
   QString station_sql;
   QString group_sql;
@@ -442,162 +438,157 @@ bool RDReport::generateReport(const QDate &startdate,const QDate &enddate,
   delete q;
 
   //
-  // Iterate Selected Services
+  // Selected Services
   //
-  sql=QString().sprintf("select SERVICE_NAME from REPORT_SERVICES \
-                         where REPORT_NAME=\"%s\"",
-			(const char *)name());
+  QString svc_sql;
+  sql=QString("select SERVICE_NAME from REPORT_SERVICES where ")+
+    "REPORT_NAME=\""+RDEscapeString(name())+"\"";
   q=new RDSqlQuery(sql);
   while(q->next()) {
-    svc=new RDSvc(q->value(0).toString(),report_station,report_config);
-    if(svc->exists()) {
-      rec_name=q->value(0).toString();
-      rec_name.replace(" ","_");
-
-      //
-      // Generate Type Filters
-      //
-      force_sql="";
-      if(!exportTypeEnabled(RDReport::Generic)) {
-	if(exportTypeForced(RDReport::Traffic)||
-	   exportTypeEnabled(RDReport::Traffic)) {
-	  force_sql+=QString().sprintf("(`%s_SRT`.EVENT_SOURCE=%d)||",
-				       (const char *)rec_name,
-				       RDLogLine::Traffic);
-	}
-	if(exportTypeForced(RDReport::Music)||
-	   exportTypeEnabled(RDReport::Music)) {
-	  force_sql+=QString().sprintf("(`%s_SRT`.EVENT_SOURCE=%d)||",
-				       (const char *)rec_name,
-				       RDLogLine::Music);
-	}
-	force_sql=force_sql.left(force_sql.length()-2);
-      }
-
-      //
-      // Selected Fields
-      //
-      sql=QString("select ")+
-	"LENGTH,"+                           // 00
-	"LOG_ID,"+                           // 01
-	"CART_NUMBER,"+                      // 02
-	"STATION_NAME,"+                     // 03
-	"EVENT_DATETIME,"+                   // 04
-	"EVENT_TYPE,"+                       // 05
-	"EXT_START_TIME,"+                   // 06
-	"EXT_LENGTH,"+                       // 07
-	"EXT_DATA,"+                         // 08
-	"EXT_EVENT_ID,"+                     // 09
-	"EXT_ANNC_TYPE,"+                    // 10
-	"PLAY_SOURCE,"+                      // 11
-	"CUT_NUMBER,"+                       // 12
-	"EVENT_SOURCE,"+                     // 13
-	"EXT_CART_NAME,"+                    // 14
-	"LOG_NAME,"+                         // 15
-	"`"+rec_name+"_SRT`.TITLE,"+         // 16
-	"`"+rec_name+"_SRT`.ARTIST,"+        // 17
-	"SCHEDULED_TIME,"+                   // 18
-	"START_SOURCE,"+                     // 19
-	"`"+rec_name+"_SRT`.PUBLISHER,"+     // 20
-	"`"+rec_name+"_SRT`.COMPOSER,"+      // 21
-	"`"+rec_name+"_SRT`.ALBUM,"+         // 22
-	"`"+rec_name+"_SRT`.LABEL,"+         // 23
-	"`"+rec_name+"_SRT`.ISRC,"+          // 24
-	"`"+rec_name+"_SRT`.USAGE_CODE,"+    // 25
-	"`"+rec_name+"_SRT`.ONAIR_FLAG,"+    // 26
-	"`"+rec_name+"_SRT`.ISCI,"+          // 27
-	"`"+rec_name+"_SRT`.CONDUCTOR,"+     // 28
-	"`"+rec_name+"_SRT`.USER_DEFINED,"+  // 29
-	"`"+rec_name+"_SRT`.SONG_ID,"+       // 30
-	"`"+rec_name+"_SRT`.DESCRIPTION,"+   // 31
-	"`"+rec_name+"_SRT`.OUTCUE "+        // 32
-	"from `"+rec_name+"_SRT` left join CART "+
-	"on `"+rec_name+"_SRT`.CART_NUMBER=CART.NUMBER where ";
-
-      //
-      // OnAir Flag Filter
-      //
-      if(filterOnairFlag()) {
-	sql+="(ONAIR_FLAG=\"Y\")&&";
-      }
+    svc_sql+="\""+RDEscapeString(q->value(0).toString())+"\",";
+  }
+  delete q;
+  svc_sql=svc_sql.left(svc_sql.length()-1);
 
-      //
-      // Group Filter
-      //
-      sql+="(";
-      if(!group_sql.isEmpty()) {
-	sql+=QString("(")+group_sql+")&&";
+  //
+  // Copy the matching as-played records in a single pass over ELR_LINES
+  //
+  if(!svc_sql.isEmpty()) {
+    //
+    // Generate Type Filters
+    //
+    force_sql="";
+    if(!exportTypeEnabled(RDReport::Generic)) {
+      if(exportTypeForced(RDReport::Traffic)||
+	 exportTypeEnabled(RDReport::Traffic)) {
+	force_sql+=QString().sprintf("(ELR_LINES.EVENT_SOURCE=%d)||",
+				     RDLogLine::Traffic);
       }
-      if(!force_sql.isEmpty()) {
-	sql+=QString("(")+force_sql+")&&";
+      if(exportTypeForced(RDReport::Music)||
+	 exportTypeEnabled(RDReport::Music)) {
+	force_sql+=QString().sprintf("(ELR_LINES.EVENT_SOURCE=%d)||",
+				     RDLogLine::Music);
       }
+      force_sql=force_sql.left(force_sql.length()-2);
+    }
 
-      //
-      // Daypart Filter
-      //
-      if(daypart_sql.isEmpty()) {
-    	  //TODO Do we need to escape on Select statement?
-	sql+=QString("(EVENT_DATETIME>=\"")+startdate.toString("yyyy-MM-dd")+
-	  " 00:00:00\")&&"+
-	  "(EVENT_DATETIME<=\""+enddate.toString("yyyy-MM-dd")+
-	  " 23:59:59\")&&";
-      }
-      else {
-	sql+=(QString("(")+daypart_sql+")&&");
-      }
-      if(!station_sql.isEmpty()) {
-	sql+=QString("(")+station_sql+")||";
-      }
-      sql=sql.left(sql.length()-2);
-      sql+=")";
-      q1=new RDSqlQuery(sql);
-      while(q1->next()) {
-	sql=QString("insert into `")+mixname+"_SRT` "+
-	  "set "+QString().sprintf("LENGTH=%d,LOG_ID=%u,CART_NUMBER=%u,",
-				   q1->value(0).toInt(),
-				   q1->value(1).toUInt(),
-				   q1->value(2).toInt())+
-	  "STATION_NAME=\""+RDEscapeString(q1->value(3).toString())+"\","+
-	  "EVENT_DATETIME="+RDCheckDateTime(q1->value(4).toDateTime(),
-				     "yyyy-MM-dd hh:mm:ss")+","+
-	  QString().sprintf("EVENT_TYPE=%d,",q1->value(5).toInt())+
-	  "EXT_START_TIME=\""+RDEscapeString(q1->value(6).toString())+"\","+
-	  QString().sprintf("EXT_LENGTH=%d,",q1->value(7).toInt())+
-	  "EXT_DATA=\""+RDEscapeString(q1->value(8).toString())+"\","+
-	  "EXT_EVENT_ID=\""+RDEscapeString(q1->value(9).toString())+"\","+
-	  "EXT_ANNC_TYPE=\""+RDEscapeString(q1->value(10).toString())+"\","+
-	  QString().sprintf("PLAY_SOURCE=%d,CUT_NUMBER=%d,EVENT_SOURCE=%d,",
-			    q1->value(11).toInt(),
-			    q1->value(12).toInt(),
-			    q1->value(13).toInt())+
-	  "EXT_CART_NAME=\""+RDEscapeString(q1->value(14).toString())+"\","+
-	  "LOG_NAME=\""+RDEscapeString(q1->value(15).toString())+"\","+
-	  "TITLE=\""+RDEscapeString(q1->value(16).toString())+"\","+
-	  "ARTIST=\""+RDEscapeString(q1->value(17).toString())+"\","+
-	  "SCHEDULED_TIME="+
-	  RDCheckDateTime(q1->value(18).toDate(),"yyyy-MM-dd hh:mm:ss")+","+
-	  QString().sprintf("START_SOURCE=%d,",q1->value(19).toInt())+
-	  "PUBLISHER=\""+RDEscapeString(q1->value(20).toString())+"\","+
-	  "COMPOSER=\""+RDEscapeString(q1->value(21).toString())+"\","+
-	  "ALBUM=\""+RDEscapeString(q1->value(22).toString())+"\","+
-	  "LABEL=\""+RDEscapeString(q1->value(23).toString())+"\","+
-	  "ISRC=\""+RDEscapeString(q1->value(24).toString())+"\","+
-	  QString().sprintf("USAGE_CODE=%d,",q1->value(25).toInt())+
-	  "ONAIR_FLAG=\""+RDEscapeString(q1->value(26).toString())+"\","+
-	  "ISCI=\""+RDEscapeString(q1->value(27).toString())+"\","+
-	  "CONDUCTOR=\""+RDEscapeString(q1->value(28).toString())+"\","+
-	  "USER_DEFINED=\""+RDEscapeString(q1->value(29).toString())+"\","+
-	  "SONG_ID=\""+RDEscapeString(q1->value(30).toString())+"\","+
-	  "DESCRIPTION=\""+RDEscapeString(q1->value(31).toString())+"\","+
-	  "OUTCUE=\""+RDEscapeString(q1->value(32).toString())+"\"";
-	q2=new RDSqlQuery(sql);
-	delete q2;
-      }
-      delete q1;
+    //
+    // Selected Fields
+    //
+    sql=QString("insert into `")+mixname+"_SRT` ("+
+      "LENGTH,"+
+      "LOG_ID,"+
+      "CART_NUMBER,"+
+      "STATION_NAME,"+
+      "EVENT_DATETIME,"+
+      "EVENT_TYPE,"+
+      "EXT_START_TIME,"+
+      "EXT_LENGTH,"+
+      "EXT_DATA,"+
+      "EXT_EVENT_ID,"+
+      "EXT_ANNC_TYPE,"+
+      "PLAY_SOURCE,"+
+      "CUT_NUMBER,"+
+      "EVENT_SOURCE,"+
+      "EXT_CART_NAME,"+
+      "LOG_NAME,"+
+      "TITLE,"+
+      "ARTIST,"+
+      "SCHEDULED_TIME,"+
+      "START_SOURCE,"+
+      "PUBLISHER,"+
+      "COMPOSER,"+
+      "ALBUM,"+
+      "LABEL,"+
+      "ISRC,"+
+      "USAGE_CODE,"+
+      "ONAIR_FLAG,"+
+      "ISCI,"+
+      "CONDUCTOR,"+
+      "USER_DEFINED,"+
+      "SONG_ID,"+
+      "DESCRIPTION,"+
+      "OUTCUE) "+
+      "select "+
+      "ELR_LINES.LENGTH,"+
+      "ELR_LINES.LOG_ID,"+
+      "ELR_LINES.CART_NUMBER,"+
+      "ELR_LINES.STATION_NAME,"+
+      "ELR_LINES.EVENT_DATETIME,"+
+      "ELR_LINES.EVENT_TYPE,"+
+      "ELR_LINES.EXT_START_TIME,"+
+      "ELR_LINES.EXT_LENGTH,"+
+      "ELR_LINES.EXT_DATA,"+
+      "ELR_LINES.EXT_EVENT_ID,"+
+      "ELR_LINES.EXT_ANNC_TYPE,"+
+      "ELR_LINES.PLAY_SOURCE,"+
+      "ELR_LINES.CUT_NUMBER,"+
+      "ELR_LINES.EVENT_SOURCE,"+
+      "ELR_LINES.EXT_CART_NAME,"+
+      "ELR_LINES.LOG_NAME,"+
+      "ELR_LINES.TITLE,"+
+      "ELR_LINES.ARTIST,"+
+      "ELR_LINES.SCHEDULED_TIME,"+
+      "ELR_LINES.START_SOURCE,"+
+      "ELR_LINES.PUBLISHER,"+
+      "ELR_LINES.COMPOSER,"+
+      "ELR_LINES.ALBUM,"+
+      "ELR_LINES.LABEL,"+
+      "ELR_LINES.ISRC,"+
+      "ELR_LINES.USAGE_CODE,"+
+      "ELR_LINES.ONAIR_FLAG,"+
+      "ELR_LINES.ISCI,"+
+      "ELR_LINES.CONDUCTOR,"+
+      "ELR_LINES.USER_DEFINED,"+
+      "ELR_LINES.SONG_ID,"+
+      "ELR_LINES.DESCRIPTION,"+
+      "ELR_LINES.OUTCUE "+
+      "from ELR_LINES left join CART "+
+      "on ELR_LINES.CART_NUMBER=CART.NUMBER where "+
+      "(ELR_LINES.SERVICE_NAME in ("+svc_sql+"))&&"+
+      "(ELR_LINES.EVENT_DATETIME>=\""+startdate.toString("yyyy-MM-dd")+
+      " 00:00:00\")&&"+
+      "(ELR_LINES.EVENT_DATETIME<=\""+enddate.toString("yyyy-MM-dd")+
+      " 23:59:59\")&&";
+
+    //
+    // OnAir Flag Filter
+    //
+    if(filterOnairFlag()) {
+      sql+="(ONAIR_FLAG=\"Y\")&&";
+    }
+
+    //
+    // Group Filter
+    //
+    sql+="(";
+    if(!group_sql.isEmpty()) {
+      sql+=QString("(")+group_sql+")&&";
+    }
+    if(!force_sql.isEmpty()) {
+      sql+=QString("(")+force_sql+")&&";
     }
-    delete svc;
+
+    //
+    // Daypart Filter
+    //
+    if(daypart_sql.isEmpty()) {
+      sql+=QString("(EVENT_DATETIME>=\"")+startdate.toString("yyyy-MM-dd")+
+	" 00:00:00\")&&"+
+	"(EVENT_DATETIME<=\""+enddate.toString("yyyy-MM-dd")+
+	" 23:59:59\")&&";
+    }
+    else {
+      sql+=(QString("(")+daypart_sql+")&&");
+    }
+    if(!station_sql.isEmpty()) {
+      sql+=QString("(")+station_sql+")||";
+    }
+    sql=sql.left(sql.length()-2);
+    sql+=")";
+    q=new RDSqlQuery(sql);
+    delete q;
   }
-  delete q;
 
   bool ret=false;
 #ifdef WIN32
@@ -19,6 +19,7 @@
 //
 
 #include <ctype.h>
+#include <unistd.h>
 
 #include <qobject.h>
 #include <qapplication.h>
@@ -41,6 +42,8 @@ RDRipc::RDRipc(RDStation *station,RDConfig *config,QObject *parent)
   argptr=0;
 
   ripc_connected=false;
+  ripc_notify_batch=0;
+  ripc_notify_sequence=0;
 
   //
   // TCP Connection
@@ -49,11 +52,19 @@ RDRipc::RDRipc(RDStation *station,RDConfig *config,QObject *parent)
   connect(ripc_socket,SIGNAL(connected()),this,SLOT(connectedData()));
   connect(ripc_socket,SIGNAL(error(int)),this,SLOT(errorData(int)));
   connect(ripc_socket,SIGNAL(readyRead()),this,SLOT(readyData()));
+
+  //
+  // Notification Batch Timer
+  //
+  ripc_notify_timer=new QTimer(this);
+  connect(ripc_notify_timer,SIGNAL(timeout()),
+	  this,SLOT(flushNotificationsData()));
 }
 
 
 RDRipc::~RDRipc()
 {
+  flushNotificationsData();
   delete ripc_socket;
 }
 
@@ -139,7 +150,49 @@ void RDRipc::sendGpoCart(int matrix)
 
 void RDRipc::sendNotification(const RDNotification &notify)
 {
-  SendCommand("ON "+notify.write()+"!");
+  if(ripc_notify_batch==0) {
+    SendNotification(notify);
+    return;
+  }
+
+  //
+  // Coalesce into the most recent pending message when the type and
+  // action match; anything else starts a new message so that ordering
+  // between different actions is preserved.
+  //
+  for(unsigned i=0;i<notify.idQuantity();i++) {
+    if((ripc_notify_pending.size()>0)&&
+       (ripc_notify_pending.back().type()==notify.type())&&
+       (ripc_notify_pending.back().action()==notify.action())) {
+      if(ripc_notify_pending.back().containsId(notify.id(i))||
+	 ripc_notify_pending.back().addId(notify.id(i))) {
+	continue;
+      }
+      SendNotification(ripc_notify_pending.back());  // Message is full
+      ripc_notify_pending.pop_back();
+    }
+    ripc_notify_pending.
+      push_back(RDNotification(notify.type(),notify.action(),notify.id(i)));
+    if(ripc_notify_pending.size()==1) {
+      ripc_notify_timer->start(RIPC_NOTIFICATION_BATCH_INTERVAL,true);
+    }
+  }
+}
+
+
+void RDRipc::beginNotificationBatch()
+{
+  ripc_notify_batch++;
+}
+
+
+void RDRipc::endNotificationBatch()
+{
+  if(ripc_notify_batch>0) {
+    if(--ripc_notify_batch==0) {
+      flushNotificationsData();
+    }
+  }
 }
 
 
@@ -204,7 +257,7 @@ void RDRipc::errorData(int errorcode)
 
 void RDRipc::readyData()
 {
-  char buf[255];
+  char buf[257];
   int c;
 
   while((c=ripc_socket->readBlock(buf,256))>0) {
@@ -247,6 +300,24 @@ void RDRipc::readyData()
 }
 
 
+void RDRipc::flushNotificationsData()
+{
+  ripc_notify_timer->stop();
+  for(unsigned i=0;i<ripc_notify_pending.size();i++) {
+    SendNotification(ripc_notify_pending[i]);
+  }
+  ripc_notify_pending.clear();
+}
+
+
+void RDRipc::SendNotification(RDNotification notify)
+{
+  notify.setSource(ripc_station->name()+QString().sprintf(":%d",getpid()));
+  notify.setSequence(++ripc_notify_sequence);
+  SendCommand("ON "+notify.write()+"!");
+}
+
+
 void RDRipc::SendCommand(QString cmd)
 {
   // printf("RDRipc::SendCommand(%s)\n",(const char *)cmd);
@@ -446,6 +517,15 @@ void RDRipc::DispatchCommand()
       delete notify;
       return;
     }
+    if(notify->sequence()>0) {
+      std::map<QString,unsigned>::iterator it=
+	ripc_notify_sequences.find(notify->source());
+      if((it!=ripc_notify_sequences.end())&&
+	 (notify->sequence()>(it->second+1))) {
+	emit notificationsMissed(notify->source());
+      }
+      ripc_notify_sequences[notify->source()]=notify->sequence();
+    }
     emit notificationReceived(notify);
     delete notify;
   }
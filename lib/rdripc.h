@@ -18,6 +18,9 @@
 //   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
 //
 
+#include <map>
+#include <vector>
+
 #include <qsqldatabase.h>
 #include <qstring.h>
 #include <qobject.h>
@@ -37,6 +40,11 @@
 #define RIPC_MAX_LENGTH 256
 #define RIPC_START_DELAY 2000
 
+//
+// Maximum time (mS) a notification is held back while a batch is open
+//
+#define RIPC_NOTIFICATION_BATCH_INTERVAL 1000
+
 class RDRipc : public QObject
 {
   Q_OBJECT
@@ -56,6 +64,8 @@ class RDRipc : public QObject
   void sendGpiCart(int matrix);
   void sendGpoCart(int matrix);
   void sendNotification(const RDNotification &notify);
+  void beginNotificationBatch();
+  void endNotificationBatch();
   void sendOnairFlag();
   void sendRml(RDMacro *macro);
   void reloadHeartbeat();
@@ -70,6 +80,7 @@ class RDRipc : public QObject
   void gpiCartChanged(int matrix,int line,int off_cartnum,int on_cartnum);
   void gpoCartChanged(int matrix,int line,int off_cartnum,int on_cartnum);
   void notificationReceived(RDNotification *notify);
+  void notificationsMissed(const QString &source);
   void onairFlagChanged(bool state);
   void rmlReceived(RDMacro *rml);
   
@@ -77,8 +88,10 @@ class RDRipc : public QObject
   void connectedData();
   void errorData(int errorcode);
   void readyData();
+  void flushNotificationsData();
 
  private:
+  void SendNotification(RDNotification notify);
   void SendCommand(QString cmd);
   void DispatchCommand();
   QSocket *ripc_socket;
@@ -94,6 +107,11 @@ class RDRipc : public QObject
   int argnum;
   int argptr;
   bool ripc_connected;
+  int ripc_notify_batch;
+  unsigned ripc_notify_sequence;
+  std::vector<RDNotification> ripc_notify_pending;
+  QTimer *ripc_notify_timer;
+  std::map<QString,unsigned> ripc_notify_sequences;
 };
 
 
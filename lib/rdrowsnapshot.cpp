@@ -0,0 +1,137 @@
+// rdrowsnapshot.cpp
+//
+// Load-once snapshot of configuration rows
+//
+//   (C) Copyright 2018 Fred Gleason <fredg@paravelsystems.com>
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License version 2 as
+//   published by the Free Software Foundation.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public
+//   License along with this program; if not, write to the Free Software
+//   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+//
+
+#include <qsqldriver.h>
+#include <qsqlrecord.h>
+
+#include "rddb.h"
+#include "rdrowsnapshot.h"
+
+RDRowSnapshot::RDRowSnapshot(const QString &table,const QString &where,
+			     const QString &index_col)
+{
+  snap_table=table;
+  snap_where=where;
+  snap_index_col=index_col.upper();
+  snap_enabled=false;
+  snap_loaded=false;
+}
+
+
+bool RDRowSnapshot::isEnabled() const
+{
+  return snap_enabled;
+}
+
+
+void RDRowSnapshot::setEnabled(bool state)
+{
+  if(snap_enabled!=state) {
+    snap_enabled=state;
+    snap_loaded=false;
+    snap_rows.clear();
+  }
+}
+
+
+QVariant RDRowSnapshot::value(const QString &field,int index,bool *valid)
+{
+  QVariant ret;
+
+  if(!snap_enabled) {
+    QString sql=QString("select `")+field+"` from `"+snap_table+"` where "+
+      snap_where;
+    if(!snap_index_col.isEmpty()) {
+      sql+=QString().sprintf("&&(`%s`=%d)",(const char *)snap_index_col,index);
+    }
+    RDSqlQuery *q=new RDSqlQuery(sql);
+    if(q->first()) {
+      ret=q->value(0);
+    }
+    delete q;
+  }
+  else {
+    if(!snap_loaded) {
+      Load();
+    }
+    std::map<int,std::map<QString,QVariant> >::const_iterator row=
+      snap_rows.find(index);
+    if(row!=snap_rows.end()) {
+      std::map<QString,QVariant>::const_iterator it=
+	row->second.find(field.upper());
+      if(it!=row->second.end()) {
+	ret=it->second;
+      }
+    }
+  }
+  if(valid!=NULL) {
+    *valid=!ret.isNull();
+  }
+
+  return ret;
+}
+
+
+void RDRowSnapshot::setValue(const QString &field,const QVariant &value,
+			     int index)
+{
+  //
+  // Keeps the snapshot coherent with writes made through the owning class
+  //
+  if(snap_loaded) {
+    snap_rows[index][field.upper()]=value;
+  }
+}
+
+
+void RDRowSnapshot::reload()
+{
+  snap_loaded=false;
+  snap_rows.clear();
+}
+
+
+void RDRowSnapshot::Load()
+{
+  int index=0;
+  QString sql=QString("select * from `")+snap_table+"` where "+snap_where;
+  RDSqlQuery *q=new RDSqlQuery(sql);
+  QSqlRecord rec=q->driver()->record(*q);
+  int index_field=-1;
+  if(!snap_index_col.isEmpty()) {
+    index_field=rec.position(snap_index_col);
+  }
+  while(q->next()) {
+    if(index_field>=0) {
+      index=q->value(index_field).toInt();
+    }
+    std::map<QString,QVariant> &row=snap_rows[index];
+    for(unsigned i=0;i<rec.count();i++) {
+      if(q->isNull(i)) {
+	row[rec.fieldName(i).upper()]=QVariant();
+      }
+      else {
+	row[rec.fieldName(i).upper()]=q->value(i);
+      }
+    }
+  }
+  delete q;
+  snap_loaded=true;
+}
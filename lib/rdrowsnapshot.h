@@ -0,0 +1,58 @@
+// rdrowsnapshot.h
+//
+// Load-once snapshot of configuration rows
+//
+//   (C) Copyright 2018 Fred Gleason <fredg@paravelsystems.com>
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License version 2 as
+//   published by the Free Software Foundation.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public
+//   License along with this program; if not, write to the Free Software
+//   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+//
+
+#ifndef RDROWSNAPSHOT_H
+#define RDROWSNAPSHOT_H
+
+#include <map>
+
+#include <qstring.h>
+#include <qvariant.h>
+
+//
+// Holds the rows of 'table' selected by 'where', indexed by the value
+// of 'index_col' (or by 0 if no index column is given).  While disabled,
+// every value() call goes to the database just as RDGetSqlValue() does.
+// Once enabled, all rows are fetched with a single select on first use
+// and held until reload() is called.
+//
+class RDRowSnapshot
+{
+ public:
+  RDRowSnapshot(const QString &table,const QString &where,
+		const QString &index_col="");
+  bool isEnabled() const;
+  void setEnabled(bool state);
+  QVariant value(const QString &field,int index=0,bool *valid=NULL);
+  void setValue(const QString &field,const QVariant &value,int index=0);
+  void reload();
+
+ private:
+  void Load();
+  QString snap_table;
+  QString snap_where;
+  QString snap_index_col;
+  bool snap_enabled;
+  bool snap_loaded;
+  std::map<int,std::map<QString,QVariant> > snap_rows;
+};
+
+
+#endif  // RDROWSNAPSHOT_H
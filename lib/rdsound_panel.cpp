@@ -310,7 +310,6 @@ void RDSoundPanel::setLogName(const QString &logname)
 void RDSoundPanel::setSvcName(const QString &svcname)
 {
   panel_svcname=svcname;
-  panel_svcname.replace(" ","_");
 }
 
 
@@ -1367,10 +1366,6 @@ void RDSoundPanel::SaveButton(RDAirPlayConf::PanelType type,
       QString().sprintf("(ROW_NO=%d)&&",row)+
       QString().sprintf("(COLUMN_NO=%d)",col);
     q=new RDSqlQuery(sql1);
-    if(q->isActive()) {
-      delete q;
-      return;
-    }
     delete q;
   }
   else {
@@ -1394,6 +1389,12 @@ void RDSoundPanel::SaveButton(RDAirPlayConf::PanelType type,
     q=new RDSqlQuery(sql1);
     delete q;
   }
+
+  RDNotification *notify=new RDNotification(RDNotification::PanelType,
+					    RDNotification::ModifyAction,
+					    QVariant(owner));
+  rda->ripc()->sendNotification(*notify);
+  delete notify;
 }
 
 
@@ -1482,13 +1483,15 @@ void RDSoundPanel::LogTraffic(RDPanelButton *button)
   q=new RDSqlQuery(sql);
   if(q->first()) {
 
-    QString eventDateTimeSQL = "NULL";
+    QString eventDateTimeSQL=
+      RDCheckDateTime(QDateTime::currentDateTime(),"yyyy-MM-dd hh:mm:ss");
 
     if(datetime.isValid() && button->startTime().isValid())
       eventDateTimeSQL = RDCheckDateTime(QDateTime(datetime.date(),
             button->startTime()), "yyyy-MM-dd hh:mm:ss");
 
-    sql=QString("insert into `")+panel_svcname+"_SRT` set "+
+    sql=QString("insert into ELR_LINES set ")+
+      "SERVICE_NAME=\""+RDEscapeString(panel_svcname)+"\","+
       QString().sprintf("LENGTH=%d,",button->startTime().
 			msecsTo(datetime.time()))+
       QString().sprintf("CART_NUMBER=%u,",button->cart())+
@@ -1532,7 +1535,8 @@ void RDSoundPanel::LogTrafficMacro(RDPanelButton *button)
     QString().sprintf("NUMBER=%u",button->cart());
   q=new RDSqlQuery(sql);
   if(q->first()) {
-    sql=QString("insert into `")+panel_svcname+"_SRT` set "+
+    sql=QString("insert into ELR_LINES set ")+
+      "SERVICE_NAME=\""+RDEscapeString(panel_svcname)+"\","+
       QString().sprintf("LENGTH=%d,",q->value(5).toUInt())+
       QString().sprintf("CART_NUMBER=%u,",button->cart())+
       "STATION_NAME=\""+RDEscapeString(rda->station()->name().utf8())+"\","+
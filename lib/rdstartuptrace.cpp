@@ -0,0 +1,54 @@
+// rdstartuptrace.cpp
+//
+// Per-phase query count and timing for module start-up
+//
+//   (C) Copyright 2018 Fred Gleason <fredg@paravelsystems.com>
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License version 2 as
+//   published by the Free Software Foundation.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public
+//   License along with this program; if not, write to the Free Software
+//   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+//
+
+#include "rddb.h"
+#include "rdstartuptrace.h"
+
+RDStartupTrace::RDStartupTrace()
+{
+  trace_clock.start();
+  trace_last_msecs=0;
+  trace_first_count=RDSqlQuery::queryCount();
+  trace_last_count=trace_first_count;
+}
+
+
+void RDStartupTrace::mark(const QString &phase)
+{
+  int msecs=trace_clock.elapsed();
+  unsigned count=RDSqlQuery::queryCount();
+
+  if(!trace_phases.isEmpty()) {
+    trace_phases+=", ";
+  }
+  trace_phases+=phase+QString().sprintf(" %u queries/%d ms",
+					 count-trace_last_count,
+					 msecs-trace_last_msecs);
+  trace_last_msecs=msecs;
+  trace_last_count=count;
+}
+
+
+QString RDStartupTrace::report() const
+{
+  return QString("startup: ")+trace_phases+
+    QString().sprintf(" [total %u queries/%d ms]",
+		      trace_last_count-trace_first_count,trace_last_msecs);
+}
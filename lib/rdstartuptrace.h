@@ -0,0 +1,43 @@
+// rdstartuptrace.h
+//
+// Per-phase query count and timing for module start-up
+//
+//   (C) Copyright 2018 Fred Gleason <fredg@paravelsystems.com>
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License version 2 as
+//   published by the Free Software Foundation.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public
+//   License along with this program; if not, write to the Free Software
+//   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+//
+
+#ifndef RDSTARTUPTRACE_H
+#define RDSTARTUPTRACE_H
+
+#include <qdatetime.h>
+#include <qstring.h>
+
+class RDStartupTrace
+{
+ public:
+  RDStartupTrace();
+  void mark(const QString &phase);
+  QString report() const;
+
+ private:
+  QTime trace_clock;
+  int trace_last_msecs;
+  unsigned trace_first_count;
+  unsigned trace_last_count;
+  QString trace_phases;
+};
+
+
+#endif  // RDSTARTUPTRACE_H
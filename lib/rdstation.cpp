@@ -35,12 +35,59 @@ RDStation::RDStation(const QString &name,bool create)
   QString sql;
   time_offset_valid = false;
   station_name=name;
+  station_snapshot=
+    new RDRowSnapshot("STATIONS","NAME=\""+RDEscapeString(name)+"\"");
+  station_live_row=
+    new RDRowSnapshot("STATIONS","NAME=\""+RDEscapeString(name)+"\"");
+  station_cards_snapshot=
+    new RDRowSnapshot("AUDIO_CARDS",
+		      "STATION_NAME=\""+RDEscapeString(name)+"\"",
+		      "CARD_NUMBER");
 }
 
 
 RDStation::~RDStation()
 {
-//  printf("Destroying RDStation\n");
+  delete station_snapshot;
+  delete station_live_row;
+  delete station_cards_snapshot;
+}
+
+
+bool RDStation::snapshotEnabled() const
+{
+  return station_snapshot->isEnabled();
+}
+
+
+void RDStation::setSnapshotEnabled(bool state)
+{
+  //
+  // The audio card rows, capabilities, driver versions and scan flag are
+  // rewritten by caed(8) whenever it starts, without any notification
+  // being sent, so those are always read live (station_live_row is never
+  // enabled, station_cards_snapshot only by caed(8) itself).
+  //
+  station_snapshot->setEnabled(state);
+}
+
+
+void RDStation::setCardsSnapshotEnabled(bool state)
+{
+  //
+  // For caed(8), which writes the AUDIO_CARDS rows.  Card values are then
+  // read with a single select, and writes that would not change a row
+  // are skipped.
+  //
+  station_cards_snapshot->setEnabled(state);
+}
+
+
+void RDStation::reload()
+{
+  station_snapshot->reload();
+  station_cards_snapshot->reload();
+  time_offset_valid=false;
 }
 
 
@@ -58,7 +105,7 @@ QString RDStation::name() const
 
 QString RDStation::shortName() const
 {
-  return RDGetSqlValue("STATIONS","NAME",station_name,"SHORT_NAME").toString();
+  return station_snapshot->value("SHORT_NAME").toString();
 }
 
 
@@ -70,7 +117,7 @@ void RDStation::setShortName(const QString &str) const
 
 QString RDStation::description() const
 {
-  return RDGetSqlValue("STATIONS","NAME",station_name,"DESCRIPTION").toString();
+  return station_snapshot->value("DESCRIPTION").toString();
 }
 
 
@@ -82,7 +129,7 @@ void RDStation::setDescription(QString desc) const
 
 QString RDStation::userName() const
 {
-  return RDGetSqlValue("STATIONS","NAME",station_name,"USER_NAME").toString();
+  return station_snapshot->value("USER_NAME").toString();
 }
 
 
@@ -94,7 +141,7 @@ void RDStation::setUserName(QString name) const
 
 QString RDStation::defaultName() const
 {
-  return RDGetSqlValue("STATIONS","NAME",station_name,"DEFAULT_NAME").
+  return station_snapshot->value("DEFAULT_NAME").
     toString();
 }
 
@@ -108,7 +155,7 @@ void RDStation::setDefaultName(QString name) const
 QHostAddress RDStation::address() const
 {
   QHostAddress addr;
-  addr.setAddress(RDGetSqlValue("STATIONS","NAME",station_name,"IPV4_ADDRESS").
+  addr.setAddress(station_snapshot->value("IPV4_ADDRESS").
 		  toString());
   return addr;
 }
@@ -142,7 +189,7 @@ QHostAddress RDStation::httpAddress(RDConfig *config) const
 QString RDStation::httpStation() const
 {
   return
-    RDGetSqlValue("STATIONS","NAME",station_name,"HTTP_STATION").toString();
+    station_snapshot->value("HTTP_STATION").toString();
 }
 
 
@@ -155,7 +202,7 @@ void RDStation::setHttpStation(const QString &str)
 QString RDStation::caeStation() const
 {
   return
-    RDGetSqlValue("STATIONS","NAME",station_name,"CAE_STATION").toString();
+    station_snapshot->value("CAE_STATION").toString();
 }
 
 
@@ -194,7 +241,7 @@ QString RDStation::webServiceUrl(RDConfig *config) const
 int RDStation::timeOffset()
 {
   if (!time_offset_valid){
-    time_offset = RDGetSqlValue("STATIONS","NAME",station_name,"TIME_OFFSET").toInt();
+    time_offset = station_snapshot->value("TIME_OFFSET").toInt();
     time_offset_valid = true;
   }
   return time_offset;
@@ -210,7 +257,7 @@ void RDStation::setTimeOffset(int msecs)
 
 QString RDStation::backupPath() const
 {
-  return RDGetSqlValue("STATIONS","NAME",station_name,"BACKUP_DIR").toString();
+  return station_snapshot->value("BACKUP_DIR").toString();
 }
 
 
@@ -222,7 +269,7 @@ void RDStation::setBackupPath(QString path) const
 
 int RDStation::backupLife() const
 {
-  return RDGetSqlValue("STATIONS","NAME",station_name,"BACKUP_LIFE").toInt();
+  return station_snapshot->value("BACKUP_LIFE").toInt();
 }
 
 
@@ -234,7 +281,7 @@ void RDStation::setBackupLife(int days) const
 
 unsigned RDStation::heartbeatCart() const
 {
-  return RDGetSqlValue("STATIONS","NAME",station_name,"HEARTBEAT_CART").
+  return station_snapshot->value("HEARTBEAT_CART").
     toUInt();
 }
 
@@ -247,7 +294,7 @@ void RDStation::setHeartbeatCart(unsigned cartnum) const
 
 unsigned RDStation::heartbeatInterval() const
 {
-  return RDGetSqlValue("STATIONS","NAME",station_name,"HEARTBEAT_INTERVAL").
+  return station_snapshot->value("HEARTBEAT_INTERVAL").
     toUInt();
 }
 
@@ -260,7 +307,7 @@ void RDStation::setHeartbeatInterval(unsigned interval) const
 
 unsigned RDStation::startupCart() const
 {
-  return RDGetSqlValue("STATIONS","NAME",station_name,"STARTUP_CART").
+  return station_snapshot->value("STARTUP_CART").
     toUInt();
 }
 
@@ -273,7 +320,7 @@ void RDStation::setStartupCart(unsigned cartnum) const
 
 QString RDStation::editorPath() const
 {
-  return RDGetSqlValue("STATIONS","NAME",station_name,"EDITOR_PATH").
+  return station_snapshot->value("EDITOR_PATH").
     toString();
 }
 
@@ -286,8 +333,7 @@ void RDStation::setEditorPath(const QString &cmd)
 
 RDStation::FilterMode RDStation::filterMode() const
 {
-  return (RDStation::FilterMode)RDGetSqlValue("STATIONS","NAME",station_name,
-					      "FILTER_MODE").toInt();
+  return (RDStation::FilterMode)station_snapshot->value("FILTER_MODE").toInt();
 }
 
 
@@ -299,7 +345,7 @@ void RDStation::setFilterMode(RDStation::FilterMode mode) const
 
 bool RDStation::startJack() const
 {
-  return RDBool(RDGetSqlValue("STATIONS","NAME",station_name,"START_JACK").
+  return RDBool(station_snapshot->value("START_JACK").
 		toString());
 }
 
@@ -312,7 +358,7 @@ void RDStation::setStartJack(bool state) const
 
 QString RDStation::jackServerName() const
 {
-  return RDGetSqlValue("STATIONS","NAME",station_name,"JACK_SERVER_NAME").
+  return station_snapshot->value("JACK_SERVER_NAME").
     toString();
 }
 
@@ -325,7 +371,7 @@ void RDStation::setJackServerName(const QString &str) const
 
 QString RDStation::jackCommandLine() const
 {
-  return RDGetSqlValue("STATIONS","NAME",station_name,"JACK_COMMAND_LINE").
+  return station_snapshot->value("JACK_COMMAND_LINE").
     toString();
 }
 
@@ -338,7 +384,7 @@ void RDStation::setJackCommandLine(const QString &str) const
 
 int RDStation::jackPorts() const
 {
-  return RDGetSqlValue("STATIONS","NAME",station_name,"JACK_PORTS").toInt();
+  return station_snapshot->value("JACK_PORTS").toInt();
 }
 
 
@@ -350,7 +396,7 @@ void RDStation::setJackPorts(int ports) const
 
 int RDStation::cueCard() const
 {
-  return RDGetSqlValue("STATIONS","NAME",station_name,"CUE_CARD").toInt();
+  return station_snapshot->value("CUE_CARD").toInt();
 }
 
 
@@ -362,7 +408,7 @@ void RDStation::setCueCard(int card)
 
 int RDStation::cuePort() const
 {
-  return RDGetSqlValue("STATIONS","NAME",station_name,"CUE_PORT").toInt();
+  return station_snapshot->value("CUE_PORT").toInt();
 }
 
 
@@ -374,7 +420,7 @@ void RDStation::setCuePort(int port)
 
 unsigned RDStation::cueStartCart() const
 {
-  return RDGetSqlValue("STATIONS","NAME",station_name,"CUE_START_CART").
+  return station_snapshot->value("CUE_START_CART").
     toUInt();
 }
 
@@ -387,7 +433,7 @@ void RDStation::setCueStartCart(unsigned cartnum) const
 
 unsigned RDStation::cueStopCart() const
 {
-  return RDGetSqlValue("STATIONS","NAME",station_name,"CUE_STOP_CART").toUInt();
+  return station_snapshot->value("CUE_STOP_CART").toUInt();
 }
 
 
@@ -399,7 +445,7 @@ void RDStation::setCueStopCart(unsigned cartnum) const
 
 int RDStation::cartSlotColumns() const
 {
-  return RDGetSqlValue("STATIONS","NAME",station_name,"CARTSLOT_COLUMNS").
+  return station_snapshot->value("CARTSLOT_COLUMNS").
     toInt();
 }
 
@@ -412,7 +458,7 @@ void RDStation::setCartSlotColumns(int cols)
 
 int RDStation::cartSlotRows() const
 {
-  return RDGetSqlValue("STATIONS","NAME",station_name,"CARTSLOT_ROWS").toInt();
+  return station_snapshot->value("CARTSLOT_ROWS").toInt();
 }
 
 
@@ -424,8 +470,7 @@ void RDStation::setCartSlotRows(int rows)
 
 bool RDStation::enableDragdrop() const
 {
-  return RDBool(RDGetSqlValue("STATIONS","NAME",station_name,
-			      "ENABLE_DRAGDROP").toString());
+  return RDBool(station_snapshot->value("ENABLE_DRAGDROP").toString());
 }
 
 
@@ -437,8 +482,7 @@ void RDStation::setEnableDragdrop(bool state)
 
 bool RDStation::enforcePanelSetup() const
 {
-  return RDBool(RDGetSqlValue("STATIONS","NAME",station_name,
-			      "ENFORCE_PANEL_SETUP").toString());
+  return RDBool(station_snapshot->value("ENFORCE_PANEL_SETUP").toString());
 }
 
 
@@ -450,7 +494,7 @@ void RDStation::setEnforcePanelSetup(bool state)
 
 bool RDStation::systemMaint() const
 {
-  return RDBool(RDGetSqlValue("STATIONS","NAME",station_name,"SYSTEM_MAINT").
+  return RDBool(station_snapshot->value("SYSTEM_MAINT").
 	       toString());
 }
 
@@ -463,7 +507,7 @@ void RDStation::setSystemMaint(bool state) const
 
 bool RDStation::scanned() const
 {
-  return RDBool(RDGetSqlValue("STATIONS","NAME",station_name,"STATION_SCANNED").
+  return RDBool(station_live_row->value("STATION_SCANNED").
 	       toString());
 }
 
@@ -478,36 +522,29 @@ bool RDStation::haveCapability(Capability cap) const
 {
   switch(cap) {
       case RDStation::HaveOggenc:
-	return RDBool(RDGetSqlValue("STATIONS","NAME",station_name,
-				  "HAVE_OGGENC").toString());
+	return RDBool(station_live_row->value("HAVE_OGGENC").toString());
 	break;
 
       case RDStation::HaveOgg123:
-	return RDBool(RDGetSqlValue("STATIONS","NAME",station_name,
-				  "HAVE_OGG123").toString());
+	return RDBool(station_live_row->value("HAVE_OGG123").toString());
 	break;
 
       case RDStation::HaveFlac:
-	return RDBool(RDGetSqlValue("STATIONS","NAME",station_name,
-				  "HAVE_FLAC").toString());
+	return RDBool(station_live_row->value("HAVE_FLAC").toString());
 	break;
 
       case RDStation::HaveLame:
-	return RDBool(RDGetSqlValue("STATIONS","NAME",station_name,
-				  "HAVE_LAME").toString());
+	return RDBool(station_live_row->value("HAVE_LAME").toString());
 	break;
 
       case RDStation::HaveMp4Decode:
-	return RDBool(RDGetSqlValue("STATIONS","NAME",station_name,
-				  "HAVE_MP4_DECODE").toString());
+	return RDBool(station_live_row->value("HAVE_MP4_DECODE").toString());
 
       case RDStation::HaveMpg321:
-	return RDBool(RDGetSqlValue("STATIONS","NAME",station_name,
-				  "HAVE_MPG321").toString());
+	return RDBool(station_live_row->value("HAVE_MPG321").toString());
 
       case RDStation::HaveTwoLame:
-	return RDBool(RDGetSqlValue("STATIONS","NAME",station_name,
-				  "HAVE_TWOLAME").toString());
+	return RDBool(station_live_row->value("HAVE_TWOLAME").toString());
 	break;
   }
   return false;
@@ -552,6 +589,15 @@ int RDStation::cards() const
 {
   int n=0;
 
+  if(station_cards_snapshot->isEnabled()) {
+    for(int i=0;i<RD_MAX_CARDS;i++) {
+      if((RDStation::AudioDriver)station_cards_snapshot->
+	 value("DRIVER",i).toInt()!=RDStation::None) {
+	n++;
+      }
+    }
+    return n;
+  }
   QString sql=QString("select DRIVER from AUDIO_CARDS where ")+
     "STATION_NAME=\""+RDEscapeString(station_name)+"\"";
   RDSqlQuery *q=new RDSqlQuery(sql);
@@ -568,28 +614,23 @@ int RDStation::cards() const
 
 RDStation::AudioDriver RDStation::cardDriver(int cardnum) const
 {
-  RDStation::AudioDriver ret=RDStation::None;
-  QString sql=QString("select DRIVER from AUDIO_CARDS where ")+
-    "STATION_NAME=\""+RDEscapeString(station_name)+"\" && "+
-    QString().sprintf("CARD_NUMBER=%d",cardnum);
-  RDSqlQuery *q=new RDSqlQuery(sql);
-  if(q->first()) {
-    ret=(RDStation::AudioDriver)q->value(0).toInt();
-  }
-  delete q;
-
-  return ret;
+  return (RDStation::AudioDriver)station_cards_snapshot->
+    value("DRIVER",cardnum).toInt();
 }
 
 
 void RDStation::setCardDriver(int cardnum,AudioDriver driver) const
 {
+  if(CardUnchanged(cardnum,"DRIVER",(int)driver)) {
+    return;
+  }
   QString sql=QString("update AUDIO_CARDS set ")+
     QString().sprintf("DRIVER=%d where ",driver)+
     "STATION_NAME=\""+RDEscapeString(station_name)+"\" && "+
     QString().sprintf("CARD_NUMBER=%d",cardnum);
   RDSqlQuery *q=new RDSqlQuery(sql);
   delete q;
+  station_cards_snapshot->setValue("DRIVER",(int)driver,cardnum);
 }
 
 
@@ -600,15 +641,15 @@ QString RDStation::driverVersion(AudioDriver driver) const
 	return QString();
 
       case RDStation::Hpi:
-	return RDGetSqlValue("STATIONS","NAME",station_name,"HPI_VERSION").
+	return station_live_row->value("HPI_VERSION").
 	  toString();
 
       case RDStation::Jack:
-	return RDGetSqlValue("STATIONS","NAME",station_name,"JACK_VERSION").
+	return station_live_row->value("JACK_VERSION").
 	  toString();
 
       case RDStation::Alsa:
-	return RDGetSqlValue("STATIONS","NAME",station_name,"ALSA_VERSION").
+	return station_live_row->value("ALSA_VERSION").
 	  toString();
   }
   return QString();
@@ -638,82 +679,76 @@ void RDStation::setDriverVersion(AudioDriver driver,QString ver) const
 
 QString RDStation::cardName(int cardnum) const
 {
-  QString ret;
-  QString sql=QString("select NAME from AUDIO_CARDS where ")+
-    "STATION_NAME=\""+RDEscapeString(station_name)+"\" && "+
-    QString().sprintf("CARD_NUMBER=%d",cardnum);
-  RDSqlQuery *q=new RDSqlQuery(sql);
-  if(q->first()) {
-    ret=q->value(0).toString();
-  }
-  delete q;
-
-  return ret;
+  return station_cards_snapshot->value("NAME",cardnum).toString();
 }
 
 
 void RDStation::setCardName(int cardnum,QString name) const
 {
+  if(CardUnchanged(cardnum,"NAME",name)) {
+    return;
+  }
   QString sql=QString("update AUDIO_CARDS set ")+
     "NAME=\""+RDEscapeString(name)+"\" where "+
     "STATION_NAME=\""+RDEscapeString(station_name)+"\" && "+
     QString().sprintf("CARD_NUMBER=%d",cardnum);
   RDSqlQuery *q=new RDSqlQuery(sql);
   delete q;
+  station_cards_snapshot->setValue("NAME",name,cardnum);
 }
 
 
 int RDStation::cardInputs(int cardnum) const
 {
-  int ret=-1;
-  QString sql=QString("select INPUTS from AUDIO_CARDS where ")+
-    "STATION_NAME=\""+RDEscapeString(station_name)+"\" && "+
-    QString().sprintf("CARD_NUMBER=%d",cardnum);
-  RDSqlQuery *q=new RDSqlQuery(sql);
-  if(q->first()) {
-    ret=q->value(0).toInt();
-  }
-  delete q;
+  bool valid=false;
+  int ret=station_cards_snapshot->value("INPUTS",cardnum,&valid).toInt();
 
+  if(!valid) {
+    return -1;
+  }
   return ret;
 }
 
 
 void RDStation::setCardInputs(int cardnum,int inputs) const
 {
+  if(CardUnchanged(cardnum,"INPUTS",inputs)) {
+    return;
+  }
   QString sql=QString("update AUDIO_CARDS set ")+
     QString().sprintf("INPUTS=%d where ",inputs)+
     "STATION_NAME=\""+RDEscapeString(station_name)+"\" && "+
     QString().sprintf("CARD_NUMBER=%d",cardnum);
   RDSqlQuery *q=new RDSqlQuery(sql);
   delete q;
+  station_cards_snapshot->setValue("INPUTS",inputs,cardnum);
 }
 
 
 int RDStation::cardOutputs(int cardnum) const
 {
-  int ret=-1;
-  QString sql=QString("select OUTPUTS from AUDIO_CARDS where ")+
-    "STATION_NAME=\""+RDEscapeString(station_name)+"\" && "+
-    QString().sprintf("CARD_NUMBER=%d",cardnum);
-  RDSqlQuery *q=new RDSqlQuery(sql);
-  if(q->first()) {
-    ret=q->value(0).toInt();
-  }
-  delete q;
+  bool valid=false;
+  int ret=station_cards_snapshot->value("OUTPUTS",cardnum,&valid).toInt();
 
+  if(!valid) {
+    return -1;
+  }
   return ret;
 }
 
 
 void RDStation::setCardOutputs(int cardnum,int outputs) const
 {
+  if(CardUnchanged(cardnum,"OUTPUTS",outputs)) {
+    return;
+  }
   QString sql=QString("update AUDIO_CARDS set ")+
     QString().sprintf("OUTPUTS=%d where ",outputs)+
     "STATION_NAME=\""+RDEscapeString(station_name)+"\" && "+
     QString().sprintf("CARD_NUMBER=%d",cardnum);
   RDSqlQuery *q=new RDSqlQuery(sql);
   delete q;
+  station_cards_snapshot->setValue("OUTPUTS",outputs,cardnum);
 }
 
 
@@ -2076,6 +2111,7 @@ void RDStation::SetRow(const QString &param,const QString &value) const
 			(const char *)RDEscapeString(station_name));
   q=new RDSqlQuery(sql);
   delete q;
+  station_snapshot->setValue(param,value);
 }
 
 
@@ -2090,6 +2126,7 @@ void RDStation::SetRow(const QString &param,int value) const
 			(const char *)RDEscapeString(station_name));
   q=new RDSqlQuery(sql);
   delete q;
+  station_snapshot->setValue(param,value);
 }
 
 
@@ -2104,6 +2141,7 @@ void RDStation::SetRow(const QString &param,unsigned value) const
 			(const char *)RDEscapeString(station_name));
   q=new RDSqlQuery(sql);
   delete q;
+  station_snapshot->setValue(param,value);
 }
 
 
@@ -2118,4 +2156,19 @@ void RDStation::SetRow(const QString &param,bool value) const
 			(const char *)RDEscapeString(station_name));
   q=new RDSqlQuery(sql);
   delete q;
+  station_snapshot->setValue(param,RDYesNo(value));
+}
+
+
+bool RDStation::CardUnchanged(int cardnum,const QString &field,
+			      const QVariant &value) const
+{
+  bool valid=false;
+
+  if(!station_cards_snapshot->isEnabled()) {
+    return false;
+  }
+  QVariant old=station_cards_snapshot->value(field,cardnum,&valid);
+
+  return valid&&(old.toString()==value.toString());
 }
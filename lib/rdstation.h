@@ -25,6 +25,7 @@
 #include <qhostaddress.h>
 
 #include <rdconfig.h>
+#include <rdrowsnapshot.h>
 
 class RDStation
 {
@@ -35,6 +36,10 @@ class RDStation
   enum FilterMode {FilterSynchronous=0,FilterAsynchronous=1};
   RDStation(const QString &name,bool create=false);
   ~RDStation();
+  bool snapshotEnabled() const;
+  void setSnapshotEnabled(bool state);
+  void setCardsSnapshotEnabled(bool state);
+  void reload();
   QString name() const;
   bool exists() const;
   QString shortName() const;
@@ -121,9 +126,14 @@ class RDStation
   void SetRow(const QString &param,int value) const;
   void SetRow(const QString &param,unsigned value) const;
   void SetRow(const QString &param,bool value) const;
+  bool CardUnchanged(int cardnum,const QString &field,
+		     const QVariant &value) const;
   QString station_name;
   int time_offset;
   bool time_offset_valid;
+  RDRowSnapshot *station_snapshot;
+  RDRowSnapshot *station_live_row;
+  RDRowSnapshot *station_cards_snapshot;
 };
 
 
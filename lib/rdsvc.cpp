@@ -18,20 +18,65 @@
 //   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
 //
 
+#include <map>
+
 #include <qmessagebox.h>
 
 #include "rdapplication.h"
 #include "rdclock.h"
 #include "rdconf.h"
-#include "rdcreate_log.h"
 #include "rddatedecode.h"
 #include "rddb.h"
 #include "rd.h"
 #include "rdescape_string.h"
 #include "rdlog.h"
+#include "rdloglinebuffer.h"
 #include "rdsvc.h"
 #include "rdweb.h"
 
+__RDSvcImportLine::__RDSvcImportLine()
+{
+  start_hour=0;
+  start_secs=0;
+  cart_number=0;
+  length=0;
+  insert_break=false;
+  insert_track=false;
+  insert_first=RDEventLine::InsertNone;
+  link_length=-1;
+}
+
+
+QString __RDSvcImportLine::values(int id) const
+{
+  QString ret=QString().sprintf("(%d,%d,%d,%u,",id,start_hour,start_secs,
+				cart_number)+
+    "\""+RDEscapeString(title)+"\","+
+    QString().sprintf("%d,",length)+
+    "\""+RDYesNo(insert_break)+"\","+
+    "\""+RDYesNo(insert_track)+"\","+
+    QString().sprintf("%d,",insert_first);
+  if(insert_track) {
+    ret+="\""+RDEscapeString(track_string)+"\",";
+  }
+  else {
+    ret+="NULL,";
+  }
+  ret+="\""+RDEscapeString(ext_data)+"\","+
+    "\""+RDEscapeString(ext_event_id)+"\","+
+    "\""+RDEscapeString(ext_annc_type)+"\","+
+    "\""+RDEscapeString(ext_cart_name)+"\",";
+  if(link_start_time.isValid()&&(link_length>=0)) {
+    ret+="\""+link_start_time.toString("hh:mm:ss")+"\","+
+      QString().sprintf("%d)",link_length);
+  }
+  else {
+    ret+="NULL,NULL)";
+  }
+  return ret;
+}
+
+
 //
 // Global Classes
 //
@@ -384,6 +429,12 @@ bool RDSvc::import(ImportSource src,const QDate &date,const QString &break_str,
   int cartlen;
   QString sql;
   bool ok=false;
+  QTime elapsed;
+  int parse_msecs=0;
+  int load_msecs=0;
+  int validate_msecs=0;
+
+  svc_import_times="";
 
   //
   // Set Import Source
@@ -446,6 +497,7 @@ bool RDSvc::import(ImportSource src,const QDate &date,const QString &break_str,
   if(!preimport_cmd.isEmpty()) {
     system(RDDateDecode(preimport_cmd,date,svc_station,svc_config,svc_name));
   }
+  elapsed.start();
 
   QString parser_table;
   QString parser_name;
@@ -514,37 +566,12 @@ bool RDSvc::import(ImportSource src,const QDate &date,const QString &break_str,
   delete q;
 
   //
-  // Setup Data Source and Destination
+  // Parse
   //
-  rda->dropTable(dest_table);
-  sql=QString("create table ")+
-    "`"+dest_table+"` ("+
-    "ID int primary key,"+
-    "START_HOUR int not null,"+
-    "START_SECS int not null,"+
-    "CART_NUMBER int unsigned,"+
-    "TITLE char(255),"+
-    "LENGTH int,"+
-    "INSERT_BREAK enum('N','Y') default 'N',"+
-    "INSERT_TRACK enum('N','Y') default 'N',"+
-    "INSERT_FIRST int unsigned default 0,"+
-    "TRACK_STRING char(255),"+
-    "EXT_DATA char(32),"+
-    "EXT_EVENT_ID char(32),"+
-    "EXT_ANNC_TYPE char(8),"+
-    "EXT_CART_NAME char(32),"+
-    "LINK_START_TIME time default NULL,"+
-    "LINK_LENGTH int default NULL,"+
-    "EVENT_USED enum('N','Y') default 'N',"+
-    "INDEX START_TIME_IDX (START_HOUR,START_SECS)) "+
-    svc_config->createTablePostfix();
-  q=new RDSqlQuery(sql);
-  delete q;
-
+  // The whole file is parsed into memory first, so the break and track
+  // flags from the marker lines are simply set on the row they belong to.
   //
-  // Parse and Save
-  //
-  int line_id=0;
+  std::vector<__RDSvcImportLine> lines;
   bool insert_found=false;
   bool cart_ok=false;
   bool start_time_ok=false;
@@ -612,62 +639,40 @@ bool RDSvc::import(ImportSource src,const QDate &date,const QString &break_str,
     if(start_time_ok&&(cart_ok||
 		       ((!label_cart.isEmpty())&&(cartname==label_cart))||
 		       ((!track_cart.isEmpty())&&(cartname==track_cart)))) {
-      sql=QString("insert into ")+
-	"`"+dest_table+"`	set "+
-	QString().sprintf("ID=%d,",line_id++)+
-	QString().sprintf("START_HOUR=%d,",start_hour)+
-	QString().sprintf("START_SECS=%d,",
-			  60*start_minutes+start_seconds)+
-	QString().sprintf("CART_NUMBER=%u,",cartnum)+
-	"TITLE=\""+RDEscapeString(title)+"\","+
-	QString().sprintf("LENGTH=%d,",cartlen)+
-	"EXT_DATA=\""+data_buf+"\","+
-	"EXT_EVENT_ID=\""+eventid_buf+"\","+
-	"EXT_ANNC_TYPE=\""+annctype_buf+"\","+
-	"EXT_CART_NAME=\""+cartname+"\"";
-      q=new RDSqlQuery(sql);
-      delete q;
+      lines.push_back(__RDSvcImportLine());
+      __RDSvcImportLine *line=&lines.back();
+      line->start_hour=start_hour;
+      line->start_secs=60*start_minutes+start_seconds;
+      line->cart_number=cartnum;
+      line->title=title;
+      line->length=cartlen;
+      line->ext_data=data_buf;
+      line->ext_event_id=eventid_buf;
+      line->ext_annc_type=annctype_buf;
+      line->ext_cart_name=cartname;
+
       //
       // Insert Break
       //
       if(insert_break) {
-	sql=QString("update ")+"`"+dest_table+"` set "+
-	  "INSERT_BREAK=\"Y\"";
+	line->insert_break=true;
 	if(break_first) {
-	  sql+=QString().sprintf(",INSERT_FIRST=%d",
-				 RDEventLine::InsertBreak);
+	  line->insert_first=RDEventLine::InsertBreak;
 	}
 	if(link_time.isValid()&&(link_length>=0)) {
-	  sql+=",LINK_START_TIME=\""+
-	    link_time.toString("hh:mm:ss")+"\""+
-	    QString().sprintf(",LINK_LENGTH=%d",
-			      link_length);
+	  line->link_start_time=link_time;
+	  line->link_length=link_length;
 	}
-	sql+=QString().sprintf(" where ID=%d",line_id-1);
-	q=new RDSqlQuery(sql);
-	delete q;
       }
       //
       // Insert Track
       //
       if(insert_track) {
+	line->insert_track=true;
+	line->track_string=track_label;
 	if(track_first) {
-	  sql=QString("update ")+
-	    "`"+dest_table+"` set "+
-	    "INSERT_TRACK=\"Y\","+
-	    "TRACK_STRING=\""+RDEscapeString(track_label)+"\","+
-	    QString().sprintf("INSERT_FIRST=%d ",RDEventLine::InsertTrack)+
-	    QString().sprintf("where ID=%d",line_id-1);
+	  line->insert_first=RDEventLine::InsertTrack;
 	}
-	else {
-	  sql=QString("update ")+
-	    "`"+dest_table+"` set "+
-	    "INSERT_TRACK=\"Y\","+
-	    "TRACK_STRING=\""+RDEscapeString(track_label)+"\" "+
-	    QString().sprintf("where ID=%d",line_id-1);
-	}
-	q=new RDSqlQuery(sql);
-	delete q;
       }
       insert_break=false;
       break_first=false;
@@ -710,31 +715,130 @@ bool RDSvc::import(ImportSource src,const QDate &date,const QString &break_str,
       }
     }
   }
+  fclose(infile);
+  parse_msecs=elapsed.restart();
 
   //
-  // Cleanup
+  // Setup Data Destination
   //
-  fclose(infile);
+  rda->dropTable(dest_table);
+  sql=QString("create table ")+
+    "`"+dest_table+"` ("+
+    "ID int primary key,"+
+    "START_HOUR int not null,"+
+    "START_SECS int not null,"+
+    "CART_NUMBER int unsigned,"+
+    "TITLE char(255),"+
+    "LENGTH int,"+
+    "INSERT_BREAK enum('N','Y') default 'N',"+
+    "INSERT_TRACK enum('N','Y') default 'N',"+
+    "INSERT_FIRST int unsigned default 0,"+
+    "TRACK_STRING char(255),"+
+    "EXT_DATA char(32),"+
+    "EXT_EVENT_ID char(32),"+
+    "EXT_ANNC_TYPE char(8),"+
+    "EXT_CART_NAME char(32),"+
+    "LINK_START_TIME time default NULL,"+
+    "LINK_LENGTH int default NULL,"+
+    "EVENT_USED enum('N','Y') default 'N',"+
+    "CART_FORCED_LENGTH int default NULL,"+
+    "INDEX START_TIME_IDX (START_HOUR,START_SECS)) "+
+    svc_config->createTablePostfix();
+  q=new RDSqlQuery(sql);
+  delete q;
+
+  //
+  // Load
+  //
+  for(unsigned i=0;i<lines.size();i+=RDSVC_IMPORT_BATCH_SIZE) {
+    sql=QString("insert into `")+dest_table+"` ("+
+      "ID,"+
+      "START_HOUR,"+
+      "START_SECS,"+
+      "CART_NUMBER,"+
+      "TITLE,"+
+      "LENGTH,"+
+      "INSERT_BREAK,"+
+      "INSERT_TRACK,"+
+      "INSERT_FIRST,"+
+      "TRACK_STRING,"+
+      "EXT_DATA,"+
+      "EXT_EVENT_ID,"+
+      "EXT_ANNC_TYPE,"+
+      "EXT_CART_NAME,"+
+      "LINK_START_TIME,"+
+      "LINK_LENGTH) values ";
+    for(unsigned j=i;(j<lines.size())&&(j<(i+RDSVC_IMPORT_BATCH_SIZE));j++) {
+      sql+=lines[j].values(j)+",";
+    }
+    sql=sql.left(sql.length()-1);
+    q=new RDSqlQuery(sql);
+    delete q;
+  }
+  load_msecs=elapsed.restart();
+
+  //
+  // Validate Carts
+  //
+  // One set-based update picks up the length of every cart that exists,
+  // leaving CART_FORCED_LENGTH NULL for those that don't.
+  //
+  sql=QString("update `")+dest_table+"`,CART set "+
+    "`"+dest_table+"`.CART_FORCED_LENGTH=ifnull(CART.FORCED_LENGTH,0) where "+
+    "`"+dest_table+"`.CART_NUMBER=CART.NUMBER";
+  q=new RDSqlQuery(sql);
+  delete q;
+  validate_msecs=elapsed.elapsed();
+
+  svc_import_times=
+    QString().sprintf("parse %d mS (%u lines), ",parse_msecs,
+		      (unsigned)lines.size())+
+    QString().sprintf("load %d mS, ",load_msecs)+
+    QString().sprintf("validate %d mS",validate_msecs);
+
   return true;
 }
 
 
+QString RDSvc::importTimes() const
+{
+  return svc_import_times;
+}
+
+
 bool RDSvc::generateLog(const QDate &date,const QString &logname,
 			const QString &nextname,QString *report,RDUser *user,
 			QString *err_msg)
 {
   QString sql;
   RDSqlQuery *q;
-  RDClock clock;
   //  QString err_msg;
   RDLog *log=NULL;
   RDLogLock *log_lock=NULL;
-
+  RDLogLineBuffer *buf=NULL;
+  std::map<QString,RDClock *> clocks;
+  std::map<QString,RDEventLine> events;
+  std::map<QString,RDClock *>::iterator it;
+  std::map<int,QString> hours;
+  QString clockname;
+  QTime total;
+  QTime elapsed;
+  int setup_msecs=0;
+  int template_msecs=0;
+  int event_msecs=0;
+  int insert_msecs=0;
+  int finish_msecs=0;
+  unsigned lines=0;
+  bool ret=true;
+
+  svc_generation_times="";
   if((!date.isValid()||logname.isEmpty())) {
     return false;
   }
 
   emit generationProgress(0);
+  total.start();
+  elapsed.start();
 
   //
   // Generate Log Structure
@@ -757,67 +861,104 @@ bool RDSvc::generateLog(const QDate &date,const QString &logname,
   log=new RDLog(logname);
   log->setDescription(RDDateDecode(descriptionTemplate(),date,svc_station,
 				   svc_config,svc_name));
+  buf=new RDLogLineBuffer(logname);
+  setup_msecs=elapsed.restart();
 
   emit generationProgress(1);
 
   //
   // Generate Events
   //
+  // Each clock (and each event within it) is loaded only once per run,
+  // however many hours it is scheduled in.
+  //
+  sql=QString("select ")+
+    "HOUR,"+        // 00
+    "CLOCK_NAME "+  // 01
+    "from SERVICE_CLOCKS where "+
+    "(SERVICE_NAME=\""+RDEscapeString(svc_name)+"\")&&"+
+    QString().sprintf("(HOUR>=%d)&&(HOUR<%d)",24*(date.dayOfWeek()-1),
+		      24*date.dayOfWeek());
+  q=new RDSqlQuery(sql);
+  while(q->next()) {
+    if((!q->value(1).isNull())&&(!q->value(1).toString().isEmpty())) {
+      hours[q->value(0).toInt()-24*(date.dayOfWeek()-1)]=
+	q->value(1).toString();
+    }
+  }
+  delete q;
+  template_msecs+=elapsed.restart();
   for(int i=0;i<24;i++) {
-    sql=QString("select CLOCK_NAME from SERVICE_CLOCKS where ")+
-      "(SERVICE_NAME=\""+RDEscapeString(svc_name)+"\")&&"+
-      QString().sprintf("(HOUR=%d)",24*(date.dayOfWeek()-1)+i);
-    q=new RDSqlQuery(sql);
-    if(q->first()) {
-      if((!q->value(0).isNull())&&(!q->value(0).toString().isEmpty())) {
-	clock.setName(q->value(0).toString());
-	clock.load();
-	clock.generateLog(i,logname,svc_name,report);
-	clock.clear();
+    if(hours.find(i)!=hours.end()) {
+      clockname=hours[i];
+      if((it=clocks.find(clockname))==clocks.end()) {
+	it=clocks.insert(std::pair<QString,RDClock *>
+			 (clockname,new RDClock())).first;
+	it->second->setName(clockname);
+	it->second->load(&events);
+	template_msecs+=elapsed.restart();
       }
+      it->second->generateLog(i,buf,svc_name,report);
+      event_msecs+=elapsed.restart();
     }
-    delete q;
     emit generationProgress(1+i);
   }
+  for(it=clocks.begin();it!=clocks.end();it++) {
+    delete it->second;
+  }
 
   //
-  // Get Current Count
+  // Log Chain To
   //
-  int count;
-  sql=QString("select COUNT from `")+RDLog::tableName(logname)+"` order by COUNT desc";
-  q=new RDSqlQuery(sql);
-  if(q->first()) {
-    count=q->value(0).toInt()+1;
-  }
-  else {
-    count=0;
+  if(chainto()) {
+    buf->addLine();
+    buf->setValue(RDLogLineBuffer::Type,RDLogLine::Chain);
+    buf->setValue(RDLogLineBuffer::Source,RDLogLine::Template);
+    buf->setValue(RDLogLineBuffer::TimeType,RDLogLine::Relative);
+    buf->setValue(RDLogLineBuffer::TransType,RDLogLine::Segue);
+    buf->setValue(RDLogLineBuffer::Label,nextname);
   }
-  delete q;
 
   //
-  // Log Chain To
+  // Write Lines
   //
-  if(chainto()) {
-    sql=QString("insert into `")+RDLog::tableName(logname)+"` set "+
-      QString().sprintf("ID=%d,COUNT=%d,TYPE=%d,",count,count,RDLogLine::Chain)+
-      QString().sprintf("SOURCE=%d,TRANS_TYPE=%d,",RDLogLine::Template,
-			RDLogLine::Segue)+
-      "LABEL=\""+RDEscapeString(nextname)+"\"";
-    q=new RDSqlQuery(sql);
-    delete q;
-    count ++;
+  lines=buf->size();
+  if(!buf->flush()) {
+    *err_msg=tr("Unable to write log lines");
+    ret=false;
   }
+  insert_msecs=elapsed.restart();
 
-  log->updateLinkQuantity(RDLog::SourceMusic);
-  log->setLinkState(RDLog::SourceMusic,false);
-  log->updateLinkQuantity(RDLog::SourceTraffic);
-  log->setLinkState(RDLog::SourceTraffic,false);
-  log->setNextId(count);
-  log->setAutoRefresh(autoRefresh());
+  if(ret) {
+    log->updateLinkQuantity(RDLog::SourceMusic);
+    log->setLinkState(RDLog::SourceMusic,false);
+    log->updateLinkQuantity(RDLog::SourceTraffic);
+    log->setLinkState(RDLog::SourceTraffic,false);
+    log->setNextId(buf->nextCount());
+    log->setAutoRefresh(autoRefresh());
+  }
+  delete buf;
   delete log;
   delete log_lock;
+  finish_msecs=elapsed.elapsed();
+
+  svc_generation_times=
+    QString().sprintf("setup %d mS, ",setup_msecs)+
+    QString().sprintf("templates %d mS (%u clocks, %u events), ",
+		      template_msecs,(unsigned)clocks.size(),
+		      (unsigned)events.size())+
+    QString().sprintf("events %d mS, ",event_msecs)+
+    QString().sprintf("insert %d mS (%u lines), ",insert_msecs,lines)+
+    QString().sprintf("finish %d mS, ",finish_msecs)+
+    QString().sprintf("total %d mS",total.elapsed());
 
-  return true;
+  return ret;
+}
+
+
+QString RDSvc::generationTimes() const
+{
+  return svc_generation_times;
 }
 
 
@@ -828,7 +969,11 @@ bool RDSvc::linkLog(RDSvc::ImportSource src,const QDate &date,
   QString sql;
   RDSqlQuery *q;
   QString autofill_errors;
+  std::map<QString,RDEventLine> events;
+  std::map<QString,RDEventLine>::iterator it;
+  QTime elapsed;
 
+  svc_link_times="";
   RDLogLock *log_lock=new RDLogLock(logname,user,svc_station,this);
   if(!TryLock(log_lock,err_msg)) {
     delete log_lock;
@@ -857,6 +1002,7 @@ bool RDSvc::linkLog(RDSvc::ImportSource src,const QDate &date,
     delete log_lock;
     return false;
   }
+  elapsed.start();
 
   //
   // Calculate Source
@@ -888,12 +1034,14 @@ bool RDSvc::linkLog(RDSvc::ImportSource src,const QDate &date,
   for(int i=0;i<src_event->size();i++) {
     logline=src_event->logLine(i);
     if(logline->type()==src_type) {
-      RDEventLine *e=new RDEventLine();
-      e->setName(logline->linkEventName());
-      e->load();
-      e->linkLog(dest_event,svc_name,logline,track_str,label_cart,track_cart,
-		 import_name,&autofill_errors);
-      delete e;
+      if((it=events.find(logline->linkEventName()))==events.end()) {
+	it=events.insert(std::pair<QString,RDEventLine>
+			 (logline->linkEventName(),RDEventLine())).first;
+	it->second.setName(logline->linkEventName());
+	it->second.load();
+      }
+      it->second.linkLog(dest_event,svc_name,logline,track_str,label_cart,
+			 track_cart,import_name,&autofill_errors);
       emit generationProgress(1+(24*current_link++)/total_links);
     }
     else {
@@ -975,11 +1123,19 @@ bool RDSvc::linkLog(RDSvc::ImportSource src,const QDate &date,
   //  printf("Import Table: %s\n",(const char *)import_name);
   rda->dropTable(import_name);
   delete log_lock;
+  svc_link_times=importTimes()+
+    QString().sprintf(", merge %d mS",elapsed.elapsed());
 
   return true;
 }
 
 
+QString RDSvc::linkTimes() const
+{
+  return svc_link_times;
+}
+
+
 bool RDSvc::clearLogLinks(RDSvc::ImportSource src,const QString &logname,
 			  RDUser *user,QString *err_msg)
 {
@@ -1379,13 +1535,6 @@ bool RDSvc::create(const QString &name,QString *err_msg,
     delete q;
   }
 
-  //
-  // Create Service Reconciliation Table
-  //
-  sql=RDCreateReconciliationTableSql(RDSvc::svcTableName(name),config);
-  q=new RDSqlQuery(sql);
-  delete q;
-
   return true;
 }
 
@@ -1394,6 +1543,7 @@ void RDSvc::remove(const QString &name)
 {
   QString sql;
   RDSqlQuery *q;
+  RDSqlQuery *q1;
   QString logname;
 
   sql=QString("delete from AUDIO_PERMS where ")+
@@ -1447,8 +1597,11 @@ void RDSvc::remove(const QString &name)
   q=new RDSqlQuery(sql);
   while(q->next()) {
     logname=q->value(0).toString();
+    sql=QString("delete from LOG_LINES where ")+
+      "LOG_NAME=\""+RDEscapeString(logname)+"\"";
+    q1=new RDSqlQuery(sql);
+    delete q1;
     logname.replace(" ","_");
-    rda->dropTable(RDLog::tableName(logname));
     rda->dropTable(logname+"_REC");
   }
   delete q;
@@ -1456,9 +1609,13 @@ void RDSvc::remove(const QString &name)
   QString tablename=name;
   tablename.replace(" ","_");
 
-  rda->dropTable(tablename+"_SRT");
   rda->dropTable(tablename+"_STACK");
 
+  sql=QString("delete from ELR_LINES where ")+
+    "SERVICE_NAME=\""+RDEscapeString(name)+"\"";
+  q=new RDSqlQuery(sql);
+  delete q;
+
   sql=QString("delete from LOGS where ")+
     "SERVICE=\""+RDEscapeString(name)+"\"";
   q=new RDSqlQuery(sql);
@@ -1466,15 +1623,6 @@ void RDSvc::remove(const QString &name)
 }
 
 
-QString RDSvc::svcTableName(const QString &svc_name)
-{
-  QString ret=svc_name;
-  ret.replace(" ","_");
-
-  return ret+"_SRT";
-}
-
-
 QString RDSvc::timeString(int hour,int secs)
 {
   return QString().sprintf("%02d:%02d:%02d",hour,secs/60,secs%60);
@@ -23,6 +23,7 @@
 
 #include <vector>
 
+#include <qdatetime.h>
 #include <qobject.h>
 #include <qsqldatabase.h>
 
@@ -31,6 +32,38 @@
 #include "rdstation.h"
 #include "rduser.h"
 
+//
+// Maximum number of rows sent in a single INSERT when loading an import
+// table
+//
+#define RDSVC_IMPORT_BATCH_SIZE 250
+
+//
+// One parsed line of a traffic or music schedule file
+//
+class __RDSvcImportLine
+{
+ public:
+  __RDSvcImportLine();
+  QString values(int id) const;
+  int start_hour;
+  int start_secs;
+  unsigned cart_number;
+  QString title;
+  int length;
+  bool insert_break;
+  bool insert_track;
+  int insert_first;
+  QString track_string;
+  QString ext_data;
+  QString ext_event_id;
+  QString ext_annc_type;
+  QString ext_cart_name;
+  QTime link_start_time;
+  int link_length;
+};
+
+
 class RDSvc : public QObject
 {
   Q_OBJECT
@@ -89,9 +122,12 @@ class RDSvc : public QObject
   bool import(ImportSource src,const QDate &date,const QString &break_str,
 	      const QString &track_str,const QString &dest_table) 
     const;
+  QString importTimes() const;
   bool generateLog(const QDate &date,const QString &logname,
 		   const QString &nextname,QString *report,RDUser *user,
 		   QString *err_msg);
+  QString generationTimes() const;
+  QString linkTimes() const;
   bool linkLog(RDSvc::ImportSource src,const QDate &date,
 	       const QString &logname,QString *report,RDUser *user,
 	       QString *err_msg);
@@ -105,7 +141,6 @@ class RDSvc : public QObject
   static void remove(const QString &name);
   static bool exists(const QString &name);
   static QString timeString(int hour,int secs);
-  static QString svcTableName(const QString &svc_name);
 
  signals:
   void generationProgress(int step);
@@ -121,6 +156,9 @@ class RDSvc : public QObject
 			QString *label_cart,QString *track_cart);
   bool CheckId(std::vector<int> *v,int value);
   QString svc_name;
+  QString svc_generation_times;
+  QString svc_link_times;
+  mutable QString svc_import_times;
   RDStation *svc_station;
   RDConfig *svc_config;
 };
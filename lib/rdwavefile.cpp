@@ -48,6 +48,7 @@
 #include <rdcart.h>
 #include <rdwavefile.h>
 #include <rdconf.h>
+#include <rdhash.h>
 #include <rdmp4.h>
 
 #ifdef HAVE_MP4_LIBS
@@ -162,6 +163,13 @@ RDWaveFile::RDWaveFile(QString file_name)
   for(int i=0;i<MEXT_CHUNK_SIZE;i++) {
     mext_chunk_data[i]=0;
   }
+  sha1_hashing=false;
+  sha1_valid=false;
+  sha1_expected_frames=0;
+  chase_mode=false;
+  chase_growing=false;
+  chase_wait=0;
+  chase_final_length=0;
   levl_chunk=false;
   levl_format=DEFAULT_LEVL_FORMAT; 
   levl_points=DEFAULT_LEVL_POINTS;
@@ -232,7 +240,26 @@ bool RDWaveFile::openWave(RDWaveData *data)
     }
     data_chunk=true;
     data_start=lseek(wave_file.handle(),0,SEEK_CUR);
-    if((!GetFact(wave_file.handle()))||(sample_length==0)) {
+    if(chase_mode&&format_chunk) {
+      unsigned char size_buf[4];
+      struct stat st;
+      chase_growing=(pread(wave_file.handle(),size_buf,4,4)==4)&&
+	(ReadDword(size_buf,0)==0);
+      chase_stall_time.start();
+      if((!chase_growing)&&(data_length>0)&&
+	 (fstat(wave_file.handle(),&st)==0)&&
+	 (st.st_size<(off_t)data_start+(off_t)data_length)) {
+	//
+	// A complete header but not yet all of the data (e.g. a file
+	// still being downloaded), so follow the file size instead
+	//
+	chase_growing=true;
+	chase_final_length=data_length;
+	data_length=0;
+	UpdateGrowingLength();
+      }
+    }
+    if((!GetFact(wave_file.handle()))||(sample_length==0)||chase_growing) {
       if((format_tag!=WAVE_FORMAT_PCM)&&
 	 (format_tag!=WAVE_FORMAT_IEEE_FLOAT)&&format_chunk) {
 #ifdef MPEG_FACT_FUDGE
@@ -571,6 +598,10 @@ bool RDWaveFile::createWave(RDWaveData *data,unsigned ptr_offset)
 	wave_type=RDWaveFile::Wave;
 	write(wave_file.handle(),"data\0\0\0\0",8);
 	data_start=lseek(wave_file.handle(),0,SEEK_CUR);
+	sha1_hash="";
+	if(sha1_hashing) {
+	  StartSha1Hash();
+	}
 	break;
 
       case WAVE_FORMAT_VORBIS:
@@ -648,6 +679,9 @@ void RDWaveFile::closeWave(int samples)
 	    levl_points=1;
 	    levl_block_size=1152;
 	    levl_channels=channels;
+	    if(format_tag==WAVE_FORMAT_PCM) {
+	      energy_data.resize(LevlEntries(data_length/block_align),0);
+	    }
 	    levl_frames=energy_data.size()/channels;
 	    levl_peak_offset=0xFFFFFFFF;
 	    levl_peak_value=0;
@@ -671,17 +705,6 @@ void RDWaveFile::closeWave(int samples)
 	    ftruncate(wave_file.handle(),lseek(wave_file.handle(),0,SEEK_CUR));
 	  }
 
-	  //
-	  // Update file size
-	  //
-	  cptr=lseek(wave_file.handle(),0,SEEK_END)-8;
-	  size_buf[0]=cptr&0xff;
-	  size_buf[1]=(cptr>>8)&0xff;
-	  size_buf[2]=(cptr>>16)&0xff;
-	  size_buf[3]=(cptr>>24)&0xff;
-	  lseek(wave_file.handle(),4,SEEK_SET);
-	  write(wave_file.handle(),size_buf,4);
-	  
 	  //
 	  // Update data chunk size
 	  //
@@ -693,6 +716,20 @@ void RDWaveFile::closeWave(int samples)
 		FindChunk(wave_file.handle(),"data",&csize)-4,SEEK_SET);
 	  write(wave_file.handle(),size_buf,4);
 	  
+	  //
+	  // Update file size
+	  //
+	  // (Done after the data chunk size, as a non-zero RIFF size tells
+	  // a chasing reader that the data chunk size is final.)
+	  //
+	  cptr=lseek(wave_file.handle(),0,SEEK_END)-8;
+	  size_buf[0]=cptr&0xff;
+	  size_buf[1]=(cptr>>8)&0xff;
+	  size_buf[2]=(cptr>>16)&0xff;
+	  size_buf[3]=(cptr>>24)&0xff;
+	  lseek(wave_file.handle(),4,SEEK_SET);
+	  write(wave_file.handle(),size_buf,4);
+	  
 	  //
 	  // Update fact chunk
 	  //
@@ -752,6 +789,13 @@ void RDWaveFile::closeWave(int samples)
 				  "data",&csize)+data_length);
 	    }
 	  }
+
+	  //
+	  // Finish SHA-1 Hash
+	  //
+	  if(sha1_hashing) {
+	    FinishSha1Hash();
+	  }
 	  break;
 
 	case RDWaveFile::Ogg:
@@ -777,6 +821,14 @@ void RDWaveFile::closeWave(int samples)
 #endif  // HAVE_VORBIS
   }
   wave_file.close();
+  if(recordable&&sha1_hashing&&sha1_hash.isEmpty()&&(!chase_mode)) {
+    sha1_hash=RDSha1Hash(wave_file.name());
+  }
+  sha1_hashing=false;
+  sha1_expected_frames=0;
+  chase_mode=false;
+  chase_growing=false;
+  chase_final_length=0;
   recordable=false;
   time_length=0;
   format_chunk=false;
@@ -985,7 +1037,17 @@ int RDWaveFile::readWave(void *buf,int count)
 	// but not sure if signed or not... 
 	// grauf@rfa.org Tue, 04 Apr 2006 21:02:51 -0400
 	//
-        if (((pos+count)>(data_start+data_length))&&(data_length>0)) {
+	if(chase_growing&&((pos+count)>(data_start+data_length))) {
+	  QTime wait_time;
+	  wait_time.start();
+	  while(UpdateGrowingLength()&&
+		((pos+count)>(data_start+data_length))&&
+		(wait_time.elapsed()<chase_wait)) {
+	    usleep(1000*RDWAVEFILE_CHASE_POLL_INTERVAL);
+	  }
+	}
+        if (((pos+count)>(data_start+data_length))&&
+	    ((data_length>0)||chase_growing)) {
           count=count - ( (pos+count) - (data_start+data_length) );
         }
 	c = read(wave_file.handle(),buf,count);
@@ -1076,7 +1138,7 @@ int RDWaveFile::writeWave(void *buf,int count)
 	  WriteSword((unsigned char *)buf,2*i,s);
 	}
       }
-      return write(wave_file.handle(),buf,count);
+      return WriteData(buf,count);
 
     case 24:
       if(levl_chunk) {
@@ -1140,7 +1202,7 @@ int RDWaveFile::writeWave(void *buf,int count)
       }
       lseek(wave_file.handle(),0,SEEK_END);
       data_length+=count;
-      return write(wave_file.handle(),buf,count);
+      return WriteData(buf,count);
     }
 
   case WAVE_FORMAT_MPEG:
@@ -1184,7 +1246,7 @@ int RDWaveFile::writeWave(void *buf,int count)
     }
     lseek(wave_file.handle(),0,SEEK_END);
     data_length+=count;
-    return write(wave_file.handle(),buf,count);
+    return WriteData(buf,count);
 
   case WAVE_FORMAT_VORBIS:
     WriteOggBuffer((char *)buf,count);
@@ -1354,6 +1416,9 @@ int RDWaveFile::seekWave(int offset,int whence)
               if(offset<0) {
                 offset=0;
               }
+              if(chase_growing&&((unsigned)offset>data_length)) {
+                UpdateGrowingLength();
+              }
               if((unsigned)offset>data_length) {
                 offset=data_length;
               }
@@ -4660,6 +4725,252 @@ void RDWaveFile::setNormalizeLevel(double level)
 }
 
 
+void RDWaveFile::setSha1Hashing(bool state)
+{
+  sha1_hashing=state;
+}
+
+
+void RDWaveFile::setExpectedFrames(unsigned frames)
+{
+  sha1_expected_frames=frames;
+
+  //
+  // Restart the hash with the new sizes if no audio has been written yet
+  //
+  if(recordable&&sha1_hashing&&(wave_type==RDWaveFile::Wave)&&
+     (data_length==0)) {
+    StartSha1Hash();
+  }
+}
+
+
+QString RDWaveFile::sha1Hash() const
+{
+  return sha1_hash;
+}
+
+
+void RDWaveFile::setChaseMode(bool state)
+{
+  chase_mode=state;
+}
+
+
+bool RDWaveFile::chaseMode() const
+{
+  return chase_mode;
+}
+
+
+bool RDWaveFile::isGrowing() const
+{
+  return chase_growing;
+}
+
+
+void RDWaveFile::setChaseWait(int msecs)
+{
+  chase_wait=msecs;
+}
+
+
+int RDWaveFile::WriteData(void *buf,int count)
+{
+  int n=write(wave_file.handle(),buf,count);
+
+  if(sha1_hashing&&sha1_valid) {
+    if(n>0) {
+      SHA1_Update(&sha1_ctx,buf,n);
+    }
+    sha1_valid=(n==count);
+  }
+  if(chase_mode&&(n==count)) {
+    CommitDataLength();
+  }
+  return n;
+}
+
+
+void RDWaveFile::StartSha1Hash()
+{
+  unsigned char size_buf[4];
+  unsigned len;
+  unsigned size;
+
+  //
+  // Bytes are hashed in file order, so the header must already hold
+  // its final contents when the first audio is written.  With a known
+  // frame count we can write the RIFF and data sizes now; closeWave()
+  // checks that the header is unchanged before trusting the digest.
+  // In chase mode the sizes on disk must keep marking the file as
+  // growing, so they go only into the copy that is hashed and are
+  // written by closeWave().
+  //
+  sha1_header.resize(data_start);
+  sha1_valid=pread(wave_file.handle(),sha1_header.data(),data_start,0)==
+    data_start;
+  if((sha1_expected_frames>0)&&(format_tag==WAVE_FORMAT_PCM)) {
+    len=sha1_expected_frames*block_align;
+    size=data_start+len;
+    if(levl_chunk) {
+      size+=LEVL_CHUNK_SIZE+2*LevlEntries(sha1_expected_frames);
+    }
+    if(sha1_valid) {
+      WriteDword((unsigned char *)sha1_header.data(),4,size-8);
+      WriteDword((unsigned char *)sha1_header.data(),data_start-4,len);
+    }
+    if(!chase_mode) {
+      WriteDword(size_buf,0,size-8);
+      pwrite(wave_file.handle(),size_buf,4,4);
+      WriteDword(size_buf,0,len);
+      pwrite(wave_file.handle(),size_buf,4,data_start-4);
+    }
+  }
+  SHA1_Init(&sha1_ctx);
+  SHA1_Update(&sha1_ctx,sha1_header.data(),data_start);
+}
+
+
+void RDWaveFile::FinishSha1Hash()
+{
+  unsigned char md[SHA_DIGEST_LENGTH];
+  char buf[4096];
+  QByteArray header(data_start);
+  off_t ptr=data_start+data_length;
+  off_t end=lseek(wave_file.handle(),0,SEEK_END);
+  ssize_t n;
+
+  if((!sha1_valid)||(end<ptr)||
+     (pread(wave_file.handle(),header.data(),data_start,0)!=data_start)||
+     (memcmp(header.data(),sha1_header.data(),data_start)!=0)) {
+    return;  // closeWave() will read the file back instead
+  }
+
+  //
+  // Trailing chunks (levl) were written by closeWave() and are small
+  //
+  while((ptr<end)&&
+	((n=pread(wave_file.handle(),buf,
+		  (end-ptr)<(off_t)sizeof(buf)?end-ptr:sizeof(buf),ptr))>0)) {
+    SHA1_Update(&sha1_ctx,buf,n);
+    ptr+=n;
+  }
+  if(ptr!=end) {
+    return;
+  }
+  SHA1_Final(md,&sha1_ctx);
+  for(int i=0;i<SHA_DIGEST_LENGTH;i++) {
+    sha1_hash+=QString().sprintf("%02x",0xff&md[i]);
+  }
+}
+
+
+unsigned RDWaveFile::LevlEntries(unsigned frames) const
+{
+  //
+  // The number of energy values closeWave() writes for 'frames' frames
+  // of PCM: one per channel for each block of 1152 frames, plus the
+  // block writeWave() opens after the last one, even if it is empty
+  //
+  return channels*(1+frames/1152);
+}
+
+
+void RDWaveFile::CommitDataLength()
+{
+  unsigned char size_buf[4];
+
+  //
+  // The RIFF size is left at zero until closeWave(), marking the file
+  // as still growing.
+  //
+  if(wave_type==RDWaveFile::Wave) {
+    WriteDword(size_buf,0,data_length);
+    pwrite(wave_file.handle(),size_buf,4,data_start-4);
+  }
+}
+
+
+bool RDWaveFile::UpdateGrowingLength()
+{
+  unsigned char size_buf[4];
+  unsigned riff_size;
+  unsigned len;
+
+  //
+  // Returns true if the file is still growing
+  //
+  if(!chase_growing) {
+    return false;
+  }
+  if(chase_final_length>0) {
+    //
+    // Following the file size, up to the length given in the header
+    //
+    struct stat st;
+    if(fstat(wave_file.handle(),&st)!=0) {
+      return true;
+    }
+    len=0;
+    if(st.st_size>(off_t)data_start) {
+      len=st.st_size-data_start;
+    }
+    if(len>=chase_final_length) {
+      len=chase_final_length;
+      chase_growing=false;
+    }
+    else {
+      if(block_align>0) {
+	len-=len%block_align;
+      }
+    }
+  }
+  else {
+    if(pread(wave_file.handle(),size_buf,4,4)!=4) {
+      return true;
+    }
+    riff_size=ReadDword(size_buf,0);
+    if(pread(wave_file.handle(),size_buf,4,data_start-4)!=4) {
+      return true;
+    }
+    len=ReadDword(size_buf,0);
+    if(riff_size!=0) {
+      chase_growing=false;
+    }
+    else {
+      if(len>data_length) {
+	chase_stall_time.restart();
+      }
+      else {
+	if(chase_stall_time.elapsed()>RDWAVEFILE_CHASE_STALL_TIMEOUT) {
+	  //
+	  // The writer has stopped without closing the file (e.g. it
+	  // crashed), so take what has been committed as final
+	  //
+	  chase_growing=false;
+	}
+      }
+    }
+  }
+  if((len>data_length)||((!chase_growing)&&(len>0))) {
+    data_length=len;
+    if((format_tag==WAVE_FORMAT_PCM)||(format_tag==WAVE_FORMAT_IEEE_FLOAT)) {
+      sample_length=data_length/block_align;
+    }
+    else {
+      sample_length=(unsigned)(1152.0*((double)data_length/
+				       (144.0*(double)head_bit_rate/
+					(double)samples_per_sec)));
+    }
+    ext_time_length=(unsigned)(1000.0*(double)sample_length/
+			       (double)samples_per_sec);
+    time_length=ext_time_length/1000;
+  }
+  return chase_growing;
+}
+
+
 void RDWaveFile::GrowAlloc(size_t size)
 {
   if(size>(size_t)cook_buffer_size) {
@@ -33,6 +33,8 @@
 #include <qdatetime.h>
 #include <qfile.h>
 
+#include <openssl/sha.h>
+
 #ifdef HAVE_VORBIS
 #include <vorbis/vorbisfile.h>
 #include <vorbis/vorbisenc.h>
@@ -95,6 +97,17 @@
 #define DEFAULT_LEVL_POINTS 1
 #define DEFAULT_LEVL_BLOCK_SIZE 1152
 
+//
+// Interval at which readWave() polls a growing file for more audio, in mS
+//
+#define RDWAVEFILE_CHASE_POLL_INTERVAL 10
+
+//
+// Time after which a growing file whose committed length has not changed
+// is taken to be finished, in mS
+//
+#define RDWAVEFILE_CHASE_STALL_TIMEOUT 10000
+
 
 /**
  * @short A class for handling Microsoft WAV files.
@@ -1016,6 +1029,70 @@ class RDWaveFile
    double getNormalizeLevel() const;
    void setNormalizeLevel(double level);
 
+  /**
+   * Generate a SHA-1 hash of the file as it is written by createWave(),
+   * writeWave() and closeWave().  Must be called before createWave().
+   * The hash is available from sha1Hash() after closeWave().
+   * @param state true = generate hash, false = do not generate hash
+   **/
+   void setSha1Hashing(bool state);
+
+  /**
+   * Set the number of frames that will be written to the file.  When
+   * set before the first call to writeWave(), the final chunk sizes are
+   * written up front so that the hash can be generated from the bytes as
+   * they are written.  Otherwise, or if a different amount of audio is
+   * written, the file is read back once in closeWave() to generate the
+   * hash.  In chase mode the file is never read back, and sha1Hash()
+   * returns an empty string instead.
+   * @param frames Number of frames
+   **/
+   void setExpectedFrames(unsigned frames);
+
+  /**
+   * Returns the SHA-1 hash of the last file written with hashing enabled,
+   * or an empty string if none is available.
+   **/
+   QString sha1Hash() const;
+
+  /**
+   * Enable chase mode.  Must be called before createWave() or openWave().
+   * When recording, the size of the DATA chunk is committed to the header
+   * after each block is written, so that the file can be played while it
+   * is still being captured.  When playing, a WAV file whose RIFF size is
+   * still zero (i.e. closeWave() has not yet been called by the writer) is
+   * opened as growing, and reads follow the writer's committed length
+   * rather than running on to the end of the file.  If the committed
+   * length then stops changing for RDWAVEFILE_CHASE_STALL_TIMEOUT mS, the
+   * writer is taken to have gone away and the file is treated as finished
+   * at that length.  A WAV file with a complete header that is shorter
+   * than its DATA chunk says (e.g. one still being downloaded) is also
+   * opened as growing, and reads follow the size of the file until all
+   * of the DATA chunk is present.
+   * @param state true = enable chase mode, false = disable chase mode
+   **/
+   void setChaseMode(bool state);
+
+  /**
+   * Returns true if chase mode is enabled.
+   **/
+   bool chaseMode() const;
+
+  /**
+   * Returns true if the file was opened in chase mode and the writer
+   * has not yet finished with it.  A short count from readWave() does not
+   * indicate end-of-file while this is true.
+   **/
+   bool isGrowing() const;
+
+  /**
+   * Set the maximum time that readWave() will wait for the writer to
+   * commit more audio to a growing file before returning a short count.
+   * The default is zero (do not wait).
+   * @param msecs Wait time, in milliseconds
+   **/
+   void setChaseWait(int msecs);
+
   private:
    RDWaveFile::Type GetType(int fd);
    bool IsWav(int fd);
@@ -1073,6 +1150,12 @@ class RDWaveFile
    int WriteOggPage(ogg_page *page);
 #endif  // HAVE_VORBIS
    int WriteOggBuffer(char *buf,int size);
+   int WriteData(void *buf,int count);
+   void StartSha1Hash();
+   void FinishSha1Hash();
+   unsigned LevlEntries(unsigned frames) const;
+   void CommitDataLength();
+   bool UpdateGrowingLength();
    unsigned FrameOffset(int msecs) const;
    QFile wave_file;
    RDWaveData *wave_data;
@@ -1213,6 +1296,19 @@ class RDWaveFile
    QString rdxl_contents;
 
    double normalize_level; 
+
+   bool sha1_hashing;
+   bool sha1_valid;
+   unsigned sha1_expected_frames;
+   SHA_CTX sha1_ctx;
+   QByteArray sha1_header;
+   QString sha1_hash;
+
+   bool chase_mode;
+   bool chase_growing;
+   int chase_wait;
+   unsigned chase_final_length;
+   QTime chase_stall_time;
    
    bool av10_chunk;
    unsigned char av10_chunk_data[AV10_CHUNK_SIZE];
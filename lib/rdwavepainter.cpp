@@ -26,6 +26,8 @@
 #include <qmessagebox.h>
 #include <qobject.h>
 
+#include <rd.h>
+#include <rdapplication.h>
 #include <rdwavepainter.h>
 
 
@@ -37,7 +39,9 @@ RDWavePainter::RDWavePainter(const QPaintDevice *pd,RDCut *cut,
   wave_station=station;
   wave_user=user;
   wave_config=config;
-  wave_peaks=NULL;
+  wave_sample_rate=RD_DEFAULT_SAMPLE_RATE;
+  wave_channels=RD_DEFAULT_CHANNELS;
+  wave_loaded=false;
   LoadWave();
 }
 
@@ -48,15 +52,14 @@ RDWavePainter::RDWavePainter(RDStation *station,RDUser *user,RDConfig *config)
   wave_station=station;
   wave_user=user;
   wave_config=config;
-  wave_peaks=NULL;
+  wave_sample_rate=RD_DEFAULT_SAMPLE_RATE;
+  wave_channels=RD_DEFAULT_CHANNELS;
+  wave_loaded=false;
 }
 
 
 RDWavePainter::~RDWavePainter()
 {
-  if(wave_peaks!=NULL) {
-    delete wave_peaks;
-  }
 }
 
 
@@ -91,8 +94,13 @@ void RDWavePainter::drawWaveBySamples(int x,int w,int startsamp,int endsamp,
   int startclipblock=-1;
   int endclipblock=-1;
 
-
-  if((startblock>(int)wave_peaks->energySize())||(wave_peaks->energySize()==0)) {
+  //
+  // Pick up peak data that has arrived since the cut was named
+  //
+  if((!wave_loaded)&&(!wave_cut_name.isEmpty())) {
+    wave_loaded=rda->peaksCache()->lookup(wave_cut_name,&wave_energy);
+  }
+  if((w<=0)||(startblock>(int)wave_energy.size())||(wave_energy.size()==0)) {
     return;
   }
   if(startclip>=0) {
@@ -102,23 +110,24 @@ void RDWavePainter::drawWaveBySamples(int x,int w,int startsamp,int endsamp,
     endclipblock=endclip/1152;
   }
 
-  double time_scale=1.0;
-  double gain_scale=1.0;
-  int dx=0;
+  double time_scale=(double)(endblock-startblock)/(double)w;
   QPixmap *pix=(QPixmap *)device();
   int center=pix->height()/2;
-  RDWavePainter::Channel effective_channel=channel;
+  double gain_scale=(double)(pix->height()/65536.0)*
+    pow(10.0,(double)gain/2000.0);
+  int chan=-1;
   switch(channel) {
-      case RDWavePainter::Left:
-      case RDWavePainter::Right:
-	if(wave_channels==1) {
-	  effective_channel=RDWavePainter::Mono;
-	}
-	break;
+  case RDWavePainter::Left:
+    chan=0;
+    break;
 
-      default:
-	effective_channel=channel;
-	break;
+  case RDWavePainter::Right:
+    chan=1;
+    break;
+
+  case RDWavePainter::Mono:
+    chan=-1;
+    break;
   }
   save();
   resetXForm();
@@ -127,84 +136,11 @@ void RDWavePainter::drawWaveBySamples(int x,int w,int startsamp,int endsamp,
   QPointArray array(w+2);
   array.setPoint(0,0,center);
   array.setPoint(w+1,w+1,center);
-  switch(effective_channel) {
-      case RDWavePainter::Left:
-	time_scale=(double)(endblock-startblock)/(double)w;
-	gain_scale=(double)(pix->height()/65536.0)*
-	  pow(10.0,(double)gain/2000.0);
-	for(int i=0;i<w;i++) {
-	  if(((dx=(2*((int)(time_scale*(double)i)+startblock)))<
-	     (int)wave_peaks->energySize())&&
-	     ((startclipblock<0)||(dx>(startclipblock*2)))&&
-	     ((endclipblock<0)||(dx<(endclipblock*2)))) {
-	    array.setPoint(i+1,i+1,
-			   center+(int)(gain_scale*(double)wave_peaks->energy(dx)));
-	  }
-	  else {
-	    array.setPoint(i+1,i+1,center);
-	  }
-	}
-	break;
-
-      case RDWavePainter::Right:
-	time_scale=(double)(endblock-startblock)/(double)w;
-	gain_scale=(double)(pix->height()/65536.0)*
-	  pow(10.0,(double)gain/2000.0);
-	for(int i=0;i<w;i++) {
-	  if(((dx=(1+2*((int)(time_scale*(double)i)+startblock)))<
-	     (int)wave_peaks->energySize())&&
-	     ((startclipblock<0)||(dx>(startclipblock*2)))&&
-	     ((endclipblock<0)||(dx<(endclipblock*2)))) {
-	    array.setPoint(i+1,i+1,
-			   center+(int)(gain_scale*(double)wave_peaks->energy(dx)));
-	  }
-	  else {
-	    array.setPoint(i+1,i+1,center);
-	  }
-	}
-	break;
-
-      case RDWavePainter::Mono:
-	switch(wave_channels) {
-	    case 1:
-	      time_scale=(double)(endblock-startblock)/(double)w;
-	      gain_scale=(double)(pix->height()/65536.0)*
-		pow(10.0,(double)gain/2000.0);
-	      for(int i=0;i<w;i++) {
-		if(((dx=((int)(time_scale*(double)i)+startblock))<
-		   (int)wave_peaks->energySize())&&
-		   ((startclipblock<0)||(dx>startclipblock))&&
-		   ((endclipblock<0)||(dx<endclipblock))) {
-		  array.setPoint(i+1,i+1,
-				 center+(int)(gain_scale*(double)wave_peaks->energy(dx)));
-		}
-		else {
-		  array.setPoint(i+1,i+1,center);
-		}
-	      }
-	      break;
-
-	    case 2:
-	      time_scale=(double)(endblock-startblock)/(double)w;
-	      gain_scale=(double)(pix->height()/65536.0)*
-		pow(10.0,(double)gain/2000.0);
-	      for(int i=0;i<w;i++) {
-		if(((dx=(2*((int)(time_scale*(double)i)+startblock)))<
-		   (int)wave_peaks->energySize())&&
-		   ((startclipblock<0)||(dx>(startclipblock*2)))&&
-		   ((endclipblock<0)||(dx<(endclipblock*2)))) {
-		  array.setPoint(i+1,i+1,
-				 center+(int)(gain_scale*
-					      ((double)wave_peaks->energy(dx)+
-					       (double)wave_peaks->energy(dx+1))/2.0));
-		}
-		else {
-		  array.setPoint(i+1,i+1,center);
-		}
-	      }
-	      break;
-	}
-	break;
+  for(int i=0;i<w;i++) {
+    array.setPoint(i+1,i+1,center+(int)(gain_scale*(double)
+		  Peak(startblock+(int)(time_scale*(double)i),
+		       startblock+(int)(time_scale*(double)(i+1)),
+		       chan,startclipblock,endclipblock)));
   }
   drawPolygon(array);
   for(int i=0;i<(w+2);i++) {
@@ -229,15 +165,74 @@ void RDWavePainter::drawWaveByMsecs(int x,int w,int startmsecs,int endmsecs,
 }
 
 
+bool RDWavePainter::isLoaded() const
+{
+  return wave_loaded;
+}
+
+
 void RDWavePainter::LoadWave()
 {
   wave_sample_rate=wave_cut->sampleRate();
   wave_channels=wave_cut->channels();
-  if(wave_peaks!=NULL) {
-    delete wave_peaks;
+  wave_cut_name=wave_cut->cutName();
+
+  //
+  // Does not block.  If the peak data is not yet cached locally, it is
+  // fetched in the background and picked up by the next draw after
+  // RDPeaksCache::peaksLoaded() has been emitted.
+  //
+  wave_loaded=rda->peaksCache()->peaks(wave_cut_name,&wave_energy);
+}
+
+
+int RDWavePainter::Peak(int block,int endblock,int chan,int startclipblock,
+			int endclipblock) const
+{
+  //
+  // Return the largest value in blocks [block,endblock), so that peaks
+  // are not lost when more than one block maps onto a single pixel.
+  //
+  int ret=0;
+  int val=0;
+  unsigned dx=0;
+
+  if(endblock<=block) {
+    endblock=block+1;
   }
-  wave_peaks=new RDPeaksExport();
-  wave_peaks->setCartNumber(wave_cut->cartNumber());
-  wave_peaks->setCutNumber(wave_cut->cutNumber());
-  wave_peaks->runExport(wave_user->name(),wave_user->password());
+  for(int i=block;i<endblock;i++) {
+    if((i<0)||((startclipblock>=0)&&(i<=startclipblock))||
+       ((endclipblock>=0)&&(i>=endclipblock))) {
+      continue;
+    }
+    if(wave_channels==1) {
+      if((dx=i)>=wave_energy.size()) {
+	break;
+      }
+      val=wave_energy[dx];
+    }
+    else {
+      if((dx=2*i+1)>=wave_energy.size()) {
+	break;
+      }
+      switch(chan) {
+      case 0:
+	val=wave_energy[dx-1];
+	break;
+
+      case 1:
+	val=wave_energy[dx];
+	break;
+
+      default:
+	val=((int)wave_energy[dx-1]+(int)wave_energy[dx])/2;
+	break;
+      }
+    }
+    if(val>ret) {
+      ret=val;
+    }
+  }
+
+  return ret;
 }
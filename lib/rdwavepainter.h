@@ -21,10 +21,11 @@
 #ifndef RDWAVEPAINTER_H
 #define RDWAVEPAINTER_H
 
+#include <vector>
+
 #include <qpainter.h>
 
 #include <rdconfig.h>
-#include <rdpeaksexport.h>
 #include <rdstation.h>
 #include <rduser.h>
 #include <rdcut.h>
@@ -46,14 +47,19 @@ class RDWavePainter : public QPainter
   void drawWaveByMsecs(int x,int w,int startmsecs,int endmsecs,int gain,
 		       Channel channel,const QColor &color,
 		       int startclip=-1,int endclip=-1);
+  bool isLoaded() const;
 
  private:
   void LoadWave();
+  int Peak(int block,int endblock,int chan,int startclipblock,
+	   int endclipblock) const;
   RDCut *wave_cut;
   RDStation *wave_station;
   RDUser *wave_user;
   RDConfig *wave_config;
-  RDPeaksExport *wave_peaks;
+  std::vector<unsigned short> wave_energy;
+  QString wave_cut_name;
+  bool wave_loaded;
   unsigned wave_sample_rate;
   unsigned wave_channels;
 };
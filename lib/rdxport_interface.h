@@ -55,6 +55,7 @@
 #define RDXPORT_COMMAND_REHASH 32
 #define RDXPORT_COMMAND_LISTSYSTEMSETTINGS 33
 #define RDXPORT_COMMAND_LOCKLOG 34
+#define RDXPORT_COMMAND_BATCH 35
 
 
 #endif  // RDXPORT_INTERFACE_H
@@ -33,6 +33,7 @@
 #include <qfiledialog.h>
 
 #include <rd.h>
+#include <rdapplication.h>
 #include <rddb.h>
 #include <rdtextvalidator.h>
 #include <rdlist_logs.h>
@@ -1270,6 +1271,11 @@ void EditRDAirPlay::okData()
     air_conf->setOpMode(i+RD_RDVAIRPLAY_LOG_BASE,air_virtual_opmodes[i]);
   }
   air_conf->setSkinPath(air_skin_edit->text());
+  RDNotification *notify=new RDNotification(RDNotification::StationType,
+					    RDNotification::ModifyAction,
+					    air_conf->station());
+  rda->ripc()->sendNotification(*notify);
+  delete notify;
   done(0);
 }
 
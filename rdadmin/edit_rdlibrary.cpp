@@ -34,6 +34,7 @@
 #include <qsqldatabase.h>
 
 #include <rd.h>
+#include <rdapplication.h>
 #include <edit_rdlibrary.h>
 #include <rdtextvalidator.h>
 
@@ -494,6 +495,11 @@ void EditRDLibrary::okData()
   lib_lib->setSrcConverter(lib_converter_box->currentItem());
   lib_lib->setLimitSearch((RDLibraryConf::SearchLimit)
 			  lib_limit_search_box->currentItem());
+  RDNotification *notify=new RDNotification(RDNotification::StationType,
+					    RDNotification::ModifyAction,
+					    lib_lib->station());
+  rda->ripc()->sendNotification(*notify);
+  delete notify;
   done(0);
 }
 
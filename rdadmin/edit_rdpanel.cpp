@@ -34,6 +34,7 @@
 
 #include <rddb.h>
 #include <rd.h>
+#include <rdapplication.h>
 #include <rdtextvalidator.h>
 #include <rdlist_logs.h>
 
@@ -494,6 +495,11 @@ void EditRDPanel::okData()
   air_conf->setFlashPanel(air_flash_box->isChecked());
   air_conf->setPanelPauseEnabled(air_panel_pause_box->isChecked());
   air_conf->setButtonLabelTemplate(air_label_template_edit->text());
+  RDNotification *notify=new RDNotification(RDNotification::StationType,
+					    RDNotification::ModifyAction,
+					    air_conf->station());
+  rda->ripc()->sendNotification(*notify);
+  delete notify;
 
   done(0);
 }
@@ -722,6 +722,11 @@ void EditStation::okData()
   station_station->setCaeStation(station_cae_station_box->currentText());
   station_catch_connect->reloadHeartbeat();
   station_catch_connect->reloadOffset();
+  RDNotification *notify=new RDNotification(RDNotification::StationType,
+					    RDNotification::ModifyAction,
+					    station_station->name());
+  rda->ripc()->sendNotification(*notify);
+  delete notify;
 
   //
   // Allow the event loop to run so the packets get delivered
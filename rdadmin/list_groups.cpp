@@ -175,6 +175,7 @@ void ListGroups::addData()
   }
   delete add_group;
   add_group=NULL;
+  SendNotification(RDNotification::AddAction,group);
   RDListViewItem *item=new RDListViewItem(list_groups_view);
   item->setText(0,group);
   RefreshItem(item);
@@ -191,7 +192,9 @@ void ListGroups::editData()
     return;
   }
   EditGroup *edit_group=new EditGroup(item->text(0),this);
-  edit_group->exec();
+  if(edit_group->exec()==0) {
+    SendNotification(RDNotification::ModifyAction,item->text(0));
+  }
   delete edit_group;
   edit_group=NULL;
   RefreshItem(item);
@@ -258,9 +261,17 @@ void ListGroups::deleteData()
   // Delete Member Carts
   //
   RDCart *cart;
+  RDNotification *notify=NULL;
+  rda->ripc()->beginNotificationBatch();
   while(q->next()) {
     cart=new RDCart(q->value(0).toUInt());
-    cart->remove(rda->station(),rda->user(),rda->config());
+    if(cart->remove(rda->station(),rda->user(),rda->config())) {
+      notify=new RDNotification(RDNotification::CartType,
+				RDNotification::DeleteAction,
+				QVariant(cart->number()));
+      rda->ripc()->sendNotification(*notify);
+      delete notify;
+    }
     delete cart;
   }
   delete q;
@@ -296,6 +307,8 @@ void ListGroups::deleteData()
 			(const char *)RDEscapeString(groupname));
   q=new RDSqlQuery(sql);
   delete q;
+  SendNotification(RDNotification::DeleteAction,groupname);
+  rda->ripc()->endNotificationBatch();
   item->setSelected(false);
   delete item;
 }
@@ -491,3 +504,13 @@ void ListGroups::WriteItem(RDListViewItem *item,RDSqlQuery *q)
   item->setText(7,q->value(7).toString());
   item->setText(8,q->value(8).toString());
 }
+
+
+void ListGroups::SendNotification(RDNotification::Action action,
+				  const QString &groupname)
+{
+  RDNotification *notify=new RDNotification(RDNotification::GroupType,
+					    action,QVariant(groupname));
+  rda->ripc()->sendNotification(*notify);
+  delete notify;
+}
@@ -29,6 +29,7 @@
 
 #include <rdlistviewitem.h>
 #include <rddb.h>
+#include <rdnotification.h>
 
 class ListGroups : public QDialog
 {
@@ -55,6 +56,8 @@ class ListGroups : public QDialog
   void RefreshList();
   void RefreshItem(RDListViewItem *item);
   void WriteItem(RDListViewItem *item,RDSqlQuery *q);
+  void SendNotification(RDNotification::Action action,
+			const QString &groupname);
   RDListView *list_groups_view;
   QPushButton *list_add_button;
   QPushButton *list_edit_button;
@@ -138,6 +138,7 @@ void ListSvcs::addData()
     return;
   }
   delete add_svc;
+  SendNotification(RDNotification::AddAction,svcname);
   RefreshList(svcname);
 }
 
@@ -148,7 +149,9 @@ void ListSvcs::editData()
     return;
   }
   EditSvc *edit_svc=new EditSvc(list_box->currentText(),this);
-  edit_svc->exec();
+  if(edit_svc->exec()==0) {
+    SendNotification(RDNotification::ModifyAction,list_box->currentText());
+  }
   delete edit_svc;
 }
 
@@ -190,6 +193,7 @@ void ListSvcs::deleteData()
   RDSvc *svc=new RDSvc(list_box->currentText(),rda->station(),rda->config());
   svc->remove();
   delete svc;
+  SendNotification(RDNotification::DeleteAction,list_box->currentText());
   list_box->removeItem(list_box->currentItem());
   if(list_box->currentItem()>=0) {
     list_box->setSelected(list_box->currentItem(),true);
@@ -224,3 +228,13 @@ void ListSvcs::RefreshList(QString svcname)
   }
   delete q;
 }
+
+
+void ListSvcs::SendNotification(RDNotification::Action action,
+				const QString &svcname)
+{
+  RDNotification *notify=new RDNotification(RDNotification::ServiceType,
+					    action,QVariant(svcname));
+  rda->ripc()->sendNotification(*notify);
+  delete notify;
+}
@@ -28,6 +28,8 @@
 #include <qradiobutton.h>
 #include <qsqldatabase.h>
 
+#include <rdnotification.h>
+
 class ListSvcs : public QDialog
 {
   Q_OBJECT
@@ -46,6 +48,7 @@ class ListSvcs : public QDialog
   
  private:
   void RefreshList(QString svcname="");
+  void SendNotification(RDNotification::Action action,const QString &svcname);
   QListBox *list_box;
 };
 
@@ -20,6 +20,8 @@
 
 #include <math.h>
 
+#include <vector>
+
 #include <qdialog.h>
 #include <qstring.h>
 #include <qpushbutton.h>
@@ -31,6 +33,7 @@
 #include <qmessagebox.h>
 #include <qcheckbox.h>
 #include <qbuttongroup.h>
+#include <rdapplication.h>
 #include <rddb.h>
 
 #include <rename_group.h>
@@ -172,6 +175,14 @@ void RenameGroup::okData()
   //
   // Update Cart List
   //
+  std::vector<unsigned> cartnums;
+  sql=QString("select NUMBER from CART where ")+
+    "GROUP_NAME=\""+RDEscapeString(group_name_edit->text())+"\"";
+  q=new RDSqlQuery(sql);
+  while(q->next()) {
+    cartnums.push_back(q->value(0).toUInt());
+  }
+  delete q;
   sql=QString().
     sprintf("update CART set GROUP_NAME=\"%s\" where GROUP_NAME=\"%s\"",
 	    (const char *)RDEscapeString(group_newname_edit->text()),
@@ -269,6 +280,37 @@ void RenameGroup::okData()
     delete q;
   }
 
+  //
+  // Send Notifications
+  //
+  RDNotification *notify=NULL;
+  rda->ripc()->beginNotificationBatch();
+  for(unsigned i=0;i<cartnums.size();i++) {
+    notify=new RDNotification(RDNotification::CartType,
+			      RDNotification::ModifyAction,
+			      QVariant(cartnums[i]));
+    rda->ripc()->sendNotification(*notify);
+    delete notify;
+  }
+  notify=new RDNotification(RDNotification::GroupType,
+			    RDNotification::DeleteAction,
+			    QVariant(group_name_edit->text()));
+  rda->ripc()->sendNotification(*notify);
+  delete notify;
+  if(merging) {
+    notify=new RDNotification(RDNotification::GroupType,
+			      RDNotification::ModifyAction,
+			      QVariant(group_newname_edit->text()));
+  }
+  else {
+    notify=new RDNotification(RDNotification::GroupType,
+			      RDNotification::AddAction,
+			      QVariant(group_newname_edit->text()));
+  }
+  rda->ripc()->sendNotification(*notify);
+  delete notify;
+  rda->ripc()->endNotificationBatch();
+
   done(0);
 }
 
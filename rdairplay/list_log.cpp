@@ -35,6 +35,7 @@
 #include "colors.h"
 #include "globals.h"
 #include "list_log.h"
+#include "log_listviewitem.h"
 
 #include "../icons/play.xpm"
 #include "../icons/rml5.xpm"
@@ -409,6 +410,13 @@ ListLog::ListLog(RDLogPlay *log,RDCae *cae,int id,bool allow_pause,
   connect(list_log,SIGNAL(auditionStopped(int)),
 	  this,SLOT(auditionStoppedData(int)));
 
+  //
+  // Transition Frame Timer
+  //
+  list_frame_pending=false;
+  list_frame_timer=new QTimer(this);
+  connect(list_frame_timer,SIGNAL(timeout()),this,SLOT(frameTimerData()));
+
   setBackgroundColor(QColor(system_mid_color));
 
   RefreshList();
@@ -595,8 +603,8 @@ void ListLog::setTimeMode(RDAirPlayConf::TimeMode mode)
   }
   list_hour_selector->setTimeMode(mode);
   list_time_mode=mode;
-  UpdateTimes();
   RefreshList();
+  UpdateTimes();
 }
 
 
@@ -907,6 +915,7 @@ void ListLog::logReloadedData()
 
 void ListLog::logPlayedData(int line)
 {
+  StartFrame();
   setStatus(line,RDLogLine::Playing);
   UpdateTimes();
 }
@@ -914,6 +923,7 @@ void ListLog::logPlayedData(int line)
 
 void ListLog::logPausedData(int line)
 {
+  StartFrame();
   setStatus(line,RDLogLine::Paused);
   UpdateTimes();
 }
@@ -921,6 +931,7 @@ void ListLog::logPausedData(int line)
 
 void ListLog::logStoppedData(int line)
 {
+  StartFrame();
   setStatus(line,RDLogLine::Finished);
   UpdateTimes();
 }
@@ -944,7 +955,7 @@ void ListLog::logInsertedData(int line)
     }
     item=(RDListViewItem *)item->nextSibling();
   }
-  item=new RDListViewItem(list_log_list);
+  item=new LogListViewItem(this,list_log_list);
   list_log->logLine(line)->setListViewItem(item);
   RefreshItem(item,line);
   if(appended) {
@@ -1053,6 +1064,7 @@ void ListLog::transportChangedData()
 {
   int transport_line[TRANSPORT_QUANTITY];
 
+  StartFrame();
   SetColor();
 
   list_log->transportEvents(transport_line);
@@ -1086,6 +1098,20 @@ void ListLog::cartDroppedData(int line,RDLogLine *ll)
 }
 
 
+void ListLog::frameTimerData()
+{
+  //
+  // Fires once the event loop has drained the repaints queued by the
+  // transition, so this approximates the full frame time
+  //
+  list_frame_pending=false;
+  rda->log(RDConfig::LogDebug,
+	   QString().sprintf("log %d: transition on %d line log took %d mS",
+			     list_id,list_log->size(),
+			     list_frame_clock.elapsed()));
+}
+
+
 void ListLog::paintEvent(QPaintEvent *e)
 {
   if(!rda->airplayConf()->showCounters()) {
@@ -1121,7 +1147,7 @@ void ListLog::RefreshList()
   l->setText(14,QString().sprintf("%d",list_log->size()));
   for(int i=list_log->size()-1;i>=0;i--) {
     if((logline=list_log->logLine(i))!=NULL) {
-      l=new RDListViewItem(list_log_list);
+      l=new LogListViewItem(this,list_log_list);
       logline->setListViewItem(l);
     }
     RefreshItem(l,i);
@@ -1142,6 +1168,27 @@ void ListLog::RefreshList(int line)
 
 
 void ListLog::RefreshItem(RDListViewItem *l,int line)
+{
+  RDLogLine *log_line=list_log->logLine(line);
+  if(log_line==NULL) {
+    return;
+  }
+  if(log_line->timeType()==RDLogLine::Hard) {
+    l->setText(1,QString("T")+
+	       TimeString(log_line->startTime(RDLogLine::Logged)));
+  }
+  l->setText(14,QString().sprintf("%d",log_line->id()));
+  l->setText(15,QString().sprintf("%d",line));
+  l->setText(16,QString().sprintf("%d",log_line->status()));
+  SetPlaybuttonMode(ListLog::ButtonDisabled);
+  list_modify_button->setDisabled(true);
+  ((LogListViewItem *)l)->clearStartTime();
+  ((LogListViewItem *)l)->setStale(true);
+  list_log_list->repaintItem(l);
+}
+
+
+void ListLog::RenderItem(RDListViewItem *l,int line)
 {
   int lines[TRANSPORT_QUANTITY];
   bool is_next=false;
@@ -1152,14 +1199,11 @@ void ListLog::RefreshItem(RDListViewItem *l,int line)
   }
   switch(log_line->timeType()) {
       case RDLogLine::Hard:
-	l->setText(1,QString("T")+
-		   TimeString(log_line->startTime(RDLogLine::Logged)));
 	l->setText(8,QString("T")+
 		   TimeString(log_line->startTime(RDLogLine::Logged)));
 	for(int i=0;i<list_log_list->columns();i++) {
 	  l->setTextColor(i,LOG_HARDTIME_TEXT_COLOR,QFont::Bold);
 	}
-	l->setText(14,"N");
 	break;
       default:
 	if(!log_line->startTime(RDLogLine::Logged).isNull()) {
@@ -1171,7 +1215,6 @@ void ListLog::RefreshItem(RDListViewItem *l,int line)
 	for(int i=0;i<list_log_list->columns();i++) {
 	  l->setTextColor(i,LOG_RELATIVE_TEXT_COLOR,QFont::Normal);
 	}
-	l->setText(14,"");
 	break;
   }
   switch(log_line->transType()) {
@@ -1292,11 +1335,6 @@ void ListLog::RefreshItem(RDListViewItem *l,int line)
       default:
 	break;
   }
-  l->setText(14,QString().sprintf("%d",log_line->id()));
-  l->setText(15,QString().sprintf("%d",line));
-  l->setText(16,QString().sprintf("%d",log_line->status()));
-  SetPlaybuttonMode(ListLog::ButtonDisabled);
-  list_modify_button->setDisabled(true);
   switch(log_line->state()) {
       case RDLogLine::NoCart:
 	if(log_line->type()==RDLogLine::Cart) {
@@ -1392,29 +1430,40 @@ void ListLog::UpdateTimes(int removed_line,int num_lines)
       line+=num_lines;
     }
     if((logline=list_log->logLine(line))!=NULL) {
+      //
+      // Only reformat rows whose displayed time has actually moved
+      //
+      LogListViewItem *item=(LogListViewItem *)next;
       switch((RDLogLine::Status)next->text(16).toInt()) {
 	  case RDLogLine::Scheduled:
 	  case RDLogLine::Paused:
 	    switch(logline->timeType()) {
 		case RDLogLine::Hard:
-		  next->setText(1,QString(tr("T"))+
-			  TimeString(logline->startTime(RDLogLine::Logged)));
+		  time=logline->startTime(RDLogLine::Logged);
+		  if(item->startTimeChanged(time,RDLogLine::Logged)) {
+		    next->setText(1,QString(tr("T"))+TimeString(time));
+		  }
 		  break;
 		  
 		default:
-		  if(!logline->startTime(RDLogLine::Predicted).isNull()) {
-		    next->setText(1,
-		        TimeString(logline->startTime(RDLogLine::Predicted)));
-		  }
-		  else {
-		    next->setText(1,"");
+		  time=logline->startTime(RDLogLine::Predicted);
+		  if(item->startTimeChanged(time,RDLogLine::Predicted)) {
+		    if(!time.isNull()) {
+		      next->setText(1,TimeString(time));
+		    }
+		    else {
+		      next->setText(1,"");
+		    }
 		  }
 		  break;
 	    }
 	    break;
 
 	  default:
-	    next->setText(1,TimeString(logline->startTime(RDLogLine::Actual)));
+	    time=logline->startTime(RDLogLine::Actual);
+	    if(item->startTimeChanged(time,RDLogLine::Actual)) {
+	      next->setText(1,TimeString(time));
+	    }
 	    break;
       }
       next=(RDListViewItem *)next->nextSibling();
@@ -1442,7 +1491,7 @@ void ListLog::UpdateColor(int line,bool next)
     return;
   }
   RDListViewItem *item=GetItem(line);
-  if(item==NULL) {
+  if((item==NULL)||((LogListViewItem *)item)->isStale()) {
     return;
   }
   switch(logline->status()) {
@@ -1500,6 +1549,16 @@ void ListLog::UpdateColor(int line,bool next)
 }
 
 
+void ListLog::StartFrame()
+{
+  if(!list_frame_pending) {
+    list_frame_pending=true;
+    list_frame_clock.start();
+    list_frame_timer->start(0,true);
+  }
+}
+
+
 void ListLog::SetColor()
 {
   for(int i=0;i<list_log->size();i++) {
@@ -26,6 +26,7 @@
 #include <qlabel.h>
 #include <qpixmap.h>
 #include <qpushbutton.h>
+#include <qtimer.h>
 
 #include <rdairplay_conf.h>
 #include <rdlistview.h>
@@ -87,6 +88,7 @@ class ListLog : public QWidget
   void modifiedData(int line);
   void refreshabilityChangedData(bool state);
   void cartDroppedData(int line,RDLogLine *ll);
+  void frameTimerData();
 
  protected:
   void paintEvent(QPaintEvent *e);
@@ -96,6 +98,7 @@ class ListLog : public QWidget
   void RefreshList();
   void RefreshList(int line);
   void RefreshItem(RDListViewItem *l,int line);
+  void RenderItem(RDListViewItem *l,int line);
   int CurrentLine();
   RDLogLine::Status CurrentStatus();
   RDLogLine::State CurrentState();
@@ -104,6 +107,7 @@ class ListLog : public QWidget
   void UpdateTimes(int removed_line=-1,int num_lines=0);
   void ScrollTo(int line);
   void UpdateColor(int line,bool next=false);
+  void StartFrame();
   void SetColor();
   void SetPlaybuttonMode(ListLog::PlayButtonMode mode);
   QString TimeString(const QTime &time) const;
@@ -152,6 +156,10 @@ class ListLog : public QWidget
   bool list_audition_head_playing;
   bool list_audition_tail_playing;
   RDCae *list_cae;
+  QTimer *list_frame_timer;
+  QTime list_frame_clock;
+  bool list_frame_pending;
+  friend class LogListViewItem;
 };
 
 
@@ -0,0 +1,73 @@
+//   log_listviewitem.cpp
+//
+//   Deferred-render list item for RDAirPlay's Full Log widget.
+//
+//   (C) Copyright 2018 Fred Gleason <fredg@paravelsystems.com>
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License version 2 as
+//   published by the Free Software Foundation.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public
+//   License along with this program; if not, write to the Free Software
+//   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+//
+
+#include <list_log.h>
+#include <log_listviewitem.h>
+
+LogListViewItem::LogListViewItem(ListLog *log,QListView *parent)
+  : RDListViewItem(parent)
+{
+  item_list_log=log;
+  item_stale=false;
+  item_time_valid=false;
+  item_time_type=RDLogLine::Predicted;
+}
+
+
+bool LogListViewItem::isStale() const
+{
+  return item_stale;
+}
+
+
+void LogListViewItem::setStale(bool state)
+{
+  item_stale=state;
+}
+
+
+bool LogListViewItem::startTimeChanged(const QTime &time,
+				       RDLogLine::StartTimeType type)
+{
+  if(item_time_valid&&(time==item_time)&&(type==item_time_type)) {
+    return false;
+  }
+  item_time=time;
+  item_time_type=type;
+  item_time_valid=true;
+  return true;
+}
+
+
+void LogListViewItem::clearStartTime()
+{
+  item_time_valid=false;
+}
+
+
+void LogListViewItem::paintCell(QPainter *p,const QColorGroup &cg,int column,
+				int width,int align)
+{
+  if(item_stale) {
+    item_stale=false;
+    item_list_log->RenderItem(this,text(15).toInt());
+  }
+  RDListViewItem::paintCell(p,cg,column,width,align);
+}
@@ -0,0 +1,57 @@
+//   log_listviewitem.h
+//
+//   Deferred-render list item for RDAirPlay's Full Log widget.
+//
+//   (C) Copyright 2018 Fred Gleason <fredg@paravelsystems.com>
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License version 2 as
+//   published by the Free Software Foundation.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public
+//   License along with this program; if not, write to the Free Software
+//   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+//
+
+#ifndef LOG_LISTVIEWITEM_H
+#define LOG_LISTVIEWITEM_H
+
+#include <qdatetime.h>
+
+#include <rdlistviewitem.h>
+#include <rdlog_line.h>
+
+class ListLog;
+
+//
+// Only the key columns (times, id, line and status) are kept current for
+// every row.  The remaining columns are rendered from the log line the
+// first time the row is actually painted after being marked stale, so
+// rows that are never scrolled into view cost next to nothing.
+//
+class LogListViewItem : public RDListViewItem
+{
+ public:
+  LogListViewItem(ListLog *log,QListView *parent);
+  bool isStale() const;
+  void setStale(bool state);
+  bool startTimeChanged(const QTime &time,RDLogLine::StartTimeType type);
+  void clearStartTime();
+  void paintCell(QPainter *p,const QColorGroup &cg,int column,
+		 int width,int align);
+
+ private:
+  ListLog *item_list_log;
+  bool item_stale;
+  bool item_time_valid;
+  QTime item_time;
+  RDLogLine::StartTimeType item_time_type;
+};
+
+
+#endif  // LOG_LISTVIEWITEM_H
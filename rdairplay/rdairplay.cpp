@@ -145,8 +145,10 @@ MainWidget::MainWidget(QWidget *parent)
     QMessageBox::critical(this,"RDAirPlay - "+tr("Error"),err_msg);
     exit(1);
   }
+  rda->cutRotation()->setEnabled(true);
   connect(RDDbStatus(),SIGNAL(logText(RDConfig::LogPriority,const QString &)),
 	  this,SLOT(logLine(RDConfig::LogPriority,const QString &))); 
+  air_startup_trace.mark("database");
 
 
   //
@@ -366,6 +368,7 @@ MainWidget::MainWidget(QWidget *parent)
   }
   connect(air_log[0],SIGNAL(transportChanged()),
 	  this,SLOT(transportChangedData()));
+  air_startup_trace.mark("log machines");
 
   //
   // Audio Channel Assignments
@@ -725,6 +728,8 @@ MainWidget::MainWidget(QWidget *parent)
 	    this,SLOT(panelChannelStoppedData(int,int,int)));
   }
 
+  air_startup_trace.mark("sound panels");
+
   //
   // Full Log List
   //
@@ -1025,6 +1030,8 @@ void MainWidget::ripcConnectedData(bool state)
       delete q;
     }
   }
+  air_startup_trace.mark("initial logs");
+  rda->log(RDConfig::LogInfo,air_startup_trace.report());
 }
 
 
@@ -2169,6 +2176,10 @@ void MainWidget::closeEvent(QCloseEvent *e)
     if(!rda->airplayConf()->exitPasswordValid(passwd)) {
       return;
     }
+    for(int i=0;i<RDAIRPLAY_LOG_QUANTITY;i++) {
+      delete air_log[i];
+    }
+    rda->cutRotation()->flush();
     rda->airplayConf()->setExitCode(RDAirPlayConf::ExitClean);
     LogLine(RDConfig::LogInfo,"RDAirPlay exiting");
     air_lock->unlock();
@@ -2185,6 +2196,7 @@ void MainWidget::closeEvent(QCloseEvent *e)
   for(int i=0;i<RDAIRPLAY_LOG_QUANTITY;i++) {
     delete air_log[i];
   }
+  rda->cutRotation()->flush();
   rda->airplayConf()->setExitCode(RDAirPlayConf::ExitClean);
   LogLine(RDConfig::LogInfo,"RDAirPlay exiting");
   air_lock->unlock();
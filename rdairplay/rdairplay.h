@@ -50,6 +50,7 @@
 #include <rdripc.h>
 #include <rdrlmhost.h>
 #include <rdsound_panel.h>
+#include <rdstartuptrace.h>
 #include <rdstereometer.h>
 #include <rdttydevice.h>
 #include <rduser.h>
@@ -220,6 +221,7 @@ class MainWidget : public QWidget
   std::map<unsigned,QTimer *> air_channel_timers[2];
   RDEmptyCart *air_empty_cart;
   RDCae *air_cae;
+  RDStartupTrace air_startup_trace;
 };
 
 
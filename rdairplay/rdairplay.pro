@@ -27,6 +27,7 @@ x11 {
   SOURCES += list_log.cpp
   SOURCES += list_logs.cpp
   SOURCES += local_macros.cpp
+  SOURCES += log_listviewitem.cpp
   SOURCES += loglinebox.cpp
   SOURCES += mode_display.cpp
   SOURCES += pie_counter.cpp
@@ -45,6 +46,7 @@ x11 {
   HEADERS += lib_listview.h
   HEADERS += list_log.h
   HEADERS += list_logs.h
+  HEADERS += log_listviewitem.h
   HEADERS += loglinebox.h
   HEADERS += mode_display.h
   HEADERS += pie_counter.h
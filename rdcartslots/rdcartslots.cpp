@@ -66,6 +66,7 @@ MainWidget::MainWidget(QWidget *parent)
     QMessageBox::critical(this,"RDCartSlots - "+tr("Error"),err_msg);
     exit(1);
   }
+  rda->cutRotation()->setEnabled(true);
 
   //
   // Read Command Options
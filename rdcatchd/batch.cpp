@@ -28,6 +28,7 @@
 #include <pwd.h>
 #include <grp.h>
 #include <sys/types.h>
+#include <sys/stat.h>
 #include <sys/wait.h>
 #include <sched.h>
 #include <errno.h>
@@ -35,6 +36,7 @@
 #include <vector>
 
 #include <qapplication.h>
+#include <qdatetime.h>
 #include <qtimer.h>
 #include <qsignalmapper.h>
 #include <qsessionmanager.h>
@@ -171,6 +173,9 @@ void MainObject::RunImport(CatchEvent *evt)
 void MainObject::RunDownload(CatchEvent *evt)
 {
   RDDownload::ErrorCode conv_err;
+  QTime elapsed;
+  int download_msecs=0;
+  int import_msecs=0;
 
   //
   // Resolve Wildcards
@@ -180,9 +185,20 @@ void MainObject::RunDownload(CatchEvent *evt)
   delete station;
 
   //
-  // Execute Download
+  // Start the import alongside the download, converting the audio as it
+  // arrives
   //
   evt->setTempName(BuildTempName(evt,"download"));
+  unlink(evt->tempName());
+  QString partname=RDConfiguration()->audioRoot()+
+    QString().sprintf("/rdcatchd-download-%d.",evt->id())+
+    RDConfiguration()->audioExtension();
+  pid_t import_pid=StartPipelinedImport(evt,partname);
+  bool pipelined=false;
+
+  //
+  // Execute Download
+  //
   LogLine(RDConfig::LogInfo,QString().
 	  sprintf("starting download of %s to %s, id=%d",
 		  (const char *)evt->resolvedUrl(),
@@ -199,14 +215,19 @@ void MainObject::RunDownload(CatchEvent *evt)
     url_username=RD_ANON_FTP_USERNAME;
     url_password=QString(RD_ANON_FTP_PASSWORD)+"-"+VERSION;
   }
+  elapsed.start();
   switch((conv_err=conv->runDownload(url_username,url_password,
 				     rda->config()->logXloadDebugData()))) {
   case RDDownload::ErrorOk:
+    download_msecs=elapsed.restart();
     LogLine(RDConfig::LogInfo,QString().
 	    sprintf("finished download of %s to %s, id=%d",
 		    (const char *)evt->tempName(),
 		    (const char *)evt->resolvedUrl(),
-		    evt->id()));
+		    evt->id())+
+	    QString().sprintf(", %.0lf bytes in %d ms, %d resumes",
+			      conv->bytesDownloaded(),download_msecs,
+			      conv->resumeCount()));
     break;
 
   case RDDownload::ErrorInternal:
@@ -219,6 +240,7 @@ void MainObject::RunDownload(CatchEvent *evt)
 		    (const char *)RDDownload::errorText(conv_err),
 		    evt->id()));
     delete conv;
+    StopPipelinedImport(import_pid,partname);
     unlink(evt->tempName());
     exit(0);
 
@@ -232,16 +254,49 @@ void MainObject::RunDownload(CatchEvent *evt)
 		    (const char *)RDDownload::errorText(conv_err),
 		    evt->id()));
     delete conv;
+    StopPipelinedImport(import_pid,partname);
     unlink(evt->tempName());
     exit(0);
   }
+  int resumes=conv->resumeCount();
+  if(conv->restarted()) {
+    //
+    // The pipelined import was following the original temp file, which
+    // was replaced when the download started over
+    //
+    StopPipelinedImport(import_pid,partname);
+    import_pid=-1;
+  }
   delete conv;
   
   //
   // Execute Import
   //
-  if(Import(evt)) {
-    catch_connect->setExitCode(evt->id(),RDRecording::Ok,tr("OK"));
+  if(import_pid>0) {
+    if(!(pipelined=FinishPipelinedImport(evt,import_pid,partname))) {
+      LogLine(RDConfig::LogInfo,QString().
+	      sprintf("pipelined import of %s not completed, id=%d",
+		      (const char *)evt->tempName(),evt->id()));
+    }
+  }
+  if(pipelined||Import(evt)) {
+    import_msecs=elapsed.elapsed();
+    LogLine(RDConfig::LogInfo,QString().
+	    sprintf("download timings: download: %d ms, import: %d ms%s, id=%d",
+		    download_msecs,import_msecs,
+		    pipelined ? " (pipelined)" : "",evt->id()));
+    QString msg=tr("OK")+" ["+tr("download")+
+      QString().sprintf(" %.1lfs",(double)download_msecs/1000.0);
+    if(resumes>0) {
+      msg+=QString().sprintf(" (%d ",resumes)+tr("resumes")+")";
+    }
+    msg+=", "+tr("import")+
+      QString().sprintf(" %.1lfs",(double)import_msecs/1000.0);
+    if(pipelined) {
+      msg+=", "+tr("pipelined");
+    }
+    msg+="]";
+    catch_connect->setExitCode(evt->id(),RDRecording::Ok,msg);
     qApp->processEvents();
   }
   LogLine(RDConfig::LogInfo,QString().sprintf("deleting file %s, id=%d",
@@ -464,25 +519,7 @@ bool MainObject::Import(CatchEvent *evt)
   conv->setSourceFile(RDEscapeString(evt->tempName()));
   conv->setDestinationFile(RDCut::pathName(evt->cutName()));
   RDSettings *settings=new RDSettings();
-  switch(evt->format()) {
-  case RDCae::Pcm16:
-    settings->setFormat(RDSettings::Pcm16);
-    break;
-
-  case RDCae::Pcm24:
-    settings->setFormat(RDSettings::Pcm24);
-    break;
-
-  case RDCae::MpegL1:
-  case RDCae::MpegL2:
-  case RDCae::MpegL3:
-    settings->setFormat(RDSettings::MpegL2Wav);
-    break;
-  }
-  settings->setChannels(evt->channels());
-  settings->setSampleRate(rda->system()->sampleRate());
-  settings->setBitRate(evt->bitrate());
-  settings->setNormalizationLevel(evt->normalizeLevel()/100);
+  GetImportSettings(evt,settings);
   LogLine(RDConfig::LogInfo,QString().
 	  sprintf("started import of %s to cut %s, id=%d",
 		  (const char *)evt->tempName(),
@@ -541,3 +578,181 @@ bool MainObject::Import(CatchEvent *evt)
 }
 
 
+void MainObject::GetImportSettings(CatchEvent *evt,RDSettings *settings)
+{
+  switch(evt->format()) {
+  case RDCae::Pcm16:
+    settings->setFormat(RDSettings::Pcm16);
+    break;
+
+  case RDCae::Pcm24:
+    settings->setFormat(RDSettings::Pcm24);
+    break;
+
+  case RDCae::MpegL1:
+  case RDCae::MpegL2:
+  case RDCae::MpegL3:
+    settings->setFormat(RDSettings::MpegL2Wav);
+    break;
+  }
+  settings->setChannels(evt->channels());
+  settings->setSampleRate(rda->system()->sampleRate());
+  settings->setBitRate(evt->bitrate());
+  settings->setNormalizationLevel(evt->normalizeLevel()/100);
+}
+
+
+pid_t MainObject::StartPipelinedImport(CatchEvent *evt,const QString &partname)
+{
+  pid_t pid;
+  QTime stall;
+  off_t size=-1;
+  struct stat st;
+  bool ok=false;
+
+  //
+  // Everything that needs the database is done here, before forking
+  //
+  RDCut *cut=new RDCut(evt->cutName());
+  if(!cut->exists()) {
+    delete cut;
+    return -1;
+  }
+  RDSettings *settings=new RDSettings();
+  GetImportSettings(evt,settings);
+  RDAudioConvert *conv=new RDAudioConvert(this);
+  conv->setSourceFile(evt->tempName());
+  conv->setSourceChaseWait(RDCATCHD_PIPELINE_STALL_WAIT);
+  conv->setDestinationFile(partname);
+  conv->setDestinationSettings(settings);
+  RDWaveData *wavedata=NULL;
+  if(evt->enableMetadata()) {
+    RDCart *cart=new RDCart(cut->cartNumber());
+    wavedata=new RDWaveData();
+    cart->getMetadata(wavedata);
+    cut->getMetadata(wavedata);
+    conv->setDestinationWaveData(wavedata);
+    delete cart;
+  }
+  delete cut;
+  unlink(partname);
+  fflush(stdout);
+  fflush(stderr);
+  if((pid=fork())!=0) {
+    if(wavedata!=NULL) {
+      delete wavedata;
+    }
+    delete conv;
+    delete settings;
+    return pid;
+  }
+
+  //
+  // Child -- wait for the WAV header to arrive, then convert from the
+  // growing download.  Only PCM and MPEG WAV sources can be followed;
+  // anything else exits non-zero so that the completed download is
+  // imported in the usual way.  The database connection and sockets
+  // belong to the parent, so exit without running any destructors.
+  //
+  stall.start();
+  while(stall.elapsed()<RDCATCHD_PIPELINE_STALL_WAIT) {
+    if(stat(evt->tempName(),&st)==0) {
+      RDWaveFile *wave=new RDWaveFile(evt->tempName());
+      wave->setChaseMode(true);
+      if(wave->openWave()) {
+	ok=(wave->type()==RDWaveFile::Wave)&&
+	  ((wave->getFormatTag()==WAVE_FORMAT_MPEG)||
+	   ((wave->getFormatTag()==WAVE_FORMAT_PCM)&&
+	    ((wave->getBitsPerSample()==16)||(wave->getBitsPerSample()==24))));
+	wave->closeWave();
+	delete wave;
+	if(!ok) {
+	  _exit(1);
+	}
+	break;
+      }
+      delete wave;
+      if(st.st_size>=65536) {  // Should have seen a header by now
+	_exit(1);
+      }
+      if(st.st_size!=size) {
+	size=st.st_size;
+	stall.restart();
+      }
+    }
+    usleep(100000);
+  }
+  if(!ok) {
+    _exit(1);
+  }
+  if(conv->convert()!=RDAudioConvert::ErrorOk) {
+    unlink(partname);
+    _exit(1);
+  }
+  _exit(0);
+}
+
+
+bool MainObject::FinishPipelinedImport(CatchEvent *evt,pid_t pid,
+				       const QString &partname)
+{
+  int status=0;
+
+  //
+  // Returns false if the pipelined import didn't complete, in which case
+  // the download must be imported in the usual way
+  //
+  while((waitpid(pid,&status,0)<0)&&(errno==EINTR));
+  if((!WIFEXITED(status))||(WEXITSTATUS(status)!=0)) {
+    unlink(partname);
+    return false;
+  }
+  RDWaveData *wavedata=new RDWaveData();
+  RDWaveFile *wave=new RDWaveFile(evt->tempName());
+  if(!wave->openWave(wavedata)) {
+    delete wave;
+    delete wavedata;
+    unlink(partname);
+    return false;
+  }
+  unsigned msecs=wave->getExtTimeLength();
+  delete wave;
+  if(rename(partname,RDCut::pathName(evt->cutName()))!=0) {
+    LogLine(RDConfig::LogErr,QString().
+	    sprintf("unable to move %s to cut %s [%s], id=%d",
+		    (const char *)partname,(const char *)evt->cutName(),
+		    strerror(errno),evt->id()));
+    delete wavedata;
+    unlink(partname);
+    return false;
+  }
+  CheckInRecording(evt->cutName(),evt,msecs,evt->trimThreshold());
+  if(evt->enableMetadata()) {
+    RDCut *cut=new RDCut(evt->cutName());
+    RDCart *cart=new RDCart(cut->cartNumber());
+    cart->setMetadata(wavedata);
+    cut->setMetadata(wavedata);
+    delete cart;
+    delete cut;
+  }
+  delete wavedata;
+  LogLine(RDConfig::LogInfo,QString().
+	  sprintf("completed pipelined import of %s to cut %s, id=%d",
+		  (const char *)evt->tempName(),
+		  (const char *)evt->cutName(),
+		  evt->id()));
+
+  return true;
+}
+
+
+void MainObject::StopPipelinedImport(pid_t pid,const QString &partname)
+{
+  if(pid>0) {
+    kill(pid,SIGKILL);
+    while((waitpid(pid,NULL,0)<0)&&(errno==EINTR));
+    unlink(partname);
+  }
+}
+
+
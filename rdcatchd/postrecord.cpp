@@ -0,0 +1,281 @@
+// postrecord.cpp
+//
+// Queue for post-record processing in rdcatchd(8)
+//
+//   (C) Copyright 2018 Fred Gleason <fredg@paravelsystems.com>
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License version 2 as
+//   published by the Free Software Foundation.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public
+//   License along with this program; if not, write to the Free Software
+//   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+//
+
+#include <errno.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <syslog.h>
+#include <unistd.h>
+
+#include <rd.h>
+#include <rdcut.h>
+#include <rdhash.h>
+#include <rdwavefile.h>
+
+#include "postrecord.h"
+
+PostRecordJob::PostRecordJob(const QString &cutname,int id,int trim_level,
+			     unsigned priority,const QString &hash)
+{
+  cut_name=cutname;
+  this->id=id;
+  this->trim_level=trim_level;
+  this->priority=priority;
+  sha1_hash=hash;
+  ok=false;
+  start_point=0;
+  end_point=-1;
+  wait_msecs=0;
+  hash_msecs=0;
+  trim_msecs=0;
+  pid=-1;
+  cancelled=false;
+  notifier=NULL;
+  queued_time.start();
+}
+
+
+PostRecordQueue::PostRecordQueue(unsigned max_jobs,QObject *parent)
+  : QObject(parent)
+{
+  post_max_jobs=max_jobs;
+  if(post_max_jobs==0) {
+    post_max_jobs=1;
+  }
+}
+
+
+PostRecordQueue::~PostRecordQueue()
+{
+  for(std::list<PostRecordJob *>::iterator it=post_pending.begin();
+      it!=post_pending.end();it++) {
+    delete *it;
+  }
+  for(std::map<int,PostRecordJob *>::iterator it=post_running.begin();
+      it!=post_running.end();it++) {
+    delete it->second->notifier;
+    close(it->first);
+    delete it->second;
+  }
+}
+
+
+bool PostRecordQueue::push(const QString &cutname,int id,int trim_level,
+			   unsigned priority,const QString &hash)
+{
+  //
+  // Returns false if the queue is full, in which case the caller must
+  // do the work itself
+  //
+  if(post_pending.size()>=POSTRECORD_MAX_PENDING) {
+    return false;
+  }
+
+  //
+  // Jobs are taken lowest 'priority' value first, and in the order they
+  // were pushed for equal values
+  //
+  PostRecordJob *job=new PostRecordJob(cutname,id,trim_level,priority,hash);
+  std::list<PostRecordJob *>::iterator it=post_pending.begin();
+  while((it!=post_pending.end())&&((*it)->priority<=priority)) {
+    it++;
+  }
+  post_pending.insert(it,job);
+  StartJobs();
+  return true;
+}
+
+
+void PostRecordQueue::cancel(const QString &cutname)
+{
+  std::list<PostRecordJob *>::iterator it=post_pending.begin();
+  while(it!=post_pending.end()) {
+    if((*it)->cut_name==cutname) {
+      delete *it;
+      it=post_pending.erase(it);
+    }
+    else {
+      it++;
+    }
+  }
+  for(std::map<int,PostRecordJob *>::iterator it=post_running.begin();
+      it!=post_running.end();it++) {
+    if(it->second->cut_name==cutname) {
+      it->second->cancelled=true;
+    }
+  }
+}
+
+
+unsigned PostRecordQueue::pending() const
+{
+  return post_pending.size();
+}
+
+
+unsigned PostRecordQueue::running() const
+{
+  return post_running.size();
+}
+
+
+void PostRecordQueue::readyReadData(int fd)
+{
+  char data[1024];
+  ssize_t n;
+  char hash[256];
+
+  std::map<int,PostRecordJob *>::iterator it=post_running.find(fd);
+  if(it==post_running.end()) {
+    return;
+  }
+  PostRecordJob *job=it->second;
+  if((n=read(fd,data,1024))>0) {
+    job->output.append(data,n);
+    return;
+  }
+  if((n<0)&&((errno==EINTR)||(errno==EAGAIN))) {
+    return;
+  }
+
+  //
+  // The child has finished
+  //
+  job->notifier->setEnabled(false);
+  job->notifier->deleteLater();
+  job->notifier=NULL;
+  close(fd);
+  post_running.erase(it);
+  job->ok=(job->output.size()<256)&&
+    (sscanf(job->output.c_str(),"%s %d %d %d %d",hash,&job->start_point,
+	    &job->end_point,&job->hash_msecs,&job->trim_msecs)==5);
+  if(job->ok) {
+    job->sha1_hash=hash;
+  }
+  if(!job->cancelled) {
+    emit finished(job);
+  }
+  delete job;
+  StartJobs();
+}
+
+
+void PostRecordQueue::StartJobs()
+{
+  int pipefd[2];
+  pid_t pid;
+
+  while((post_running.size()<post_max_jobs)&&(post_pending.size()>0)) {
+    PostRecordJob *job=post_pending.front();
+    post_pending.pop_front();
+    job->wait_msecs=job->queued_time.elapsed();
+    job->started_time.start();
+    if(pipe(pipefd)<0) {
+      emit finished(job);
+      delete job;
+      continue;
+    }
+    fflush(stdout);
+    fflush(stderr);
+    if((pid=fork())==0) {
+      close(pipefd[0]);
+      RunJob(job,pipefd[1]);
+    }
+    close(pipefd[1]);
+    if(pid<0) {
+      close(pipefd[0]);
+      emit finished(job);
+      delete job;
+      continue;
+    }
+    job->pid=pid;
+    job->notifier=new QSocketNotifier(pipefd[0],QSocketNotifier::Read,this);
+    connect(job->notifier,SIGNAL(activated(int)),
+	    this,SLOT(readyReadData(int)));
+    post_running[pipefd[0]]=job;
+  }
+}
+
+
+void PostRecordQueue::RunJob(PostRecordJob *job,int fd)
+{
+  //
+  // Runs in the child.  The database connection belongs to the parent, so
+  // exit without running any destructors.
+  //
+  QString wavename=RDCut::pathName(job->cut_name);
+  QString hash=job->sha1_hash;
+  QTime timer;
+  int point;
+  const char *ptr;
+  ssize_t n;
+  size_t left;
+
+  signal(SIGTERM,SIG_DFL);
+  signal(SIGINT,SIG_DFL);
+  errno=0;
+  if((nice(10)==-1)&&(errno!=0)) {
+    syslog(LOG_WARNING,"unable to lower priority of post-record job: %s",
+	   strerror(errno));
+  }
+  timer.start();
+  if(hash.isEmpty()) {  // Not made by the writer
+    hash=RDSha1Hash(wavename);
+  }
+  job->hash_msecs=timer.restart();
+  RDWaveFile *wave=new RDWaveFile(wavename);
+  if(wave->openWave()) {
+    job->start_point=0;
+    job->end_point=wave->getExtTimeLength();
+    if(job->trim_level<0) {
+      if((point=wave->startTrim(REFERENCE_LEVEL-job->trim_level))>-1) {
+	job->start_point=
+	  (int)(1000.0*(double)point/(double)wave->getSamplesPerSec());
+      }
+      if((point=wave->endTrim(+REFERENCE_LEVEL-job->trim_level))>-1) {
+	job->end_point=
+	  (int)(1000.0*(double)point/(double)wave->getSamplesPerSec());
+      }
+    }
+    wave->closeWave();
+  }
+  job->trim_msecs=timer.elapsed();
+  if(hash.isEmpty()||(job->end_point<0)) {
+    _exit(1);
+  }
+  QString out=QString().sprintf("%s %d %d %d %d\n",(const char *)hash,
+				job->start_point,job->end_point,
+				job->hash_msecs,job->trim_msecs);
+  ptr=(const char *)out;
+  left=out.length();
+  while(left>0) {
+    if((n=write(fd,ptr,left))<0) {
+      if(errno==EINTR) {
+	continue;
+      }
+      _exit(1);
+    }
+    ptr+=n;
+    left-=n;
+  }
+  _exit(0);
+}
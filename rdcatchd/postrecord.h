@@ -0,0 +1,104 @@
+// postrecord.h
+//
+// Queue for post-record processing in rdcatchd(8)
+//
+//   (C) Copyright 2018 Fred Gleason <fredg@paravelsystems.com>
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License version 2 as
+//   published by the Free Software Foundation.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public
+//   License along with this program; if not, write to the Free Software
+//   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+//
+
+#ifndef POSTRECORD_H
+#define POSTRECORD_H
+
+#include <sys/types.h>
+
+#include <list>
+#include <map>
+#include <string>
+
+#include <qdatetime.h>
+#include <qobject.h>
+#include <qsocketnotifier.h>
+
+//
+// Maximum number of jobs run at once
+//
+#define POSTRECORD_MAX_JOBS 2
+
+//
+// Maximum number of jobs waiting to run
+//
+#define POSTRECORD_MAX_PENDING 32
+
+//
+// The disk-bound part of checking in a recording -- hashing the audio and
+// finding the trim points -- is done in a child process, one per job, so
+// that the event loop never waits on it.  The child touches no database
+// objects; its results are passed back over a pipe and applied by the
+// caller when finished() is emitted.  A hash already made by the writer
+// is passed in with the job and used as it is.
+//
+class PostRecordJob
+{
+ public:
+  PostRecordJob(const QString &cutname,int id,int trim_level,
+		unsigned priority,const QString &hash);
+  QString cut_name;
+  int id;
+  int trim_level;
+  unsigned priority;
+  bool ok;
+  QString sha1_hash;
+  int start_point;
+  int end_point;
+  int wait_msecs;
+  int hash_msecs;
+  int trim_msecs;
+  QTime queued_time;
+  QTime started_time;
+  pid_t pid;
+  bool cancelled;
+  std::string output;
+  QSocketNotifier *notifier;
+};
+
+
+class PostRecordQueue : public QObject
+{
+  Q_OBJECT;
+ public:
+  PostRecordQueue(unsigned max_jobs,QObject *parent=0);
+  ~PostRecordQueue();
+  bool push(const QString &cutname,int id,int trim_level,unsigned priority,
+	    const QString &hash="");
+  void cancel(const QString &cutname);
+  unsigned pending() const;
+  unsigned running() const;
+
+ signals:
+  void finished(PostRecordJob *job);
+
+ private slots:
+  void readyReadData(int fd);
+
+ private:
+  void StartJobs();
+  void RunJob(PostRecordJob *job,int fd);
+  std::list<PostRecordJob *> post_pending;
+  std::map<int,PostRecordJob *> post_running;
+  unsigned post_max_jobs;
+};
+
+
+#endif  // POSTRECORD_H
@@ -134,6 +134,8 @@ MainObject::MainObject(QObject *parent)
     fprintf(stderr,"rdcatchd: %s\n",(const char *)err_msg);
     exit(1);
   }
+  rda->cutRotation()->setEnabled(true);
+  catch_postrecord=NULL;
 
   //
   // Read Command Options
@@ -338,6 +340,22 @@ MainObject::MainObject(QObject *parent)
   connect(catch_engine,SIGNAL(timeout(int)),this,SLOT(engineData(int)));
   LoadEngine();
 
+  //
+  // Post-Record Queue
+  //
+  catch_postrecord=new PostRecordQueue(POSTRECORD_MAX_JOBS,this);
+  connect(catch_postrecord,SIGNAL(finished(PostRecordJob *)),
+	  this,SLOT(postRecordFinishedData(PostRecordJob *)));
+
+  //
+  // Clear recording flags left behind by an earlier instance
+  //
+  sql=QString("update CUTS set RECORDING=\"N\" where ")+
+    "(RECORDING=\"Y\")&&"+
+    "(ORIGIN_NAME=\""+RDEscapeString(rda->config()->stationName())+"\")";
+  q=new RDSqlQuery(sql);
+  delete q;
+
   if(qApp->argc()==1) {
     RDDetach(rda->config()->logCoreDumpDirectory());
   }
@@ -922,13 +940,19 @@ void MainObject::recordUnloadedData(int card,int stream,unsigned msecs)
     LogLine(RDConfig::LogDebug,QString().
 	    sprintf("invalid record event:  Id: %d",
 		    catch_record_id[deck-1]));
+    RDCut *cut=new RDCut(catch_record_name[deck-1]);
+    if(cut->exists()) {
+      cut->setRecording(false);
+    }
+    delete cut;
     RunRmlRecordingCache(deck);
     return;
   }
 
   if(catch_events[event].normalizeLevel()==0) {
     CheckInRecording(catch_record_name[deck-1],&catch_events[event],msecs,
-		     catch_record_threshold[deck-1]);
+		     catch_record_threshold[deck-1],
+		     rda->cae()->recordSha1Hash(card,stream));
   }
   else {
     StartBatch(catch_events[event].id());
@@ -1285,6 +1309,9 @@ bool MainObject::StartRecording(int event)
     catch_events[event].setDeleteTempFile(true);
     format=RDCae::Pcm24;
   }    
+  if(catch_postrecord!=NULL) {
+    catch_postrecord->cancel(catch_events[event].cutName());
+  }
 
   //
   // Start the recording
@@ -1361,6 +1388,28 @@ bool MainObject::StartRecording(int event)
       cut->setEndDatetime(datetime,true);
     }
   }
+
+  //
+  // Publish the growing cut
+  //
+  // The ALSA and JACK drivers in caed commit the recorded length to the
+  // file as they go, and follow it when playing a cut marked as
+  // recording, so the cut can be played out while it is still being
+  // captured.  The final length, trim points and hash are set and the
+  // mark cleared by CheckInRecording() once the recording is unloaded.
+  //
+  RDStation::AudioDriver driver=
+    rda->station()->cardDriver(catch_record_card[deck-1]);
+  if((catch_events[event].normalizeLevel()==0)&&(length>0)&&
+     ((driver==RDStation::Alsa)||(driver==RDStation::Jack))) {
+    cut->setRecording(true);
+    cut->setStartPoint(0);
+    cut->setEndPoint(length);
+    cut->setLength(length);
+    RDCart *cart=new RDCart(cut->cartNumber());
+    cart->updateLength();
+    delete cart;
+  }
   delete cut;
 
   return true;
@@ -2396,7 +2445,8 @@ void MainObject::LoadHeartbeat()
 
 
 void MainObject::CheckInRecording(QString cutname,CatchEvent *evt,
-				  unsigned msecs,unsigned threshold)
+				  unsigned msecs,unsigned threshold,
+				  const QString &hash)
 {
   RDCut *cut=new RDCut(cutname);
   RDSettings *s=new RDSettings();
@@ -2406,14 +2456,90 @@ void MainObject::CheckInRecording(QString cutname,CatchEvent *evt,
   s->setChannels(evt->channels());
   cut->checkInRecording(rda->config()->stationName(),"",
 			rda->config()->stationName(),s,msecs);
-  cut->setSha1Hash(RDSha1Hash(RDCut::pathName(cut->cutName())));
+  cut->setRecording(false);
   delete s;
+  chown(RDCut::pathName(cutname),rda->config()->uid(),rda->config()->gid());
+
+  //
+  // Use the hash caed generated as it wrote the file, if there is one
+  //
+  if(!hash.isEmpty()) {
+    cut->setSha1Hash(hash);
+  }
+
+  //
+  // Hash and trim in the background, shortest recordings first
+  //
+  if((catch_postrecord!=NULL)&&
+     catch_postrecord->push(cutname,evt->id(),-(int)threshold,msecs,hash)) {
+    delete cut;
+    LogLine(RDConfig::LogDebug,QString().
+	    sprintf("queued post-record processing: cut %s | ",
+		    (const char *)cutname)+
+	    QString().sprintf("pending: %u, running: %u",
+			      catch_postrecord->pending(),
+			      catch_postrecord->running()));
+    return;
+  }
+  if(catch_postrecord!=NULL) {
+    LogLine(RDConfig::LogWarning,QString().
+	    sprintf("post-record queue full, processing cut %s at once",
+		    (const char *)cutname));
+  }
+  if(hash.isEmpty()) {
+    cut->setSha1Hash(RDSha1Hash(RDCut::pathName(cut->cutName())));
+  }
   cut->autoTrim(RDCut::AudioBoth,-threshold);
   RDCart *cart=new RDCart(cut->cartNumber());
   cart->updateLength();
   delete cart;
   delete cut;
-  chown(RDCut::pathName(cutname),rda->config()->uid(),rda->config()->gid());
+}
+
+
+void MainObject::postRecordFinishedData(PostRecordJob *job)
+{
+  QTime timer;
+
+  timer.start();
+  RDCut *cut=new RDCut(job->cut_name);
+  if(cut->exists()) {
+    if(job->ok) {
+      cut->setSha1Hash(job->sha1_hash);
+      cut->setTrimPoints(job->start_point,job->end_point);
+    }
+    else {
+      //
+      // Fall back to hashing and trimming here, so that the hash matches
+      // the recording and the cut and cart lengths reflect it rather
+      // than the length published when it started
+      //
+      LogLine(RDConfig::LogWarning,QString().
+	      sprintf("post-record processing failed: cut %s, id: %d",
+		      (const char *)job->cut_name,job->id));
+      if(job->sha1_hash.isEmpty()) {
+	cut->setSha1Hash(RDSha1Hash(RDCut::pathName(job->cut_name)));
+      }
+      else {
+	cut->setSha1Hash(job->sha1_hash);
+      }
+      cut->autoTrim(RDCut::AudioBoth,job->trim_level);
+    }
+    RDCart *cart=new RDCart(cut->cartNumber());
+    cart->updateLength();
+    delete cart;
+  }
+  delete cut;
+  if(!job->ok) {
+    return;
+  }
+  LogLine(RDConfig::LogInfo,QString().
+	  sprintf("post-record processing complete: cut %s, id: %d | ",
+		  (const char *)job->cut_name,job->id)+
+	  QString().sprintf("wait: %d mS, hash: %d mS, trim: %d mS, ",
+			    job->wait_msecs,job->hash_msecs,job->trim_msecs)+
+	  QString().sprintf("update: %d mS, total: %d mS",
+			    timer.elapsed(),job->queued_time.elapsed()));
 }
 
 
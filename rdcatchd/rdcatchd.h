@@ -49,6 +49,7 @@
 
 #include "catch_event.h"
 #include "event_player.h"
+#include "postrecord.h"
 
 //
 // Global RDCATCHD Definitions
@@ -62,6 +63,13 @@
 #define RDCATCHD_HEARTBEAT_INTERVAL 10000
 #define RDCATCHD_ERROR_ID_OFFSET 1000000
 
+//
+// How long a pipelined download import will wait for more of the file to
+// arrive before giving up and falling back to importing the completed
+// download
+//
+#define RDCATCHD_PIPELINE_STALL_WAIT 30000
+
 //
 // Function Prototypes
 //
@@ -104,6 +112,7 @@ class MainObject : public QObject
   void sysHeartbeatData();
   void updateXloadsData();
   void startupCartData();
+  void postRecordFinishedData(PostRecordJob *job);
   void log(RDConfig::LogPriority prio,const QString &line);
 
   //
@@ -123,6 +132,11 @@ class MainObject : public QObject
   bool Export(CatchEvent *evt);
   QString GetExportCmd(CatchEvent *evt,QString *tempname);
   bool Import(CatchEvent *evt);
+  void GetImportSettings(CatchEvent *evt,RDSettings *settings);
+  pid_t StartPipelinedImport(CatchEvent *evt,const QString &partname);
+  bool FinishPipelinedImport(CatchEvent *evt,pid_t pid,
+			     const QString &partname);
+  void StopPipelinedImport(pid_t pid,const QString &partname);
   QString GetImportCmd(CatchEvent *evt,QString *tempname);
 
   //
@@ -158,7 +172,7 @@ class MainObject : public QObject
   void PurgeEvent(int event);
   void LoadHeartbeat();
   void CheckInRecording(QString cutname,CatchEvent *evt,unsigned msecs,
-			unsigned threshold);
+			unsigned threshold,const QString &hash="");
   void CheckInPodcast(CatchEvent *e) const;
   RDRecording::ExitCode ReadExitCode(int event);
   void WriteExitCode(int event,RDRecording::ExitCode code,
@@ -245,6 +259,7 @@ class MainObject : public QObject
   QTimer *catch_xload_timer;
   QString catch_temp_dir;
   RDCatchConf *catch_conf;
+  PostRecordQueue *catch_postrecord;
 };
 
 
@@ -37,6 +37,8 @@
 #include <qlistview.h>
 #include <qprogressdialog.h>
 #include <qtooltip.h>
+#include <qheader.h>
+#include <qscrollbar.h>
 #include <curl/curl.h>
 
 #include <dbversion.h>
@@ -181,6 +183,8 @@ MainWidget::MainWidget(QWidget *parent)
   connect(rda,SIGNAL(userChanged()),this,SLOT(userData()));
   connect(rda->ripc(),SIGNAL(notificationReceived(RDNotification *)),
 	  this,SLOT(notificationReceivedData(RDNotification *)));
+  connect(rda->ripc(),SIGNAL(notificationsMissed(const QString &)),
+	  this,SLOT(notificationsMissedData(const QString &)));
   rda->ripc()->
     connectHost("localhost",RIPCD_TCP_PORT,rda->config()->password());
   cut_clipboard=NULL;
@@ -335,6 +339,13 @@ MainWidget::MainWidget(QWidget *parent)
 	  this,SLOT(cartClickedData(QListViewItem *)));
   connect(lib_cart_list,SIGNAL(onItem(QListViewItem *)),
 	  this,SLOT(cartOnItemData(QListViewItem *)));
+  connect(lib_cart_list->verticalScrollBar(),SIGNAL(valueChanged(int)),
+	  this,SLOT(cartListScrolledData(int)));
+  connect(lib_cart_list->header(),SIGNAL(clicked(int)),
+	  this,SLOT(cartListSortedData(int)));
+  lib_last_cartnum=0;
+  lib_list_count=0;
+  lib_list_complete=true;
   lib_cart_list->addColumn("");
   lib_cart_list->setColumnAlignment(0,Qt::AlignHCenter);
   lib_cart_list->addColumn(tr("CART"));
@@ -616,6 +627,9 @@ void MainWidget::addData()
     delete rdcart;
   } 
   else {
+    if((!lib_list_complete)&&((unsigned)cart_num>lib_last_cartnum)) {
+      lib_added_carts.insert(cart_num);
+    }
     RDListViewItem *item=new RDListViewItem(lib_cart_list);
     item->setText(1,QString().sprintf("%06u",cart_num));
     RefreshLine(item);
@@ -913,38 +927,55 @@ void MainWidget::notificationReceivedData(RDNotification *notify)
   RDListViewItem *item=NULL;
   QString sql;
   RDSqlQuery *q;
+  QString cartnums;
+  QDateTime current_datetime(QDate::currentDate(),QTime::currentTime());
 
   if(notify->type()==RDNotification::CartType) {
-    unsigned cartnum=notify->id().toUInt();
+    for(unsigned i=0;i<notify->idQuantity();i++) {
+      cartnums+=QString().sprintf("%u,",notify->id(i).toUInt());
+    }
+    cartnums=cartnums.left(cartnums.length()-1);
     switch(notify->action()) {
     case RDNotification::AddAction:
-      sql=QString("select CART.NUMBER from CART ")+
-	"left join CUTS on CART.NUMBER=CUTS.CART_NUMBER "+
-	WhereClause()+
-	QString().sprintf(" && CART.NUMBER=%u ",cartnum);
+      sql=CartSql(current_datetime)+WhereClause()+
+	" && (CART.NUMBER in ("+cartnums+"))";
       q=new RDSqlQuery(sql);
-      if(q->first()) {
-	item=new RDListViewItem(lib_cart_list);
-	item->setText(1,QString().sprintf("%06u",cartnum));
-	RefreshLine(item);
+      while(q->next()) {
+	//
+	// Carts past the end of a partial list arrive with a later page
+	//
+	if(lib_list_complete||(q->value(0).toUInt()<=lib_last_cartnum)) {
+	  item=new RDListViewItem(lib_cart_list);
+	  WriteItem(item,q,current_datetime);
+	}
       }
       delete q;
       break;
 
     case RDNotification::ModifyAction:
-      if((item=(RDListViewItem *)lib_cart_list->
-	  findItem(QString().sprintf("%06u",cartnum),1))!=NULL) {
-	RefreshLine(item);
+      sql=CartSql(current_datetime)+
+	" where CART.NUMBER in ("+cartnums+")";
+      q=new RDSqlQuery(sql);
+      while(q->next()) {
+	if((item=(RDListViewItem *)lib_cart_list->
+	    findItem(QString().sprintf("%06u",q->value(0).toUInt()),1))!=
+	   NULL) {
+	  WriteItem(item,q,current_datetime);
+	}
       }
+      delete q;
       break;
 
     case RDNotification::DeleteAction:
-      if(lib_edit_pending) {
-	lib_deleted_carts.push_back(cartnum);
-      }
-      else {
-	if((item=(RDListViewItem *)lib_cart_list->findItem(QString().sprintf("%06u",cartnum),1))!=NULL) {
-	  delete item;
+      for(unsigned i=0;i<notify->idQuantity();i++) {
+	unsigned cartnum=notify->id(i).toUInt();
+	if(lib_edit_pending) {
+	  lib_deleted_carts.push_back(cartnum);
+	}
+	else {
+	  if((item=(RDListViewItem *)lib_cart_list->findItem(QString().sprintf("%06u",cartnum),1))!=NULL) {
+	    delete item;
+	  }
 	}
       }
       break;
@@ -957,6 +988,31 @@ void MainWidget::notificationReceivedData(RDNotification *notify)
 }
 
 
+void MainWidget::notificationsMissedData(const QString &source)
+{
+  RefreshList();
+}
+
+
+void MainWidget::cartListScrolledData(int value)
+{
+  if((!lib_list_complete)&&
+     (value>=(lib_cart_list->verticalScrollBar()->maxValue()-
+	      lib_cart_list->visibleHeight()))) {
+    FetchPage();
+  }
+}
+
+
+void MainWidget::cartListSortedData(int section)
+{
+  //
+  // Sorting on any other key needs every matching cart in the list
+  //
+  FetchAll();
+}
+
+
 void MainWidget::quitMainWidget()
 {
   SaveGeometry();
@@ -1018,23 +1074,91 @@ void MainWidget::resizeEvent(QResizeEvent *e)
 
 
 void MainWidget::RefreshList()
+{
+  lib_cart_list->clear();
+  lib_last_cartnum=0;
+  lib_list_count=0;
+  lib_list_complete=false;
+  lib_added_carts.clear();
+  if(GetTypeFilter().isEmpty()) {
+    lib_list_complete=true;
+    return;
+  }
+  FetchPage();
+}
+
+
+void MainWidget::FetchPage()
 {
   RDSqlQuery *q;
   QString sql;
   RDListViewItem *l=NULL;
-  QString type_filter;
   QDateTime current_datetime(QDate::currentDate(),QTime::currentTime());
-  unsigned cartnum=0;
-  RDCart::Validity validity=RDCart::NeverValid;
-  QDateTime end_datetime;
+  int limit=RDLIBRARY_PAGE_SIZE;
+  int rows=0;
 
-  lib_cart_list->clear();
+  if(lib_list_complete) {
+    return;
+  }
+  if(lib_showmatches_box->isChecked()) {
+    if((RD_LIMITED_CART_SEARCH_QUANTITY-lib_list_count)<limit) {
+      limit=RD_LIMITED_CART_SEARCH_QUANTITY-lib_list_count;
+    }
+  }
+
+  //
+  // Keyset pagination: each page picks up after the last cart number
+  // already in the list.
+  //
+  sql=CartSql(current_datetime)+WhereClause()+
+    QString().sprintf(" && (CART.NUMBER>%u) ",lib_last_cartnum)+
+    QString().sprintf("order by CART.NUMBER limit %d",limit);
+  q=new RDSqlQuery(sql);
+  while(q->next()) {
+    rows++;
+    lib_last_cartnum=q->value(0).toUInt();
+    if(lib_added_carts.find(lib_last_cartnum)!=lib_added_carts.end()) {
+      continue;
+    }
+    l=new RDListViewItem(lib_cart_list);
+    WriteItem(l,q,current_datetime);
+    lib_list_count++;
+  }
+  delete q;
+  if((rows<limit)||
+     (lib_showmatches_box->isChecked()&&
+      (lib_list_count>=RD_LIMITED_CART_SEARCH_QUANTITY))) {
+    lib_list_complete=true;
+    lib_added_carts.clear();
+  }
+}
+
+
+void MainWidget::FetchAll()
+{
+  int step=0;
 
-  type_filter=GetTypeFilter();
-  if(type_filter.isEmpty()) {
+  if(lib_list_complete) {
     return;
   }
-  sql=QString("select ")+
+  lib_progress_dialog->setTotalSteps(0);
+  lib_progress_dialog->setProgress(0);
+  while(!lib_list_complete) {
+    FetchPage();
+    lib_progress_dialog->setProgress(++step);
+    qApp->eventLoop()->processEvents(QEventLoop::ExcludeUserInput);
+  }
+  lib_progress_dialog->reset();
+}
+
+
+QString MainWidget::CartSql(const QDateTime &datetime) const
+{
+  //
+  // One row per cart, with the validity of its cuts worked out by the
+  // database.  The join with CUTS is only there for the search filter.
+  //
+  return QString("select distinct ")+
     "CART.NUMBER,"+             // 00
     "CART.FORCED_LENGTH,"+      // 01
     "CART.TITLE,"+              // 02
@@ -1059,134 +1183,9 @@ void MainWidget::RefreshList()
     "CART.OWNER,"+              // 21
     "CART.VALIDITY,"+           // 22
     "GROUPS.COLOR,"+            // 23
-    "CUTS.LENGTH,"+             // 24  offsets begin here
-    "CUTS.EVERGREEN,"+          // 25
-    "CUTS.START_DATETIME,"+     // 26
-    "CUTS.END_DATETIME,"+       // 27
-    "CUTS.START_DAYPART,"+      // 28
-    "CUTS.END_DAYPART,"+        // 29
-    "CUTS.MON,"+                // 30
-    "CUTS.TUE,"+                // 31
-    "CUTS.WED,"+                // 32
-    "CUTS.THU,"+                // 33
-    "CUTS.FRI,"+                // 34
-    "CUTS.SAT,"+                // 35
-    "CUTS.SUN "+                // 36
+    ValidateCartSql(datetime)+" "+  // 24
     "from CART left join GROUPS on CART.GROUP_NAME=GROUPS.NAME "+
     "left join CUTS on CART.NUMBER=CUTS.CART_NUMBER";
-  sql+=WhereClause();
-  sql+=" order by CART.NUMBER";
-  if(lib_showmatches_box->isChecked()) {
-    sql+=QString().sprintf(" limit %d",RD_LIMITED_CART_SEARCH_QUANTITY);
-  }
-  q=new RDSqlQuery(sql);
-  int step=0;
-  int count=0;
-  lib_progress_dialog->setTotalSteps(q->size()/RDLIBRARY_STEP_SIZE);
-  lib_progress_dialog->setProgress(0);
-  while(q->next()) {
-    end_datetime=q->value(14).toDateTime();
-    if(q->value(0).toUInt()==cartnum) {
-      if((RDCart::Type)q->value(15).toUInt()==RDCart::Macro) {
-	validity=RDCart::AlwaysValid;
-      }
-      else {
-	validity=ValidateCut(q,24,validity,current_datetime);
-      }
-    }
-    else {
-      //
-      // Write availability color
-      //
-      UpdateItemColor(l,validity,q->value(14).toDateTime(),current_datetime);
-
-      //
-      // Start a new entry
-      //
-      if((RDCart::Type)q->value(15).toUInt()==RDCart::Macro) {
-	validity=RDCart::AlwaysValid;
-      }
-      else {
-	validity=ValidateCut(q,24,RDCart::NeverValid,current_datetime);
-      }
-      l=new RDListViewItem(lib_cart_list);
-      switch((RDCart::Type)q->value(15).toUInt()) {
-      case RDCart::Audio:
-	if(q->value(21).isNull()) {
-	  l->setPixmap(0,*lib_playout_map);
-	}
-	else {
-	  l->setPixmap(0,*lib_track_cart_map);
-	}
-	break;
-	
-      case RDCart::Macro:
-	l->setPixmap(0,*lib_macro_map);
-	l->setBackgroundColor(backgroundColor());
-	break;
-	
-      case RDCart::All:
-	break;
-      }
-      l->setText(1,QString().sprintf("%06d",q->value(0).toUInt()));
-      l->setText(2,q->value(12).toString());
-      l->setTextColor(2,q->value(23).toString(),QFont::Bold);
-      l->setText(3,RDGetTimeLength(q->value(1).toUInt()));
-      l->setText(4,q->value(2).toString());
-      l->setText(5,q->value(3).toString());
-      if(!q->value(13).toDateTime().isNull()) {
-	l->setText(6,q->value(13).toDateTime().
-		   toString("MM/dd/yyyy - hh:mm:ss"));
-      }
-      if(!q->value(14).toDateTime().isNull()) {
-	l->setText(7,q->value(14).toDateTime().
-		   toString("MM/dd/yyyy - hh:mm:ss"));
-      }
-      else {
-	l->setText(7,"TFN");
-      }
-      l->setText(8,q->value(4).toString());
-      l->setText(9,q->value(5).toString());
-      l->setText(10,q->value(9).toString());
-      l->setText(11,q->value(11).toString());
-      l->setText(12,q->value(10).toString());
-      l->setText(13,q->value(6).toString());
-      l->setText(14,q->value(7).toString());
-      l->setText(15,q->value(8).toString());
-      l->setText(16,q->value(16).toString());
-      l->setText(17,q->value(17).toString());
-      l->setText(18,q->value(18).toString());
-      l->setText(19,q->value(19).toString());
-      l->setText(20,q->value(20).toString());
-      l->setText(21,q->value(21).toString());
-      if(q->value(18).toString()=="Y") {
-	l->setTextColor(3,QColor(RDLIBRARY_ENFORCE_LENGTH_COLOR),QFont::Bold);
-      }
-      else {
-	if((q->value(20).toUInt()>RDLIBRARY_MID_LENGTH_LIMIT)&&
-	   (q->value(18).toString()=="N")) {
-	  if(q->value(20).toUInt()>RDLIBRARY_MAX_LENGTH_LIMIT) {
-	    l->setTextColor(3,QColor(RDLIBRARY_MAX_LENGTH_COLOR),QFont::Bold);
-	  }
-	  else {
-	    l->setTextColor(3,QColor(RDLIBRARY_MID_LENGTH_COLOR),QFont::Bold);
-	  }
-	}
-	else {
-	  l->setTextColor(3,QColor(black),QFont::Normal);
-	}
-      }
-    }
-    cartnum=q->value(0).toUInt();
-    if(count++>RDLIBRARY_STEP_SIZE) {
-      lib_progress_dialog->setProgress(++step);
-      count=0;
-      qApp->eventLoop()->processEvents(QEventLoop::ExcludeUserInput);
-    }
-  }
-  UpdateItemColor(l,validity,end_datetime,current_datetime);
-  lib_progress_dialog->reset();
-  delete q;
 }
 
 
@@ -1235,114 +1234,100 @@ void SigHandler(int signo)
 
 void MainWidget::RefreshLine(RDListViewItem *item)
 {
-  RDCart::Validity validity=RDCart::NeverValid;
   QDateTime current_datetime(QDate::currentDate(),QTime::currentTime());
-  QString sql=QString().sprintf("select CART.FORCED_LENGTH,CART.TITLE,\
-                                 CART.ARTIST,\
-                                 CART.ALBUM,CART.LABEL,\
-                                 CART.CLIENT,\
-                                 CART.AGENCY,CART.USER_DEFINED,\
-                                 CART.COMPOSER,CART.CONDUCTOR,CART.PUBLISHER,\
-                                 CART.GROUP_NAME,CART.START_DATETIME,\
-                                 CART.END_DATETIME,CART.TYPE,\
-                                 CART.CUT_QUANTITY,CART.LAST_CUT_PLAYED,\
-                                 CART.ENFORCE_LENGTH,\
-                                 CART.PRESERVE_PITCH,\
-                                 CART.LENGTH_DEVIATION,CART.OWNER,\
-                                 CART.VALIDITY,GROUPS.COLOR,CUTS.LENGTH,\
-                                 CUTS.EVERGREEN,CUTS.START_DATETIME,\
-                                 CUTS.END_DATETIME,CUTS.START_DAYPART,\
-                                 CUTS.END_DAYPART,CUTS.MON,CUTS.TUE,\
-                                 CUTS.WED,CUTS.THU,CUTS.FRI,CUTS.SAT,CUTS.SUN \
-                                 from CART left join GROUPS on \
-                                 CART.GROUP_NAME=GROUPS.NAME left join \
-                                 CUTS on CART.NUMBER=CUTS.CART_NUMBER \
-                                 where CART.NUMBER=%u",
-				item->text(1).toUInt());
+  QString sql=CartSql(current_datetime)+
+    QString().sprintf(" where CART.NUMBER=%u",item->text(1).toUInt());
   RDSqlQuery *q=new RDSqlQuery(sql);
-  while(q->next()) {
-    if((RDCart::Type)q->value(14).toUInt()==RDCart::Macro) {
-      validity=RDCart::AlwaysValid;
-    }
-    else {
-      validity=ValidateCut(q,23,validity,current_datetime);
-    }
-    switch((RDCart::Type)q->value(14).toUInt()) {
-	case RDCart::Audio:
-	  if(q->value(20).isNull()) {
-	    item->setPixmap(0,*lib_playout_map);
-	  }
-	  else {
-	    item->setPixmap(0,*lib_track_cart_map);
-	  }
-	  if(q->value(0).toUInt()==0) {
-	    item->setBackgroundColor(RD_CART_ERROR_COLOR);
-	  }
-	  else {
-	    UpdateItemColor(item,validity,
-			    q->value(13).toDateTime(),current_datetime);
-	  }
-	  break;
+  if(q->first()) {
+    WriteItem(item,q,current_datetime);
+  }
+  delete q;
+}
 
-	case RDCart::Macro:
-	  item->setPixmap(0,*lib_macro_map);
-	  break;
 
-    case RDCart::All:
-	  break;
-    }
-    item->setText(2,q->value(11).toString());
-    item->setTextColor(2,q->value(22).toString(),QFont::Bold);
-    item->setText(3,RDGetTimeLength(q->value(0).toUInt()));
-    item->setText(4,q->value(1).toString());
-    item->setText(5,q->value(2).toString());
-    item->setText(8,q->value(3).toString());
-    item->setText(9,q->value(4).toString());
-    item->setText(10,q->value(8).toString());
-    item->setText(11,q->value(9).toString());
-
-    item->setText(12,q->value(10).toString());
-    item->setText(13,q->value(5).toString());
-    item->setText(14,q->value(6).toString());
-    if(!q->value(12).toDateTime().isNull()) {
-      item->setText(6,q->value(12).toDateTime().
-		    toString("MM/dd/yyyy - hh:mm:ss"));
+void MainWidget::WriteItem(RDListViewItem *item,RDSqlQuery *q,
+			   const QDateTime &current_datetime)
+{
+  RDCart::Validity validity=RDCart::NeverValid;
+
+  switch((RDCart::Type)q->value(15).toUInt()) {
+  case RDCart::Audio:
+    if(q->value(21).isNull()) {
+      item->setPixmap(0,*lib_playout_map);
     }
     else {
-      item->setText(6,"");
+      item->setPixmap(0,*lib_track_cart_map);
     }
-    if(!q->value(13).toDateTime().isNull()) {
-      item->setText(7,q->value(13).toDateTime().
-		    toString("MM/dd/yyyy - hh:mm:ss"));
+    if(q->value(1).toUInt()==0) {
+      item->setBackgroundColor(RD_CART_ERROR_COLOR);
     }
     else {
-      item->setText(7,tr("TFN"));
+      validity=ValidateCartRank(q->value(24));
+      UpdateItemColor(item,validity,
+		      q->value(14).toDateTime(),current_datetime);
     }
-    item->setText(16,q->value(15).toString());
-    item->setText(17,q->value(16).toString());
-    item->setText(18,q->value(17).toString());
-    item->setText(19,q->value(18).toString());
-    item->setText(20,q->value(19).toString());
-    item->setText(21,q->value(20).toString());
-    if(q->value(17).toString()=="Y") {
-      item->setTextColor(3,QColor(RDLIBRARY_ENFORCE_LENGTH_COLOR),QFont::Bold);
-    }
-    else {
-      if((q->value(19).toUInt()>RDLIBRARY_MID_LENGTH_LIMIT)&&
-	 (q->value(17).toString()=="N")) {
-	if(q->value(19).toUInt()>RDLIBRARY_MAX_LENGTH_LIMIT) {
-	  item->setTextColor(3,QColor(RDLIBRARY_MAX_LENGTH_COLOR),QFont::Bold);
-	}
-	else {
-	  item->setTextColor(3,QColor(RDLIBRARY_MID_LENGTH_COLOR),QFont::Bold);
-	}
+    break;
+
+  case RDCart::Macro:
+    item->setPixmap(0,*lib_macro_map);
+    UpdateItemColor(item,RDCart::AlwaysValid,
+		    q->value(14).toDateTime(),current_datetime);
+    break;
+
+  case RDCart::All:
+    break;
+  }
+  item->setText(1,QString().sprintf("%06u",q->value(0).toUInt()));
+  item->setText(2,q->value(12).toString());
+  item->setTextColor(2,q->value(23).toString(),QFont::Bold);
+  item->setText(3,RDGetTimeLength(q->value(1).toUInt()));
+  item->setText(4,q->value(2).toString());
+  item->setText(5,q->value(3).toString());
+  if(!q->value(13).toDateTime().isNull()) {
+    item->setText(6,q->value(13).toDateTime().
+		  toString("MM/dd/yyyy - hh:mm:ss"));
+  }
+  else {
+    item->setText(6,"");
+  }
+  if(!q->value(14).toDateTime().isNull()) {
+    item->setText(7,q->value(14).toDateTime().
+		  toString("MM/dd/yyyy - hh:mm:ss"));
+  }
+  else {
+    item->setText(7,tr("TFN"));
+  }
+  item->setText(8,q->value(4).toString());
+  item->setText(9,q->value(5).toString());
+  item->setText(10,q->value(9).toString());
+  item->setText(11,q->value(11).toString());
+  item->setText(12,q->value(10).toString());
+  item->setText(13,q->value(6).toString());
+  item->setText(14,q->value(7).toString());
+  item->setText(15,q->value(8).toString());
+  item->setText(16,q->value(16).toString());
+  item->setText(17,q->value(17).toString());
+  item->setText(18,q->value(18).toString());
+  item->setText(19,q->value(19).toString());
+  item->setText(20,q->value(20).toString());
+  item->setText(21,q->value(21).toString());
+  if(q->value(18).toString()=="Y") {
+    item->setTextColor(3,QColor(RDLIBRARY_ENFORCE_LENGTH_COLOR),QFont::Bold);
+  }
+  else {
+    if((q->value(20).toUInt()>RDLIBRARY_MID_LENGTH_LIMIT)&&
+       (q->value(18).toString()=="N")) {
+      if(q->value(20).toUInt()>RDLIBRARY_MAX_LENGTH_LIMIT) {
+	item->setTextColor(3,QColor(RDLIBRARY_MAX_LENGTH_COLOR),QFont::Bold);
       }
       else {
-	item->setTextColor(3,QColor(black),QFont::Normal);
+	item->setTextColor(3,QColor(RDLIBRARY_MID_LENGTH_COLOR),QFont::Bold);
       }
     }
+    else {
+      item->setTextColor(3,QColor(black),QFont::Normal);
+    }
   }
-  delete q;
 }
 
 
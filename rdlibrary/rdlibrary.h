@@ -34,6 +34,8 @@
 #include <qprogressdialog.h>
 #include <qtimer.h>
 
+#include <set>
+
 #include <rdstation.h>
 #include <rdcart.h>
 #include <rduser.h>
@@ -48,7 +50,11 @@
 #include <cart_tip.h>
 
 #define RDLIBRARY_GEOMETRY_FILE ".rdlibrary"
-#define RDLIBRARY_STEP_SIZE 5000
+
+//
+// Number of carts fetched at a time as the cart list is scrolled
+//
+#define RDLIBRARY_PAGE_SIZE 500
 
 //
 // Cut Length Deviation Values
@@ -89,6 +95,9 @@ class MainWidget : public QWidget
   void searchLimitChangedData(int state);
   void dragsChangedData(int state);
   void notificationReceivedData(RDNotification *notify);
+  void notificationsMissedData(const QString &source);
+  void cartListScrolledData(int value);
+  void cartListSortedData(int section);
   void quitMainWidget();
 
  protected:
@@ -97,8 +106,13 @@ class MainWidget : public QWidget
   
  private:
   void RefreshList();
+  void FetchPage();
+  void FetchAll();
+  QString CartSql(const QDateTime &datetime) const;
   QString WhereClause() const;
   void RefreshLine(RDListViewItem *item);
+  void WriteItem(RDListViewItem *item,RDSqlQuery *q,
+		 const QDateTime &current_datetime);
   void UpdateItemColor(RDListViewItem *item,RDCart::Validity validity,
 		       const QDateTime &end_datetime,
 		       const QDateTime &current_datetime); 
@@ -152,6 +166,10 @@ class MainWidget : public QWidget
   QTimer *lib_user_timer;
   bool lib_resize;
   std::vector<unsigned> lib_deleted_carts;
+  unsigned lib_last_cartnum;
+  int lib_list_count;
+  bool lib_list_complete;
+  std::set<unsigned> lib_added_carts;
 };
 
 
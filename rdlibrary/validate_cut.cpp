@@ -19,6 +19,7 @@
 //
 
 #include <validate_cut.h>
+#include <rdconf.h>
 #include <rddb.h> 
 
 QString ValidateCutFields()
@@ -97,3 +98,44 @@ RDCart::Validity ValidateCut(RDSqlQuery *q,unsigned offset,
 
   return RDCart::AlwaysValid;
 }
+
+
+QString ValidateCartSql(const QDateTime &datetime)
+{
+  //
+  // A subquery that rates the cuts of the cart in CART.NUMBER by the same
+  // rules as ValidateCut() and returns the best of them: 3 for AlwaysValid,
+  // 2 for EvergreenValid, 1 for FutureValid and 0 or NULL for NeverValid.
+  // A cart that has both evergreen and future cuts rates as evergreen,
+  // since it will still play.
+  //
+  QString dt=datetime.toString("yyyy-MM-dd hh:mm:ss");
+  QString t=datetime.time().toString("hh:mm:ss");
+  QString day=RDGetShortDayNameEN(datetime.date().dayOfWeek()).upper();
+
+  return QString("(select max(")+
+    "if(VALID_CUTS.LENGTH<=0,0,"+
+    "if(VALID_CUTS.EVERGREEN=\"Y\",2,"+
+    "if(VALID_CUTS."+day+"!=\"Y\",0,"+
+    "if(VALID_CUTS.START_DATETIME>\""+dt+"\",1,"+
+    "if(VALID_CUTS.END_DATETIME<\""+dt+"\",0,"+
+    "if(VALID_CUTS.START_DAYPART>\""+t+"\",0,"+
+    "if(VALID_CUTS.END_DAYPART<\""+t+"\",0,3)))))))) "+
+    "from CUTS as VALID_CUTS where VALID_CUTS.CART_NUMBER=CART.NUMBER)";
+}
+
+
+RDCart::Validity ValidateCartRank(const QVariant &rank)
+{
+  switch(rank.toInt()) {
+  case 3:
+    return RDCart::AlwaysValid;
+
+  case 2:
+    return RDCart::EvergreenValid;
+
+  case 1:
+    return RDCart::FutureValid;
+  }
+  return RDCart::NeverValid;
+}
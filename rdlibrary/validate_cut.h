@@ -30,5 +30,7 @@ QString ValidateCutFields();
 RDCart::Validity ValidateCut(RDSqlQuery *q,unsigned offset,
 			     RDCart::Validity prev_validity,
 			     const QDateTime &datetime);
+QString ValidateCartSql(const QDateTime &datetime);
+RDCart::Validity ValidateCartRank(const QVariant &rank);
 
 #endif  // VALIDATE_CUT_H
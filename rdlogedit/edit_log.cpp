@@ -34,7 +34,6 @@
 #include <rdadd_log.h>
 #include <rdapplication.h>
 #include <rdconf.h>
-#include <rdcreate_log.h>
 #include <rddatedialog.h>
 #include <rddb.h>
 #include <rddebug.h>
@@ -1093,10 +1092,9 @@ void EditLog::notificationReceivedData(RDNotification *notify)
   RDListViewItem *item=NULL;
 
   if(notify->type()==RDNotification::CartType) {
-    unsigned cartnum=notify->id().toUInt();
     item=(RDListViewItem *)edit_log_list->firstChild();
     while(item!=NULL) {
-      if(item->text(3).toUInt()==cartnum) {
+      if(notify->containsId(QVariant(item->text(3).toUInt()))) {
 	int line=item->text(14).toInt();
 	if(line>=0) {
 	  edit_log_event->refresh(line);
@@ -1158,7 +1156,6 @@ void EditLog::saveasData()
     delete edit_log;
     edit_newlogs->push_back(logname);
     edit_log=new RDLog(logname);
-    RDCreateLogTable(RDLog::tableName(logname),rda->config());
     edit_log_event->setLogName(RDLog::tableName(logname));
     for(int i=0;i<edit_service_box->count();i++) {
       if(edit_service_box->text(i)==svcname) {
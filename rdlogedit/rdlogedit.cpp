@@ -156,6 +156,8 @@ MainWidget::MainWidget(QWidget *parent)
   connect(rda->ripc(),SIGNAL(connected(bool)),this,SLOT(connectedData(bool)));
   connect(rda->ripc(),SIGNAL(notificationReceived(RDNotification *)),
 	  this,SLOT(notificationReceivedData(RDNotification *)));
+  connect(rda->ripc(),SIGNAL(notificationsMissed(const QString &)),
+	  this,SLOT(notificationsMissedData(const QString &)));
   connect(rda,SIGNAL(userChanged()),this,SLOT(userData()));
   rda->ripc()->connectHost("localhost",RIPCD_TCP_PORT,rda->config()->password());
 #else
@@ -700,46 +702,57 @@ void MainWidget::notificationReceivedData(RDNotification *notify)
   ListListViewItem *item=NULL;
 
   if(notify->type()==RDNotification::LogType) {
-    QString logname=notify->id().toString();
-    switch(notify->action()) {
-    case RDNotification::AddAction:
-      sql=QString("select NAME from LOGS where (TYPE=0)&&(LOG_EXISTS=\"Y\")&&")+
-	"(NAME=\""+RDEscapeString(logname)+"\") "+
-	log_filter_widget->whereSql();
-      q=new RDSqlQuery(sql);
-      if(q->first()) {
-	item=new ListListViewItem(log_log_list);
-	item->setText(1,logname);
-	RefreshItem(item);
-      }
-      delete q;
-      break;
-
-    case RDNotification::ModifyAction:
-      if((item=(ListListViewItem *)log_log_list->findItem(logname,1))!=NULL) {
-	RefreshItem(item);
-      }
-      break;
+    for(unsigned i=0;i<notify->idQuantity();i++) {
+      QString logname=notify->id(i).toString();
+      switch(notify->action()) {
+      case RDNotification::AddAction:
+	sql=QString("select NAME from LOGS where (TYPE=0)&&(LOG_EXISTS=\"Y\")&&")+
+	  "(NAME=\""+RDEscapeString(logname)+"\") "+
+	  log_filter_widget->whereSql();
+	q=new RDSqlQuery(sql);
+	if(q->first()) {
+	  item=new ListListViewItem(log_log_list);
+	  item->setText(1,logname);
+	  RefreshItem(item);
+	}
+	delete q;
+	break;
 
-    case RDNotification::DeleteAction:
-      if(log_list_locked) {
-	log_deleted_logs.push_back(logname);
-      }
-      else {
+      case RDNotification::ModifyAction:
 	if((item=(ListListViewItem *)log_log_list->findItem(logname,1))!=NULL) {
-	  delete item;
+	  RefreshItem(item);
 	}
-      }
-      break;
+	break;
 
-    case RDNotification::NoAction:
-    case RDNotification::LastAction:
-      break;
+      case RDNotification::DeleteAction:
+	if(log_list_locked) {
+	  log_deleted_logs.push_back(logname);
+	}
+	else {
+	  if((item=(ListListViewItem *)log_log_list->findItem(logname,1))!=
+	     NULL) {
+	    delete item;
+	  }
+	}
+	break;
+
+      case RDNotification::NoAction:
+      case RDNotification::LastAction:
+	break;
+      }
     }
   }
 }
 
 
+void MainWidget::notificationsMissedData(const QString &source)
+{
+  if(!log_list_locked) {
+    RefreshList();
+  }
+}
+
+
 void MainWidget::quitMainWidget()
 {
   exit(0);
@@ -63,6 +63,7 @@ class MainWidget : public QMainWindow
   void logSelectionChangedData();
   void logDoubleclickedData(QListViewItem *item,const QPoint &pt,int col);
   void notificationReceivedData(RDNotification *notify);
+  void notificationsMissedData(const QString &source);
   void quitMainWidget();
 
  protected:
@@ -169,6 +169,8 @@ VoiceTracker::VoiceTracker(const QString &logname,QString *import_path,
   //
   connect(rda->ripc(),SIGNAL(notificationReceived(RDNotification *)),
 	  this,SLOT(notificationReceivedData(RDNotification *)));
+  connect(rda->peaksCache(),SIGNAL(peaksLoaded(const QString &)),
+	  this,SLOT(peaksLoadedData(const QString &)));
 
   //
   // Waveform Pixmaps
@@ -1982,10 +1984,9 @@ void VoiceTracker::notificationReceivedData(RDNotification *notify)
   RDListViewItem *item=NULL;
 
   if(notify->type()==RDNotification::CartType) {
-    unsigned cartnum=notify->id().toUInt();
     item=(RDListViewItem *)track_log_list->firstChild();
     while(item!=NULL) {
-      if(item->text(3).toUInt()==cartnum) {
+      if(notify->containsId(QVariant(item->text(3).toUInt()))) {
 	track_log_event->refresh(item->line());
 	RefreshLine(item);
       }
@@ -1995,6 +1996,18 @@ void VoiceTracker::notificationReceivedData(RDNotification *notify)
 }
 
 
+void VoiceTracker::peaksLoadedData(const QString &cutname)
+{
+  for(int i=0;i<3;i++) {
+    if((!edit_wave_name[i].isEmpty())&&(edit_track_cuts[i]!=NULL)&&
+       (wpg[i]!=NULL)&&(edit_track_cuts[i]->cutName()==cutname)) {
+      DrawTrackMap(i);
+      WriteTrackMap(i);
+    }
+  }
+}
+
+
 void VoiceTracker::closeData()
 {
   stopData();
@@ -123,6 +123,7 @@ class VoiceTracker : public QDialog
   void recordStoppedData(int card,int stream);
   void recordUnloadedData(int cart,int stream,unsigned msecs);
   void notificationReceivedData(RDNotification *notify);
+  void peaksLoadedData(const QString &cutname);
   void closeData();
 
  protected:
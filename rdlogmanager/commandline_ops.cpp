@@ -18,7 +18,14 @@
 //   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
 //
 
+#include <errno.h>
 #include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+
+#include <map>
 
 #include <qapplication.h>
 #include <qfile.h>
@@ -34,6 +41,73 @@
 
 #include <rdlogmanager.h>
 #include <globals.h>
+#include <logobject.h>
+
+int RunLogBatch(int argc,char *argv[],const QStringList &svcnames,
+		int start_offset,int end_offset,bool protect_existing,
+		bool gen_log,bool merge_mus,bool merge_tfc,bool show_timing,
+		unsigned jobs)
+{
+  std::map<pid_t,QString> running;
+  unsigned next=0;
+  int status;
+  pid_t pid;
+  QTime elapsed;
+  int ret=0;
+
+  //
+  // Each service is handed to its own process, with its own database
+  // connection, and up to 'jobs' of them run at once.  A service's days
+  // are still done in order by its worker, since the scheduler stack is
+  // per service.
+  //
+  elapsed.start();
+  fflush(stdout);
+  while((next<svcnames.size())||(running.size()>0)) {
+    while((next<svcnames.size())&&(running.size()<jobs)) {
+      if((pid=fork())==0) {
+	QApplication a(argc,argv,false);
+	new LogObject(svcnames[next],start_offset,end_offset,protect_existing,
+		      gen_log,merge_mus,merge_tfc,show_timing);
+	exit(a.exec());
+      }
+      if(pid<0) {
+	fprintf(stderr,
+		"rdlogmanager: unable to start worker for \"%s\" [%s]\n",
+		(const char *)svcnames[next].utf8(),strerror(errno));
+	ret=256;
+      }
+      else {
+	running[pid]=svcnames[next];
+      }
+      next++;
+    }
+    if(running.size()==0) {
+      break;
+    }
+    if((pid=waitpid(-1,&status,0))<0) {
+      if(errno==EINTR) {
+	continue;
+      }
+      break;
+    }
+    if(running.find(pid)!=running.end()) {
+      if((!WIFEXITED(status))||(WEXITSTATUS(status)!=0)) {
+	fprintf(stderr,"rdlogmanager: processing \"%s\" failed\n",
+		(const char *)running[pid].utf8());
+	ret=256;
+      }
+      running.erase(pid);
+    }
+  }
+  if(show_timing) {
+    fprintf(stderr,"rdlogmanager: processed %u services in %d mS [%u jobs]\n",
+	    svcnames.size(),elapsed.elapsed(),jobs);
+  }
+
+  return ret;
+}
+
 
 int RunReportOperation(int argc,char *argv[],const QString &rptname,
 		       bool protect_existing,int start_offset,int end_offset)
@@ -282,6 +282,7 @@ void ListClocks::addData()
       q=new RDSqlQuery(sql);
       delete q;
     }
+    SendNotification(RDNotification::AddAction,clockname,&new_clocks);
     QListViewItem *item=new QListViewItem(edit_clocks_list);
     item->setText(0,clockname);
     RefreshItem(item,&new_clocks);
@@ -304,6 +305,7 @@ void ListClocks::editData()
     return;
   }
   delete clock_dialog;
+  SendNotification(RDNotification::ModifyAction,item->text(0),&new_clocks);
   RefreshItem(item,&new_clocks);
 }
 
@@ -416,6 +418,8 @@ void ListClocks::renameData()
 			(const char *)item->text(0));
   q=new RDSqlQuery(sql);
   delete q;
+  SendNotification(RDNotification::DeleteAction,item->text(0));
+  SendNotification(RDNotification::AddAction,new_name);
 
   item->setText(0,new_name);
   RefreshItem(item);
@@ -633,6 +637,7 @@ void ListClocks::DeleteClock(QString clockname)
   delete q;
   rda->dropTable(base_name+"_CLK");
   rda->dropTable(base_name+"_RULES");
+  SendNotification(RDNotification::DeleteAction,clockname);
 }
 
 
@@ -682,3 +687,29 @@ QString ListClocks::GetNoneFilter()
   return filter;
 }
 
+
+void ListClocks::SendNotification(RDNotification::Action action,
+				  const QString &name,
+				  std::vector<QString> *new_clocks)
+{
+  RDNotification *notify=NULL;
+
+  rda->ripc()->beginNotificationBatch();
+  notify=new RDNotification(RDNotification::ClockType,action,QVariant(name));
+  rda->ripc()->sendNotification(*notify);
+  delete notify;
+
+  //
+  // Copies saved from the editor
+  //
+  if(new_clocks!=NULL) {
+    for(unsigned i=0;i<new_clocks->size();i++) {
+      notify=new RDNotification(RDNotification::ClockType,
+				RDNotification::AddAction,
+				QVariant(new_clocks->at(i)));
+      rda->ripc()->sendNotification(*notify);
+      delete notify;
+    }
+  }
+  rda->ripc()->endNotificationBatch();
+}
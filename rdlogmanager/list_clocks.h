@@ -33,6 +33,7 @@
 #include <rduser.h>
 #include <rdmatrix.h>
 #include <rddb.h>
+#include <rdnotification.h>
 
 class ListClocks : public QDialog
 {
@@ -65,6 +66,8 @@ class ListClocks : public QDialog
   void WriteItem(QListViewItem *item,RDSqlQuery *q);
   int ActiveClocks(QString clockname,QString *svc_list);
   void DeleteClock(QString clockname);
+  void SendNotification(RDNotification::Action action,const QString &name,
+			std::vector<QString> *new_clocks=NULL);
   QString GetClockFilter(QString svc_name);
   QString GetNoneFilter();
   QListView *edit_clocks_list;
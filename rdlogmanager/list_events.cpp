@@ -253,6 +253,7 @@ void ListEvents::addData()
     }
   }
   delete event_dialog;
+  SendNotification(RDNotification::AddAction,logname,&new_events);
   QListViewItem *item=new QListViewItem(edit_events_list);
   item->setText(0,logname);
   RefreshItem(item,&new_events);
@@ -275,6 +276,7 @@ void ListEvents::editData()
     return;
   }
   delete event_dialog;
+  SendNotification(RDNotification::ModifyAction,item->text(0),&new_events);
   RefreshItem(item,&new_events);
 }
 
@@ -390,6 +392,8 @@ void ListEvents::renameData()
 			(const char *)item->text(0));
   q=new RDSqlQuery(sql);
   delete q;
+  SendNotification(RDNotification::DeleteAction,item->text(0));
+  SendNotification(RDNotification::AddAction,new_name);
 
   item->setText(0,new_name);
   RefreshItem(item);
@@ -600,6 +604,7 @@ void ListEvents::DeleteEvent(QString event_name)
   delete q;
   rda->dropTable(base_name+"_PRE");
   rda->dropTable(base_name+"_POST");
+  SendNotification(RDNotification::DeleteAction,event_name);
 }
 
 
@@ -648,3 +653,30 @@ QString ListEvents::GetNoneFilter()
 
   return filter;
 }
+
+
+void ListEvents::SendNotification(RDNotification::Action action,
+				  const QString &name,
+				  std::vector<QString> *new_events)
+{
+  RDNotification *notify=NULL;
+
+  rda->ripc()->beginNotificationBatch();
+  notify=new RDNotification(RDNotification::EventType,action,QVariant(name));
+  rda->ripc()->sendNotification(*notify);
+  delete notify;
+
+  //
+  // Copies saved from the editor
+  //
+  if(new_events!=NULL) {
+    for(unsigned i=0;i<new_events->size();i++) {
+      notify=new RDNotification(RDNotification::EventType,
+				RDNotification::AddAction,
+				QVariant(new_events->at(i)));
+      rda->ripc()->sendNotification(*notify);
+      delete notify;
+    }
+  }
+  rda->ripc()->endNotificationBatch();
+}
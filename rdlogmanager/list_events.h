@@ -33,6 +33,7 @@
 #include <rduser.h>
 #include <rdmatrix.h>
 #include <rddb.h>
+#include <rdnotification.h>
 
 class ListEvents : public QDialog
 {
@@ -64,6 +65,8 @@ class ListEvents : public QDialog
   void WriteItem(QListViewItem *item,RDSqlQuery *q);
   int ActiveEvents(QString event_name,QString *clock_list);
   void DeleteEvent(QString event_name);
+  void SendNotification(RDNotification::Action action,const QString &name,
+			std::vector<QString> *new_events=NULL);
   QString GetEventFilter(QString svc_name);
   QString GetNoneFilter();
   QListView *edit_events_list;
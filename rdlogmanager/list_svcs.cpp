@@ -21,6 +21,7 @@
 #include <qmessagebox.h>
 #include <qdatetime.h>
 
+#include <rdescape_string.h>
 #include <rdlog.h>
 #include <rddb.h>
 #include <list_svcs.h>
@@ -153,7 +154,6 @@ void ListSvcs::resizeEvent(QResizeEvent *e)
 void ListSvcs::RefreshList()
 {
   RDSqlQuery *q1;
-  QString tablename;
   QListViewItem *item;
   list_log_list->clear();
   QString sql="select NAME from SERVICES order by NAME";
@@ -162,10 +162,9 @@ void ListSvcs::RefreshList()
   while(q->next()) {
     item=new QListViewItem(list_log_list);
     item->setText(0,q->value(0).toString());
-    tablename=q->value(0).toString();
-    tablename.replace(" ","_");
-    sql=QString().sprintf("select EVENT_DATETIME from `%s_SRT` \
-                           order by EVENT_DATETIME",(const char *)tablename);
+    sql=QString("select EVENT_DATETIME from ELR_LINES where ")+
+      "SERVICE_NAME=\""+RDEscapeString(q->value(0).toString())+"\" "+
+      "order by EVENT_DATETIME limit 1";
     q1=new RDSqlQuery(sql);
     if(q1->first()) {
       item->setText(1,q1->value(0).toDate().toString("MM/dd/yyyy"));
@@ -183,16 +182,16 @@ void ListSvcs::RefreshLine(QListViewItem *item)
 {
   QString sql;
   RDSqlQuery *q;
-  QString tablename=item->text(0);
-    tablename.replace(" ","_");
-    sql=QString().sprintf("select EVENT_DATETIME from `%s_SRT` \
-                           order by EVENT_DATETIME",(const char *)tablename);
-    q=new RDSqlQuery(sql);
-    if(q->first()) {
-      item->setText(1,q->value(0).toDate().toString("MM/dd/yyyy"));
-    }
-    else {
-      item->setText(1,tr("[none]"));
-    }
-    delete q;
+
+  sql=QString("select EVENT_DATETIME from ELR_LINES where ")+
+    "SERVICE_NAME=\""+RDEscapeString(item->text(0))+"\" "+
+    "order by EVENT_DATETIME limit 1";
+  q=new RDSqlQuery(sql);
+  if(q->first()) {
+    item->setText(1,q->value(0).toDate().toString("MM/dd/yyyy"));
+  }
+  else {
+    item->setText(1,tr("[none]"));
+  }
+  delete q;
 }
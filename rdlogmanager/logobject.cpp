@@ -30,19 +30,24 @@
 
 #include "logobject.h"
 
-LogObject::LogObject(const QString &svcname,int start_offset,
+LogObject::LogObject(const QString &svcname,int start_offset,int end_offset,
 		     bool protect_existing,bool gen_log,bool merge_mus,
-		     bool merge_tfc,QObject *parent)
+		     bool merge_tfc,bool show_timing,QObject *parent)
   : QObject(parent)
 {
   QString err_msg;
 
   log_service_name=svcname;
   log_start_offset=start_offset;
+  log_end_offset=end_offset;
+  if(log_end_offset<log_start_offset) {
+    log_end_offset=log_start_offset;
+  }
   log_protect_existing=protect_existing;
   log_generate_log=gen_log;
   log_merge_music=merge_mus;
   log_merge_traffic=merge_tfc;
+  log_show_timing=show_timing;
 
   //
   // Open the Database
@@ -61,149 +66,173 @@ LogObject::LogObject(const QString &svcname,int start_offset,
 
 void LogObject::userData()
 {
-  QString err_msg;
-  QString sql;
-  RDSqlQuery *q;
-  QString report;
-  QString unused_report;
-  QString svcname_table=log_service_name;
-  svcname_table.replace(" ","_");
+  int ret=0;
 
   if(rda->user()->createLog()) {
-    //
-    // Some Basic Structures
-    //
     RDSvc *svc=new RDSvc(log_service_name,rda->station(),rda->config());
     if(!svc->exists()) {
       fprintf(stderr,"rdlogmanager: no such service\n");
       exit(256);
     }
-    QDate start_date=QDate::currentDate().addDays(1+log_start_offset);
-    QString logname=
-      RDDateDecode(svc->nameTemplate(),start_date,rda->station(),rda->config(),
-		   svc->name());
-    RDLog *log=new RDLog(logname);
+    srand(QTime::currentTime().msec());
 
     //
-    // Generate Log
+    // Days are done in order, as each one's scheduler picks depend upon
+    // the stack left by the one before.
     //
-    if(log_generate_log) {
-      if(log_protect_existing&&log->exists()) {
-	fprintf(stderr,"log \"%s\" already exists\n",
-		(const char *)log->name().utf8());
-	exit(256);
+    for(int i=log_start_offset;i<=log_end_offset;i++) {
+      if((ret=RunDate(svc,QDate::currentDate().addDays(1+i)))!=0) {
+	exit(ret);
       }
-      SendNotification(RDNotification::DeleteAction,log->name());
-      log->removeTracks(rda->station(),rda->user(),rda->config());
-      srand(QTime::currentTime().msec());
-      sql=RDCreateStackTableSql(svcname_table,rda->config());
-      q=new RDSqlQuery(sql);
-      if(!q->isActive()) {
-	fprintf(stderr,"SQL: %s\n",(const char *)sql);
-	fprintf(stderr,"SQL Error: %s\n",
-		(const char *)q->lastError().databaseText());
-      }
-      delete q;
-      if(!svc->generateLog(start_date,
-			   RDDateDecode(svc->nameTemplate(),start_date,
-				   rda->station(),rda->config(),svc->name()),
-			   RDDateDecode(svc->nameTemplate(),start_date.addDays(1),
-				   rda->station(),rda->config(),svc->name()),
-			   &unused_report,rda->user(),&err_msg)) {
-	fprintf(stderr,"rdlogmanager: %s\n",(const char *)err_msg);
-	exit(256);
-      }
-      log->updateTracks();
-      SendNotification(RDNotification::AddAction,log->name());
-
-      //
-      // Generate Exception Report
-      //
-      RDLogEvent *event=
-	new RDLogEvent(QString().sprintf("%s_LOG",(const char *)logname));
-      event->load();
-      if((event->validate(&report,start_date)!=0)||
-	 (!unused_report.isEmpty())) {
-	printf("%s\n\n%s",(const char*)report,(const char*)unused_report);
-      }
-      delete event;
     }
+    delete svc;
+    exit(0);
+  }
+  fprintf(stderr,"rdlogmanager: insufficient permissions\n");
+  exit(1);
+}
 
-    //
-    // Merge Music
-    //
-    if(log_merge_music) {
-      if(!log->exists()) {
-	fprintf(stderr,"rdlogmanager: log does not exist\n");
-	exit(256);
-      }
-      if(log_protect_existing&&
-	 (log->linkState(RDLog::SourceMusic)==RDLog::LinkDone)) {
-	fprintf(stderr,
-		"rdlogmanager: music for log \"%s\" is already imported\n",
-		(const char *)log->name().utf8());
-	exit(256);
-      }
-      report="";
-      log->removeTracks(rda->station(),rda->user(),rda->config());
-      if(!svc->clearLogLinks(RDSvc::Traffic,logname,rda->user(),&err_msg)) {
-	fprintf(stderr,"rdlogmanager: %s\n",(const char *)err_msg);
-	exit(256);
-      }
-      if(!svc->clearLogLinks(RDSvc::Music,logname,rda->user(),&err_msg)) {
-	fprintf(stderr,"rdlogmanager: %s\n",(const char *)err_msg);
-	exit(256);
-      }
-      if(svc->linkLog(RDSvc::Music,start_date,logname,&report,rda->user(),
-		      &err_msg)) {
-	printf("%s\n",(const char*)report);
-      }
-      else {
-	fprintf(stderr,"rdlogmanager: %s\n",(const char *)err_msg);
-	exit(256);
-      }
-      SendNotification(RDNotification::ModifyAction,log->name());
+
+int LogObject::RunDate(RDSvc *svc,const QDate &start_date)
+{
+  QString err_msg;
+  QString sql;
+  RDSqlQuery *q;
+  QString report;
+  QString unused_report;
+  QString svcname_table=log_service_name;
+  svcname_table.replace(" ","_");
+
+  QString logname=
+    RDDateDecode(svc->nameTemplate(),start_date,rda->station(),rda->config(),
+		 svc->name());
+  RDLog *log=new RDLog(logname);
+
+  //
+  // Generate Log
+  //
+  if(log_generate_log) {
+    if(log_protect_existing&&log->exists()) {
+      fprintf(stderr,"log \"%s\" already exists\n",
+	      (const char *)log->name().utf8());
+      return 256;
+    }
+    SendNotification(RDNotification::DeleteAction,log->name());
+    log->removeTracks(rda->station(),rda->user(),rda->config());
+    sql=RDCreateStackTableSql(svcname_table,rda->config());
+    q=new RDSqlQuery(sql);
+    if(!q->isActive()) {
+      fprintf(stderr,"SQL: %s\n",(const char *)sql);
+      fprintf(stderr,"SQL Error: %s\n",
+	      (const char *)q->lastError().databaseText());
+    }
+    delete q;
+    if(!svc->generateLog(start_date,
+			 RDDateDecode(svc->nameTemplate(),start_date,
+				      rda->station(),rda->config(),svc->name()),
+			 RDDateDecode(svc->nameTemplate(),start_date.addDays(1),
+				      rda->station(),rda->config(),svc->name()),
+			 &unused_report,rda->user(),&err_msg)) {
+      fprintf(stderr,"rdlogmanager: %s\n",(const char *)err_msg);
+      return 256;
     }
+    if(log_show_timing) {
+      fprintf(stderr,"rdlogmanager: generated log \"%s\": %s\n",
+	      (const char *)logname.utf8(),
+	      (const char *)svc->generationTimes());
+    }
+    log->updateTracks();
+    SendNotification(RDNotification::AddAction,log->name());
 
     //
-    // Merge Traffic
+    // Generate Exception Report
     //
-    if(log_merge_traffic) {
-      if(!log->exists()) {
-	fprintf(stderr,"rdlogmanager: log does not exist\n");
-	exit(256);
-      }
-      if(log_protect_existing&&
-	 (log->linkState(RDLog::SourceTraffic)==RDLog::LinkDone)) {
-	fprintf(stderr,
-		"rdlogmanager: traffic for log \"%s\" is already imported\n",
-		(const char *)log->name().utf8());
-	exit(256);
-      }
-      report="";
-      if(!svc->clearLogLinks(RDSvc::Traffic,logname,rda->user(),&err_msg)) {
-	fprintf(stderr,"rdlogmanager: %s\n",(const char *)err_msg);
-	exit(256);
-      }
-      if(svc->linkLog(RDSvc::Traffic,start_date,logname,&report,rda->user(),
-		      &err_msg)) {
-	printf("%s\n",(const char*)report);
-      }
-      else {
-	fprintf(stderr,"rdlogmanager: %s\n",(const char *)err_msg);
+    RDLogEvent *event=
+      new RDLogEvent(QString().sprintf("%s_LOG",(const char *)logname));
+    event->load();
+    if((event->validate(&report,start_date)!=0)||
+       (!unused_report.isEmpty())) {
+      printf("%s\n\n%s",(const char*)report,(const char*)unused_report);
+    }
+    delete event;
+  }
+
+  //
+  // Merge Music
+  //
+  if(log_merge_music) {
+    if(!log->exists()) {
+      fprintf(stderr,"rdlogmanager: log does not exist\n");
+      return 256;
+    }
+    if(log_protect_existing&&
+       (log->linkState(RDLog::SourceMusic)==RDLog::LinkDone)) {
+      fprintf(stderr,
+	      "rdlogmanager: music for log \"%s\" is already imported\n",
+	      (const char *)log->name().utf8());
+      return 256;
+    }
+    report="";
+    log->removeTracks(rda->station(),rda->user(),rda->config());
+    if(!svc->clearLogLinks(RDSvc::Traffic,logname,rda->user(),&err_msg)) {
+      fprintf(stderr,"rdlogmanager: %s\n",(const char *)err_msg);
+      return 256;
+    }
+    if(!svc->clearLogLinks(RDSvc::Music,logname,rda->user(),&err_msg)) {
+      fprintf(stderr,"rdlogmanager: %s\n",(const char *)err_msg);
+      return 256;
+    }
+    if(svc->linkLog(RDSvc::Music,start_date,logname,&report,rda->user(),
+		    &err_msg)) {
+      printf("%s\n",(const char*)report);
+      if(log_show_timing) {
+	fprintf(stderr,"rdlogmanager: merged music into \"%s\": %s\n",
+		(const char *)logname.utf8(),(const char *)svc->linkTimes());
       }
-      SendNotification(RDNotification::ModifyAction,log->name());
     }
+    else {
+      fprintf(stderr,"rdlogmanager: %s\n",(const char *)err_msg);
+      return 256;
+    }
+    SendNotification(RDNotification::ModifyAction,log->name());
+  }
 
-    //
-    // Clean Up
-    //
-    delete log;
-    delete svc;
-    exit(0);
+  //
+  // Merge Traffic
+  //
+  if(log_merge_traffic) {
+    if(!log->exists()) {
+      fprintf(stderr,"rdlogmanager: log does not exist\n");
+      return 256;
+    }
+    if(log_protect_existing&&
+       (log->linkState(RDLog::SourceTraffic)==RDLog::LinkDone)) {
+      fprintf(stderr,
+	      "rdlogmanager: traffic for log \"%s\" is already imported\n",
+	      (const char *)log->name().utf8());
+      return 256;
+    }
+    report="";
+    if(!svc->clearLogLinks(RDSvc::Traffic,logname,rda->user(),&err_msg)) {
+      fprintf(stderr,"rdlogmanager: %s\n",(const char *)err_msg);
+      return 256;
+    }
+    if(svc->linkLog(RDSvc::Traffic,start_date,logname,&report,rda->user(),
+		    &err_msg)) {
+      printf("%s\n",(const char*)report);
+      if(log_show_timing) {
+	fprintf(stderr,"rdlogmanager: merged traffic into \"%s\": %s\n",
+		(const char *)logname.utf8(),(const char *)svc->linkTimes());
+      }
+    }
+    else {
+      fprintf(stderr,"rdlogmanager: %s\n",(const char *)err_msg);
+    }
+    SendNotification(RDNotification::ModifyAction,log->name());
   }
-  fprintf(stderr,"rdlogmanager: insufficient permissions\n");
-  exit(1);
+  delete log;
+
+  return 0;
 }
 
 
@@ -24,25 +24,30 @@
 #include <qobject.h>
 
 #include <rdnotification.h>
+#include <rdsvc.h>
 
 class LogObject : public QObject
 {
  Q_OBJECT
  public:
- LogObject(const QString &svcname,int start_offset,bool protect_existing,
-	   bool gen_log,bool merge_mus,bool merge_tfc,QObject *parent=0);
+ LogObject(const QString &svcname,int start_offset,int end_offset,
+	   bool protect_existing,bool gen_log,bool merge_mus,bool merge_tfc,
+	   bool show_timing,QObject *parent=0);
   
  private slots:
   void userData();
 
  private:
+  int RunDate(RDSvc *svc,const QDate &start_date);
   void SendNotification(RDNotification::Action action,const QString &logname);
   QString log_service_name;
   int log_start_offset;
+  int log_end_offset;
   bool log_protect_existing;
   bool log_generate_log;
   bool log_merge_music;
   bool log_merge_traffic;
+  bool log_show_timing;
 };
 
 
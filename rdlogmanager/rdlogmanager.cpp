@@ -368,7 +368,10 @@ int main(int argc,char *argv[])
   bool cmd_generate=false;
   bool cmd_merge_music=false;
   bool cmd_merge_traffic=false;
-  QString cmd_service=NULL;
+  bool cmd_timing=false;
+  QStringList cmd_services;
+  unsigned cmd_jobs=1;
+  bool ok=false;
   QString cmd_report=NULL;
   int cmd_start_offset=0;
   int cmd_end_offset=0;
@@ -396,10 +399,22 @@ int main(int argc,char *argv[])
     if(cmd->key(i)=="--skip-db-check") {
       cmd->setProcessed(i,true);
     }
+    if(cmd->key(i)=="--timing") {
+      cmd_timing=true;
+      cmd->setProcessed(i,true);
+    }
+    if(cmd->key(i)=="--jobs") {
+      cmd_jobs=cmd->value(i).toUInt(&ok);
+      if((!ok)||(cmd_jobs==0)) {
+	fprintf(stderr,"rdlogmanager: invalid --jobs value\n");
+	exit(2);
+      }
+      cmd->setProcessed(i,true);
+    }
     if(cmd->key(i)=="-s") {
       if((i+1)<cmd->keys()) {
 	i++;
-	cmd_service = cmd->key(i);
+	cmd_services.push_back(cmd->key(i));
       }
       else {
 	fprintf(stderr,"rdlogmanager: missing argument to \"-s\"\n");
@@ -455,9 +470,15 @@ int main(int argc,char *argv[])
   }
 
   if(cmd_generate||cmd_merge_traffic||cmd_merge_music) {
+    if(cmd_services.size()>1) {
+      return RunLogBatch(argc,argv,cmd_services,cmd_start_offset,
+			 cmd_end_offset,cmd_protect_existing,cmd_generate,
+			 cmd_merge_music,cmd_merge_traffic,cmd_timing,cmd_jobs);
+    }
     QApplication a(argc,argv,false);
-    new LogObject(cmd_service,cmd_start_offset,cmd_protect_existing,
-		  cmd_generate,cmd_merge_music,cmd_merge_traffic);
+    new LogObject(cmd_services.size()==0?QString():cmd_services[0],
+		  cmd_start_offset,cmd_end_offset,cmd_protect_existing,
+		  cmd_generate,cmd_merge_music,cmd_merge_traffic,cmd_timing);
     return a.exec();
  }
   if(!cmd_report.isEmpty()) {
@@ -28,17 +28,19 @@
 #include <qlistview.h>
 #include <qpushbutton.h>
 #include <qpixmap.h>
+#include <qstringlist.h>
 
 #include <rdlog_line.h>
 
-#define RDLOGMANAGER_USAGE "[-P] [-g] [-m] [-t] [-r <rpt-name>] [-d <days>] [-e <days>] -s <svc-name>\n\n-P\n     Do not overwrite existing logs or imports.\n\n-g\n     Generate a new log for the specified service.\n\n-m\n     Merge the Music log for the specified service.\n\n-t\n     Merge the Traffic log for the specified service.\n\n-r <rpt-name>\n     Generate report <rpt-name>.\n\n-d <days>\n     Specify a start date offset.  For log operations, this will be added\n     to tomorrow's date to arrive at a target date, whereas for report\n     operations it will be added to yesterday's date to arrive at a target\n     date.  Default value is '0'.\n\n-e <days>\n     Specify an end date offset.  This will be added to yesterday's date\n     to arrive at a target end date.  Valid only for certain report types.\n     Default value is '0'.\n\n-s <service-name>\n     Specify service <service-name> for log operations.\n\n"
+#define RDLOGMANAGER_USAGE "[-P] [-g] [-m] [-t] [-r <rpt-name>] [-d <days>] [-e <days>] [--jobs=<n>] [--timing] -s <svc-name> [-s <svc-name>] ...\n\n-P\n     Do not overwrite existing logs or imports.\n\n-g\n     Generate a new log for the specified service.\n\n-m\n     Merge the Music log for the specified service.\n\n-t\n     Merge the Traffic log for the specified service.\n\n-r <rpt-name>\n     Generate report <rpt-name>.\n\n-d <days>\n     Specify a start date offset.  For log operations, this will be added\n     to tomorrow's date to arrive at a target date, whereas for report\n     operations it will be added to yesterday's date to arrive at a target\n     date.  Default value is '0'.\n\n-e <days>\n     Specify an end date offset.  For log operations, this will be added\n     to tomorrow's date to arrive at the last target date, and each day\n     from the start date through it will be processed in turn.  For report\n     operations, it will be added to yesterday's date to arrive at a target\n     end date (valid only for certain report types).  Default value is '0'.\n\n-s <service-name>\n     Specify service <service-name> for log operations.  May be given\n     more than once to process several services in one run.\n\n--jobs=<n>\n     Process up to <n> services at the same time, each in its own\n     process.  The days of any one service are always done in order.\n     Default value is '1'.\n\n--timing\n     Print the time spent in each phase of log generation and of music\n     and traffic merges to standard error.\n\n"
 
 //
 // Command Line Operations
 //
-extern int RunLogOperation(int argc,char *argv[],const QString &svcname,
-			   int start_offset,bool protect_existing,bool gen_log,
-			   bool merge_mus,bool merge_tfc);
+extern int RunLogBatch(int argc,char *argv[],const QStringList &svcnames,
+		       int start_offset,int end_offset,bool protect_existing,
+		       bool gen_log,bool merge_mus,bool merge_tfc,
+		       bool show_timing,unsigned jobs);
 extern int RunReportOperation(int argc,char *argv[],const QString &rptname,
 			      bool protect_existing,int start_offset,
 			      int end_offset);
@@ -23,6 +23,7 @@
 #include <qlabel.h>
 #include <qpalette.h>
 #include <rddb.h>
+#include <rdescape_string.h>
 #include <svc_rec.h>
 
 //
@@ -46,14 +47,12 @@ SvcRec::SvcRec(const QString &svcname,QWidget *parent)
   //
   // Generate Date Boundaries
   //
-  pick_tablename=svcname;
-  pick_tablename.replace(" ","_");
   QDate current_date=QDate::currentDate();
   pick_high_year=current_date.year();
   pick_low_year=pick_high_year;
-  sql=QString().sprintf("select EVENT_DATETIME from `%s_SRT`\
-                         order by EVENT_DATETIME",
-			(const char *)pick_tablename);
+  sql=QString("select EVENT_DATETIME from ELR_LINES where ")+
+    "SERVICE_NAME=\""+RDEscapeString(pick_service_name)+"\" "+
+    "order by EVENT_DATETIME limit 1";
   q=new RDSqlQuery(sql);
   if(q->first()) {
     pick_low_year=q->value(0).toDate().year();
@@ -214,14 +213,10 @@ void SvcRec::deleteDay()
   QString sql;
   RDSqlQuery *q;
 
-  QString tablename=pick_service_name;
-  tablename.replace(" ","_");
-  sql=QString().sprintf("delete from `%s_SRT` where \
-                         (EVENT_DATETIME>=\"%s\")&&\
-                         (EVENT_DATETIME<=\"%s\")",
-			(const char *)tablename,
-			(const char *)date().toString("yyyy-MM-dd 00:00:00"),
-			(const char *)date().toString("yyyy-MM-dd 23:59:59"));
+  sql=QString("delete from ELR_LINES where ")+
+    "(SERVICE_NAME=\""+RDEscapeString(pick_service_name)+"\")&&"+
+    "(EVENT_DATETIME>=\""+date().toString("yyyy-MM-dd 00:00:00")+"\")&&"+
+    "(EVENT_DATETIME<=\""+date().toString("yyyy-MM-dd 23:59:59")+"\")";
   q=new RDSqlQuery(sql);
   delete q;
   GetActiveDays(pick_date);
@@ -403,16 +398,21 @@ void SvcRec::GetActiveDays(const QDate &date)
   QString sql;
   RDSqlQuery *q;
 
-  for(int i=0;i<=31;i++) {
-    sql=QString().sprintf("select ID from `%s_SRT` where \
-                           (EVENT_DATETIME>=\"%s-%02d 00:00:00\")&&\
-                           (EVENT_DATETIME<=\"%s-%02d 23:59:59\")",
-			  (const char *)pick_tablename,
-			  (const char *)date.toString("yyyy-MM"),i+1,
-			  (const char *)date.toString("yyyy-MM"),i+1);
-    q=new RDSqlQuery(sql);
-    pick_active_days[i]=q->first();
-    delete q;
+  for(int i=0;i<31;i++) {
+    pick_active_days[i]=false;
   }
+  QDate first=QDate(date.year(),date.month(),1);
+  sql=QString("select distinct dayofmonth(EVENT_DATETIME) from ELR_LINES ")+
+    "where (SERVICE_NAME=\""+RDEscapeString(pick_service_name)+"\")&&"+
+    "(EVENT_DATETIME>=\""+first.toString("yyyy-MM-dd")+" 00:00:00\")&&"+
+    "(EVENT_DATETIME<=\""+first.addDays(first.daysInMonth()-1).
+    toString("yyyy-MM-dd")+" 23:59:59\")";
+  q=new RDSqlQuery(sql);
+  while(q->next()) {
+    if((q->value(0).toInt()>=1)&&(q->value(0).toInt()<=31)) {
+      pick_active_days[q->value(0).toInt()-1]=true;
+    }
+  }
+  delete q;
 }
 
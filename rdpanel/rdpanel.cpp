@@ -109,6 +109,7 @@ MainWidget::MainWidget(QWidget *parent)
     QMessageBox::critical(this,"RDPanel - "+tr("Error"),err_msg);
     exit(1);
   }
+  rda->cutRotation()->setEnabled(true);
 
   //
   // Read Command Options
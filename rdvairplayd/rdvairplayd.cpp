@@ -73,6 +73,7 @@ MainObject::MainObject(QObject *parent)
     fprintf(stderr,"rdvairplayd: %s\n",(const char *)err_msg);
     exit(1);
   }
+  rda->cutRotation()->setEnabled(true);
   air_previous_exit_code=rda->airplayConf()->virtualExitCode();
   rda->airplayConf()->setVirtualExitCode(RDAirPlayConf::ExitDirty);
 
@@ -351,6 +352,7 @@ void MainObject::exitData()
     for(int i=0;i<RD_RDVAIRPLAY_LOG_QUAN;i++) {
       delete air_logs[i];
     }
+    rda->cutRotation()->flush();
     rda->airplayConf()->setVirtualExitCode(RDAirPlayConf::ExitClean);
     rda->log(RDConfig::LogInfo,"exiting");
     exit(0);
@@ -37,6 +37,8 @@
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <sys/wait.h>
+#include <sys/ioctl.h>
+#include <linux/sockios.h>
 
 #include <rdapplication.h>
 #include <rdconf.h>
@@ -48,6 +50,14 @@
 #include "ripcd.h"
 
 bool global_exiting=false;
+bool global_log_rml_stats=false;
+
+//
+// Upper bounds (in uS) of the RML latency histogram bins, with the last
+// bin catching everything slower.
+//
+static const int rml_latency_bounds[RIPCD_RML_LATENCY_BINS-1]=
+  {100,250,500,1000,2000,5000,10000,100000};
 
 void SigHandler(int signo)
 {
@@ -62,12 +72,18 @@ void SigHandler(int signo)
     ::signal(SIGCHLD,SigHandler);
     ::signal(SIGTERM,SigHandler);
     ::signal(SIGINT,SigHandler);
+    ::signal(SIGUSR1,SigHandler);
     return;
 
   case SIGTERM:
   case SIGINT:
     global_exiting=true;
     break;
+
+  case SIGUSR1:
+    global_log_rml_stats=true;
+    ::signal(SIGUSR1,SigHandler);
+    break;
   }
 }
 
@@ -139,6 +155,7 @@ MainObject::MainObject(QObject *parent)
   ::signal(SIGCHLD,SigHandler);
   ::signal(SIGTERM,SigHandler);
   ::signal(SIGINT,SigHandler);
+  ::signal(SIGUSR1,SigHandler);
   if(!RDWritePid(RD_PID_DIR,"ripcd.pid",rda->config()->uid())) {
     printf("ripcd: can't write pid file\n");
     exit(1);
@@ -181,12 +198,23 @@ MainObject::MainObject(QObject *parent)
   ripcd_notification_mcaster->subscribe(rda->system()->notificationAddress());
 
   //
-  // Start RML Polling
+  // Start RML Ingest
   //
-  QTimer *timer=new QTimer(this);
-  timer->changeInterval(RIPCD_RML_READ_INTERVAL);
-  connect(timer,SIGNAL(timeout()),this,SLOT(readRml()));
-  timer->start(true);
+  for(int i=0;i<RIPCD_RML_LATENCY_BINS;i++) {
+    ripcd_rml_latencies[i]=0;
+  }
+  ripcd_rml_echo_notifier=
+    new QSocketNotifier(ripcd_rml_echo->socket(),QSocketNotifier::Read,this);
+  connect(ripcd_rml_echo_notifier,SIGNAL(activated(int)),
+	  this,SLOT(readRml()));
+  ripcd_rml_noecho_notifier=
+    new QSocketNotifier(ripcd_rml_noecho->socket(),QSocketNotifier::Read,this);
+  connect(ripcd_rml_noecho_notifier,SIGNAL(activated(int)),
+	  this,SLOT(readRml()));
+  ripcd_rml_reply_notifier=
+    new QSocketNotifier(ripcd_rml_reply->socket(),QSocketNotifier::Read,this);
+  connect(ripcd_rml_reply_notifier,SIGNAL(activated(int)),
+	  this,SLOT(readRml()));
 
   //
   // Database Backup Timer
@@ -213,7 +241,7 @@ MainObject::MainObject(QObject *parent)
   //
   // Exit Timer
   //
-  timer=new QTimer(this);
+  QTimer *timer=new QTimer(this);
   connect(timer,SIGNAL(timeout()),this,SLOT(exitTimerData()));
   timer->start(200);
 
@@ -393,6 +421,10 @@ void MainObject::macroTimerData(int num)
 
 void MainObject::exitTimerData()
 {
+  if(global_log_rml_stats) {
+    global_log_rml_stats=false;
+    LogRmlStats();
+  }
   if(global_exiting) {
     for(int i=0;i<MAX_MATRICES;i++) {
       if(ripcd_switcher[i]!=NULL) {
@@ -643,6 +675,10 @@ void MainObject::DispatchCommand(int ch)
   if(!strcmp(conn->args[0],"TA")) {  // Send Onair Flag State
     EchoCommand(ch,QString().sprintf("TA %d!",ripc_onair_flag));
   }
+
+  if(!strcmp(conn->args[0],"RS")) {  // Send RML Statistics
+    SendRmlStats(ch);
+  }
 }
 
 
@@ -700,8 +736,15 @@ void MainObject::ReadRmlSocket(QSocketDevice *dev,RDMacro::Role role,
   int n;
   QHostAddress peer_addr;
   RDMacro macro;
+  struct timeval recv_tv;
 
+  //
+  // Drain everything that is queued, so a burst is handled in one wake-up
+  //
   while((n=dev->readBlock(buffer,RD_RML_MAX_LENGTH))>0) {
+    if(ioctl(dev->socket(),SIOCGSTAMP,&recv_tv)!=0) {
+      gettimeofday(&recv_tv,NULL);
+    }
     buffer[n]=0;
     if(macro.parseString(buffer,n)) {
       if(macro.command()==RDMacro::AG) {
@@ -710,14 +753,14 @@ void MainObject::ReadRmlSocket(QSocketDevice *dev,RDMacro::Role role,
 	  f0.pop_front();
 	  QString rmlstr=f0.join(" ");
 	  if(!macro.parseString(rmlstr,rmlstr.length())) {
-	    break;
+	    continue;
 	  }
 	}
 	else {
 	  LogLine(RDConfig::LogDebug,
 		  QString("rejected rml: \"")+buffer+
 		  "\": on-air flag not active");
-	  break;
+	  continue;
 	}
       }
       macro.setRole(role);
@@ -740,6 +783,7 @@ void MainObject::ReadRmlSocket(QSocketDevice *dev,RDMacro::Role role,
 	  default:
 	    break;
       }
+      UpdateRmlStats(macro.address(),&recv_tv);
     }
     else {
       LogLine(RDConfig::LogWarning,
@@ -760,6 +804,64 @@ void MainObject::ReadRmlSocket(QSocketDevice *dev,RDMacro::Role role,
 }
 
 
+void MainObject::UpdateRmlStats(const QHostAddress &addr,
+				struct timeval *recv_tv)
+{
+  struct timeval now;
+  int usecs;
+  int bin=RIPCD_RML_LATENCY_BINS-1;
+
+  ripcd_rml_counts[addr.toString()]++;
+  gettimeofday(&now,NULL);
+  usecs=1000000*(now.tv_sec-recv_tv->tv_sec)+now.tv_usec-recv_tv->tv_usec;
+  for(int i=0;i<(RIPCD_RML_LATENCY_BINS-1);i++) {
+    if(usecs<rml_latency_bounds[i]) {
+      bin=i;
+      break;
+    }
+  }
+  ripcd_rml_latencies[bin]++;
+}
+
+
+void MainObject::LogRmlStats()
+{
+  QString str="rml commands by source:";
+
+  for(std::map<QString,unsigned>::const_iterator it=ripcd_rml_counts.begin();
+      it!=ripcd_rml_counts.end();it++) {
+    str+=QString().sprintf(" %s=%u",(const char *)it->first,it->second);
+  }
+  LogLine(RDConfig::LogInfo,str);
+
+  str="rml receive-to-dispatch latency:";
+  for(int i=0;i<(RIPCD_RML_LATENCY_BINS-1);i++) {
+    str+=QString().sprintf(" <%duS=%u",rml_latency_bounds[i],
+			   ripcd_rml_latencies[i]);
+  }
+  str+=QString().sprintf(" >=%duS=%u",
+			 rml_latency_bounds[RIPCD_RML_LATENCY_BINS-2],
+			 ripcd_rml_latencies[RIPCD_RML_LATENCY_BINS-1]);
+  LogLine(RDConfig::LogInfo,str);
+}
+
+
+void MainObject::SendRmlStats(int ch)
+{
+  QString str=QString().sprintf("RS %u",(unsigned)ripcd_rml_counts.size());
+
+  for(std::map<QString,unsigned>::const_iterator it=ripcd_rml_counts.begin();
+      it!=ripcd_rml_counts.end();it++) {
+    str+=QString().sprintf(" %s %u",(const char *)it->first,it->second);
+  }
+  for(int i=0;i<RIPCD_RML_LATENCY_BINS;i++) {
+    str+=QString().sprintf(" %u",ripcd_rml_latencies[i]);
+  }
+  str+="!";
+  EchoCommand(ch,str);
+}
+
+
 void MainObject::LoadGpiTable()
 {
   for(int i=0;i<MAX_MATRICES;i++) {
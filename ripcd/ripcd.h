@@ -22,7 +22,9 @@
 #define RIPCD_H
 
 #include <sys/types.h>
+#include <sys/time.h>
 
+#include <map>
 #include <vector>
 
 #include <qobject.h>
@@ -30,6 +32,7 @@
 #include <qserversocket.h>
 #include <qsqldatabase.h>
 #include <qsocketdevice.h>
+#include <qsocketnotifier.h>
 #include <qtimer.h>
 
 #include <rdsocket.h>
@@ -49,7 +52,7 @@
 // Global RIPCD Definitions
 //
 #define RIPCD_MAX_LENGTH 256
-#define RIPCD_RML_READ_INTERVAL 100
+#define RIPCD_RML_LATENCY_BINS 9
 #define RIPCD_TTY_READ_INTERVAL 100
 #define RIPCD_USAGE "[-d]\n\nSupplying the '-d' flag will set 'debug' mode, causing ripcd(8) to stay\nin the foreground and print debugging info on standard output.\n" 
 
@@ -92,6 +95,9 @@ class MainObject : public QObject
   void BroadcastCommand(const char *,int except_ch=-1);
   void EchoArgs(int,const char);
   void ReadRmlSocket(QSocketDevice *dev,RDMacro::Role role,bool echo);
+  void UpdateRmlStats(const QHostAddress &addr,struct timeval *recv_tv);
+  void LogRmlStats();
+  void SendRmlStats(int ch);
   QString StripPoint(QString);
   void LoadLocalMacros();
   void RunLocalMacros(RDMacro *rml);
@@ -116,6 +122,11 @@ class MainObject : public QObject
   QSocketDevice *ripcd_rml_echo;
   QSocketDevice *ripcd_rml_noecho;
   QSocketDevice *ripcd_rml_reply;
+  QSocketNotifier *ripcd_rml_echo_notifier;
+  QSocketNotifier *ripcd_rml_noecho_notifier;
+  QSocketNotifier *ripcd_rml_reply_notifier;
+  std::map<QString,unsigned> ripcd_rml_counts;
+  unsigned ripcd_rml_latencies[RIPCD_RML_LATENCY_BINS];
   QHostAddress ripcd_host_addr;
   Switcher *ripcd_switcher[MAX_MATRICES];
   bool ripcd_gpi_state[MAX_MATRICES][MAX_GPIO_PINS];
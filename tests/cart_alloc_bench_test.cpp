@@ -0,0 +1,180 @@
+// cart_alloc_bench_test.cpp
+//
+// Benchmark the Rivendell cart number allocator.
+//
+//   (C) Copyright 2018 Fred Gleason <fredg@paravelsystems.com>
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License version 2 as
+//   published by the Free Software Foundation.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public
+//   License along with this program; if not, write to the Free Software
+//   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+//
+
+#include <stdlib.h>
+#include <stdio.h>
+
+#include <vector>
+
+#include <qapplication.h>
+#include <qdatetime.h>
+
+#include <rdcmd_switch.h>
+#include <rdconfig.h>
+#include <rddb.h>
+#include <rdgroup.h>
+
+#include "cart_alloc_bench_test.h"
+
+MainObject::MainObject(QObject *parent)
+  :QObject(parent)
+{
+  QString group_name;
+  unsigned count=1000;
+  unsigned quantity=1;
+  unsigned steps=10;
+  unsigned schema=0;
+  bool ok=false;
+  std::vector<unsigned> cart_nums;
+  std::vector<unsigned> reserved;
+  QTime elapsed;
+  QString sql;
+  RDSqlQuery *q;
+
+  //
+  // Read Command Options
+  //
+  RDCmdSwitch *cmd=
+    new RDCmdSwitch(qApp->argc(),qApp->argv(),"cart_alloc_bench_test",
+		    CART_ALLOC_BENCH_TEST_USAGE);
+  for(unsigned i=0;i<cmd->keys();i++) {
+    if(cmd->key(i)=="--group") {
+      group_name=cmd->value(i);
+      cmd->setProcessed(i,true);
+    }
+    if(cmd->key(i)=="--count") {
+      count=cmd->value(i).toUInt(&ok);
+      if((!ok)||(count<1)) {
+	fprintf(stderr,"cart_alloc_bench_test: invalid --count value\n");
+	exit(256);
+      }
+      cmd->setProcessed(i,true);
+    }
+    if(cmd->key(i)=="--quantity") {
+      quantity=cmd->value(i).toUInt(&ok);
+      if((!ok)||(quantity<1)) {
+	fprintf(stderr,"cart_alloc_bench_test: invalid --quantity value\n");
+	exit(256);
+      }
+      cmd->setProcessed(i,true);
+    }
+    if(cmd->key(i)=="--steps") {
+      steps=cmd->value(i).toUInt(&ok);
+      if((!ok)||(steps<1)) {
+	fprintf(stderr,"cart_alloc_bench_test: invalid --steps value\n");
+	exit(256);
+      }
+      cmd->setProcessed(i,true);
+    }
+    if(!cmd->processed(i)) {
+      fprintf(stderr,"cart_alloc_bench_test: unknown option \"%s\"\n",
+	      (const char *)cmd->value(i));
+      exit(256);
+    }
+  }
+  if(group_name.isEmpty()) {
+    fprintf(stderr,"cart_alloc_bench_test: you must specify a group\n");
+    exit(256);
+  }
+
+  //
+  // Load Configuration
+  //
+  RDConfig *config=new RDConfig();
+  config->load();
+  config->setModuleName("cart_alloc_bench_test");
+
+  //
+  // Open Database
+  //
+  QString err (tr("cart_alloc_bench_test: "));
+  QSqlDatabase *db=RDInitDb(&schema,&err);
+  if(!db) {
+    fprintf(stderr,err.ascii());
+    delete cmd;
+    exit(256);
+  }
+
+  //
+  // Run the Test
+  //
+  RDGroup *group=new RDGroup(group_name);
+  if(!group->exists()) {
+    fprintf(stderr,"cart_alloc_bench_test: group \"%s\" does not exist\n",
+	    (const char *)group_name.utf8());
+    exit(256);
+  }
+  unsigned range=group->defaultHighCart()-group->defaultLowCart()+1;
+  unsigned step=count/steps;
+  if(step<quantity) {
+    step=quantity;
+  }
+  printf("group: %s, range: %06u - %06u, %u carts per call\n",
+	 (const char *)group_name,group->defaultLowCart(),
+	 group->defaultHighCart(),quantity);
+  printf("   fill     carts   carts/sec\n");
+  int total_msecs=0;
+  unsigned mark=0;
+  elapsed.start();
+  while(reserved.size()<count) {
+    if(!group->reserveCarts(&cart_nums,config->stationName(),RDCart::Audio,
+			    quantity)) {
+      printf("reservation failed after %u carts\n",(unsigned)reserved.size());
+      break;
+    }
+    for(unsigned i=0;i<cart_nums.size();i++) {
+      reserved.push_back(cart_nums[i]);
+    }
+    if(((reserved.size()-mark)>=step)||(reserved.size()>=count)) {
+      int msecs=elapsed.elapsed();
+      total_msecs+=msecs;
+      printf("%6.1lf%%  %8u  %10.1lf\n",
+	     100.0*(double)(range-group->freeCartQuantity())/(double)range,
+	     (unsigned)reserved.size(),
+	     1000.0*(double)(reserved.size()-mark)/(double)(msecs>0?msecs:1));
+      mark=reserved.size();
+      elapsed.start();
+    }
+  }
+  if(total_msecs>0) {
+    printf("total: %u carts in %.2lf sec, %.1lf carts/sec\n",
+	   (unsigned)reserved.size(),(double)total_msecs/1000.0,
+	   1000.0*(double)reserved.size()/(double)total_msecs);
+  }
+
+  //
+  // Clean Up
+  //
+  for(unsigned i=0;i<reserved.size();i++) {
+    sql=QString().sprintf("delete from CART where NUMBER=%u",reserved[i]);
+    q=new RDSqlQuery(sql);
+    delete q;
+  }
+
+  exit(0);
+}
+
+
+int main(int argc,char *argv[])
+{
+  QApplication a(argc,argv,false);
+  new MainObject();
+  return a.exec();
+}
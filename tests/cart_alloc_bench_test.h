@@ -0,0 +1,35 @@
+// cart_alloc_bench_test.h
+//
+// Benchmark the Rivendell cart number allocator.
+//
+//   (C) Copyright 2018 Fred Gleason <fredg@paravelsystems.com>
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License version 2 as
+//   published by the Free Software Foundation.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public
+//   License along with this program; if not, write to the Free Software
+//   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+//
+
+#ifndef CART_ALLOC_BENCH_TEST_H
+#define CART_ALLOC_BENCH_TEST_H
+
+#include <qobject.h>
+
+#define CART_ALLOC_BENCH_TEST_USAGE "[options]\n\nTime cart number allocation as a group fills up\n\nOptions are:\n--group=<name>\n     Name of group to reserve carts in.\n\n--count=<num>\n     Total number of carts to reserve.  Default is 1000.\n\n--quantity=<num>\n     Number of carts to reserve per call.  Default is 1.\n\n--steps=<num>\n     Number of progress lines to print.  Default is 10.\n\nAll carts reserved by the test are deleted again before it exits.\n\n"
+
+class MainObject : public QObject
+{
+ public:
+  MainObject(QObject *parent=0);
+};
+
+
+#endif  // CART_ALLOC_BENCH_TEST_H
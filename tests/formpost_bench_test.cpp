@@ -0,0 +1,200 @@
+// formpost_bench_test.cpp
+//
+// Benchmark and verify multipart POST parsing in RDFormPost.
+//
+//   (C) Copyright 2018 Fred Gleason <fredg@paravelsystems.com>
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License version 2 as
+//   published by the Free Software Foundation.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public
+//   License along with this program; if not, write to the Free Software
+//   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+//
+
+#include <fcntl.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <qapplication.h>
+#include <qdatetime.h>
+
+#include <rdcmd_switch.h>
+#include <rdformpost.h>
+#include <rdtempdirectory.h>
+
+#include "formpost_bench_test.h"
+
+#define FORMPOST_BENCH_TEST_BOUNDARY "----RivendellFormPostBenchBoundary"
+
+//
+// Deterministic filler, so the result can be checked without keeping a
+// copy of the original.  Every 4 kB block gets a CR/LF and a truncated
+// boundary to exercise the delimiter search.
+//
+static void FillBlock(char *buf,unsigned len,unsigned block,unsigned *seed)
+{
+  for(unsigned i=0;i<len;i++) {
+    buf[i]=rand_r(seed)&0xff;
+  }
+  if(len>64) {
+    memcpy(buf+(block%(len-64)),"\r\n------RivendellFormPostBench",30);
+  }
+}
+
+
+MainObject::MainObject(QObject *parent)
+  :QObject(parent)
+{
+  unsigned size=500;
+  int passes=3;
+  bool ok=false;
+  QTime elapsed;
+  char buf[4096];
+  char chk[4096];
+  unsigned seed;
+  int fd;
+
+  //
+  // Read Command Options
+  //
+  RDCmdSwitch *cmd=
+    new RDCmdSwitch(qApp->argc(),qApp->argv(),"formpost_bench_test",
+		    FORMPOST_BENCH_TEST_USAGE);
+  for(unsigned i=0;i<cmd->keys();i++) {
+    if(cmd->key(i)=="--size") {
+      size=cmd->value(i).toUInt(&ok);
+      if((!ok)||(size<1)) {
+	fprintf(stderr,"formpost_bench_test: invalid --size value\n");
+	exit(256);
+      }
+      cmd->setProcessed(i,true);
+    }
+    if(cmd->key(i)=="--passes") {
+      passes=cmd->value(i).toInt(&ok);
+      if((!ok)||(passes<1)) {
+	fprintf(stderr,"formpost_bench_test: invalid --passes value\n");
+	exit(256);
+      }
+      cmd->setProcessed(i,true);
+    }
+    if(!cmd->processed(i)) {
+      fprintf(stderr,"formpost_bench_test: unknown option \"%s\"\n",
+	      (const char *)cmd->value(i));
+      exit(256);
+    }
+  }
+
+  //
+  // Generate the POST body
+  //
+  RDTempDirectory *tempdir=new RDTempDirectory("formpost_bench_test");
+  QString err_msg;
+  if(!tempdir->create(&err_msg)) {
+    fprintf(stderr,"formpost_bench_test: %s\n",(const char *)err_msg);
+    exit(256);
+  }
+  QString postname=tempdir->path()+"/post.dat";
+  if((fd=open(postname,O_WRONLY|O_CREAT|O_TRUNC,S_IRUSR|S_IWUSR))<0) {
+    fprintf(stderr,"formpost_bench_test: unable to create \"%s\"\n",
+	    (const char *)postname);
+    exit(256);
+  }
+  QString str=QString("--")+FORMPOST_BENCH_TEST_BOUNDARY+"\r\n"+
+    "Content-Disposition: form-data; name=\"COMMAND\"\r\n\r\n"+
+    "2\r\n"+
+    "--"+FORMPOST_BENCH_TEST_BOUNDARY+"\r\n"+
+    "Content-Disposition: form-data; name=\"FILENAME\"; "+
+    "filename=\"bench.wav\"\r\n"+
+    "Content-Type: application/octet-stream\r\n\r\n";
+  write(fd,(const char *)str,str.length());
+  seed=1;
+  for(unsigned i=0;i<(size*256);i++) {
+    FillBlock(buf,4096,i,&seed);
+    write(fd,buf,4096);
+  }
+  str=QString("\r\n--")+FORMPOST_BENCH_TEST_BOUNDARY+"--\r\n";
+  write(fd,(const char *)str,str.length());
+  off_t post_len=lseek(fd,0,SEEK_CUR);
+  ::close(fd);
+  setenv("REQUEST_METHOD","POST",1);
+  setenv("CONTENT_LENGTH",QString().sprintf("%lu",post_len),1);
+  setenv("CONTENT_TYPE",QString("multipart/form-data; boundary=")+
+	 FORMPOST_BENCH_TEST_BOUNDARY,1);
+
+  //
+  // Run the Test
+  //
+  printf("posting %u MB file part (%lu bytes total)\n",size,post_len);
+  for(int i=0;i<passes;i++) {
+    if((fd=open(postname,O_RDONLY))<0) {
+      fprintf(stderr,"formpost_bench_test: unable to open \"%s\"\n",
+	      (const char *)postname);
+      exit(256);
+    }
+    dup2(fd,0);
+    ::close(fd);
+    elapsed.start();
+    RDFormPost *post=new RDFormPost(RDFormPost::MultipartEncoded,0,true);
+    int msecs=elapsed.elapsed();
+    if(post->error()!=RDFormPost::ErrorOk) {
+      printf("pass %d: %s\n",i+1,
+	     (const char *)RDFormPost::errorString(post->error()));
+      exit(1);
+    }
+
+    //
+    // Verify
+    //
+    QString cmdval;
+    QString filename;
+    post->getValue("COMMAND",&cmdval);
+    post->getValue("FILENAME",&filename);
+    bool match=(cmdval=="2")&&post->isFile("FILENAME");
+    if(match&&((fd=open(filename,O_RDONLY))>=0)) {
+      seed=1;
+      for(unsigned j=0;j<(size*256);j++) {
+	FillBlock(buf,4096,j,&seed);
+	if((read(fd,chk,4096)!=4096)||(memcmp(buf,chk,4096)!=0)) {
+	  match=false;
+	  break;
+	}
+      }
+      if(read(fd,chk,1)!=0) {
+	match=false;
+      }
+      ::close(fd);
+    }
+    else {
+      match=false;
+    }
+    printf("pass %d: %.2lf sec [%.1lf MB/sec], data %s\n",i+1,
+	   (double)msecs/1000.0,
+	   (double)post_len/(1048.576*(double)(msecs>0?msecs:1)),
+	   match?"verified":"MISMATCH");
+    delete post;
+    if(!match) {
+      exit(1);
+    }
+  }
+  unlink(postname);
+  delete tempdir;
+
+  exit(0);
+}
+
+
+int main(int argc,char *argv[])
+{
+  QApplication a(argc,argv,false);
+  new MainObject();
+  return a.exec();
+}
@@ -0,0 +1,35 @@
+// formpost_bench_test.h
+//
+// Benchmark and verify multipart POST parsing in RDFormPost.
+//
+//   (C) Copyright 2018 Fred Gleason <fredg@paravelsystems.com>
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License version 2 as
+//   published by the Free Software Foundation.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public
+//   License along with this program; if not, write to the Free Software
+//   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+//
+
+#ifndef FORMPOST_BENCH_TEST_H
+#define FORMPOST_BENCH_TEST_H
+
+#include <qobject.h>
+
+#define FORMPOST_BENCH_TEST_USAGE "[options]\n\nTime the parsing of a multipart POST carrying a large file\n\nOptions are:\n--size=<mbytes>\n     Size of the file part to post, in megabytes.  Default is 500.\n\n--passes=<n>\n     Number of times to parse the post.  Default is 3.\n\nThe file part is filled with pseudo-random binary data, including\nCR/LF pairs and partial boundary strings, and is checked byte for byte\nafter each pass.\n\n"
+
+class MainObject : public QObject
+{
+ public:
+  MainObject(QObject *parent=0);
+};
+
+
+#endif  // FORMPOST_BENCH_TEST_H
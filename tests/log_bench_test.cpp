@@ -0,0 +1,143 @@
+// log_bench_test.cpp
+//
+// Time loading and saving of Rivendell logs
+//
+//   (C) Copyright 2026 Fred Gleason <fredg@paravelsystems.com>
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License version 2 as
+//   published by the Free Software Foundation.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public
+//   License along with this program; if not, write to the Free Software
+//   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+//
+
+#include <stdlib.h>
+#include <stdio.h>
+
+#include <qapplication.h>
+#include <qdatetime.h>
+#include <qstringlist.h>
+
+#include <rdcmd_switch.h>
+#include <rdconfig.h>
+#include <rddb.h>
+#include <rdlog.h>
+#include <rdlog_event.h>
+
+#include "log_bench_test.h"
+
+MainObject::MainObject(QObject *parent)
+  :QObject(parent)
+{
+  QStringList lognames;
+  int passes=10;
+  bool save=false;
+  unsigned schema=0;
+  bool ok=false;
+  QTime elapsed;
+  int load_msecs;
+  int save_msecs;
+  int lines;
+
+  //
+  // Read Command Options
+  //
+  RDCmdSwitch *cmd=
+    new RDCmdSwitch(qApp->argc(),qApp->argv(),"log_bench_test",
+		    LOG_BENCH_TEST_USAGE);
+  for(unsigned i=0;i<cmd->keys();i++) {
+    if(cmd->key(i)=="--log") {
+      lognames.push_back(cmd->value(i));
+      cmd->setProcessed(i,true);
+    }
+    if(cmd->key(i)=="--passes") {
+      passes=cmd->value(i).toInt(&ok);
+      if((!ok)||(passes<1)) {
+	fprintf(stderr,"log_bench_test: invalid --passes value\n");
+	exit(256);
+      }
+      cmd->setProcessed(i,true);
+    }
+    if(cmd->key(i)=="--save") {
+      save=true;
+      cmd->setProcessed(i,true);
+    }
+    if(!cmd->processed(i)) {
+      fprintf(stderr,"log_bench_test: unknown option \"%s\"\n",
+	      (const char *)cmd->value(i));
+      exit(256);
+    }
+  }
+  if(lognames.size()==0) {
+    fprintf(stderr,
+	    "log_bench_test: you must specify a log name with \"--log=\"\n");
+    exit(256);
+  }
+
+  //
+  // Open Config
+  //
+  RDConfig *config=new RDConfig();
+  config->load();
+
+  //
+  // Open Database
+  //
+  QString err (tr("log_bench_test: "));
+  QSqlDatabase *db=RDInitDb(&schema,&err);
+  if(!db) {
+    fprintf(stderr,err.ascii());
+    delete cmd;
+    exit(256);
+  }
+
+  //
+  // Run the Test
+  //
+  printf("DB schema: %u\n",schema);
+  for(unsigned i=0;i<lognames.size();i++) {
+    if(!RDLog::exists(lognames[i])) {
+      fprintf(stderr,"log_bench_test: no such log \"%s\"\n",
+	      (const char *)lognames[i]);
+      exit(1);
+    }
+    load_msecs=0;
+    save_msecs=0;
+    lines=0;
+    for(int j=0;j<passes;j++) {
+      RDLogEvent *log_event=new RDLogEvent(RDLog::tableName(lognames[i]));
+      elapsed.start();
+      lines=log_event->load();
+      load_msecs+=elapsed.elapsed();
+      if(save) {
+	elapsed.start();
+	log_event->save(config,false);
+	save_msecs+=elapsed.elapsed();
+      }
+      delete log_event;
+    }
+    printf("%s: %d lines, load: %.1lf mS",(const char *)lognames[i],lines,
+	   (double)load_msecs/(double)passes);
+    if(save) {
+      printf(", save: %.1lf mS",(double)save_msecs/(double)passes);
+    }
+    printf(" (average of %d passes)\n",passes);
+  }
+
+  exit(0);
+}
+
+
+int main(int argc,char *argv[])
+{
+  QApplication a(argc,argv,false);
+  new MainObject();
+  return a.exec();
+}
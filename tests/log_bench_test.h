@@ -0,0 +1,35 @@
+// log_bench_test.h
+//
+// Time loading and saving of Rivendell logs
+//
+//   (C) Copyright 2026 Fred Gleason <fredg@paravelsystems.com>
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License version 2 as
+//   published by the Free Software Foundation.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public
+//   License along with this program; if not, write to the Free Software
+//   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+//
+
+#ifndef LOG_BENCH_TEST_H
+#define LOG_BENCH_TEST_H
+
+#include <qobject.h>
+
+#define LOG_BENCH_TEST_USAGE "[options]\n\nTime loading and saving of Rivendell logs\n\nOptions are:\n--log=<log-name>\n     Name of log to use.  May be given more than once.\n\n--passes=<n>\n     Number of times to load (and save) each log.  Default is 10.\n\n--save\n     Also time saving each log back to the database.  The log contents\n     are rewritten unchanged.\n\n"
+
+class MainObject : public QObject
+{
+ public:
+  MainObject(QObject *parent=0);
+};
+
+
+#endif  // LOG_BENCH_TEST_H
@@ -0,0 +1,182 @@
+// wav_sha1_test.cpp
+//
+// Test SHA-1 hash generation while writing WAV files
+//
+//   (C) Copyright 2018 Fred Gleason <fredg@paravelsystems.com>
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License version 2 as
+//   published by the Free Software Foundation.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public
+//   License along with this program; if not, write to the Free Software
+//   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+//
+
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#include <qapplication.h>
+
+#include <rdcmd_switch.h>
+#include <rdhash.h>
+#include <rdwavefile.h>
+
+#include "wav_sha1_test.h"
+
+MainObject::MainObject(QObject *parent)
+  :QObject(parent)
+{
+  QString filename="/tmp/wav_sha1_test.wav";
+  unsigned blocks=4;
+  bool ok=false;
+  int failures=0;
+
+  //
+  // Read Command Options
+  //
+  RDCmdSwitch *cmd=
+    new RDCmdSwitch(qApp->argc(),qApp->argv(),"wav_sha1_test",
+		    WAV_SHA1_TEST_USAGE);
+  for(unsigned i=0;i<cmd->keys();i++) {
+    if(cmd->key(i)=="--filename") {
+      filename=cmd->value(i);
+      cmd->setProcessed(i,true);
+    }
+    if(cmd->key(i)=="--blocks") {
+      blocks=cmd->value(i).toUInt(&ok);
+      if((!ok)||(blocks==0)) {
+	fprintf(stderr,"wav_sha1_test: invalid --blocks\n");
+	exit(256);
+      }
+      cmd->setProcessed(i,true);
+    }
+    if(!cmd->processed(i)) {
+      fprintf(stderr,"wav_sha1_test: invalid option\n");
+      exit(256);
+    }
+  }
+
+  //
+  // A whole number of levl blocks is the case where the trailing, empty
+  // energy block must still be allowed for in the header
+  //
+  for(int chase=0;chase<=1;chase++) {
+    for(unsigned chans=1;chans<=2;chans++) {
+      for(unsigned bits=16;bits<=24;bits+=8) {
+	for(int delta=-1;delta<=1;delta++) {
+	  if(!RunTest(filename,1152*blocks+delta,chans,bits,chase)) {
+	    failures++;
+	  }
+	}
+      }
+    }
+  }
+  unlink(filename);
+  if(failures>0) {
+    printf("%d test(s) failed\n",failures);
+    exit(256);
+  }
+  printf("all tests passed\n");
+
+  exit(0);
+}
+
+
+bool MainObject::RunTest(const QString &filename,unsigned frames,
+			 unsigned channels,unsigned bits,bool chase)
+{
+  unsigned block_align=channels*bits/8;
+  unsigned char *pcm=new unsigned char[1152*block_align];
+  struct stat st;
+  off_t header_len;
+  unsigned char *header=NULL;
+  unsigned char *final_header=NULL;
+  int fd=-1;
+  bool ret=true;
+
+  printf("%6u frames, %u channel(s), %u bits%s: ",frames,channels,bits,
+	 chase?", chase":"");
+  for(unsigned i=0;i<1152*block_align;i++) {
+    pcm[i]=(unsigned char)(i*7);
+  }
+
+  RDWaveFile *wave=new RDWaveFile(filename);
+  wave->setFormatTag(WAVE_FORMAT_PCM);
+  wave->setChannels(channels);
+  wave->setSamplesPerSec(48000);
+  wave->setBitsPerSample(bits);
+  wave->setBextChunk(true);
+  wave->setLevlChunk(true);
+  wave->setSha1Hashing(true);
+  wave->setChaseMode(chase);
+  if(!chase) {
+    wave->setExpectedFrames(frames);
+  }
+  unlink(filename);
+  if(!wave->createWave()) {
+    printf("unable to create \"%s\"\n",(const char *)filename);
+    delete wave;
+    delete[] pcm;
+    return false;
+  }
+  if(chase) {
+    //
+    // As caed(8) does, once the record length is known
+    //
+    wave->setExpectedFrames(frames);
+  }
+  for(unsigned left=frames;left>0;) {
+    unsigned n=left<1152?left:1152;
+    wave->writeWave(pcm,n*block_align);
+    left-=n;
+  }
+
+  //
+  // Everything ahead of the audio is hashed as it stands now, so must be
+  // unchanged by closeWave() for the hash to be made without a re-read.
+  // (In chase mode the sizes are only written at close, and as the file
+  // is never re-read an empty hash shows a mismatch.)
+  //
+  stat(filename,&st);
+  header_len=st.st_size-(off_t)frames*block_align;
+  header=new unsigned char[header_len];
+  final_header=new unsigned char[header_len];
+  fd=open(filename,O_RDONLY);
+  pread(fd,header,header_len,0);
+  wave->closeWave();
+  pread(fd,final_header,header_len,0);
+  close(fd);
+  if((!chase)&&(memcmp(header,final_header,header_len)!=0)) {
+    printf("header changed at close ");
+    ret=false;
+  }
+  if(wave->sha1Hash()!=RDSha1Hash(filename)) {
+    printf("hash mismatch ");
+    ret=false;
+  }
+  printf("%s\n",ret?"OK":"FAILED");
+  delete wave;
+  delete[] final_header;
+  delete[] header;
+  delete[] pcm;
+
+  return ret;
+}
+
+
+int main(int argc,char *argv[])
+{
+  QApplication a(argc,argv,false);
+  new MainObject();
+  return a.exec();
+}
@@ -0,0 +1,39 @@
+// wav_sha1_test.h
+//
+// Test SHA-1 hash generation while writing WAV files
+//
+//   (C) Copyright 2018 Fred Gleason <fredg@paravelsystems.com>
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License version 2 as
+//   published by the Free Software Foundation.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public
+//   License along with this program; if not, write to the Free Software
+//   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+//
+
+#ifndef WAV_SHA1_TEST_H
+#define WAV_SHA1_TEST_H
+
+#include <qobject.h>
+
+#define WAV_SHA1_TEST_USAGE "[options]\n\nTest SHA-1 hash generation while writing WAV files\n\n--filename=<file-name>\n     The name of the scratch file to write.  Default is\n     '/tmp/wav_sha1_test.wav'.\n\n--blocks=<n>\n     Write <n> levl blocks of 1152 frames, and one frame either side.\n     Default is 4.\n\n"
+
+class MainObject : public QObject
+{
+ public:
+  MainObject(QObject *parent=0);
+
+ private:
+  bool RunTest(const QString &filename,unsigned frames,unsigned channels,
+	       unsigned bits,bool chase);
+};
+
+
+#endif  // WAV_SHA1_TEST_H
@@ -20,7 +20,6 @@
 
 #include <rdapplication.h>
 #include <rdconf.h>
-#include <rdcreate_log.h>
 #include <rdescape_string.h>
 #include <rdsvc.h>
 
@@ -435,7 +434,6 @@ void MainObject::Saveas(const QString &logname)
       "SERVICE=\""+RDEscapeString(edit_service)+"\"";
     q=new RDSqlQuery(sql);
     delete q;
-    RDCreateLogTable(RDLog::tableName(logname),rda->config());
     edit_log_event->setLogName(RDLog::tableName(logname));
     edit_log_event->save(rda->config());
     delete edit_log;
@@ -25,6 +25,7 @@
 #include <sys/stat.h>
 #include <sys/types.h>
 
+#include <qdatetime.h>
 #include <qdir.h>
 
 #include <dbversion.h>
@@ -38,6 +39,7 @@
 #include <rdlog.h>
 #include <rdwavefile.h>
 
+#include "checkpool.h"
 #include "rddbmgr.h"
 
 bool MainObject::Check(QString *err_msg) const
@@ -107,29 +109,81 @@ bool MainObject::Check(QString *err_msg) const
   CheckCutCounts();
   printf("done.\n\n");
 
+  //
+  // Load Cut Data
+  //
+  std::map<QString,int> lengths;
+  std::map<QString,QString> hashes;
+  LoadCuts(&lengths,&hashes);
+
   //
   // Check Orphaned Audio
   //
   printf("Checking for orphaned audio...\n");
-  CheckOrphanedAudio();
+  CheckOrphanedAudio(lengths);
   printf("done.\n\n");
 
+  //
+  // Start the hash workers so they run alongside the length check
+  //
+  QTime elapsed;
+  elapsed.start();
+  CheckPoint *ckpt=new CheckPoint(db_checkpoint);
+  if(ckpt->resumed()>0) {
+    printf("Resuming from checkpoint \"%s\" (%u entries)...\n\n",
+	   (const char *)db_checkpoint,ckpt->resumed());
+  }
+  std::vector<CheckJob> jobs;
+  CheckPool *pool=NULL;
+  if(!db_rehash.isEmpty()) {
+    LoadRehashJobs(db_rehash,ckpt,&jobs);
+    pool=new CheckPool(db_check_jobs,db_check_io_rate);
+    pool->start(&jobs);
+  }
+
   //
   // Validating Audio Lengths
   //
   printf("Validating audio lengths (this may take some time)...\n");
-  ValidateAudioLengths();
+  unsigned validated=ValidateAudioLengths(lengths,ckpt);
   printf("done.\n\n");
 
   //
   // Rehash
   //
-  if(!db_rehash.isEmpty()) {
+  unsigned hashed=0;
+  double mbytes=0.0;
+  unsigned workers=0;
+  if(pool!=NULL) {
     printf("Checking hashes...\n");
-    Rehash(db_rehash);
+    hashed=Rehash(pool,&jobs,hashes,ckpt);
+    mbytes=pool->bytesRead()/1048576.0;
+    workers=pool->workers();
+    delete pool;
     printf("done.\n\n");
   }
 
+  //
+  // Throughput Report
+  //
+  double secs=(double)elapsed.elapsed()/1000.0;
+  printf("Validated %u audio lengths",validated);
+  if(workers>0) {
+    printf(", hashed %u files (%.1f MB) with %u workers",hashed,mbytes,workers);
+  }
+  printf(" in %.1f seconds",secs);
+  if((workers>0)&&(secs>0.0)) {
+    printf(" [%.1f MB/sec]",mbytes/secs);
+  }
+  printf(".\n");
+  if(ckpt->resumed()>0) {
+    printf("Skipped %u cuts already checked in a previous run.\n",
+	   ckpt->resumed());
+  }
+  printf("\n");
+  ckpt->complete();
+  delete ckpt;
+
   *err_msg="ok";
   return true;
 }
@@ -210,16 +264,16 @@ void MainObject::RelinkAudio(const QString &srcdir) const
 
 void MainObject::CheckOrphanedTracks() const
 {
-  QString logname;
   QString sql="select NUMBER,TITLE,OWNER from CART where OWNER!=\"\"";
   QSqlQuery *q=new QSqlQuery(sql);
   QSqlQuery *q1;
 
   while(q->next()) {
-    logname=q->value(2).toString()+"_LOG";
-    logname.replace(" ","_");
-    sql=QString().sprintf("select ID from `%s` where CART_NUMBER=%u",
-			  (const char *)logname,q->value(0).toUInt());
+    sql=QString("select LOG_LINES.ID from LOG_LINES left join LOGS ")+
+      "on LOG_LINES.LOG_NAME=LOGS.NAME where "+
+      "(replace(LOGS.NAME,\" \",\"_\")=\""+
+      RDEscapeString(q->value(2).toString())+"\")&&"+
+      QString().sprintf("(LOG_LINES.CART_NUMBER=%u)",q->value(0).toUInt());
     q1=new QSqlQuery(sql);
     if(!q1->first()) {
       printf("  Found orphaned track %u - \"%s\".  Delete? (y/N) ",
@@ -360,6 +414,7 @@ void MainObject::CheckOrphanedTables() const
 {
   QSqlQuery *table_q;
   QSqlQuery *q;
+  QSqlQuery *q1;
   QString sql;
 
   //
@@ -396,11 +451,42 @@ void MainObject::CheckOrphanedTables() const
   delete q;
 
   //
-  // Look for orphaned services
+  // Look for orphaned log lines
   //
-  sql="select NAME from SERVICES";
+  sql=QString("select distinct LOG_LINES.LOG_NAME from LOG_LINES ")+
+    "left join LOGS on LOG_LINES.LOG_NAME=LOGS.NAME where LOGS.NAME is null";
   q=new QSqlQuery(sql);
-  CleanTables("SRT",table_q,q);
+  while(q->next()) {
+    printf("  Lines for log %s are orphaned -- delete (y/N)? ",
+	   (const char *)q->value(0).toString());
+    fflush(NULL);
+    if(UserResponse()) {
+      sql=QString("delete from LOG_LINES where ")+
+	"LOG_NAME=\""+RDEscapeString(q->value(0).toString())+"\"";
+      q1=new QSqlQuery(sql);
+      delete q1;
+    }
+  }
+  delete q;
+
+  //
+  // Look for orphaned as-played records
+  //
+  sql=QString("select distinct ELR_LINES.SERVICE_NAME from ELR_LINES ")+
+    "left join SERVICES on ELR_LINES.SERVICE_NAME=SERVICES.NAME "+
+    "where SERVICES.NAME is null";
+  q=new QSqlQuery(sql);
+  while(q->next()) {
+    printf("  As-played data for service %s is orphaned -- delete (y/N)? ",
+	   (const char *)q->value(0).toString());
+    fflush(NULL);
+    if(UserResponse()) {
+      sql=QString("delete from ELR_LINES where ")+
+	"SERVICE_NAME=\""+RDEscapeString(q->value(0).toString())+"\"";
+      q1=new QSqlQuery(sql);
+      delete q1;
+    }
+  }
   delete q;
 
   //
@@ -417,6 +503,7 @@ void MainObject::CheckOrphanedTables() const
   //
   CleanTables("IMP",table_q);
   CleanTables("REC",table_q);
+  CleanTables("SRT",table_q);
 
 
   delete table_q;
@@ -585,7 +672,23 @@ void MainObject::CheckOrphanedCuts() const
 }
 
 
-void MainObject::CheckOrphanedAudio() const
+void MainObject::LoadCuts(std::map<QString,int> *lengths,
+			  std::map<QString,QString> *hashes) const
+{
+  QString sql;
+  QSqlQuery *q;
+
+  sql="select CUT_NAME,LENGTH,SHA1_HASH from CUTS order by CUT_NAME";
+  q=new QSqlQuery(sql);
+  while(q->next()) {
+    (*lengths)[q->value(0).toString()]=q->value(1).toInt();
+    (*hashes)[q->value(0).toString()]=q->value(2).toString();
+  }
+  delete q;
+}
+
+
+void MainObject::CheckOrphanedAudio(const std::map<QString,int> &cuts) const
 {
   QDir dir(db_config->audioRoot());
   QStringList list=dir.entryList("??????_???.wav",QDir::Files);
@@ -595,11 +698,7 @@ void MainObject::CheckOrphanedAudio() const
     if(ok) {
       list[i].mid(7,3).toInt(&ok);
       if(ok) {
-	QString sql=QString().sprintf("select CUT_NAME from CUTS \
-                                       where CUT_NAME=\"%s\"",
-				      (const char *)list[i].left(10));
-	QSqlQuery *q=new QSqlQuery(sql);
-	if(!q->first()) {
+	if(cuts.find(list[i].left(10))==cuts.end()) {
 	  printf("  File \"%s/%s\" is orphaned.\n",
 		 (const char *)db_config->audioRoot(),(const char *)list[i]);
 	  if(db_dump_cuts_dir.isEmpty()) {
@@ -618,125 +717,143 @@ void MainObject::CheckOrphanedAudio() const
 	    }
 	  }
 	}
-	delete q;
       }
     }
   }
 }
 
 
-void MainObject::ValidateAudioLengths() const
+unsigned MainObject::ValidateAudioLengths(const std::map<QString,int> &lengths,
+					  CheckPoint *ckpt) const
 {
-  QString sql;
-  QSqlQuery *q;
   RDWaveFile *wave=NULL;
+  unsigned ret=0;
 
-  sql="select CUT_NAME,CART_NUMBER,LENGTH from CUTS order by CART_NUMBER";
-  q=new QSqlQuery(sql);
-  while(q->next()) {
-    if(q->value(2).toInt()>0) {
-      wave=new RDWaveFile(RDCut::pathName(q->value(0).toString()));
+  for(std::map<QString,int>::const_iterator it=lengths.begin();
+      it!=lengths.end();it++) {
+    if((it->second>0)&&(!ckpt->isDone('L',it->first))) {
+      wave=new RDWaveFile(RDCut::pathName(it->first));
       if(wave->openWave()) {
-	if((int)wave->getExtTimeLength()<(q->value(2).toInt()-100)) {
-	  SetCutLength(q->value(0).toString(),wave->getExtTimeLength());
+	if((int)wave->getExtTimeLength()<(it->second-100)) {
+	  SetCutLength(it->first,wave->getExtTimeLength());
 	}
       }
       else {
-	SetCutLength(q->value(0).toString(),0);
+	SetCutLength(it->first,0);
       }
       delete wave;
+      ckpt->setDone('L',it->first);
+      ret++;
     }
   }
-  delete q;
+
+  return ret;
 }
 
 
-void MainObject::Rehash(const QString &arg) const
+void MainObject::LoadRehashJobs(const QString &arg,CheckPoint *ckpt,
+				std::vector<CheckJob> *jobs) const
 {
   QString sql;
   QSqlQuery *q;
   unsigned cartnum;
   bool ok=false;
 
+  cartnum=arg.toUInt(&ok);
   if(arg.lower()=="all") {
-    sql=QString("select NUMBER from CART where ")+
-      QString().sprintf("TYPE=%d ",RDCart::Audio)+
-      "order by NUMBER";
-    q=new QSqlQuery(sql);
-    while(q->next()) {
-      RehashCart(q->value(0).toUInt());
-    }
-    delete q;
-    return;
+    sql=QString("select CUTS.CUT_NAME from CUTS left join CART ")+
+      "on CUTS.CART_NUMBER=CART.NUMBER where "+
+      QString().sprintf("CART.TYPE=%d ",RDCart::Audio)+
+      "order by CUTS.CUT_NAME";
   }
-  cartnum=arg.toUInt(&ok);
-  if(ok&&(cartnum>0)&&(cartnum<=RD_MAX_CART_NUMBER)) {
-    RehashCart(cartnum);
-    return;
+  else {
+    if(ok&&(cartnum>0)&&(cartnum<=RD_MAX_CART_NUMBER)) {
+      sql=QString("select TYPE from CART where ")+
+	QString().sprintf("NUMBER=%u",cartnum);
+      q=new QSqlQuery(sql);
+      if(!q->first()) {
+	printf("  Cart %06u does not exist.\n",cartnum);
+	delete q;
+	return;
+      }
+      if(q->value(0).toInt()!=RDCart::Audio) {
+	delete q;
+	return;
+      }
+      delete q;
+      sql=QString("select CUT_NAME from CUTS where ")+
+	QString().sprintf("CART_NUMBER=%u ",cartnum)+
+	"order by CUT_NAME";
+    }
+    else {
+      sql=QString("select CUT_NAME from CUTS where ")+
+	"CUT_NAME=\""+RDEscapeString(arg)+"\"";
+    }
   }
-  RDCut *cut=new RDCut(arg);
-  if(cut->exists()) {
-    RehashCut(arg);
+  q=new QSqlQuery(sql);
+  while(q->next()) {
+    if(!ckpt->isDone('H',q->value(0).toString())) {
+      jobs->push_back(CheckJob((const char *)q->value(0).toString(),
+	      (const char *)RDCut::pathName(q->value(0).toString())));
+    }
   }
-  delete cut;
+  delete q;
 }
 
 
-void MainObject::RehashCart(unsigned cartnum) const
+unsigned MainObject::Rehash(CheckPool *pool,std::vector<CheckJob> *jobs,
+			    const std::map<QString,QString> &hashes,
+			    CheckPoint *ckpt) const
 {
-  RDCart *cart=new RDCart(cartnum);
-  if(cart->exists()) {
-    if(cart->type()==RDCart::Audio) {
-      QString sql=QString("select CUT_NAME from CUTS where ")+
-	QString().sprintf("CART_NUMBER=%u ",cartnum)+
-	"order by CUT_NAME";
-      QSqlQuery *q=new QSqlQuery(sql);
-      while(q->next()) {
-	RehashCut(q->value(0).toString());
-      }
-      delete q;
+  int index;
+  unsigned ret=0;
+
+  while((index=pool->nextResult())>=0) {
+    CheckJob *job=&jobs->at(index);
+    QString cutname=job->cut_name.c_str();
+    if(job->ok) {
+      std::map<QString,QString>::const_iterator it=hashes.find(cutname);
+      RehashCut(cutname,it==hashes.end()?QString():it->second,job->hash);
+      ret++;
     }
+    else {
+      printf("  Unable to generate hash for \"%s\"\n",job->path.c_str());
+    }
+    ckpt->setDone('H',cutname);
   }
-  else {
-    printf("  Cart %06u does not exist.\n",cartnum);
-  }
+
+  return ret;
 }
 
 
-void MainObject::RehashCut(const QString &cutnum) const
+void MainObject::RehashCut(const QString &cutnum,const QString &old_hash,
+			   const QString &hash) const
 {
-  QString hash=RDSha1Hash(RDCut::pathName(cutnum),true);
-  if(hash.isEmpty()) {
-    printf("  Unable to generate hash for \"%s\"\n",
-	    (const char *)RDCut::pathName(cutnum));
-  }
-  else {
-    RDCut *cut=new RDCut(cutnum);
-    if(cut->exists()) {
-      if(cut->sha1Hash().isEmpty()) {
-	cut->setSha1Hash(hash);
-      }
-      else {
-	if(cut->sha1Hash()!=hash) {
-	  RDCart *cart=new RDCart(RDCut::cartNumber(cutnum));
-	  printf("  Cut %d [%s] in cart %06u [%s] has inconsistent SHA1 hash.  Fix? (y/N) ",
-		 cut->cutNumber(),
-		 (const char *)cut->description(),
-		 cart->number(),
-		 (const char *)cart->title());
-	  fflush(NULL);
-	  if(UserResponse()) {
-	    cut->setSha1Hash(hash);
-	  }
-	  delete cart;
-	}
-      }
+  RDCut *cut=new RDCut(cutnum);
+  if(cut->exists()) {
+    if(old_hash.isEmpty()) {
+      cut->setSha1Hash(hash);
     }
     else {
-      printf("  Cut \"%s\" does not exist.\n",(const char *)cutnum);
+      if(old_hash!=hash) {
+	RDCart *cart=new RDCart(RDCut::cartNumber(cutnum));
+	printf("  Cut %d [%s] in cart %06u [%s] has inconsistent SHA1 hash.  Fix? (y/N) ",
+	       cut->cutNumber(),
+	       (const char *)cut->description(),
+	       cart->number(),
+	       (const char *)cart->title());
+	fflush(NULL);
+	if(UserResponse()) {
+	  cut->setSha1Hash(hash);
+	}
+	delete cart;
+      }
     }
-    delete cut;
   }
+  else {
+    printf("  Cut \"%s\" does not exist.\n",(const char *)cutnum);
+  }
+  delete cut;
 }
 
 
@@ -0,0 +1,291 @@
+// checkpool.cpp
+//
+// Worker pool and checkpoint file for --check for rddbmgr(8)
+//
+//   (C) Copyright 2018 Fred Gleason <fredg@paravelsystems.com>
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License version 2 as
+//   published by the Free Software Foundation.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public
+//   License along with this program; if not, write to the Free Software
+//   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+//
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "checkpool.h"
+
+CheckJob::CheckJob(const std::string &cutname,const std::string &path)
+{
+  cut_name=cutname;
+  this->path=path;
+  ok=false;
+  bytes=0;
+  hash[0]=0;
+}
+
+
+CheckPool::CheckPool(unsigned workers,double mbytes_per_sec)
+{
+  pool_jobs=NULL;
+  pool_workers=workers;
+  if(pool_workers==0) {
+    pool_workers=1;
+  }
+  pool_next_job=0;
+  pool_finished=0;
+  pool_returned=0;
+  pool_rate=mbytes_per_sec*1048576.0;
+  pool_budget_time=0.0;
+  pool_bytes_read=0.0;
+  pthread_mutex_init(&pool_mutex,NULL);
+  pthread_cond_init(&pool_result_cond,NULL);
+  pthread_mutex_init(&pool_budget_mutex,NULL);
+}
+
+
+CheckPool::~CheckPool()
+{
+  pthread_mutex_lock(&pool_mutex);
+  if(pool_jobs!=NULL) {
+    pool_next_job=pool_jobs->size();  // Cancel anything not yet started
+  }
+  pthread_mutex_unlock(&pool_mutex);
+  for(unsigned i=0;i<pool_threads.size();i++) {
+    pthread_join(pool_threads[i],NULL);
+  }
+  pthread_mutex_destroy(&pool_budget_mutex);
+  pthread_cond_destroy(&pool_result_cond);
+  pthread_mutex_destroy(&pool_mutex);
+}
+
+
+unsigned CheckPool::workers() const
+{
+  return pool_workers;
+}
+
+
+void CheckPool::start(std::vector<CheckJob> *jobs)
+{
+  pthread_t thread;
+
+  pool_jobs=jobs;
+  pool_budget_time=Now();
+  for(unsigned i=0;i<pool_workers;i++) {
+    if(pthread_create(&thread,NULL,WorkerThread,this)==0) {
+      pool_threads.push_back(thread);
+    }
+  }
+  if(pool_threads.size()==0) {  // No threads available, so do it here
+    WorkerThread(this);
+  }
+}
+
+
+int CheckPool::nextResult()
+{
+  int ret=-1;
+
+  if((pool_jobs==NULL)||(pool_returned==pool_jobs->size())) {
+    return -1;
+  }
+  pthread_mutex_lock(&pool_mutex);
+  while(pool_results.empty()) {
+    pthread_cond_wait(&pool_result_cond,&pool_mutex);
+  }
+  ret=pool_results.front();
+  pool_results.pop();
+  pthread_mutex_unlock(&pool_mutex);
+  pool_returned++;
+
+  return ret;
+}
+
+
+double CheckPool::bytesRead() const
+{
+  return pool_bytes_read;
+}
+
+
+void *CheckPool::WorkerThread(void *priv)
+{
+  CheckPool *pool=(CheckPool *)priv;
+  unsigned char *buffer=(unsigned char *)malloc(CHECKPOOL_BUFFER_SIZE);
+  int index;
+
+  while(true) {
+    pthread_mutex_lock(&pool->pool_mutex);
+    if(pool->pool_next_job>=pool->pool_jobs->size()) {
+      pthread_mutex_unlock(&pool->pool_mutex);
+      break;
+    }
+    index=pool->pool_next_job++;
+    pthread_mutex_unlock(&pool->pool_mutex);
+
+    if(buffer!=NULL) {
+      pool->Hash(&pool->pool_jobs->at(index),buffer);
+    }
+
+    pthread_mutex_lock(&pool->pool_mutex);
+    pool->pool_bytes_read+=pool->pool_jobs->at(index).bytes;
+    pool->pool_finished++;
+    pool->pool_results.push(index);
+    pthread_cond_signal(&pool->pool_result_cond);
+    pthread_mutex_unlock(&pool->pool_mutex);
+  }
+  free(buffer);
+
+  return NULL;
+}
+
+
+void CheckPool::Hash(CheckJob *job,unsigned char *buffer)
+{
+  SHA_CTX ctx;
+  unsigned char md[SHA_DIGEST_LENGTH];
+  int fd=-1;
+  ssize_t n;
+
+  if((fd=open(job->path.c_str(),O_RDONLY))<0) {
+    return;
+  }
+  posix_fadvise(fd,0,0,POSIX_FADV_SEQUENTIAL);
+  SHA1_Init(&ctx);
+  while((n=read(fd,buffer,CHECKPOOL_BUFFER_SIZE))>0) {
+    SHA1_Update(&ctx,buffer,n);
+    job->bytes+=n;
+    Throttle(n);
+  }
+  close(fd);
+  if(n<0) {
+    return;
+  }
+  SHA1_Final(md,&ctx);
+  for(int i=0;i<SHA_DIGEST_LENGTH;i++) {
+    snprintf(job->hash+2*i,3,"%02x",0xff&md[i]);
+  }
+  job->ok=true;
+}
+
+
+void CheckPool::Throttle(size_t bytes)
+{
+  double now;
+  double start;
+
+  //
+  // A single budget is shared by all workers: each read reserves the next
+  // slot of 'bytes/pool_rate' seconds and sleeps until it begins.
+  //
+  if(pool_rate<=0.0) {
+    return;
+  }
+  now=Now();
+  pthread_mutex_lock(&pool_budget_mutex);
+  if(pool_budget_time<now) {
+    pool_budget_time=now;
+  }
+  start=pool_budget_time;
+  pool_budget_time+=(double)bytes/pool_rate;
+  pthread_mutex_unlock(&pool_budget_mutex);
+  if(start>now) {
+    usleep((useconds_t)(1000000.0*(start-now)));
+  }
+}
+
+
+double CheckPool::Now()
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC,&ts);
+  return (double)ts.tv_sec+(double)ts.tv_nsec/1000000000.0;
+}
+
+
+CheckPoint::CheckPoint(const QString &filename)
+{
+  char line[256];
+  int len;
+
+  ck_filename=filename;
+  ck_file=NULL;
+  if(ck_filename.isEmpty()) {
+    return;
+  }
+  if((ck_file=fopen(ck_filename,"r"))!=NULL) {
+    while(fgets(line,256,ck_file)!=NULL) {
+      if((len=strlen(line))>0) {
+	if(line[len-1]=='\n') {
+	  line[--len]=0;
+	}
+	if((len>2)&&(line[1]==' ')) {
+	  ck_done.insert(QString(line));
+	}
+      }
+    }
+    fclose(ck_file);
+  }
+  if((ck_file=fopen(ck_filename,"a"))==NULL) {
+    fprintf(stderr,"rddbmgr: unable to open checkpoint file \"%s\" [%s]\n",
+	    (const char *)ck_filename,strerror(errno));
+  }
+}
+
+
+CheckPoint::~CheckPoint()
+{
+  if(ck_file!=NULL) {
+    fclose(ck_file);
+  }
+}
+
+
+bool CheckPoint::isDone(char phase,const QString &cutname) const
+{
+  if(ck_done.size()==0) {
+    return false;
+  }
+  return ck_done.find(QString(QChar(phase))+" "+cutname)!=ck_done.end();
+}
+
+
+void CheckPoint::setDone(char phase,const QString &cutname)
+{
+  if(ck_file!=NULL) {
+    fprintf(ck_file,"%c %s\n",phase,(const char *)cutname);
+    fflush(ck_file);
+  }
+}
+
+
+unsigned CheckPoint::resumed() const
+{
+  return ck_done.size();
+}
+
+
+void CheckPoint::complete()
+{
+  if(ck_file!=NULL) {
+    fclose(ck_file);
+    ck_file=NULL;
+    unlink(ck_filename);
+  }
+  ck_done.clear();
+}
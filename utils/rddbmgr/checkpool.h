@@ -0,0 +1,112 @@
+// checkpool.h
+//
+// Worker pool and checkpoint file for --check for rddbmgr(8)
+//
+//   (C) Copyright 2018 Fred Gleason <fredg@paravelsystems.com>
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License version 2 as
+//   published by the Free Software Foundation.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public
+//   License along with this program; if not, write to the Free Software
+//   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+//
+
+#ifndef CHECKPOOL_H
+#define CHECKPOOL_H
+
+#include <pthread.h>
+#include <stdio.h>
+#include <sys/types.h>
+
+#include <queue>
+#include <set>
+#include <string>
+#include <vector>
+
+#include <openssl/sha.h>
+
+#include <qstring.h>
+
+//
+// Size of the read buffer used by each worker
+//
+#define CHECKPOOL_BUFFER_SIZE 1048576
+
+//
+// The workers touch no Qt or database objects; all paths are converted
+// to std::string before the pool starts and all results are handled by
+// the calling thread.
+//
+class CheckJob
+{
+ public:
+  CheckJob(const std::string &cutname,const std::string &path);
+  std::string cut_name;
+  std::string path;
+  bool ok;
+  off_t bytes;
+  char hash[SHA_DIGEST_LENGTH*2+1];
+};
+
+
+class CheckPool
+{
+ public:
+  CheckPool(unsigned workers,double mbytes_per_sec);
+  ~CheckPool();
+  unsigned workers() const;
+  void start(std::vector<CheckJob> *jobs);
+  int nextResult();
+  double bytesRead() const;
+
+ private:
+  static void *WorkerThread(void *priv);
+  void Hash(CheckJob *job,unsigned char *buffer);
+  void Throttle(size_t bytes);
+  static double Now();
+  std::vector<CheckJob> *pool_jobs;
+  std::vector<pthread_t> pool_threads;
+  std::queue<int> pool_results;
+  unsigned pool_workers;
+  unsigned pool_next_job;
+  unsigned pool_finished;
+  unsigned pool_returned;
+  double pool_rate;
+  double pool_budget_time;
+  double pool_bytes_read;
+  pthread_mutex_t pool_mutex;
+  pthread_cond_t pool_result_cond;
+  pthread_mutex_t pool_budget_mutex;
+};
+
+
+//
+// Records each cut as it is checked so that an interrupted run can pick
+// up where it left off.  Entries are of the form "<phase> <cut-name>", one
+// per line.  The file is removed once the check completes.
+//
+class CheckPoint
+{
+ public:
+  CheckPoint(const QString &filename);
+  ~CheckPoint();
+  bool isDone(char phase,const QString &cutname) const;
+  void setDone(char phase,const QString &cutname);
+  unsigned resumed() const;
+  void complete();
+
+ private:
+  QString ck_filename;
+  FILE *ck_file;
+  std::set<QString> ck_done;
+};
+
+
+#endif  // CHECKPOOL_H
@@ -51,6 +51,11 @@ MainObject::MainObject(QObject *parent)
   db_no=false;
   db_relink_audio="";
   db_relink_audio_move=false;
+  db_check_jobs=sysconf(_SC_NPROCESSORS_ONLN);
+  if((int)db_check_jobs<1) {
+    db_check_jobs=1;
+  }
+  db_check_io_rate=0.0;
 
   //
   // Check that we're 'root'
@@ -207,6 +212,26 @@ MainObject::MainObject(QObject *parent)
     if(cmd->key(i)=="--rehash") {
       db_rehash=cmd->value(i);
     }
+    if(cmd->key(i)=="--check-jobs") {
+      db_check_jobs=cmd->value(i).toUInt(&ok);
+      if((!ok)||(db_check_jobs==0)) {
+	fprintf(stderr,"rddbmgr: invalid --check-jobs value\n");
+	exit(1);
+      }
+      cmd->setProcessed(i,true);
+    }
+    if(cmd->key(i)=="--check-io-rate") {
+      db_check_io_rate=cmd->value(i).toDouble(&ok);
+      if((!ok)||(db_check_io_rate<0.0)) {
+	fprintf(stderr,"rddbmgr: invalid --check-io-rate value\n");
+	exit(1);
+      }
+      cmd->setProcessed(i,true);
+    }
+    if(cmd->key(i)=="--checkpoint") {
+      db_checkpoint=cmd->value(i);
+      cmd->setProcessed(i,true);
+    }
 
     if(!cmd->processed(i)) {
       fprintf(stderr,"rddbmgr: unrecognized option \"%s\"\n",
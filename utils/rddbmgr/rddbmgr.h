@@ -21,11 +21,16 @@
 #ifndef RDDBMGR_H
 #define RDDBMGR_H
 
+#include <map>
+#include <vector>
+
 #include <qobject.h>
 
 #include <rdconfig.h>
 #include <rdstation.h>
 
+#include "checkpool.h"
+
 #define RDDBMGR_USAGE "[options]\n"
 
 class MainObject : public QObject
@@ -48,11 +53,18 @@ class MainObject : public QObject
   void CheckPendingCarts() const;
   void CheckOrphanedCarts() const;
   void CheckOrphanedCuts() const;
-  void CheckOrphanedAudio() const;
-  void ValidateAudioLengths() const;
-  void Rehash(const QString &arg) const;
-  void RehashCart(unsigned cartnum) const;
-  void RehashCut(const QString &cutnum) const;
+  void LoadCuts(std::map<QString,int> *lengths,
+		std::map<QString,QString> *hashes) const;
+  void CheckOrphanedAudio(const std::map<QString,int> &cuts) const;
+  unsigned ValidateAudioLengths(const std::map<QString,int> &lengths,
+				CheckPoint *ckpt) const;
+  void LoadRehashJobs(const QString &arg,CheckPoint *ckpt,
+		      std::vector<CheckJob> *jobs) const;
+  unsigned Rehash(CheckPool *pool,std::vector<CheckJob> *jobs,
+		  const std::map<QString,QString> &hashes,
+		  CheckPoint *ckpt) const;
+  void RehashCut(const QString &cutnum,const QString &old_hash,
+		 const QString &hash) const;
   void SetCutLength(const QString &cutname,int len) const;
   void CleanTables(const QString &ext,QSqlQuery *table_q,
 		   QSqlQuery *name_q) const;
@@ -94,6 +106,8 @@ class MainObject : public QObject
   bool UpdateLogTable186(const QString &table,QString *err_msg) const;
   bool ConvertTimeField186(const QString &table,const QString &field,
 			   QString *err_msg) const;
+  QString LogLineFields288() const;
+  QString ElrLineFields289() const;
 
   //
   // revertschema.cpp
@@ -127,6 +141,9 @@ class MainObject : public QObject
   QString db_orphan_group_name;
   QString db_dump_cuts_dir;
   QString db_rehash;
+  unsigned db_check_jobs;
+  double db_check_io_rate;
+  QString db_checkpoint;
   QString db_relink_audio;
   bool db_relink_audio_move;
   QString db_table_create_postfix;
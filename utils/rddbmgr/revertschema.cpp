@@ -18,6 +18,7 @@
 //   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
 //
 
+#include <rdcreate_log.h>
 #include <rddb.h>
 #include <rdescape_string.h>
 
@@ -36,6 +37,80 @@ bool MainObject::RevertSchema(int cur_schema,int set_schema,QString *err_msg) co
   // corresponding update in updateschema.cpp!
   //
 
+  //
+  // Revert 290
+  //
+  if((cur_schema==290)&&(set_schema<cur_schema)) {
+    sql=QString("alter table CUTS drop column RECORDING");
+    if(!RDSqlQuery::apply(sql,err_msg)) {
+      return false;
+    }
+
+    cur_schema--;
+  }
+
+  //
+  // Revert 289
+  //
+  if((cur_schema==289)&&(set_schema<cur_schema)) {
+    sql=QString("select NAME from SERVICES");
+    q=new RDSqlQuery(sql,false);
+    while(q->next()) {
+      tablename=q->value(0).toString()+"_SRT";
+      tablename.replace(" ","_");
+      sql=RDCreateReconciliationTableSql(tablename,db_config);
+      if(!RDSqlQuery::apply(sql,err_msg)) {
+	return false;
+      }
+      sql=QString("insert into `")+tablename+"` (EVENT_DATETIME,"+
+	ElrLineFields289()+") select EVENT_DATETIME,"+ElrLineFields289()+
+	" from ELR_LINES where "+
+	"SERVICE_NAME=\""+RDEscapeString(q->value(0).toString())+"\" "+
+	"order by ID";
+      if(!RDSqlQuery::apply(sql,err_msg)) {
+	return false;
+      }
+    }
+    delete q;
+
+    sql=QString("drop table ELR_LINES");
+    if(!RDSqlQuery::apply(sql,err_msg)) {
+      return false;
+    }
+
+    cur_schema--;
+  }
+
+  //
+  // Revert 288
+  //
+  if((cur_schema==288)&&(set_schema<cur_schema)) {
+    sql=QString("select NAME from LOGS");
+    q=new RDSqlQuery(sql,false);
+    while(q->next()) {
+      tablename=q->value(0).toString()+"_LOG";
+      tablename.replace(" ","_");
+      sql=RDCreateLogTableSql(tablename,db_config);
+      if(!RDSqlQuery::apply(sql,err_msg)) {
+	return false;
+      }
+      sql=QString("insert into `")+tablename+"` ("+LogLineFields288()+") "+
+	"select "+LogLineFields288()+" from LOG_LINES where "+
+	"LOG_NAME=\""+RDEscapeString(q->value(0).toString())+"\"";
+      if(!RDSqlQuery::apply(sql,err_msg)) {
+	return false;
+      }
+    }
+    delete q;
+
+    sql=QString("drop table LOG_LINES");
+    if(!RDSqlQuery::apply(sql,err_msg)) {
+      return false;
+    }
+
+    cur_schema--;
+  }
+
   //
   // Revert 287
   //
@@ -7167,6 +7167,201 @@ bool MainObject::UpdateSchema(int cur_schema,int set_schema,QString *err_msg) co
     cur_schema++;
   }
 
+  if((cur_schema<288)&&(set_schema>cur_schema)) {
+    QTime elapsed;
+    QStringList tables;
+    int logs=0;
+
+    elapsed.start();
+    sql=QString("create table if not exists LOG_LINES (")+
+      "LOG_NAME char(64) not null,"+
+      "ID int not null,"+
+      "COUNT int not null,"+
+      "TYPE int default 0,"+
+      "SOURCE int not null,"+
+      "START_TIME int,"+
+      "GRACE_TIME int default 0,"+
+      "CART_NUMBER int unsigned not null default 0,"+
+      "TIME_TYPE int not null,"+
+      "POST_POINT enum('N','Y') default 'N',"+
+      "TRANS_TYPE int not null,"+
+      "START_POINT int not null default -1,"+
+      "END_POINT int not null default -1,"+
+      "FADEUP_POINT int default -1,"+
+      QString().sprintf("FADEUP_GAIN int default %d,",RD_FADE_DEPTH)+
+      "FADEDOWN_POINT int default -1,"+
+      QString().sprintf("FADEDOWN_GAIN int default %d,",RD_FADE_DEPTH)+
+      "SEGUE_START_POINT int not null default -1,"+
+      "SEGUE_END_POINT int not null default -1,"+
+      QString().sprintf("SEGUE_GAIN int default %d,",RD_FADE_DEPTH)+
+      "DUCK_UP_GAIN int default 0,"+
+      "DUCK_DOWN_GAIN int default 0,"+
+      "COMMENT char(255),"+
+      "LABEL char(64),"+
+      "ORIGIN_USER char(255),"+
+      "ORIGIN_DATETIME datetime,"+
+      "EVENT_LENGTH int default -1,"+
+      "LINK_EVENT_NAME char(64),"+
+      "LINK_START_TIME int,"+
+      "LINK_LENGTH int default 0,"+
+      "LINK_START_SLOP int default 0,"+
+      "LINK_END_SLOP int default 0,"+
+      "LINK_ID int default -1,"+
+      "LINK_EMBEDDED enum('N','Y') default 'N',"+
+      "EXT_START_TIME time,"+
+      "EXT_LENGTH int,"+
+      "EXT_CART_NAME char(32),"+
+      "EXT_DATA char(32),"+
+      "EXT_EVENT_ID char(32),"+
+      "EXT_ANNC_TYPE char(8),"+
+      "primary key (LOG_NAME,ID),"+
+      "index COUNT_IDX (LOG_NAME,COUNT),"+
+      "index CART_NUMBER_IDX (CART_NUMBER),"+
+      "index LABEL_IDX (LOG_NAME,LABEL))"+
+      db_table_create_postfix;
+    if(!RDSqlQuery::apply(sql,err_msg)) {
+      return false;
+    }
+
+    //
+    // Move each log table into LOG_LINES.  Logs without a table (never
+    // saved) simply have no lines.
+    //
+    q=new RDSqlQuery("show tables",false);
+    while(q->next()) {
+      tables.push_back(q->value(0).toString());
+    }
+    delete q;
+    sql=QString("select NAME from LOGS");
+    q=new RDSqlQuery(sql,false);
+    while(q->next()) {
+      tablename=q->value(0).toString()+"_LOG";
+      tablename.replace(" ","_");
+      if(tables.findIndex(tablename)<0) {
+	continue;
+      }
+      sql=QString("insert into LOG_LINES (LOG_NAME,")+LogLineFields288()+
+	") select \""+RDEscapeString(q->value(0).toString())+"\","+
+	LogLineFields288()+" from `"+tablename+"`";
+      if(!RDSqlQuery::apply(sql,err_msg)) {
+	return false;
+      }
+      sql=QString("drop table `")+tablename+"`";
+      if(!RDSqlQuery::apply(sql,err_msg)) {
+	return false;
+      }
+      logs++;
+    }
+    delete q;
+    if(db_verbose) {
+      fprintf(stderr,"moved %d log tables into LOG_LINES in %d mS\n",
+	      logs,elapsed.elapsed());
+    }
+
+    cur_schema++;
+  }
+
+  if((cur_schema<289)&&(set_schema>cur_schema)) {
+    QTime elapsed;
+    QStringList tables;
+    int svcs=0;
+
+    elapsed.start();
+    sql=QString("create table if not exists ELR_LINES (")+
+      "ID int unsigned not null auto_increment,"+
+      "SERVICE_NAME char(10) not null,"+
+      "LENGTH int,"+
+      "LOG_NAME char(64),"+
+      "LOG_ID int,"+
+      "CART_NUMBER int unsigned,"+
+      "CUT_NUMBER int,"+
+      "TITLE char(255),"+
+      "ARTIST char(255),"+
+      "PUBLISHER char(64),"+
+      "COMPOSER char(64),"+
+      "USER_DEFINED char(255),"+
+      "SONG_ID char(32),"+
+      "ALBUM char(255),"+
+      "LABEL char(64),"+
+      "CONDUCTOR char(64),"+
+      "USAGE_CODE int,"+
+      "DESCRIPTION char(64),"+
+      "OUTCUE char(64),"+
+      "ISRC char(12),"+
+      "ISCI char(32),"+
+      "STATION_NAME char(64),"+
+      "EVENT_DATETIME datetime not null,"+
+      "SCHEDULED_TIME time,"+
+      "EVENT_TYPE int,"+
+      "EVENT_SOURCE int,"+
+      "PLAY_SOURCE int,"+
+      "START_SOURCE int default 0,"+
+      "ONAIR_FLAG enum('N','Y') default 'N',"+
+      "EXT_START_TIME time,"+
+      "EXT_LENGTH int,"+
+      "EXT_CART_NAME char(32),"+
+      "EXT_DATA char(32),"+
+      "EXT_EVENT_ID char(8),"+
+      "EXT_ANNC_TYPE char(8),"+
+      "primary key (ID,EVENT_DATETIME),"+
+      "index SERVICE_EVENT_IDX (SERVICE_NAME,EVENT_DATETIME),"+
+      "index CART_EVENT_IDX (CART_NUMBER,EVENT_DATETIME))"+
+      db_table_create_postfix;
+    if(!RDSqlQuery::apply(sql,err_msg)) {
+      return false;
+    }
+
+    //
+    // Move each service reconciliation table into ELR_LINES.  Records
+    // without an event time are kept, stamped at the start of the epoch.
+    //
+    q=new RDSqlQuery("show tables",false);
+    while(q->next()) {
+      tables.push_back(q->value(0).toString());
+    }
+    delete q;
+    sql=QString("select NAME from SERVICES");
+    q=new RDSqlQuery(sql,false);
+    while(q->next()) {
+      tablename=q->value(0).toString()+"_SRT";
+      tablename.replace(" ","_");
+      if(tables.findIndex(tablename)<0) {
+	continue;
+      }
+      sql=QString("insert into ELR_LINES (SERVICE_NAME,EVENT_DATETIME,")+
+	ElrLineFields289()+") select \""+
+	RDEscapeString(q->value(0).toString())+"\","+
+	"ifnull(EVENT_DATETIME,\"1000-01-01 00:00:00\"),"+
+	ElrLineFields289()+" from `"+tablename+"`";
+      if(!RDSqlQuery::apply(sql,err_msg)) {
+	return false;
+      }
+      sql=QString("drop table `")+tablename+"`";
+      if(!RDSqlQuery::apply(sql,err_msg)) {
+	return false;
+      }
+      svcs++;
+    }
+    delete q;
+    if(db_verbose) {
+      fprintf(stderr,
+	      "moved %d reconciliation tables into ELR_LINES in %d mS\n",
+	      svcs,elapsed.elapsed());
+    }
+
+    cur_schema++;
+  }
+
+  if((cur_schema<290)&&(set_schema>cur_schema)) {
+    sql=QString("alter table CUTS add column ")+
+      "RECORDING enum('N','Y') not null default 'N' after SHA1_HASH";
+    if(!RDSqlQuery::apply(sql,err_msg)) {
+      return false;
+    }
+
+    cur_schema++;
+  }
+
 
 
   //
@@ -7321,6 +7516,31 @@ void MainObject::CreateFeedLog151(const QString &key_name) const
 }
 
 
+QString MainObject::ElrLineFields289() const
+{
+  return QString("LENGTH,LOG_NAME,LOG_ID,CART_NUMBER,CUT_NUMBER,TITLE,ARTIST,")+
+    "PUBLISHER,COMPOSER,USER_DEFINED,SONG_ID,ALBUM,LABEL,CONDUCTOR,"+
+    "USAGE_CODE,DESCRIPTION,OUTCUE,ISRC,ISCI,STATION_NAME,SCHEDULED_TIME,"+
+    "EVENT_TYPE,EVENT_SOURCE,PLAY_SOURCE,START_SOURCE,ONAIR_FLAG,"+
+    "EXT_START_TIME,EXT_LENGTH,EXT_CART_NAME,EXT_DATA,EXT_EVENT_ID,"+
+    "EXT_ANNC_TYPE";
+}
+
+
+QString MainObject::LogLineFields288() const
+{
+  return QString("ID,COUNT,TYPE,SOURCE,START_TIME,GRACE_TIME,CART_NUMBER,")+
+    "TIME_TYPE,POST_POINT,TRANS_TYPE,START_POINT,END_POINT,"+
+    "FADEUP_POINT,FADEUP_GAIN,FADEDOWN_POINT,FADEDOWN_GAIN,"+
+    "SEGUE_START_POINT,SEGUE_END_POINT,SEGUE_GAIN,"+
+    "DUCK_UP_GAIN,DUCK_DOWN_GAIN,COMMENT,LABEL,ORIGIN_USER,ORIGIN_DATETIME,"+
+    "EVENT_LENGTH,LINK_EVENT_NAME,LINK_START_TIME,LINK_LENGTH,"+
+    "LINK_START_SLOP,LINK_END_SLOP,LINK_ID,LINK_EMBEDDED,"+
+    "EXT_START_TIME,EXT_LENGTH,EXT_CART_NAME,EXT_DATA,EXT_EVENT_ID,"+
+    "EXT_ANNC_TYPE";
+}
+
+
 bool MainObject::UpdateLogTable186(const QString &table,QString *err_msg) const
 {
   QString sql;
@@ -18,13 +18,23 @@
 //   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
 //
 
+#include <errno.h>
+#include <fcntl.h>
 #include <signal.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
 
 #include <qapplication.h>
+#include <qdatetime.h>
 #include <qdir.h>
 #include <qfile.h>
+#include <qfileinfo.h>
+#include <qsqldatabase.h>
 
 #include <rd.h>
 #include <rdapplication.h>
@@ -34,6 +44,8 @@
 #include <rdcart.h>
 #include <rdescape_string.h>
 #include <rdgroup.h>
+#include <rdwavedata.h>
+#include <rdwavefile.h>
 
 #include "rdexport.h"
 
@@ -51,6 +63,11 @@ MainObject::MainObject(QObject *parent)
   export_channels=0;
   export_quality=3;
   export_xml=false;
+  export_verbose=false;
+  export_counters=NULL;
+  export_jobs=1;
+  export_incremental=false;
+  export_state_fd=-1;
 
   //
   // Open the Database
@@ -162,6 +179,19 @@ MainObject::MainObject(QObject *parent)
       export_groups.push_back(rda->cmdSwitch()->value(i));
       rda->cmdSwitch()->setProcessed(i,true);
     }
+    if(rda->cmdSwitch()->key(i)=="--incremental") {
+      export_incremental=true;
+      rda->cmdSwitch()->setProcessed(i,true);
+    }
+    if(rda->cmdSwitch()->key(i)=="--jobs") {
+      bool ok=false;
+      export_jobs=rda->cmdSwitch()->value(i).toUInt(&ok);
+      if((!ok)||(export_jobs<1)||(export_jobs>RDEXPORT_MAX_JOBS)) {
+	fprintf(stderr,"rdexport: invalid --jobs argument\n");
+	exit(256);
+      }
+      rda->cmdSwitch()->setProcessed(i,true);
+    }
     if(rda->cmdSwitch()->key(i)=="--metadata-pattern") {
       export_metadata_pattern=rda->cmdSwitch()->value(i);
       rda->cmdSwitch()->setProcessed(i,true);
@@ -261,7 +291,7 @@ void MainObject::userData()
   //
   for(unsigned i=0;i<export_titles.size();i++) {
     Verbose("Processing title \""+export_titles[i]+"\"...");
-    ExportTitle(export_titles[i]);
+    LoadCuts("(CART.TITLE=\""+RDEscapeString(export_titles[i])+"\")");
   }
 
   //
@@ -269,106 +299,268 @@ void MainObject::userData()
   //
   for(unsigned i=0;i<export_groups.size();i++) {
     Verbose("Processing group \""+export_groups[i]+"\"...");
-    ExportGroup(export_groups[i]);
+    LoadCuts("(CART.GROUP_NAME=\""+RDEscapeString(export_groups[i])+"\")");
   }
 
   //
   // Process Cart Ranges
   //
   for(unsigned i=0;i<export_start_carts.size();i++) {
-    for(unsigned j=export_start_carts[i];j<=export_end_carts[i];j++) {
-      ExportCart(j);
-    }
+    LoadCuts(QString().sprintf("(CART.NUMBER>=%u)&&(CART.NUMBER<=%u)",
+			       export_start_carts[i],export_end_carts[i]));
   }
 
+  //
+  // Export Cuts
+  //
+  if(export_incremental) {
+    LoadState();
+  }
+  RunExports();
+
   //
   // Clean Up and Exit
   //
+  if(export_counters->aborted) {
+    exit(256);
+  }
   exit(0);
 }
 
 
-void MainObject::ExportTitle(const QString &title)
+void MainObject::LoadCuts(const QString &where)
 {
   QString sql;
   RDSqlQuery *q;
 
-  sql=QString("select NUMBER from CART where ")+
-    "(TITLE=\""+RDEscapeString(title)+"\")&&"+
-    QString().sprintf("(TYPE=%u) ",RDCart::Audio)+
-    "order by NUMBER";
+  sql=QString("select CUTS.CUT_NAME from CART,CUTS where ")+
+    where+"&&"+
+    QString().sprintf("(CART.TYPE=%u)&&",RDCart::Audio)+
+    "(CUTS.CART_NUMBER=CART.NUMBER) "+
+    "order by CART.NUMBER,CUTS.CUT_NAME";
   q=new RDSqlQuery(sql);
   while(q->next()) {
-    ExportCart(q->value(0).toUInt());
+    export_cut_names.push_back(q->value(0).toString());
   }
   delete q;
 }
 
 
-void MainObject::ExportGroup(const QString &groupname)
+void MainObject::RunExports()
 {
-  QString sql;
-  RDSqlQuery *q;
+  std::vector<pid_t> workers;
+  QTime elapsed;
+  pid_t pid;
+  int status;
 
-  sql=QString("select NUMBER from CART where ")+
-    "(GROUP_NAME=\""+RDEscapeString(groupname)+"\")&&"+
-    QString().sprintf("(TYPE=%u) ",RDCart::Audio)+
-    "order by NUMBER";
-  q=new RDSqlQuery(sql);
-  while(q->next()) {
-    ExportCart(q->value(0).toUInt());
+  //
+  // The counters live in shared memory so that each worker can take the
+  // next cut from the list and add its results as it goes
+  //
+  export_counters=(ExportCounters *)mmap(NULL,sizeof(ExportCounters),
+					 PROT_READ|PROT_WRITE,
+					 MAP_SHARED|MAP_ANONYMOUS,-1,0);
+  if(export_counters==MAP_FAILED) {
+    fprintf(stderr,"rdexport: unable to allocate shared memory [%s]\n",
+	    strerror(errno));
+    exit(256);
   }
-  delete q;
+  memset(export_counters,0,sizeof(ExportCounters));
+  if(export_jobs>export_cut_names.size()) {
+    export_jobs=export_cut_names.size();
+  }
+  elapsed.start();
+  if(export_jobs<=1) {
+    RunWorker();
+  }
+  else {
+    //
+    // Each worker uses its own database connection.  Ours is closed
+    // while they are started, so that none of them inherits it; closing
+    // it in a worker would end the session on the server for everyone
+    // sharing the socket.
+    //
+    QSqlDatabase *db=QSqlDatabase::database();
+    db->close();
+    fflush(stdout);
+    fflush(stderr);
+    for(unsigned i=0;i<export_jobs;i++) {
+      if((pid=fork())==0) {
+	if(!db->open()) {
+	  fprintf(stderr,"rdexport: worker unable to open database\n");
+	  _exit(1);
+	}
+	RunWorker();
+	fflush(stdout);
+	fflush(stderr);
+	_exit(0);
+      }
+      if(pid<0) {
+	fprintf(stderr,"rdexport: unable to start worker [%s]\n",
+		strerror(errno));
+      }
+      else {
+	workers.push_back(pid);
+      }
+    }
+    db->open();
+    if(workers.size()==0) {
+      RunWorker();
+    }
+    while(workers.size()>0) {
+      if((pid=waitpid(-1,&status,0))<0) {
+	if(errno==EINTR) {
+	  continue;
+	}
+	break;
+      }
+      for(unsigned i=0;i<workers.size();i++) {
+	if(workers[i]==pid) {
+	  if((!WIFEXITED(status))||(WEXITSTATUS(status)!=0)) {
+	    fprintf(stderr,"rdexport: worker exited abnormally\n");
+	    if(!export_continue_after_error) {
+	      export_counters->aborted=true;
+	    }
+	  }
+	  workers.erase(workers.begin()+i);
+	  break;
+	}
+      }
+    }
+  }
+
+  //
+  // Throughput
+  //
+  double secs=(double)elapsed.elapsed()/1000.0;
+  double mbytes=(double)export_counters->bytes/1048576.0;
+  if(secs<0.001) {
+    secs=0.001;
+  }
+  Verbose(QString().sprintf("exported %u cuts, skipped %u, failed %u: ",
+			    export_counters->exported,
+			    export_counters->skipped,
+			    export_counters->failed)+
+	  QString().sprintf("%.1f MB in %.1f S ",mbytes,secs)+
+	  QString().sprintf("[%.2f cuts/S, %.2f MB/S, %u jobs]",
+			    (double)export_counters->exported/secs,
+			    mbytes/secs,export_jobs));
 }
 
 
-void MainObject::ExportCart(unsigned cartnum)
+void MainObject::RunWorker()
 {
-  RDCart *cart=new RDCart(cartnum);
-  QString sql;
-  RDSqlQuery *q;
-
-  if(cart->exists()&&(cart->type()==RDCart::Audio)) {
-    sql=QString().sprintf("select CUT_NAME from CUTS where CART_NUMBER=%u",
-			  cartnum);
-    q=new RDSqlQuery(sql);
-    while(q->next()) {
-      RDCut *cut=new RDCut(q->value(0).toString());
-      ExportCut(cart,cut);
+  unsigned n;
+
+  while((!export_counters->aborted)&&
+	((n=__sync_fetch_and_add(&export_counters->next,1))<
+	 export_cut_names.size())) {
+    RDCut *cut=new RDCut(export_cut_names[n]);
+    RDCart *cart=new RDCart(cut->cartNumber());
+    if(!ExportCut(cart,cut)) {
+      __sync_fetch_and_add(&export_counters->failed,1);
+      if(!export_continue_after_error) {
+	export_counters->aborted=true;
+      }
     }
-    delete q;
+    delete cart;
+    delete cut;
   }
-  delete cart;
 }
 
 
-void MainObject::ExportCut(RDCart *cart,RDCut *cut)
+bool MainObject::ExportCut(RDCart *cart,RDCut *cut)
 {
-  RDAudioExport *conv=new RDAudioExport(this);
-  RDAudioExport::ErrorCode export_err;
-  RDAudioConvert::ErrorCode conv_err;
+  RDAudioExport::ErrorCode export_err=RDAudioExport::ErrorOk;
+  RDAudioConvert::ErrorCode conv_err=RDAudioConvert::ErrorOk;
   RDAudioInfo::ErrorCode info_err;
+  RDWaveFile::Format format=RDWaveFile::Pcm16;
+  unsigned channels=0;
+  unsigned samplerate=0;
+  unsigned bitrate=0;
+  QString key;
+  QString filename;
+  QString exten;
+  bool local=false;
+  bool reserved=false;
+  bool ok=false;
+
+  //
+  // Skip cuts that are unchanged since the last run
+  //
+  if(export_incremental) {
+    key=ExportKey(cut);
+    std::map<QString,ExportState>::const_iterator ci=
+      export_state.find(cut->cutName());
+    if((!key.isEmpty())&&(ci!=export_state.end())&&(ci->second.key==key)&&
+       QFile::exists(export_output_to+"/"+ci->second.filename)) {
+      Verbose(QString("skipping unchanged cart/cut ")+
+	      QString().sprintf("%06u/%03d",cart->number(),cut->cutNumber()));
+      __sync_fetch_and_add(&export_counters->skipped,1);
+      return true;
+    }
+  }
 
   //
   // Get Audio Parameters
   //
-  RDAudioInfo *info=new RDAudioInfo(this);
-  info->setCartNumber(cart->number());
-  info->setCutNumber(RDCut::cutNumber(cut->cutName()));
-  if((info_err=info->runInfo(rda->user()->name(),rda->user()->password()))!=
-     RDAudioInfo::ErrorOk) {
-    fprintf(stderr,"rdexport: error getting cut info [%s]\n",
-	    (const char *)RDAudioInfo::errorText(info_err));
-    if(export_continue_after_error) {
-      return;
+  // When the audio store is reachable from here, the cut is read and
+  // converted directly rather than by way of rdxport.
+  //
+  if(QFileInfo(RDCut::pathName(cut->cutName())).isReadable()&&
+     rda->user()->cartAuthorized(cart->number())) {
+    RDWaveFile *wave=new RDWaveFile(RDCut::pathName(cut->cutName()));
+    if(wave->openWave()) {
+      local=true;
+      switch(wave->getFormatTag()) {
+      case WAVE_FORMAT_PCM:
+	if(wave->getBitsPerSample()==24) {
+	  format=RDWaveFile::Pcm24;
+	}
+	else {
+	  format=RDWaveFile::Pcm16;
+	}
+	break;
+
+      case WAVE_FORMAT_MPEG:
+	if(wave->getHeadLayer()==2) {
+	  format=RDWaveFile::MpegL2;
+	}
+	else {
+	  local=false;
+	}
+	break;
+
+      default:
+	local=false;
+	break;
+      }
+      channels=wave->getChannels();
+      samplerate=wave->getSamplesPerSec();
+      bitrate=wave->getHeadBitRate();
     }
-    else {
-      exit(256);
+    delete wave;
+  }
+  if(!local) {
+    RDAudioInfo *info=new RDAudioInfo(this);
+    info->setCartNumber(cart->number());
+    info->setCutNumber(RDCut::cutNumber(cut->cutName()));
+    if((info_err=info->runInfo(rda->user()->name(),rda->user()->password()))!=
+       RDAudioInfo::ErrorOk) {
+      fprintf(stderr,"rdexport: error getting cut info [%s]\n",
+	      (const char *)RDAudioInfo::errorText(info_err));
+      delete info;
+      return false;
     }
+    format=info->format();
+    channels=info->channels();
+    samplerate=info->sampleRate();
+    bitrate=info->bitRate();
+    delete info;
   }
   RDSettings settings;
   if(export_format.isEmpty()) {
-    switch(info->format()) {
+    switch(format) {
     case RDWaveFile::Pcm16:
       settings.setFormat(RDSettings::Pcm16);
       break;
@@ -383,35 +575,30 @@ void MainObject::ExportCut(RDCart *cart,RDCut *cut)
 
     default:
       fprintf(stderr,"rdexport: unsupported source audio format\n");
-      if(export_continue_after_error) {
-	return;
-      }
-      else {
-	exit(256);
-      }
+      return false;
     }
   }
   else {
     settings.setFormat(export_set_format);
   }
   if(export_channels==0) {
-    settings.setChannels(info->channels());
+    settings.setChannels(channels);
   }
   else {
     settings.setChannels(export_channels);
   }
   if(export_samplerate==0) {
-    settings.setSampleRate(info->sampleRate());
+    settings.setSampleRate(samplerate);
   }
   else {
     settings.setSampleRate(export_samplerate);
   }
   if(export_bitrate==0) {
-    if(info->bitRate()==0) {
+    if(bitrate==0) {
       settings.setBitRate(256000);
     }
     else {
-      settings.setBitRate(info->bitRate());
+      settings.setBitRate(bitrate);
     }
   }
   else {
@@ -421,43 +608,182 @@ void MainObject::ExportCut(RDCart *cart,RDCut *cut)
   Verbose(QString("exporting cart/cut ")+
 	  QString().sprintf("%06u/%03d",RDCut::cartNumber(cut->cutName()),
 		    RDCut::cutNumber(cut->cutName()))+" ["+cart->title()+"]");
-  conv->setCartNumber(cart->number());
-  conv->setCutNumber(RDCut::cutNumber(cut->cutName()));
-  conv->setDestinationSettings(&settings);
-  conv->setDestinationFile(ResolveOutputName(cart,cut,
-      RDSettings::defaultExtension(rda->station()->name(),settings.format())));
-  conv->setEnableMetadata(true);
-
-  if((export_err=conv->runExport(rda->user()->name(),rda->user()->password(),
-				 &conv_err))==RDAudioExport::ErrorOk) {
-    QStringList f0=f0.split("/",conv->destinationFile());
+
+  //
+  // A changed cut replaces the file written for it last time
+  //
+  exten=RDSettings::defaultExtension(rda->station()->name(),settings.format());
+  if(export_incremental&&(export_state.count(cut->cutName())>0)&&
+     export_state[cut->cutName()].filename.endsWith("."+exten)) {
+    filename=export_output_to+"/"+export_state[cut->cutName()].filename;
+  }
+  else {
+    filename=ResolveOutputName(cart,cut,exten);
+    reserved=!export_allow_clobber;
+  }
+
+  if(local) {
+    ok=(conv_err=LocalExport(cart,cut,&settings,filename))==
+      RDAudioConvert::ErrorOk;
+  }
+  else {
+    RDAudioExport *conv=new RDAudioExport(this);
+    conv->setCartNumber(cart->number());
+    conv->setCutNumber(RDCut::cutNumber(cut->cutName()));
+    conv->setDestinationSettings(&settings);
+    conv->setDestinationFile(filename);
+    conv->setEnableMetadata(true);
+    ok=(export_err=conv->runExport(rda->user()->name(),
+				   rda->user()->password(),&conv_err))==
+      RDAudioExport::ErrorOk;
+    delete conv;
+  }
+  if(ok) {
+    QStringList f0=f0.split("/",filename);
     printf("%s\n",(const char *)f0[f0.size()-1]);
+    fflush(stdout);
     if(export_xml) {
       FILE *f=NULL;
-      f0=f0.split(".",conv->destinationFile(),true);
-      QString filename;
+      f0=f0.split(".",filename,true);
+      QString xmlname;
       for(unsigned i=0;i<f0.size()-1;i++) {
-	filename+=f0[i]+".";
+	xmlname+=f0[i]+".";
       }
-      filename+="xml";
-      if((f=fopen(filename,"w"))!=NULL) {
+      xmlname+="xml";
+      if((f=fopen(xmlname,"w"))!=NULL) {
 	fprintf(f,"%s\n",
 		(const char *)cart->xml(true,true,&settings,cut->cutNumber()));
 	fclose(f);
       }
     }
+    __sync_fetch_and_add(&export_counters->exported,1);
+    __sync_fetch_and_add(&export_counters->bytes,
+			 (unsigned long long)QFileInfo(filename).size());
+    if(export_incremental&&(!key.isEmpty())) {
+      SaveState(cut->cutName(),key,filename.right(filename.length()-
+					  export_output_to.length()-1));
+    }
   }
   else {
-    fprintf(stderr,"rdexport: exporter error for output file \"%s\" [%s]\n",
-	    (const char *)conv->destinationFile(),
-	    (const char *)RDAudioExport::errorText(export_err,conv_err));
-    if(!export_continue_after_error) {
-      exit(256);
+    if(local) {
+      fprintf(stderr,"rdexport: converter error for output file \"%s\" [%s]\n",
+	      (const char *)filename,
+	      (const char *)RDAudioConvert::errorText(conv_err));
+    }
+    else {
+      fprintf(stderr,"rdexport: exporter error for output file \"%s\" [%s]\n",
+	      (const char *)filename,
+	      (const char *)RDAudioExport::errorText(export_err,conv_err));
+    }
+    if(reserved) {
+      unlink(filename);
     }
   }
 
+  return ok;
+}
+
+
+RDAudioConvert::ErrorCode MainObject::LocalExport(RDCart *cart,RDCut *cut,
+						  RDSettings *settings,
+						  const QString &filename)
+{
+  RDAudioConvert::ErrorCode err;
+  RDWaveData *wavedata=new RDWaveData();
+  float speed_ratio=1.0;
+
+  cart->getMetadata(wavedata);
+  cut->getMetadata(wavedata);
+  if(cart->enforceLength()) {
+    speed_ratio=(float)cut->length()/(float)cart->forcedLength();
+  }
+  RDAudioConvert *conv=new RDAudioConvert(this);
+  conv->setSourceFile(RDCut::pathName(cut->cutName()));
+  conv->setDestinationFile(filename);
+  conv->setDestinationSettings(settings);
+  conv->setDestinationWaveData(wavedata);
+  conv->setDestinationRdxl(cart->xml(true,true,settings,cut->cutNumber()));
+  conv->setRange(-1,-1);
+  conv->setSpeedRatio(speed_ratio);
+  err=conv->convert();
   delete conv;
-  delete info;
+  delete wavedata;
+
+  return err;
+}
+
+
+QString MainObject::ExportKey(RDCut *cut) const
+{
+  QString ret=cut->sha1Hash();
+
+  //
+  // Fall back to the modification time when the cut has not been hashed
+  //
+  if(ret.isEmpty()) {
+    QFileInfo info(RDCut::pathName(cut->cutName()));
+    if(!info.exists()) {
+      return QString();
+    }
+    ret=QString().sprintf("mtime-%u",info.lastModified().toTime_t());
+  }
+  ret+=QString().sprintf(",%u,%u,%u,%d,",export_samplerate,export_bitrate,
+			 export_channels,export_quality)+
+    export_format.lower()+","+export_metadata_pattern;
+
+  return ret;
+}
+
+
+void MainObject::LoadState()
+{
+  QString path=export_output_to+"/"+RDEXPORT_STATE_FILE;
+  FILE *f=NULL;
+  char line[1024];
+  QStringList f0;
+
+  //
+  // One "<cut-name>\t<key>\t<filename>" entry per line, with later
+  // entries replacing earlier ones.  The file is compacted here and then
+  // appended to as cuts are exported.
+  //
+  if((f=fopen(path,"r"))!=NULL) {
+    while(fgets(line,1024,f)!=NULL) {
+      f0=f0.split("\t",QString::fromUtf8(line).stripWhiteSpace(),true);
+      if(f0.size()==3) {
+	export_state[f0[0]].key=f0[1];
+	export_state[f0[0]].filename=f0[2];
+      }
+    }
+    fclose(f);
+  }
+  if((f=fopen(path+".new","w"))!=NULL) {
+    for(std::map<QString,ExportState>::const_iterator ci=export_state.begin();
+	ci!=export_state.end();ci++) {
+      fprintf(f,"%s\t%s\t%s\n",(const char *)ci->first.utf8(),
+	      (const char *)ci->second.key.utf8(),
+	      (const char *)ci->second.filename.utf8());
+    }
+    fclose(f);
+    rename(path+".new",path);
+  }
+  if((export_state_fd=open(path,O_WRONLY|O_APPEND|O_CREAT,0644))<0) {
+    fprintf(stderr,"rdexport: unable to open \"%s\" [%s]\n",
+	    (const char *)path,strerror(errno));
+    exit(256);
+  }
+}
+
+
+void MainObject::SaveState(const QString &cutname,const QString &key,
+			   const QString &filename)
+{
+  QCString line=(cutname+"\t"+key+"\t"+filename+"\n").utf8();
+
+  //
+  // A single O_APPEND write, so entries from parallel workers don't mix
+  //
+  write(export_state_fd,(const char *)line,line.length());
 }
 
 
@@ -487,10 +813,19 @@ QString MainObject::ResolveOutputName(RDCart *cart,RDCut *cut,
 
   QString ret=SanitizePath(name);
   if(!export_allow_clobber) {
+    //
+    // Create the file here, so that parallel workers can't pick the
+    // same name
+    //
     int count=1;
-    while(QFile::exists(export_output_to+"/"+ret+"."+exten)) {
+    int fd;
+    while(((fd=open(export_output_to+"/"+ret+"."+exten,
+		    O_WRONLY|O_CREAT|O_EXCL,0644))<0)&&(errno==EEXIST)) {
       ret=name+QString().sprintf("[%d]",count++);
     }
+    if(fd>=0) {
+      close(fd);
+    }
   }
 
   return export_output_to+"/"+ret+"."+exten;
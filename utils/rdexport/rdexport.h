@@ -21,16 +21,51 @@
 #ifndef RDEXPORT_H
 #define RDEXPORT_H
 
+#include <map>
 #include <vector>
 
 #include <qobject.h>
 
+#include <rdaudioconvert.h>
 #include <rdcart.h>
 #include <rdcut.h>
 #include <rddb.h>
 
 #define RDEXPORT_USAGE "[options] <output-dir>\n"
 
+//
+// Record of exported cuts kept in the output directory for --incremental
+//
+#define RDEXPORT_STATE_FILE ".rdexport-state"
+
+//
+// Maximum value for --jobs
+//
+#define RDEXPORT_MAX_JOBS 32
+
+//
+// Shared by all worker processes
+//
+class ExportCounters
+{
+ public:
+  unsigned next;
+  unsigned exported;
+  unsigned skipped;
+  unsigned failed;
+  unsigned long long bytes;
+  bool aborted;
+};
+
+
+class ExportState
+{
+ public:
+  QString key;
+  QString filename;
+};
+
+
 class MainObject : public QObject
 {
   Q_OBJECT;
@@ -41,10 +76,17 @@ class MainObject : public QObject
   void userData();
 
  private:
-  void ExportTitle(const QString &title);
-  void ExportGroup(const QString &groupname);
-  void ExportCart(unsigned cartnum);
-  void ExportCut(RDCart *cart,RDCut *cut);
+  void LoadCuts(const QString &where);
+  void RunExports();
+  void RunWorker();
+  bool ExportCut(RDCart *cart,RDCut *cut);
+  RDAudioConvert::ErrorCode LocalExport(RDCart *cart,RDCut *cut,
+					RDSettings *settings,
+					const QString &filename);
+  QString ExportKey(RDCut *cut) const;
+  void LoadState();
+  void SaveState(const QString &cutname,const QString &key,
+		 const QString &filename);
   QString ResolveOutputName(RDCart *cart,RDCut *cut,const QString &exten);
   QString SanitizePath(const QString &pathname) const;
   void Verbose(const QString &msg);
@@ -52,6 +94,12 @@ class MainObject : public QObject
   std::vector<unsigned> export_end_carts;
   std::vector<QString> export_groups;
   std::vector<QString> export_titles;
+  std::vector<QString> export_cut_names;
+  ExportCounters *export_counters;
+  unsigned export_jobs;
+  bool export_incremental;
+  std::map<QString,ExportState> export_state;
+  int export_state_fd;
   QString export_metadata_pattern;
   QString export_output_to;
   QString export_format;
@@ -779,6 +779,10 @@ void MainObject::userData()
     RunDropBox();
   }
   else {
+    //
+    // Cart notifications are coalesced into batch messages for the run
+    //
+    rda->ripc()->beginNotificationBatch();
     for(unsigned i=import_file_key;i<rda->cmdSwitch()->keys();i++) {
       ProcessFileList(rda->cmdSwitch()->key(i));
     }
@@ -828,6 +832,8 @@ void MainObject::userData()
 	ProcessFileList(buffer);
       }
     }
+    rda->ripc()->endNotificationBatch();
+    qApp->processEvents();
   }
 
   //
@@ -864,9 +870,12 @@ void MainObject::RunDropBox()
     //
     // Scan for Eligible Imports
     //
+    rda->ripc()->beginNotificationBatch();
     for(unsigned i=import_file_key;i<rda->cmdSwitch()->keys();i++) {
       ProcessFileList(rda->cmdSwitch()->key(i));
     }
+    rda->ripc()->endNotificationBatch();
+    qApp->processEvents();
 
     //
     // Take Out the Trash
@@ -1064,8 +1073,13 @@ MainObject::Result MainObject::ImportFile(const QString &filename,
       return MainObject::FileBad;
     }
   }
-  if(*cartnum==0) {
-    *cartnum=effective_group->nextFreeCart();
+  bool auto_cart=(*cartnum==0);
+  if(auto_cart) {
+    //
+    // Allocate and create in one step so that concurrent importers
+    // cannot both claim the same free number.
+    //
+    *cartnum=RDCart::create(effective_group->name(),RDCart::Audio,&err_msg);
   }
   if(*cartnum==0) {
     PrintLogDateTime(stderr);
@@ -1090,8 +1104,8 @@ MainObject::Result MainObject::ImportFile(const QString &filename,
   if(import_delete_cuts) {
     DeleteCuts(import_cart_number);
   }
-  cart_created=
-    RDCart::create(effective_group->name(),RDCart::Audio,&err_msg,*cartnum)!=0;
+  cart_created=auto_cart||
+    (RDCart::create(effective_group->name(),RDCart::Audio,&err_msg,*cartnum)!=0);
   RDCart *cart=new RDCart(*cartnum);
   int cutnum=
     cart->addCut(import_format,import_bitrate,import_channels);
@@ -1363,6 +1377,8 @@ MainObject::Result MainObject::ImportFile(const QString &filename,
     }
   }
   if(!import_run) {
+    rda->ripc()->endNotificationBatch();
+    qApp->processEvents();
     exit(0);
   }
   if(!import_temp_fix_filename.isEmpty()) {
@@ -226,11 +226,10 @@ void MainObject::PurgeElr()
   sql="select NAME,ELR_SHELFLIFE from SERVICES where ELR_SHELFLIFE>=0";
   q=new RDSqlQuery(sql);
   while(q->next()) {
-    QString tablename=q->value(0).toString()+"_SRT";
-    tablename.replace(" ","_");
-    sql=QString("delete from `")+tablename+"` where "+
-      "EVENT_DATETIME<\""+
-      dt.addDays(-q->value(1).toInt()).toString("yyyy-MM-dd")+" 00:00:00\"";
+    sql=QString("delete from ELR_LINES where ")+
+      "(SERVICE_NAME=\""+RDEscapeString(q->value(0).toString())+"\")&&"+
+      "(EVENT_DATETIME<\""+
+      dt.addDays(-q->value(1).toInt()).toString("yyyy-MM-dd")+" 00:00:00\")";
     q1=new RDSqlQuery(sql);
     delete q1;
   }
@@ -0,0 +1,327 @@
+// batch.cpp
+//
+// Rivendell web service portal -- Batch service
+//
+//   (C) Copyright 2018 Fred Gleason <fredg@paravelsystems.com>
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License version 2 as
+//   published by the Free Software Foundation.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public
+//   License along with this program; if not, write to the Free Software
+//   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+//
+
+#include <errno.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <string>
+
+#include <qsqldatabase.h>
+
+#include <rdformpost.h>
+#include <rdwebresult.h>
+#include <rdxport_interface.h>
+
+#include <rdxport.h>
+
+void Xport::Batch()
+{
+  int items=0;
+  int jobs=1;
+  int pipefd[2];
+  int fds[RDXPORT_BATCH_MAX_JOBS];
+  std::string bufs[RDXPORT_BATCH_MAX_JOBS];
+  struct pollfd pfds[RDXPORT_BATCH_MAX_JOBS];
+  int worker[RDXPORT_BATCH_MAX_JOBS];
+  char buf[4096];
+  unsigned nfds;
+  size_t end;
+  ssize_t n;
+  pid_t pid;
+
+  //
+  // Verify Post
+  //
+  if(!xport_post->getValue("OPERATIONS",&items)) {
+    XmlExit("Missing OPERATIONS",400,"batch.cpp",LINE_NUMBER);
+  }
+  if(items<0) {
+    XmlExit("Invalid OPERATIONS",400,"batch.cpp",LINE_NUMBER);
+  }
+  xport_post->getValue("JOBS",&jobs);
+  if(jobs>RDXPORT_BATCH_MAX_JOBS) {
+    jobs=RDXPORT_BATCH_MAX_JOBS;
+  }
+  if(jobs>items) {
+    jobs=items;
+  }
+  if(jobs<1) {
+    jobs=1;
+  }
+
+  //
+  // Process Request
+  //
+  printf("Content-type: application/xml\n\n");
+  printf("<?xml version=\"1.0\" encoding=\"UTF-8\" ?>\n");
+  printf("<batchResultList>\n");
+  fflush(stdout);
+  if(jobs==1) {
+    //
+    // Everything is run from here, on our database connection
+    //
+    for(int i=0;i<items;i++) {
+      printf("%s",RunBatchItem(i).c_str());
+      fflush(stdout);
+    }
+  }
+  else {
+    //
+    // Operations are dealt out to 'jobs' workers, each with its own
+    // database connection, and their results are passed back here
+    // (separated by NULs) to be written out whole as they complete.
+    //
+    // Our own connection is closed while the workers run, so that none
+    // of them inherits it; closing it in a worker would end the session
+    // on the server for everyone sharing the socket.
+    //
+    QSqlDatabase *db=QSqlDatabase::database();
+    db->close();
+    for(int i=0;i<jobs;i++) {
+      fds[i]=-1;
+      if(pipe(pipefd)<0) {
+	continue;
+      }
+      if((pid=fork())==0) {
+	close(pipefd[0]);
+	bool db_ok=db->open();
+	for(int j=i;j<items;j+=jobs) {
+	  std::string result;
+	  if(db_ok) {
+	    result=RunBatchItem(j);
+	  }
+	  else {
+	    result=BatchResult(j,0,"Status: 500\n\n"+
+		std::string(RDWebResult("Unable to open database connection",
+					500,RDAudioConvert::ErrorOk).
+			    xml().utf8()));
+	  }
+	  result+='\0';
+	  for(size_t k=0;k<result.size();k+=n) {
+	    if((n=write(pipefd[1],result.c_str()+k,result.size()-k))<0) {
+	      if(errno!=EINTR) {
+		_exit(1);
+	      }
+	      n=0;
+	    }
+	  }
+	}
+	_exit(0);
+      }
+      close(pipefd[1]);
+      if(pid<0) {
+	close(pipefd[0]);
+	continue;
+      }
+      fds[i]=pipefd[0];
+    }
+    for(int i=0;i<jobs;i++) {
+      if(fds[i]<0) {
+	for(int j=i;j<items;j+=jobs) {
+	  printf("%s",BatchResult(j,0,"Status: 500\n\n"+
+		      std::string(RDWebResult("Unable to start batch worker",
+					      500,RDAudioConvert::ErrorOk).
+				  xml().utf8())).c_str());
+	}
+      }
+    }
+    fflush(stdout);
+    while(true) {
+      nfds=0;
+      for(int i=0;i<jobs;i++) {
+	if(fds[i]>=0) {
+	  pfds[nfds].fd=fds[i];
+	  pfds[nfds].events=POLLIN;
+	  pfds[nfds].revents=0;
+	  worker[nfds++]=i;
+	}
+      }
+      if(nfds==0) {
+	break;
+      }
+      if(poll(pfds,nfds,-1)<0) {
+	if(errno==EINTR) {
+	  continue;
+	}
+	break;
+      }
+      for(unsigned i=0;i<nfds;i++) {
+	if(pfds[i].revents==0) {
+	  continue;
+	}
+	int w=worker[i];
+	if((n=read(fds[w],buf,sizeof(buf)))>0) {
+	  bufs[w].append(buf,n);
+	  while((end=bufs[w].find('\0'))!=std::string::npos) {
+	    printf("%s",bufs[w].substr(0,end).c_str());
+	    bufs[w].erase(0,end+1);
+	  }
+	  fflush(stdout);
+	}
+	else {
+	  if((n<0)&&(errno==EINTR)) {
+	    continue;
+	  }
+	  close(fds[w]);
+	  fds[w]=-1;
+	}
+      }
+    }
+    while((waitpid(-1,NULL,0)>0)||(errno==EINTR));
+    db->open();
+  }
+  printf("</batchResultList>\n");
+
+  Exit(0);
+}
+
+
+std::string Xport::RunBatchItem(int item)
+{
+  QString suffix=QString().sprintf("_%d",item);
+  QStringList names;
+  std::string out;
+  int command=0;
+  int pipefd[2];
+  char buf[4096];
+  ssize_t n;
+  pid_t pid;
+
+  xport_post->getValue("COMMAND"+suffix,&command);
+  fflush(stdout);
+  if(pipe(pipefd)<0) {
+    return BatchResult(item,command,"Status: 500\n\n"+
+		       std::string(RDWebResult("Unable to create pipe",500,
+					       RDAudioConvert::ErrorOk).
+				   xml().utf8()));
+  }
+  if((pid=fork())==0) {
+    //
+    // The operation runs in its own process, so that it can exit as it
+    // would for a single call and take its allocations with it.  Fields
+    // named "<name>_<item>" override any shared "<name>" field.
+    //
+    close(pipefd[0]);
+    dup2(pipefd[1],1);
+    close(pipefd[1]);
+    xport_batch_item=true;
+    names=xport_post->names();
+    for(unsigned i=0;i<names.size();i++) {
+      if((names[i].length()>suffix.length())&&names[i].endsWith(suffix)) {
+	xport_post->setValue(names[i].left(names[i].length()-suffix.length()),
+			     xport_post->value(names[i]));
+      }
+    }
+    switch(command) {
+    case RDXPORT_COMMAND_TRIMAUDIO:
+      TrimAudio();
+      break;
+
+    case RDXPORT_COMMAND_AUDIOINFO:
+      AudioInfo();
+      break;
+
+    case RDXPORT_COMMAND_EDITCUT:
+      EditCut();
+      break;
+
+    case RDXPORT_COMMAND_REMOVECART:
+      RemoveCart();
+      break;
+
+    case RDXPORT_COMMAND_LISTCUT:
+      ListCut();
+      break;
+
+    default:
+      XmlExit("Unsupported batch command",400,"batch.cpp",LINE_NUMBER);
+      break;
+    }
+    Exit(0);
+  }
+  close(pipefd[1]);
+  if(pid<0) {
+    close(pipefd[0]);
+    return BatchResult(item,command,"Status: 500\n\n"+
+		       std::string(RDWebResult("Unable to fork",500,
+					       RDAudioConvert::ErrorOk).
+				   xml().utf8()));
+  }
+  while((n=read(pipefd[0],buf,sizeof(buf)))!=0) {
+    if(n<0) {
+      if(errno==EINTR) {
+	continue;
+      }
+      break;
+    }
+    out.append(buf,n);
+  }
+  close(pipefd[0]);
+  while((waitpid(pid,NULL,0)<0)&&(errno==EINTR));
+
+  return BatchResult(item,command,out);
+}
+
+
+std::string Xport::BatchResult(int item,int command,
+			       const std::string &response) const
+{
+  std::string ret;
+  std::string body;
+  size_t end;
+  size_t ptr=0;
+  int code=200;
+
+  //
+  // Split the CGI headers from the body
+  //
+  if((end=response.find("\n\n"))==std::string::npos) {
+    code=500;
+    body=RDWebResult("Operation failed",500,RDAudioConvert::ErrorOk).
+      xml().utf8();
+  }
+  else {
+    while(ptr<end) {
+      size_t eol=response.find('\n',ptr);
+      if(response.compare(ptr,8,"Status: ")==0) {
+	code=atoi(response.substr(ptr+8,eol-ptr-8).c_str());
+      }
+      ptr=eol+1;
+    }
+    body=response.substr(end+2);
+    if(body.compare(0,5,"<?xml")==0) {
+      body.erase(0,body.find('\n')+1);
+    }
+  }
+  ret="  <batchResult>\n";
+  ret+=QString().sprintf("    <index>%d</index>\n",item).utf8();
+  ret+=QString().sprintf("    <command>%d</command>\n",command).utf8();
+  ret+=QString().sprintf("    <responseCode>%d</responseCode>\n",code).utf8();
+  ret+=body;
+  ret+="  </batchResult>\n";
+
+  return ret;
+}
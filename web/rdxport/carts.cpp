@@ -75,13 +75,7 @@ void Xport::AddCart()
     XmlExit("No such group",404,"carts.cpp",LINE_NUMBER);
   }
   group=new RDGroup(group_name);
-  if(cart_number==0) {
-    if((cart_number=group->nextFreeCart())==0) {
-      delete group;
-      XmlExit("No free carts in group",500,"carts.cpp",LINE_NUMBER);
-    }
-  }
-  if(!group->cartNumberValid(cart_number)) {
+  if((cart_number!=0)&&(!group->cartNumberValid(cart_number))) {
     delete group;
     XmlExit("Cart number out of range for group",404,"carts.cpp",LINE_NUMBER);
   }
@@ -93,14 +87,27 @@ void Xport::AddCart()
   //
   // Process Request
   //
-  cart=new RDCart(cart_number);
-  if(cart->exists()) {
-    delete cart;
-    XmlExit("Cart already exists",400,"carts.cpp",LINE_NUMBER);
+  if(cart_number==0) {
+    //
+    // Allocate and create in one step so that concurrent requests
+    // cannot both claim the same free number.
+    //
+    if((cart_number=RDCart::create(group_name,cart_type,&err_msg))==0) {
+      XmlExit("No free carts in group",500,"carts.cpp",LINE_NUMBER);
+    }
+    cart=new RDCart(cart_number);
   }
-  if(RDCart::create(group_name,cart_type,&err_msg,cart_number)==0) {
-    delete cart;
-    XmlExit("Unable to create cart ["+err_msg+"]",500,"carts.cpp",LINE_NUMBER);
+  else {
+    cart=new RDCart(cart_number);
+    if(cart->exists()) {
+      delete cart;
+      XmlExit("Cart already exists",400,"carts.cpp",LINE_NUMBER);
+    }
+    if(RDCart::create(group_name,cart_type,&err_msg,cart_number)==0) {
+      delete cart;
+      XmlExit("Unable to create cart ["+err_msg+"]",500,"carts.cpp",
+	      LINE_NUMBER);
+    }
   }
   printf("Content-type: application/xml\n");
   printf("Status: 200\n\n");
@@ -489,6 +496,8 @@ void Xport::AddCut()
   cut=new RDCut(cart_number,cut_number);
   if(cut->exists()) {
     printf("%s",(const char *)RDCart::cutXml(cart_number,cut_number,true));
+    SendNotification(RDNotification::CutType,RDNotification::AddAction,
+		     QVariant(cut->cutName()));
     SendNotification(RDNotification::CartType,RDNotification::ModifyAction,
 		     QVariant(cart->number()));
   }
@@ -851,6 +860,8 @@ void Xport::EditCut()
   printf("<cutList>\n");
   printf("%s",(const char *)RDCart::cutXml(cart_number,cut_number,true));
   printf("</cutList>\n");
+  SendNotification(RDNotification::CutType,RDNotification::ModifyAction,
+		   QVariant(cut->cutName()));
   SendNotification(RDNotification::CartType,RDNotification::ModifyAction,
 		   QVariant(cut->cartNumber()));
   delete cut;
@@ -944,6 +955,8 @@ void Xport::RemoveCut()
     delete cart;
     XmlExit("No such cut",404);
   }
+  SendNotification(RDNotification::CutType,RDNotification::DeleteAction,
+		   QVariant(RDCut::cutName(cart_number,cut_number)));
   SendNotification(RDNotification::CartType,RDNotification::ModifyAction,
 		   QVariant(cart->number()));
   delete cart;
@@ -27,6 +27,7 @@
 #include <rdaudioconvert.h>
 #include <rdcart.h>
 #include <rdconf.h>
+#include <rd.h>
 #include <rdformpost.h>
 #include <rdgroup.h>
 #include <rdhash.h>
@@ -145,15 +146,14 @@ void Xport::Import()
     if(!group->exists()) {
       XmlExit("No such group",404,"import.cpp",LINE_NUMBER);
     }
-    if((cartnum=group->nextFreeCart())==0) {
+    //
+    // Let RDCart::create() pick the number so that it can retry if
+    // another importer takes the same one first.
+    //
+    if((cartnum=RDCart::create(group_name,RDCart::Audio,&err_msg))==0) {
       XmlExit("No available carts for specified group",404,"import.cpp",LINE_NUMBER);
     }
     cart=new RDCart(cartnum);
-    if(RDCart::create(group_name,RDCart::Audio,&err_msg,cartnum)==0) {
-      delete cart;
-      XmlExit("Unable to create cart ["+err_msg+"]",500,"import.cpp",
-	      LINE_NUMBER);
-    }
     SendNotification(RDNotification::CartType,RDNotification::AddAction,
 		     QVariant(cartnum));
     cutnum=1;
@@ -225,7 +225,24 @@ void Xport::Import()
       cart->setMetadata(conv->sourceWaveData());
       cut->setMetadata(conv->sourceWaveData());
     }
-    if(autotrim_level!=0) {
+    if(autotrim_level<0) {
+      //
+      // Trim from the levels gathered during the conversion pass rather
+      // than re-reading the new cut audio.
+      //
+      int point;
+      int start_point=0;
+      int end_point=msecs;
+      int level=REFERENCE_LEVEL-100*autotrim_level;
+      if((point=conv->startTrim(level))>-1) {
+	start_point=(int)(1000.0*(double)point/(double)settings->sampleRate());
+      }
+      if((point=conv->endTrim(level))>-1) {
+	end_point=(int)(1000.0*(double)point/(double)settings->sampleRate());
+      }
+      cut->setTrimPoints(start_point,end_point);
+    }
+    if(autotrim_level>0) {
       cut->autoTrim(RDCut::AudioBoth,100*autotrim_level);
     }
     cart->updateLength();
@@ -256,7 +273,11 @@ void Xport::Import()
     break;
   }
   if(resp_code==200) {
-    cut->setSha1Hash(RDSha1Hash(RDCut::pathName(cut->cutName())));
+    QString hash=conv->sha1Hash();
+    if(hash.isEmpty()) {
+      hash=RDSha1Hash(RDCut::pathName(cut->cutName()));
+    }
+    cut->setSha1Hash(hash);
     if(!title.isEmpty()) {
       cart->setTitle(title);
     }
@@ -25,6 +25,7 @@
 #include <ctype.h>
 #include <stdlib.h>
 #include <stdio.h>
+#include <unistd.h>
 #include <openssl/sha.h>
 
 #include <map>
@@ -37,6 +38,7 @@
 #include <rddb.h>
 #include <rdescape_string.h>
 #include <rdweb.h>
+#include <rdwebresult.h>
 #include <rdformpost.h>
 #include <rdxport_interface.h>
 #include <dbversion.h>
@@ -48,6 +50,8 @@ Xport::Xport(QObject *parent)
 {
   QString err_msg;
 
+  xport_batch_item=false;
+
   //
   // Open the Database
   //
@@ -282,6 +286,10 @@ void Xport::ripcConnectedData(bool state)
     Rehash();
     break;
 
+  case RDXPORT_COMMAND_BATCH:
+    Batch();
+    break;
+
   default:
     printf("Content-type: text/html\n\n");
     printf("rdxport: missing/invalid command\n");
@@ -422,6 +430,14 @@ void Xport::SendNotification(RDNotification::Type type,
 
 void Xport::Exit(int code)
 {
+  if(xport_batch_item) {
+    //
+    // Leave the post (and its temporary files) and the database
+    // connection to the batch process
+    //
+    fflush(stdout);
+    _exit(code);
+  }
   if(xport_post!=NULL) {
     delete xport_post;
   }
@@ -432,6 +448,15 @@ void Xport::Exit(int code)
 void Xport::XmlExit(const QString &str,int code,const QString &srcfile,
 		    int srcline,RDAudioConvert::ErrorCode err)
 {
+  if(xport_batch_item) {
+    RDWebResult *we=new RDWebResult(str,code,err);
+    printf("Content-type: application/xml\n");
+    printf("Status: %d\n",code);
+    printf("\n");
+    printf("%s",(const char *)we->xml());
+    delete we;
+    Exit(0);
+  }
   if(xport_post!=NULL) {
     delete xport_post;
   }
@@ -21,6 +21,8 @@
 #ifndef RDXPORT_H
 #define RDXPORT_H
 
+#include <string>
+
 #include <qobject.h>
 
 #include <rdaudioconvert.h>
@@ -33,6 +35,11 @@
 #define STRINGIZE2(x) #x
 #define LINE_NUMBER QString(STRINGIZE(__LINE__)).toInt()
 
+//
+// Maximum number of parallel workers for a Batch call
+//
+#define RDXPORT_BATCH_MAX_JOBS 8
+
 class Xport : public QObject
 {
   Q_OBJECT;
@@ -83,6 +90,10 @@ class Xport : public QObject
   void ListServices();
   void ListSystemSettings();
   void LockLog();
+  void Batch();
+  std::string RunBatchItem(int item);
+  std::string BatchResult(int item,int command,
+			  const std::string &response) const;
   QString LogLockXml(bool result,const QString &log_name,const QString &guid,
 		     const QString &username,const QString &stationname,
 		     const QHostAddress addr) const;
@@ -95,6 +106,7 @@ class Xport : public QObject
   RDFormPost *xport_post;
   QString xport_remote_hostname;
   QHostAddress xport_remote_address;
+  bool xport_batch_item;
 };
 
 